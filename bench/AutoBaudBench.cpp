@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench/Bench.h"
+#include "serial/AutoBaud.h"
+
+namespace {
+
+// A logic analyser style capture rate, at least 4 samples per bit up to 921600 baud.
+constexpr DWORD kSampleRate = 4000000;
+constexpr std::size_t kPayloadBytes = 256;
+
+std::vector<uint8_t> TextPayload() {
+    const std::string line = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\nOK temp=21.5 rh=40\r\n";
+    std::vector<uint8_t> payload;
+    while (payload.size() < kPayloadBytes) {
+        payload.insert(payload.end(), line.begin(), line.end());
+    }
+    payload.resize(kPayloadBytes);
+    return payload;
+}
+
+std::vector<uint8_t> BinaryPayload(std::uint32_t seed) {
+    std::vector<uint8_t> payload(kPayloadBytes);
+    for (uint8_t& byte : payload) {
+        seed = seed * 1664525U + 1013904223U;
+        byte = static_cast<uint8_t>(seed >> 24U);
+    }
+    return payload;
+}
+
+serial::PortSettings Format(DWORD baud, BYTE dataBits, serial::ParityMode parity, serial::StopBitsMode stopBits) {
+    serial::PortSettings settings{};
+    settings.baudRate = baud;
+    settings.dataBits = dataBits;
+    settings.parity = parity;
+    settings.stopBits = stopBits;
+    return settings;
+}
+
+// The transmitter pauses now and then, as real devices do between messages.
+serial::LineCapture Transmit(const std::vector<uint8_t>& payload, const serial::PortSettings& format) {
+    serial::LineCapture capture;
+    capture.sampleRate = kSampleRate;
+    capture.AppendIdle(kSampleRate / format.baudRate * 20U);
+    for (std::size_t i = 0; i < payload.size(); ++i) {
+        const std::size_t idleBits = (i % 16U == 15U) ? 5U : (i % 3U == 0U ? 1U : 0U);
+        capture.AppendFrames(std::span<const uint8_t>(&payload[i], 1), format, format.baudRate, idleBits);
+    }
+    capture.AppendIdle(kSampleRate / format.baudRate * 20U);
+    return capture;
+}
+
+// What a UART at baud in 8N1 hands to the application; framing errors read as 0 as on Linux.
+std::vector<uint8_t> Receive(const serial::LineCapture& line, DWORD baud) {
+    std::vector<uint8_t> bytes;
+    const double samplesPerBit = static_cast<double>(line.sampleRate) / baud;
+    const auto level = [&](std::size_t start, double bit) { return line.samples[start + static_cast<std::size_t>(bit * samplesPerBit)]; };
+    for (std::size_t i = 1; i + static_cast<std::size_t>(10.0 * samplesPerBit) < line.samples.size(); ++i) {
+        if (line.samples[i] != 0 || line.samples[i - 1] == 0 || level(i, 0.5) != 0) {
+            continue;
+        }
+        unsigned value = 0;
+        for (unsigned bit = 0; bit < 8; ++bit) {
+            value |= static_cast<unsigned>(level(i, 1.5 + bit)) << bit;
+        }
+        bytes.push_back(level(i, 9.5) != 0 ? static_cast<uint8_t>(value) : uint8_t{0});
+        i += static_cast<std::size_t>(9.5 * samplesPerBit);
+    }
+    return bytes;
+}
+
+std::string FormatName(const serial::PortSettings& settings) {
+    static constexpr char kParity[] = {'N', 'O', 'E', 'M', 'S'};
+    static constexpr const char* kStop[] = {"1", "1.5", "2"};
+    return std::to_string(settings.baudRate) + "/" + std::to_string(settings.dataBits) +
+        kParity[static_cast<int>(settings.parity)] + kStop[static_cast<int>(settings.stopBits)];
+}
+
+struct Expectation {
+    const char* name;
+    serial::PortSettings sent;
+    serial::PortSettings detected; // 8N2 is read back as 8N1: both receive the same data.
+    bool text;
+};
+
+void RunAutoBaud(const bench::Options&, bench::Report& report) {
+    using serial::ParityMode;
+    using serial::StopBitsMode;
+    const auto f = &Format;
+    const Expectation expectations[] = {
+        {"text", f(9600, 8, ParityMode::None, StopBitsMode::One), f(9600, 8, ParityMode::None, StopBitsMode::One), true},
+        {"text", f(115200, 7, ParityMode::Even, StopBitsMode::One), f(115200, 7, ParityMode::Even, StopBitsMode::One), true},
+        {"text", f(38400, 8, ParityMode::Odd, StopBitsMode::One), f(38400, 8, ParityMode::Odd, StopBitsMode::One), true},
+        {"text", f(19200, 8, ParityMode::None, StopBitsMode::Two), f(19200, 8, ParityMode::None, StopBitsMode::One), true},
+        {"binary", f(57600, 8, ParityMode::None, StopBitsMode::One), f(57600, 8, ParityMode::None, StopBitsMode::One), false},
+        {"binary", f(230400, 8, ParityMode::Even, StopBitsMode::One), f(230400, 8, ParityMode::Even, StopBitsMode::One), false},
+        {"binary", f(921600, 8, ParityMode::None, StopBitsMode::One), f(921600, 8, ParityMode::None, StopBitsMode::One), false},
+    };
+
+    const auto same = [](const serial::PortSettings& a, const serial::PortSettings& b) {
+        return a.baudRate == b.baudRate && a.dataBits == b.dataBits && a.parity == b.parity && a.stopBits == b.stopBits;
+    };
+
+    // Offline: one oversampled recording per transmitter, every rate and format scored on it.
+    std::size_t index = 0;
+    for (const Expectation& expectation : expectations) {
+        const std::vector<uint8_t> payload = expectation.text ? TextPayload() : BinaryPayload(static_cast<std::uint32_t>(++index));
+        const std::vector<serial::LineCapture> captures{Transmit(payload, expectation.sent)};
+
+        serial::AutoBaudOptions options;
+        options.threads = 1;
+        const auto start = bench::Clock::now();
+        const auto ranked = serial::AutoBaud::Rank(captures, options);
+        const double oneThread = bench::SecondsSince(start);
+        options.threads = 0;
+        const auto parallelStart = bench::Clock::now();
+        const auto best = serial::AutoBaud::Detect(captures, options);
+        const double allThreads = bench::SecondsSince(parallelStart);
+
+        const std::string caseName = std::string("offline/") + expectation.name + "/" + FormatName(expectation.sent);
+        bench::Case& result = report.Add(caseName);
+        result.Set("samples", static_cast<double>(captures.front().samples.size()));
+        result.Set("candidates", static_cast<double>(ranked.size()));
+        result.Set("rank_ms_1_thread", oneThread * 1000.0);
+        result.Set("rank_ms_all_threads", allThreads * 1000.0);
+        result.Set("threads", static_cast<double>(std::max(1U, std::thread::hardware_concurrency())));
+        if (ranked.size() > 1) {
+            result.Set("score_margin", ranked[0].score - ranked[1].score);
+        }
+        if (!best || !same(best->settings, expectation.detected)) {
+            report.Fail(caseName + ": detected " + (best ? FormatName(best->settings) : std::string("nothing")));
+        }
+    }
+
+    // Live-style: what a port swept through the standard rates in 8N1 would have received.
+    for (const Expectation& expectation : expectations) {
+        if (!expectation.text) {
+            continue;
+        }
+        const serial::LineCapture line = Transmit(TextPayload(), expectation.sent);
+        std::vector<serial::LineCapture> captures;
+        for (const DWORD baud : serial::AutoBaud::StandardBaudRates()) {
+            if (kSampleRate / baud >= 4U && baud >= 2400U) {
+                captures.push_back(serial::LineCapture::FromReceived(Receive(line, baud), baud));
+            }
+        }
+
+        const auto start = bench::Clock::now();
+        const auto best = serial::AutoBaud::Detect(captures);
+        const double seconds = bench::SecondsSince(start);
+
+        // Frames longer than ten bits do not survive the 8N1 sweep, only the rate can be found.
+        const bool fullFormat = 1 + expectation.sent.dataBits + (expectation.sent.parity != ParityMode::None ? 1 : 0) + 1 <= 10;
+        const std::string caseName = std::string("sweep/text/") + FormatName(expectation.sent);
+        bench::Case& result = report.Add(caseName);
+        result.Set("captures", static_cast<double>(captures.size()));
+        result.Set("rank_ms", seconds * 1000.0);
+        result.Set("format_detected", best && same(best->settings, expectation.detected) ? 1.0 : 0.0);
+        if (!best || best->settings.baudRate != expectation.sent.baudRate || (fullFormat && !same(best->settings, expectation.detected))) {
+            report.Fail(caseName + ": detected " + (best ? FormatName(best->settings) : std::string("nothing")));
+        }
+    }
+}
+
+const bench::SuiteRegistrar kAutoBaud("auto_baud", &RunAutoBaud);
+
+} // namespace
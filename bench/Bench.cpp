@@ -0,0 +1,169 @@
+#include "bench/Bench.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+namespace {
+
+struct Suite {
+    const char* name;
+    bench::SuiteFn run;
+};
+
+std::vector<Suite>& Suites() {
+    static std::vector<Suite> suites;
+    return suites;
+}
+
+void WriteJsonString(std::FILE* out, std::string_view text) {
+    std::fputc('"', out);
+    for (const char ch : text) {
+        if (ch == '"' || ch == '\\') {
+            std::fputc('\\', out);
+            std::fputc(ch, out);
+        } else if (static_cast<unsigned char>(ch) < 0x20U) {
+            std::fprintf(out, "\\u%04x", static_cast<unsigned>(ch));
+        } else {
+            std::fputc(ch, out);
+        }
+    }
+    std::fputc('"', out);
+}
+
+void WriteSuite(std::FILE* out, const char* name, const bench::Report& report) {
+    std::fputs("    {\n      \"name\": ", out);
+    WriteJsonString(out, name);
+    std::fputs(",\n      \"cases\": [", out);
+
+    const auto& cases = report.Cases();
+    for (std::size_t i = 0; i < cases.size(); ++i) {
+        std::fputs(i == 0 ? "\n        {\"name\": " : ",\n        {\"name\": ", out);
+        WriteJsonString(out, cases[i].Name());
+        std::fputs(", \"metrics\": {", out);
+
+        const auto& metrics = cases[i].Metrics();
+        for (std::size_t m = 0; m < metrics.size(); ++m) {
+            if (m > 0) {
+                std::fputs(", ", out);
+            }
+            WriteJsonString(out, metrics[m].first);
+            std::fprintf(out, ": %.10g", metrics[m].second);
+        }
+        std::fputs("}}", out);
+    }
+
+    std::fputs(cases.empty() ? "],\n      \"failures\": [" : "\n      ],\n      \"failures\": [", out);
+    const auto& failures = report.Failures();
+    for (std::size_t i = 0; i < failures.size(); ++i) {
+        if (i > 0) {
+            std::fputs(", ", out);
+        }
+        WriteJsonString(out, failures[i]);
+    }
+    std::fputs("]\n    }", out);
+}
+
+void PrintUsage() {
+    std::fputs("usage: COMTerminalBench [--seconds N] [--list] [suite...]\n", stderr);
+}
+
+} // namespace
+
+namespace bench {
+
+Case::Case(std::string name) : name_(std::move(name)) {}
+
+void Case::Set(const std::string& key, double value) {
+    metrics_.emplace_back(key, value);
+}
+
+const std::string& Case::Name() const noexcept {
+    return name_;
+}
+
+const std::vector<std::pair<std::string, double>>& Case::Metrics() const noexcept {
+    return metrics_;
+}
+
+Case& Report::Add(std::string name) {
+    cases_.emplace_back(std::move(name));
+    return cases_.back();
+}
+
+void Report::Fail(const std::string& message) {
+    failures_.push_back(message);
+}
+
+const std::vector<Case>& Report::Cases() const noexcept {
+    return cases_;
+}
+
+const std::vector<std::string>& Report::Failures() const noexcept {
+    return failures_;
+}
+
+SuiteRegistrar::SuiteRegistrar(const char* name, SuiteFn run) {
+    Suites().push_back(Suite{name, run});
+}
+
+double SecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+} // namespace bench
+
+int main(int argc, char** argv) {
+    bench::Options options;
+    std::vector<std::string_view> selected;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--seconds" && i + 1 < argc) {
+            options.seconds = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--list") {
+            for (const auto& suite : Suites()) {
+                std::printf("%s\n", suite.name);
+            }
+            return 0;
+        } else if (arg.starts_with("--")) {
+            PrintUsage();
+            return 2;
+        } else {
+            selected.push_back(arg);
+        }
+    }
+
+    if (options.seconds <= 0.0) {
+        PrintUsage();
+        return 2;
+    }
+
+    bool failed = false;
+    bool first = true;
+    std::fputs("{\n  \"suites\": [\n", stdout);
+    for (const auto& suite : Suites()) {
+        bool wanted = selected.empty();
+        for (const auto name : selected) {
+            wanted = wanted || name == suite.name;
+        }
+        if (!wanted) {
+            continue;
+        }
+
+        bench::Report report;
+        suite.run(options, report);
+        failed = failed || !report.Failures().empty();
+
+        if (!first) {
+            std::fputs(",\n", stdout);
+        }
+        first = false;
+        WriteSuite(stdout, suite.name, report);
+        std::fflush(stdout);
+    }
+    std::fputs("\n  ]\n}\n", stdout);
+
+    return failed ? 1 : 0;
+}
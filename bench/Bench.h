@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+struct Options {
+    double seconds = 2.0;
+};
+
+class Case final {
+public:
+    explicit Case(std::string name);
+
+    void Set(const std::string& key, double value);
+    [[nodiscard]] const std::string& Name() const noexcept;
+    [[nodiscard]] const std::vector<std::pair<std::string, double>>& Metrics() const noexcept;
+
+private:
+    std::string name_;
+    std::vector<std::pair<std::string, double>> metrics_;
+};
+
+class Report final {
+public:
+    Case& Add(std::string name);
+    void Fail(const std::string& message);
+
+    [[nodiscard]] const std::vector<Case>& Cases() const noexcept;
+    [[nodiscard]] const std::vector<std::string>& Failures() const noexcept;
+
+private:
+    std::vector<Case> cases_;
+    std::vector<std::string> failures_;
+};
+
+using SuiteFn = void (*)(const Options& options, Report& report);
+
+// Suites register themselves from their own translation units via a static SuiteRegistrar.
+struct SuiteRegistrar {
+    SuiteRegistrar(const char* name, SuiteFn run);
+};
+
+using Clock = std::chrono::steady_clock;
+
+[[nodiscard]] double SecondsSince(Clock::time_point start);
+
+} // namespace bench
@@ -0,0 +1,228 @@
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <arpa/inet.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench/Bench.h"
+#include "bench/PtyPair.h"
+#include "core/UniqueFd.h"
+#include "serial/PortBridge.h"
+
+namespace {
+
+constexpr unsigned kPatternPeriod = 251;
+constexpr std::size_t kWriteChunk = 16U * 1024U;
+
+double CpuSeconds() {
+    rusage usage{};
+    ::getrusage(RUSAGE_SELF, &usage);
+    const auto seconds = [](const timeval& tv) { return static_cast<double>(tv.tv_sec) + tv.tv_usec / 1e6; };
+    return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+}
+
+core::UniqueFd Connect(std::uint16_t port) {
+    core::UniqueFd fd(::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (!fd.IsValid() || ::connect(fd.Get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        return {};
+    }
+    const int noDelay = 1;
+    ::setsockopt(fd.Get(), IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    return fd;
+}
+
+// Streams the pattern into fd until stop, waiting at most 10 ms at a time for room.
+std::uint64_t WritePattern(int fd, const std::atomic<bool>& stop) {
+    std::vector<uint8_t> chunk(kWriteChunk);
+    std::uint64_t sent = 0;
+    while (!stop.load(std::memory_order_relaxed)) {
+        pollfd wait{fd, POLLOUT, 0};
+        if (::poll(&wait, 1, 10) <= 0) {
+            continue;
+        }
+        for (std::size_t i = 0; i < chunk.size(); ++i) {
+            chunk[i] = static_cast<uint8_t>((sent + i) % kPatternPeriod);
+        }
+        const ssize_t written = ::write(fd, chunk.data(), chunk.size());
+        if (written <= 0) {
+            break;
+        }
+        sent += static_cast<std::uint64_t>(written);
+    }
+    return sent;
+}
+
+struct PatternReader {
+    std::atomic<std::uint64_t> received{0};
+    std::uint64_t mismatches = 0;
+
+    // Reads until idle for idleMs after stop was set.
+    void Run(int fd, const std::atomic<bool>& stop, int idleMs) {
+        std::vector<uint8_t> buffer(64U * 1024U);
+        unsigned expected = 0;
+        for (;;) {
+            pollfd wait{fd, POLLIN, 0};
+            if (::poll(&wait, 1, stop.load() ? idleMs : 10) <= 0) {
+                if (stop.load()) {
+                    return;
+                }
+                continue;
+            }
+            const ssize_t size = ::read(fd, buffer.data(), buffer.size());
+            if (size <= 0) {
+                return;
+            }
+            for (ssize_t i = 0; i < size; ++i) {
+                if (buffer[static_cast<std::size_t>(i)] != expected) {
+                    ++mismatches;
+                    expected = buffer[static_cast<std::size_t>(i)];
+                }
+                expected = (expected + 1U) % kPatternPeriod;
+            }
+            received.fetch_add(static_cast<std::uint64_t>(size), std::memory_order_relaxed);
+        }
+    }
+};
+
+// Stands in for the UI: drains both tap rings every millisecond.
+struct TapConsumer {
+    std::atomic<bool> stop{false};
+    std::uint64_t bytes = 0;
+
+    void Run(serial::PortBridge& bridge) {
+        for (;;) {
+            const bool last = stop.load();
+            for (const auto direction : {serial::PortBridge::Direction::AToB, serial::PortBridge::Direction::BToA}) {
+                core::SlabRing& ring = bridge.Tap(direction);
+                for (auto slab = ring.Front(); !slab.empty(); slab = ring.Front()) {
+                    bytes += slab.size();
+                    ring.Release();
+                }
+            }
+            if (last) {
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+};
+
+enum class Route { PtyToTcp, TcpToPty, PtyToPty };
+
+void RunCase(const bench::Options& options, bench::Report& report, Route route, bool tap) {
+    static constexpr const char* kRouteNames[] = {"pty_to_tcp", "tcp_to_pty", "pty_to_pty"};
+    const std::string caseName = std::string(kRouteNames[static_cast<int>(route)]) + (tap ? "/tap" : "/no_tap");
+
+    serial::PortSettings settings{};
+    settings.baudRate = 115200;
+    settings.dataBits = 8;
+
+    bench::PtyPair first;
+    bench::PtyPair second;
+    serial::BridgeEndpoint a;
+    a.portName = first.SlaveName();
+    a.settings = settings;
+    serial::BridgeEndpoint b;
+    if (route == Route::PtyToPty) {
+        b.portName = second.SlaveName();
+        b.settings = settings;
+    } else {
+        b.kind = serial::BridgeEndpointKind::TcpListen;
+    }
+
+    serial::PortBridge bridge;
+    std::atomic<std::uint64_t> tapNotifications{0};
+    serial::PortBridge::TapCallback onTap;
+    if (tap) {
+        onTap = [&tapNotifications](serial::PortBridge::Direction) { tapNotifications.fetch_add(1, std::memory_order_relaxed); };
+    }
+    if (!first.IsValid() || !second.IsValid() || !bridge.Start(a, b, onTap)) {
+        report.Fail(caseName + ": cannot start the bridge");
+        return;
+    }
+
+    core::UniqueFd client;
+    if (route != Route::PtyToPty) {
+        client = Connect(bridge.ListeningPort());
+        if (!client.IsValid()) {
+            report.Fail(caseName + ": cannot connect to the bridge");
+            return;
+        }
+    }
+    const int source = (route == Route::TcpToPty) ? client.Get() : first.Master();
+    const int sink = (route == Route::PtyToTcp) ? client.Get() : (route == Route::TcpToPty) ? first.Master() : second.Master();
+
+    TapConsumer consumer;
+    std::thread consumerThread;
+    if (tap) {
+        consumerThread = std::thread([&consumer, &bridge] { consumer.Run(bridge); });
+    }
+
+    std::atomic<bool> stop{false};
+    PatternReader reader;
+    std::thread readerThread([&reader, &stop, sink] { reader.Run(sink, stop, 200); });
+
+    const double cpuBefore = CpuSeconds();
+    const auto start = bench::Clock::now();
+    std::uint64_t sent = 0;
+    std::thread writerThread([&sent, &stop, source] { sent = WritePattern(source, stop); });
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.seconds));
+    stop.store(true);
+    writerThread.join();
+    readerThread.join();
+    const double seconds = bench::SecondsSince(start);
+    const double cpu = CpuSeconds() - cpuBefore;
+
+    const serial::BridgeStats stats = bridge.Stats();
+    bridge.Stop();
+    if (tap) {
+        consumer.stop.store(true);
+        consumerThread.join();
+    }
+
+    const std::uint64_t received = reader.received.load();
+    const double megabytes = static_cast<double>(received) / (1024.0 * 1024.0);
+    bench::Case& result = report.Add(caseName);
+    result.Set("mb_per_sec", megabytes / seconds);
+    result.Set("bytes_forwarded", static_cast<double>(stats.bytesAToB + stats.bytesBToA));
+    result.Set("cpu_ms_per_mb", megabytes > 0.0 ? cpu * 1000.0 / megabytes : 0.0);
+    result.Set("zero_copy", stats.zeroCopy ? 1.0 : 0.0);
+    if (tap) {
+        result.Set("tap_bytes", static_cast<double>(consumer.bytes));
+        result.Set("tap_dropped_bytes", static_cast<double>(stats.tapDroppedBytes));
+        result.Set("tap_notifications", static_cast<double>(tapNotifications.load()));
+    }
+
+    if (received != sent || reader.mismatches != 0) {
+        report.Fail(caseName + ": received " + std::to_string(received) + " of " + std::to_string(sent) + " bytes, " +
+                    std::to_string(reader.mismatches) + " mismatches");
+    }
+    if (tap && consumer.bytes + stats.tapDroppedBytes != stats.bytesAToB + stats.bytesBToA) {
+        report.Fail(caseName + ": tap saw " + std::to_string(consumer.bytes) + " bytes plus " +
+                    std::to_string(stats.tapDroppedBytes) + " dropped");
+    }
+}
+
+void RunBridge(const bench::Options& options, bench::Report& report) {
+    for (const Route route : {Route::PtyToTcp, Route::TcpToPty, Route::PtyToPty}) {
+        RunCase(options, report, route, false);
+        RunCase(options, report, route, true);
+    }
+}
+
+const bench::SuiteRegistrar kBridge("bridge", &RunBridge);
+
+} // namespace
@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench/Bench.h"
+#include "core/BroadcastRing.h"
+
+namespace {
+
+constexpr std::size_t kRingBytes = 1024U * 1024U;
+constexpr std::size_t kPayloadBytes = 256;
+// The producer yields this often so consumers get the single core now and then.
+constexpr std::uint64_t kYieldEvery = 64;
+constexpr std::uint64_t kSlowRecords = 100000;
+constexpr std::uint64_t kSlowPauseEvery = 64;
+
+void FillPayload(std::vector<uint8_t>& payload, std::uint64_t sequence) {
+    std::memcpy(payload.data(), &sequence, sizeof(sequence));
+    for (std::size_t i = sizeof(sequence); i < payload.size(); ++i) {
+        payload[i] = static_cast<uint8_t>(sequence + i);
+    }
+}
+
+struct ConsumerResult {
+    std::uint64_t received = 0;
+    std::uint64_t corrupted = 0; // Wrong pattern, wrong size or out of order.
+    std::uint64_t first = 0;     // Sequence of the first record seen.
+    std::uint64_t last = 0;
+};
+
+// Reads until the producer is done and the consumer has caught up, checking every record.
+void Consume(core::BroadcastRing& ring, int id, const std::atomic<bool>& done, bool slow, ConsumerResult* result) {
+    std::vector<uint8_t> payload;
+    std::uint64_t next = 0;
+    for (;;) {
+        if (ring.Read(id, &payload)) {
+            std::uint64_t sequence = 0;
+            bool ok = payload.size() == kPayloadBytes;
+            if (ok) {
+                std::memcpy(&sequence, payload.data(), sizeof(sequence));
+                ok = sequence >= next;
+                for (std::size_t i = sizeof(sequence); ok && i < payload.size(); ++i) {
+                    ok = payload[i] == static_cast<uint8_t>(sequence + i);
+                }
+            }
+            result->corrupted += ok ? 0U : 1U;
+            if (result->received++ == 0) {
+                result->first = sequence;
+            }
+            result->last = sequence;
+            next = sequence + 1U;
+            if (slow && result->received % kSlowPauseEvery == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            continue;
+        }
+        if (done.load(std::memory_order_acquire) && ring.ConsumerStats(id).lagBytes == 0) {
+            return;
+        }
+        std::this_thread::yield();
+    }
+}
+
+// One producer against N consumers that read as fast as they can, for the configured time.
+void RunFanOut(const bench::Options& options, bench::Report& report, int consumers) {
+    core::BroadcastRing ring(kRingBytes);
+    std::atomic<bool> done{false};
+    std::vector<int> ids;
+    std::vector<ConsumerResult> results(static_cast<std::size_t>(consumers));
+    std::vector<std::thread> threads;
+    for (int i = 0; i < consumers; ++i) {
+        ids.push_back(ring.AddConsumer());
+        threads.emplace_back(Consume, std::ref(ring), ids.back(), std::cref(done), false, &results[static_cast<std::size_t>(i)]);
+    }
+
+    std::vector<uint8_t> payload(kPayloadBytes);
+    std::uint64_t sequence = 0;
+    const auto start = bench::Clock::now();
+    while (bench::SecondsSince(start) < options.seconds / 2.0) {
+        for (std::uint64_t i = 0; i < kYieldEvery; ++i) {
+            FillPayload(payload, sequence++);
+            ring.Publish(payload);
+        }
+        std::this_thread::yield();
+    }
+    const double seconds = bench::SecondsSince(start);
+    done.store(true, std::memory_order_release);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    std::uint64_t received = 0;
+    std::uint64_t corrupted = 0;
+    std::uint64_t skips = 0;
+    for (int i = 0; i < consumers; ++i) {
+        received += results[static_cast<std::size_t>(i)].received;
+        corrupted += results[static_cast<std::size_t>(i)].corrupted;
+        skips += ring.ConsumerStats(ids[static_cast<std::size_t>(i)]).skips;
+    }
+    const std::string name = "fan_out/consumers=" + std::to_string(consumers);
+    bench::Case& result = report.Add(name);
+    result.Set("publish_mb_per_sec", static_cast<double>(sequence * kPayloadBytes) / (1024.0 * 1024.0) / seconds);
+    result.Set("delivered_ratio", static_cast<double>(received) / static_cast<double>(sequence * static_cast<std::uint64_t>(consumers)));
+    result.Set("skips", static_cast<double>(skips));
+    if (corrupted != 0) {
+        report.Fail(name + ": records corrupted or out of order");
+    }
+}
+
+// Two fast consumers, a slow one that gets lapped and skips, and a slow one that spills. The
+// producer must not slow down for either, and the spilling one must see every record.
+void RunSlowConsumers(bench::Report& report) {
+    core::BroadcastRing ring(kRingBytes);
+    std::atomic<bool> done{false};
+    struct Consumer {
+        const char* name;
+        core::LagPolicy policy;
+        bool slow;
+    };
+    const Consumer consumers[] = {
+        {"fast_a", core::LagPolicy::Skip, false},
+        {"fast_b", core::LagPolicy::Skip, false},
+        {"slow_skip", core::LagPolicy::Skip, true},
+        {"slow_spill", core::LagPolicy::Spill, true},
+    };
+    constexpr std::size_t kConsumers = std::size(consumers);
+    int ids[kConsumers] = {};
+    ConsumerResult results[kConsumers];
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < kConsumers; ++i) {
+        ids[i] = ring.AddConsumer(consumers[i].policy);
+        if (ids[i] < 0) {
+            report.Fail(std::string("slow_consumers: cannot add ") + consumers[i].name);
+            return;
+        }
+        threads.emplace_back(Consume, std::ref(ring), ids[i], std::cref(done), consumers[i].slow, &results[i]);
+    }
+
+    std::vector<uint8_t> payload(kPayloadBytes);
+    double maxPublishUs = 0.0;
+    const auto start = bench::Clock::now();
+    for (std::uint64_t sequence = 0; sequence < kSlowRecords; ++sequence) {
+        FillPayload(payload, sequence);
+        const auto before = bench::Clock::now();
+        ring.Publish(payload);
+        maxPublishUs = std::max(maxPublishUs, std::chrono::duration<double, std::micro>(bench::Clock::now() - before).count());
+        if (sequence % kYieldEvery == kYieldEvery - 1U) {
+            std::this_thread::yield();
+        }
+    }
+    const double publishSeconds = bench::SecondsSince(start);
+    done.store(true, std::memory_order_release);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    bench::Case& producer = report.Add("slow_consumers/producer");
+    producer.Set("ns_per_publish", publishSeconds * 1e9 / static_cast<double>(kSlowRecords));
+    producer.Set("max_publish_us", maxPublishUs);
+    for (std::size_t i = 0; i < kConsumers; ++i) {
+        const core::BroadcastConsumerStats stats = ring.ConsumerStats(ids[i]);
+        const std::string name = std::string("slow_consumers/") + consumers[i].name;
+        bench::Case& result = report.Add(name);
+        result.Set("received", static_cast<double>(results[i].received));
+        result.Set("lost_kib", static_cast<double>(stats.lostBytes) / 1024.0);
+        result.Set("skips", static_cast<double>(stats.skips));
+        result.Set("spilled_mib", static_cast<double>(stats.spilledBytes) / (1024.0 * 1024.0));
+        if (results[i].corrupted != 0) {
+            report.Fail(name + ": records corrupted or out of order");
+        }
+    }
+    const ConsumerResult& spill = results[kConsumers - 1U];
+    if (spill.received != kSlowRecords || spill.first != 0 || spill.last != kSlowRecords - 1U) {
+        report.Fail("slow_consumers/slow_spill: records lost");
+    }
+}
+
+void RunBroadcast(const bench::Options& options, bench::Report& report) {
+    for (const int consumers : {1, 2, 4}) {
+        RunFanOut(options, report, consumers);
+    }
+    RunSlowConsumers(report);
+}
+
+const bench::SuiteRegistrar kBroadcast("broadcast", &RunBroadcast);
+
+} // namespace
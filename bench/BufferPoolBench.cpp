@@ -0,0 +1,322 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench/Bench.h"
+#include "core/BufferPool.h"
+
+namespace {
+
+constexpr std::size_t kCapacity = 65536;
+constexpr unsigned kPatternPeriod = 251;
+// Keeps the two-thread cases short on a machine with one core, where every handoff is a yield.
+constexpr std::uint64_t kMaxStreamBytes = 2ULL * 1024ULL * 1024ULL * 1024ULL;
+constexpr std::uint64_t kOverflowRecords = 200000;
+constexpr std::size_t kOverflowPayloadBytes = 64;
+// The overflow consumer pauses this often, so the producer outruns it.
+constexpr std::uint64_t kOverflowPauseEvery = 1024;
+
+// The previous core::BufferPool: a byte at a time, modulo on every step, under a lock (a
+// CRITICAL_SECTION there, std::mutex here). Size() is added so the producer can wait for room
+// instead of overwriting what the consumer has not read.
+class LegacyBufferPool final {
+public:
+    bool Write(const char* buffer, std::uint32_t size) {
+        if (buffer == nullptr || size == 0) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (std::uint32_t i = 0; i < size; ++i) {
+            const std::uint32_t next = (head_ + 1U) % kCapacity;
+            if (next == tail_) {
+                DiscardOldest();
+            }
+            data_[head_] = buffer[i];
+            head_ = next;
+        }
+        return true;
+    }
+
+    bool Read(char* buffer, std::uint32_t size, std::uint32_t* readBytes) {
+        if (buffer == nullptr || size == 0 || readBytes == nullptr) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::uint32_t tail = tail_;
+        const std::uint32_t toRead = std::min(size, SizeLocked());
+        for (std::uint32_t i = 0; i < toRead; ++i) {
+            buffer[i] = data_[tail];
+            tail = (tail + 1U) % kCapacity;
+        }
+        tail_ = tail;
+        *readBytes = toRead;
+        return true;
+    }
+
+    std::uint32_t Size() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return SizeLocked();
+    }
+
+private:
+    void DiscardOldest() {
+        if (tail_ != head_) {
+            tail_ = (tail_ + 1U) % kCapacity;
+        }
+    }
+
+    [[nodiscard]] std::uint32_t SizeLocked() const noexcept {
+        return head_ >= tail_ ? head_ - tail_ : kCapacity - (tail_ - head_);
+    }
+
+    std::mutex mutex_;
+    std::vector<char> data_ = std::vector<char>(kCapacity);
+    std::uint32_t head_ = 0;
+    std::uint32_t tail_ = 0;
+};
+
+// Both pools behind one interface for the benchmark loops; legacy holds one byte less.
+struct LegacyAdapter {
+    LegacyBufferPool pool;
+    static constexpr std::size_t kUsable = kCapacity - 1U;
+
+    std::size_t Free() { return kUsable - pool.Size(); }
+    void Write(const uint8_t* data, std::size_t size) { pool.Write(reinterpret_cast<const char*>(data), static_cast<std::uint32_t>(size)); }
+    std::size_t Read(uint8_t* buffer, std::size_t size) {
+        std::uint32_t read = 0;
+        pool.Read(reinterpret_cast<char*>(buffer), static_cast<std::uint32_t>(size), &read);
+        return read;
+    }
+};
+
+template <typename Pool>
+struct SpscAdapter {
+    Pool pool;
+
+    std::size_t Free() { return pool.Capacity() - pool.Size(); }
+    void Write(const uint8_t* data, std::size_t size) { pool.Write(data, size); }
+    std::size_t Read(uint8_t* buffer, std::size_t size) { return pool.Read(buffer, size); }
+};
+
+// Consumer that looks at the data in place before dropping it, as a parser needing lookahead does.
+struct PeekAdapter : SpscAdapter<core::BufferPool> {
+    std::size_t Read(uint8_t* buffer, std::size_t size) { return pool.Discard(pool.Peek(buffer, size)); }
+};
+
+using DynamicAdapter = SpscAdapter<core::BufferPool>;
+using StaticAdapter = SpscAdapter<core::BasicBufferPool<kCapacity>>;
+
+std::vector<uint8_t> Pattern(std::size_t size) {
+    std::vector<uint8_t> pattern(size + kPatternPeriod);
+    for (std::size_t i = 0; i < pattern.size(); ++i) {
+        pattern[i] = static_cast<uint8_t>(i % kPatternPeriod);
+    }
+    return pattern;
+}
+
+// Checks a read against the pattern stream at offset.
+bool MatchesPattern(const uint8_t* data, std::size_t size, std::uint64_t offset, const std::vector<uint8_t>& pattern) {
+    return std::memcmp(data, pattern.data() + offset % kPatternPeriod, size) == 0;
+}
+
+// Write a chunk, read it back, on one thread: the cost of the copies and the lock alone.
+template <typename Pool>
+void RunSingleThread(const bench::Options& options, bench::Report& report, const std::string& name, std::size_t chunk) {
+    Pool pool;
+    const std::vector<uint8_t> pattern = Pattern(std::max<std::size_t>(chunk, 4096));
+    std::vector<uint8_t> out(chunk);
+    std::uint64_t bytes = 0;
+    std::uint64_t mismatches = 0;
+    const auto start = bench::Clock::now();
+    while (bench::SecondsSince(start) < options.seconds / 2.0) {
+        for (int i = 0; i < 64; ++i) {
+            pool.Write(pattern.data() + bytes % kPatternPeriod, chunk);
+            if (pool.Read(out.data(), chunk) != chunk || !MatchesPattern(out.data(), chunk, bytes, pattern)) {
+                ++mismatches;
+            }
+            bytes += chunk;
+        }
+    }
+    const double seconds = bench::SecondsSince(start);
+
+    bench::Case& result = report.Add("single_thread/" + name + "/chunk=" + std::to_string(chunk));
+    result.Set("mb_per_sec", static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds);
+    result.Set("ns_per_byte", seconds * 1e9 / static_cast<double>(bytes));
+    if (mismatches != 0) {
+        report.Fail("single_thread/" + name + ": data corrupted");
+    }
+}
+
+// A producer thread streams the pattern in chunks, the consumer reads up to 4 KiB at a time and
+// verifies it. Neither side drops: each waits, yielding, for room or data.
+template <typename Pool>
+void RunTwoThreads(const bench::Options& options, bench::Report& report, const std::string& name, std::size_t chunk) {
+    Pool pool;
+    const std::vector<uint8_t> pattern = Pattern(std::max<std::size_t>(chunk, 4096));
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> produced{0};
+
+    std::thread producer([&] {
+        std::uint64_t offset = 0;
+        while (!stop.load(std::memory_order_relaxed) && offset < kMaxStreamBytes) {
+            if (pool.Free() < chunk) {
+                std::this_thread::yield();
+                continue;
+            }
+            pool.Write(pattern.data() + offset % kPatternPeriod, chunk);
+            offset += chunk;
+        }
+        produced.store(offset, std::memory_order_release);
+    });
+
+    std::vector<uint8_t> out(4096);
+    std::uint64_t consumed = 0;
+    std::uint64_t mismatches = 0;
+    const auto start = bench::Clock::now();
+    for (;;) {
+        const std::size_t read = pool.Read(out.data(), out.size());
+        if (read != 0) {
+            mismatches += MatchesPattern(out.data(), read, consumed, pattern) ? 0U : 1U;
+            consumed += read;
+            continue;
+        }
+        if (bench::SecondsSince(start) >= options.seconds) {
+            stop.store(true, std::memory_order_relaxed);
+        }
+        const std::uint64_t total = produced.load(std::memory_order_acquire);
+        if (total != 0 && consumed == total) {
+            break;
+        }
+        std::this_thread::yield();
+    }
+    const double seconds = bench::SecondsSince(start);
+    producer.join();
+
+    bench::Case& result = report.Add("two_threads/" + name + "/chunk=" + std::to_string(chunk));
+    result.Set("mb_per_sec", static_cast<double>(consumed) / (1024.0 * 1024.0) / seconds);
+    if (mismatches != 0) {
+        report.Fail("two_threads/" + name + "/chunk=" + std::to_string(chunk) + ": data corrupted");
+    }
+}
+
+// Length-prefixed timestamped records as the UI read path uses them.
+void RunRecords(const bench::Options& options, bench::Report& report, std::size_t payloadBytes) {
+    core::BufferPool pool(kCapacity);
+    const std::vector<uint8_t> pattern = Pattern(payloadBytes);
+    std::vector<uint8_t> payload;
+    std::uint64_t records = 0;
+    std::uint64_t mismatches = 0;
+    const auto start = bench::Clock::now();
+    while (bench::SecondsSince(start) < options.seconds / 2.0) {
+        for (int i = 0; i < 64; ++i) {
+            const auto stamp = static_cast<std::int64_t>(records);
+            pool.WriteRecord({pattern.data() + records % kPatternPeriod, payloadBytes}, stamp);
+            std::int64_t readStamp = -1;
+            if (!pool.ReadRecord(&payload, &readStamp) || readStamp != stamp || payload.size() != payloadBytes ||
+                !MatchesPattern(payload.data(), payload.size(), records, pattern)) {
+                ++mismatches;
+            }
+            ++records;
+        }
+    }
+    const double seconds = bench::SecondsSince(start);
+
+    bench::Case& result = report.Add("records/payload=" + std::to_string(payloadBytes));
+    result.Set("records_per_sec", static_cast<double>(records) / seconds);
+    result.Set("ns_per_record", seconds * 1e9 / static_cast<double>(records));
+    if (mismatches != 0) {
+        report.Fail("records/payload=" + std::to_string(payloadBytes) + ": records corrupted");
+    }
+}
+
+// The producer writes sequence-numbered records flat out into a 64 KiB pool while the consumer
+// keeps pausing; the policy decides what survives. Order must hold under every policy, and the
+// lossless ones must deliver everything.
+template <typename Pool>
+void RunOverflow(bench::Report& report, const std::string& name, Pool& pool, bool lossless) {
+    std::atomic<bool> done{false};
+    std::thread producer([&] {
+        std::vector<uint8_t> payload(kOverflowPayloadBytes);
+        for (std::uint64_t sequence = 0; sequence < kOverflowRecords; ++sequence) {
+            std::memcpy(payload.data(), &sequence, sizeof(sequence));
+            pool.WriteRecord(payload, static_cast<std::int64_t>(sequence));
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    std::vector<uint8_t> payload;
+    std::uint64_t received = 0;
+    std::uint64_t next = 0;
+    std::uint64_t disorder = 0;
+    const auto start = bench::Clock::now();
+    for (;;) {
+        if (pool.ReadRecord(&payload)) {
+            std::uint64_t sequence = 0;
+            std::memcpy(&sequence, payload.data(), sizeof(sequence));
+            disorder += sequence < next || payload.size() != kOverflowPayloadBytes ? 1U : 0U;
+            next = sequence + 1U;
+            if (++received % kOverflowPauseEvery == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            continue;
+        }
+        if (done.load(std::memory_order_acquire) && pool.Size() == 0) {
+            break;
+        }
+        std::this_thread::yield();
+    }
+    const double seconds = bench::SecondsSince(start);
+    producer.join();
+
+    const core::BufferPoolStats stats = pool.Stats();
+    bench::Case& result = report.Add("overflow/" + name);
+    result.Set("records_per_sec", static_cast<double>(received) / seconds);
+    result.Set("received", static_cast<double>(received));
+    result.Set("dropped_bytes", static_cast<double>(stats.droppedBytes));
+    result.Set("high_water_kib", static_cast<double>(stats.highWaterMark) / 1024.0);
+    result.Set("blocked_writes", static_cast<double>(stats.blockedWrites));
+    result.Set("spilled_mib", static_cast<double>(stats.spilledBytes) / (1024.0 * 1024.0));
+    if (disorder != 0) {
+        report.Fail("overflow/" + name + ": records out of order or corrupted");
+    }
+    if (lossless && received != kOverflowRecords) {
+        report.Fail("overflow/" + name + ": records lost");
+    }
+}
+
+void RunOverflowPolicies(bench::Report& report) {
+    core::BasicBufferPool<kCapacity, core::DropNewest> dropNewest;
+    RunOverflow(report, "drop_newest", dropNewest, false);
+    core::BasicBufferPool<kCapacity, core::DropOldest> dropOldest;
+    RunOverflow(report, "drop_oldest", dropOldest, false);
+    core::BasicBufferPool<kCapacity, core::Block> block(core::Block{std::chrono::seconds(5)});
+    RunOverflow(report, "block", block, true);
+    core::BasicBufferPool<kCapacity, core::SpillToFile> spill;
+    RunOverflow(report, "spill_to_file", spill, true);
+}
+
+void RunBufferPool(const bench::Options& options, bench::Report& report) {
+    for (const std::size_t chunk : {std::size_t{1}, std::size_t{64}, std::size_t{4096}}) {
+        RunSingleThread<LegacyAdapter>(options, report, "legacy", chunk);
+        RunSingleThread<DynamicAdapter>(options, report, "spsc", chunk);
+        RunSingleThread<StaticAdapter>(options, report, "spsc_static", chunk);
+        RunSingleThread<PeekAdapter>(options, report, "spsc_peek", chunk);
+    }
+    for (const std::size_t chunk : {std::size_t{64}, std::size_t{4096}}) {
+        RunTwoThreads<LegacyAdapter>(options, report, "legacy", chunk);
+        RunTwoThreads<DynamicAdapter>(options, report, "spsc", chunk);
+        RunTwoThreads<PeekAdapter>(options, report, "spsc_peek", chunk);
+    }
+    RunRecords(options, report, 16);
+    RunRecords(options, report, 1024);
+    RunOverflowPolicies(report);
+}
+
+const bench::SuiteRegistrar kBufferPool("buffer_pool", &RunBufferPool);
+
+} // namespace
@@ -0,0 +1,284 @@
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench/Bench.h"
+#include "core/Clock.h"
+#include "core/SlabRing.h"
+#include "serial/CaptureFile.h"
+#include "serial/CaptureReplayer.h"
+
+namespace {
+
+// Keeps a run within a sane amount of disk however fast the writer is.
+constexpr std::uint64_t kMaxCaptureBytes = 1024ULL * 1024ULL * 1024ULL;
+constexpr std::size_t kRxSlabCount = 256;
+constexpr std::size_t kRxSlabSize = 4096;
+
+// Temporary file name, the file is removed on destruction.
+class TempPath final {
+public:
+    TempPath() {
+        char name[] = "/tmp/comterminal-capture-XXXXXX";
+        const int fd = ::mkstemp(name);
+        if (fd >= 0) {
+            ::close(fd);
+            path_ = name;
+        }
+    }
+
+    ~TempPath() {
+        if (!path_.empty()) {
+            ::unlink(path_.c_str());
+        }
+    }
+
+    [[nodiscard]] bool IsValid() const noexcept { return !path_.empty(); }
+    [[nodiscard]] const std::string& Narrow() const noexcept { return path_; }
+    [[nodiscard]] std::wstring Path() const { return std::wstring(path_.begin(), path_.end()); }
+
+private:
+    std::string path_;
+};
+
+// Record n carries bytes (n + i) mod 256, every 16th one is TX.
+void FillRecord(std::uint64_t n, std::vector<uint8_t>* payload) {
+    for (std::size_t i = 0; i < payload->size(); ++i) {
+        (*payload)[i] = static_cast<uint8_t>(n + i);
+    }
+}
+
+serial::CaptureKind KindOf(std::uint64_t n) {
+    return n % 16 == 15 ? serial::CaptureKind::Tx : serial::CaptureKind::Rx;
+}
+
+bool MatchesRecord(std::uint64_t n, const serial::CaptureRecord& record, std::size_t size) {
+    if (record.kind != KindOf(n) || record.payload.size() != size) {
+        return false;
+    }
+    for (std::size_t i = 0; i < size; ++i) {
+        if (record.payload[i] != static_cast<uint8_t>(n + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+double Percentile(std::vector<double> values, double fraction) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    const auto index = static_cast<std::size_t>(fraction * static_cast<double>(values.size() - 1U));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+    return values[index];
+}
+
+// Appends records as fast as one thread can for options.seconds, then reads the file back, then
+// replays it as fast as possible into a SlabRing drained by a second thread, as in the UI.
+void RunThroughput(const bench::Options& options, bench::Report& report, std::size_t recordBytes) {
+    const std::string caseName = "record=" + std::to_string(recordBytes);
+    TempPath path;
+    serial::CaptureWriter writer;
+    if (!path.IsValid() || !writer.Open(path.Path())) {
+        report.Fail(caseName + ": cannot create the capture file");
+        return;
+    }
+
+    std::vector<uint8_t> payload(recordBytes);
+    std::uint64_t records = 0;
+    std::int64_t appendNs = 0;
+    const auto start = bench::Clock::now();
+    while (bench::SecondsSince(start) < options.seconds && records * recordBytes < kMaxCaptureBytes) {
+        FillRecord(records, &payload);
+        const std::int64_t before = core::MonotonicNanos();
+        writer.Append(KindOf(records), before, payload);
+        appendNs += core::MonotonicNanos() - before;
+        ++records;
+    }
+    writer.Close();
+    const double writeSeconds = bench::SecondsSince(start);
+    const serial::CaptureWriterStats written = writer.Stats();
+    const double megabytes = static_cast<double>(records * recordBytes) / (1024.0 * 1024.0);
+
+    bench::Case& write = report.Add("write/" + caseName);
+    write.Set("mb_per_sec", megabytes / writeSeconds);
+    write.Set("records_per_sec", static_cast<double>(records) / writeSeconds);
+    write.Set("append_ns", static_cast<double>(appendNs) / static_cast<double>(std::max<std::uint64_t>(records, 1)));
+    write.Set("overhead_bytes_per_record",
+              static_cast<double>(written.fileBytes - written.payloadBytes) / static_cast<double>(std::max<std::uint64_t>(written.records, 1)));
+    write.Set("dropped_records", static_cast<double>(written.droppedRecords));
+    if (written.writeFailed || written.records + written.droppedRecords < records) {
+        report.Fail("write/" + caseName + ": the writer lost records without counting them");
+    }
+
+    // Dropped records leave a Lost record behind and shift the numbering.
+    serial::CaptureReader reader;
+    if (!reader.Open(path.Path())) {
+        report.Fail("read/" + caseName + ": cannot open the capture");
+        return;
+    }
+    const auto readStart = bench::Clock::now();
+    serial::CaptureRecord record;
+    std::uint64_t read = 0;
+    std::uint64_t mismatches = 0;
+    while (reader.Next(&record)) {
+        if (written.droppedRecords == 0 && !MatchesRecord(read, record, recordBytes)) {
+            ++mismatches;
+        }
+        ++read;
+    }
+    const double readSeconds = bench::SecondsSince(readStart);
+    bench::Case& readCase = report.Add("read/" + caseName);
+    readCase.Set("mb_per_sec", static_cast<double>(written.payloadBytes) / (1024.0 * 1024.0) / readSeconds);
+    readCase.Set("records", static_cast<double>(read));
+    if (read != written.records || mismatches != 0 || reader.Truncated()) {
+        report.Fail("read/" + caseName + ": read " + std::to_string(read) + " of " + std::to_string(written.records) +
+                    " records, " + std::to_string(mismatches) + " differ");
+    }
+    reader.Close();
+
+    core::SlabRing ring(kRxSlabCount, kRxSlabSize);
+    std::atomic<bool> done{false};
+    std::uint64_t drained = 0;
+    std::thread consumer([&] {
+        while (!done.load(std::memory_order_acquire) || ring.InFlight() != 0) {
+            bool any = false;
+            for (auto slab = ring.Front(); !slab.empty(); slab = ring.Front()) {
+                drained += slab.size();
+                ring.Release();
+                any = true;
+            }
+            if (!any) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    serial::CaptureReplayer replayer;
+    std::uint64_t published = 0;
+    const bool started = replayer.Start(
+        path.Path(),
+        [&](const serial::CaptureRecord& replayed, std::int64_t replayNs) {
+            if (replayed.kind != serial::CaptureKind::Rx) {
+                return;
+            }
+            // Payloads fit one slab, so a refused Publish() wrote nothing and is simply retried.
+            while (!ring.Publish(replayed.payload.data(), replayed.payload.size(), replayNs)) {
+                std::this_thread::yield();
+            }
+            published += replayed.payload.size();
+        },
+        serial::ReplayOptions{0.0});
+    if (started) {
+        replayer.Wait(std::chrono::minutes(5));
+    }
+    done.store(true, std::memory_order_release);
+    consumer.join();
+
+    const serial::ReplayStats replayed = replayer.Stats();
+    bench::Case& replay = report.Add("replay_fast/" + caseName);
+    replay.Set("mb_per_sec", static_cast<double>(replayed.bytes) / (1024.0 * 1024.0) / (static_cast<double>(replayed.elapsedNs) / 1e9));
+    replay.Set("records_per_sec", static_cast<double>(replayed.records) / (static_cast<double>(replayed.elapsedNs) / 1e9));
+    if (!started || !replayed.ok || replayed.records != written.records || drained != published) {
+        report.Fail("replay_fast/" + caseName + ": replay did not deliver the whole capture");
+    }
+}
+
+// Records with synthetic stamps gapNs apart, played back at speed: the gaps between deliveries
+// are compared with gapNs / speed.
+void RunTimed(bench::Report& report, std::size_t count, std::int64_t gapNs, double speed) {
+    const std::string caseName = "replay_timed/gap=" + std::to_string(gapNs / 1000) + "us,speed=" + std::to_string(static_cast<int>(speed));
+    TempPath path;
+    serial::CaptureWriter writer;
+    if (!path.IsValid() || !writer.Open(path.Path())) {
+        report.Fail(caseName + ": cannot create the capture file");
+        return;
+    }
+    std::vector<uint8_t> payload(16);
+    const std::int64_t origin = core::MonotonicNanos();
+    for (std::size_t i = 0; i < count; ++i) {
+        FillRecord(i, &payload);
+        writer.Append(serial::CaptureKind::Rx, origin + static_cast<std::int64_t>(i) * gapNs, payload);
+    }
+    writer.Close();
+
+    std::vector<std::int64_t> deliveries;
+    deliveries.reserve(count);
+    serial::CaptureReplayer replayer;
+    const bool started = replayer.Start(
+        path.Path(),
+        [&](const serial::CaptureRecord&, std::int64_t replayNs) { deliveries.push_back(replayNs); },
+        serial::ReplayOptions{speed});
+    if (started) {
+        replayer.Wait(std::chrono::minutes(1));
+    }
+
+    const double expectedNs = static_cast<double>(gapNs) / speed;
+    std::vector<double> errorsUs;
+    for (std::size_t i = 1; i < deliveries.size(); ++i) {
+        errorsUs.push_back(std::abs(static_cast<double>(deliveries[i] - deliveries[i - 1]) - expectedNs) / 1000.0);
+    }
+    const serial::ReplayStats stats = replayer.Stats();
+    bench::Case& result = report.Add(caseName);
+    result.Set("records", static_cast<double>(stats.records));
+    result.Set("p50_gap_error_us", Percentile(errorsUs, 0.5));
+    result.Set("p99_gap_error_us", Percentile(errorsUs, 0.99));
+    result.Set("max_late_us", static_cast<double>(stats.maxLateNs) / 1000.0);
+    result.Set("mean_late_us", static_cast<double>(stats.meanLateNs) / 1000.0);
+    if (!started || !stats.ok || deliveries.size() != count) {
+        report.Fail(caseName + ": replay did not deliver every record");
+    }
+    if (Percentile(errorsUs, 0.5) > 250.0) {
+        report.Fail(caseName + ": replay gap error above 250 us at the median");
+    }
+}
+
+// A session cut off mid-record: everything before the cut reads back, the cut is reported.
+void RunTruncated(bench::Report& report) {
+    TempPath path;
+    serial::CaptureWriter writer;
+    if (!path.IsValid() || !writer.Open(path.Path())) {
+        report.Fail("truncated: cannot create the capture file");
+        return;
+    }
+    constexpr std::size_t kRecords = 100;
+    std::vector<uint8_t> payload(100);
+    for (std::size_t i = 0; i < kRecords; ++i) {
+        FillRecord(i, &payload);
+        writer.Append(KindOf(i), core::MonotonicNanos(), payload);
+    }
+    writer.Close();
+    std::error_code ec;
+    std::filesystem::resize_file(path.Narrow(), std::filesystem::file_size(path.Narrow(), ec) - 7, ec);
+
+    serial::CaptureReader reader;
+    std::uint64_t read = 0;
+    serial::CaptureRecord record;
+    bool intact = reader.Open(path.Path());
+    while (intact && reader.Next(&record)) {
+        intact = MatchesRecord(read++, record, payload.size());
+    }
+    report.Add("truncated").Set("records", static_cast<double>(read));
+    if (ec || !intact || read != kRecords - 1 || !reader.Truncated()) {
+        report.Fail("truncated: expected " + std::to_string(kRecords - 1) + " intact records and a reported cut");
+    }
+}
+
+void RunCapture(const bench::Options& options, bench::Report& report) {
+    RunThroughput(options, report, 64);
+    RunThroughput(options, report, 4096);
+    RunTimed(report, 500, 1000000, 1.0);
+    RunTimed(report, 500, 2000000, 4.0);
+    RunTruncated(report);
+}
+
+const bench::SuiteRegistrar kCapture("capture", &RunCapture);
+
+} // namespace
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench/Bench.h"
+#include "core/CrcModel.h"
+#include "serial/ChecksumAnalyzer.h"
+
+namespace {
+
+using serial::ChecksumKind;
+using serial::ChecksumLayout;
+
+// Frames of a made-up device: `layout.begin` sync bytes, covered payload, the checksum field and
+// `layout.trailing` end bytes. Lengths repeat, so some frames share a length. A constant sync
+// byte is indistinguishable from another init, so CRCs with an unusual init cover everything.
+struct Scenario {
+    const char* name;
+    ChecksumLayout layout;
+    ChecksumKind kind;
+    core::CrcModel model; // For ChecksumKind::Crc.
+    std::size_t frames;
+    std::size_t payloadBytes;
+};
+
+std::uint32_t Checksum(const Scenario& scenario, const uint8_t* data, std::size_t size) {
+    if (scenario.kind == ChecksumKind::Crc) {
+        return core::RuntimeCrc(scenario.model).Compute(data, size);
+    }
+    std::uint32_t sum = 0;
+    std::uint32_t parity = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        sum += data[i];
+        parity ^= data[i];
+    }
+    switch (scenario.kind) {
+    case ChecksumKind::Sum8:
+        return sum & 0xFFU;
+    case ChecksumKind::Lrc8:
+        return (0U - sum) & 0xFFU;
+    case ChecksumKind::InvertedSum8:
+        return ~sum & 0xFFU;
+    case ChecksumKind::Xor8:
+        return parity;
+    case ChecksumKind::Sum16:
+        return sum & 0xFFFFU;
+    case ChecksumKind::Crc:
+        break;
+    }
+    return 0;
+}
+
+std::vector<std::vector<uint8_t>> MakeFrames(const Scenario& scenario, std::mt19937& random) {
+    const ChecksumLayout& layout = scenario.layout;
+    const std::size_t extra[] = {0, 5, 11, 0, 5, 2};
+    std::vector<std::vector<uint8_t>> frames;
+    for (std::size_t i = 0; i < scenario.frames; ++i) {
+        std::vector<uint8_t> frame(layout.begin, 0x7EU);
+        const std::size_t payload = scenario.payloadBytes + extra[i % std::size(extra)];
+        for (std::size_t j = 0; j < payload; ++j) {
+            frame.push_back(static_cast<uint8_t>(random()));
+        }
+        const std::uint32_t value = Checksum(scenario, frame.data() + layout.begin, payload);
+        for (std::size_t j = 0; j < layout.fieldBytes; ++j) {
+            const std::size_t shift = layout.bigEndian ? layout.fieldBytes - 1U - j : j;
+            frame.push_back(static_cast<uint8_t>(value >> (shift * 8U)));
+        }
+        frame.insert(frame.end(), layout.trailing, 0x0DU);
+        frames.push_back(std::move(frame));
+    }
+    return frames;
+}
+
+bool Expected(const Scenario& scenario, const serial::ChecksumMatch& match) {
+    const ChecksumLayout& a = scenario.layout;
+    const ChecksumLayout& b = match.layout;
+    const bool sameLayout = a.begin == b.begin && a.trailing == b.trailing && a.fieldBytes == b.fieldBytes && a.bigEndian == b.bigEndian;
+    const core::CrcModel& x = scenario.model;
+    const core::CrcModel& y = match.model;
+    const bool sameModel = x.width == y.width && x.poly == y.poly && x.init == y.init && x.reflectIn == y.reflectIn &&
+                           x.reflectOut == y.reflectOut && x.xorOut == y.xorOut;
+    return sameLayout && scenario.kind == match.kind && (scenario.kind != ChecksumKind::Crc || sameModel);
+}
+
+void RunChecksumAnalyzer(const bench::Options&, bench::Report& report) {
+    // Not in the catalogue: found only by the polynomial search.
+    constexpr core::CrcModel kCrc16T10Dif{16, 0x8BB7U, 0x1D0FU, false, false, 0x0000U, 0};
+    constexpr core::CrcModel kCrc8Darc{8, 0x39U, 0x00U, true, true, 0x00U, 0};
+    constexpr core::CrcModel kCrc32Koopman{32, 0x741B8CD7U, 0xFFFFFFFFU, true, true, 0xFFFFFFFFU, 0};
+    constexpr core::CrcModel kCrc16Odd{16, 0x3D65U, 0x1234U, true, true, 0x00FFU, 0};
+
+    const Scenario scenarios[] = {
+        {"modbus_rtu", {0, 0, 2, false}, ChecksumKind::Crc, core::kCrc16Modbus, 16, 6},
+        {"hdlc_ccitt_false", {1, 1, 2, true}, ChecksumKind::Crc, core::kCrc16Ibm3740, 16, 10},
+        {"crc32c_le", {2, 0, 4, false}, ChecksumKind::Crc, core::kCrc32Iscsi, 16, 20},
+        {"custom_crc16_normal", {0, 0, 2, true}, ChecksumKind::Crc, kCrc16T10Dif, 16, 12},
+        {"custom_crc16_reflected", {0, 2, 2, false}, ChecksumKind::Crc, kCrc16Odd, 16, 12},
+        {"custom_crc8", {1, 0, 1, false}, ChecksumKind::Crc, kCrc8Darc, 24, 8},
+        {"custom_crc32", {1, 1, 4, false}, ChecksumKind::Crc, kCrc32Koopman, 16, 24},
+        {"xor8", {1, 2, 1, false}, ChecksumKind::Xor8, {}, 24, 10},
+        {"lrc8", {0, 0, 1, false}, ChecksumKind::Lrc8, {}, 24, 10},
+        {"sum16_be", {0, 1, 2, true}, ChecksumKind::Sum16, {}, 16, 10},
+        {"large_custom_crc32", {1, 0, 4, false}, ChecksumKind::Crc, kCrc32Koopman, 64, 256},
+    };
+
+    std::mt19937 random(7);
+    for (const Scenario& scenario : scenarios) {
+        const std::vector<std::vector<uint8_t>> frames = MakeFrames(scenario, random);
+
+        serial::ChecksumAnalyzerOptions options;
+        options.threads = 1;
+        const auto start = bench::Clock::now();
+        const auto single = serial::ChecksumAnalyzer::Analyze(frames, options);
+        const double oneThread = bench::SecondsSince(start);
+        options.threads = 0;
+        const auto parallelStart = bench::Clock::now();
+        const auto matches = serial::ChecksumAnalyzer::Analyze(frames, options);
+        const double allThreads = bench::SecondsSince(parallelStart);
+
+        const std::string caseName = std::string("analyze/") + scenario.name;
+        bench::Case& result = report.Add(caseName);
+        result.Set("frames", static_cast<double>(frames.size()));
+        result.Set("matches", static_cast<double>(matches.size()));
+        result.Set("analyze_ms_1_thread", oneThread * 1000.0);
+        result.Set("analyze_ms_all_threads", allThreads * 1000.0);
+        result.Set("threads", static_cast<double>(std::max(1U, std::thread::hardware_concurrency())));
+        if (matches.empty() || !Expected(scenario, matches.front()) || single.size() != matches.size()) {
+            report.Fail(caseName + ": found " +
+                        (matches.empty() ? std::string("nothing") : serial::ChecksumAnalyzer::Describe(matches.front())));
+        }
+    }
+}
+
+const bench::SuiteRegistrar kChecksumAnalyzer("checksum_analyzer", &RunChecksumAnalyzer);
+
+} // namespace
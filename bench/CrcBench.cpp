@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench/Bench.h"
+#include "core/Crc.h"
+#include "core/CrcModel.h"
+
+namespace {
+
+struct Algorithm {
+    const char* name;
+    core::CrcAlgorithm algorithm;
+    std::uint32_t (*bitwise)(const uint8_t*, std::size_t);
+    std::uint32_t check; // CRC of "123456789".
+};
+
+template <typename T, T (*Fn)(const uint8_t*, std::size_t) noexcept>
+std::uint32_t Widen(const uint8_t* data, std::size_t size) {
+    return Fn(data, size);
+}
+
+// Keeps the computed CRCs alive so the loops are not optimized away.
+volatile std::uint32_t crcSink = 0;
+
+const Algorithm kAlgorithms[] = {
+    {"crc8_dallas", core::CrcAlgorithm::Crc8Dallas, &Widen<uint8_t, core::Crc8DallasBitwise>, 0xA1U},
+    {"crc16_ibm", core::CrcAlgorithm::Crc16Ibm, &Widen<uint16_t, core::Crc16IbmBitwise>, 0xBB3DU},
+    {"crc32_iso_hdlc", core::CrcAlgorithm::Crc32IsoHdlc, &Widen<uint32_t, core::Crc32IsoHdlcBitwise>, 0xCBF43926U},
+    {"crc32c", core::CrcAlgorithm::Crc32c, &Widen<uint32_t, core::Crc32cBitwise>, 0xE3069283U},
+};
+
+struct Method {
+    const char* name;
+    core::CrcMethod method;
+};
+
+const Method kMethods[] = {
+    {"table", core::CrcMethod::Table},
+    {"slice_by_8", core::CrcMethod::SliceBy8},
+    {"clmul", core::CrcMethod::Clmul},
+    {"instruction", core::CrcMethod::Instruction},
+    {"best", core::CrcMethod::Best},
+};
+
+std::uint32_t Compute(const Algorithm& algorithm, const Method* method, const uint8_t* data, std::size_t size) {
+    if (method == nullptr) {
+        return algorithm.bitwise(data, size);
+    }
+    core::CrcState state(algorithm.algorithm, method->method);
+    state.Update(data, size);
+    return state.Finalize();
+}
+
+// Check values, the same stream fed in random chunks, and random slices at random alignments,
+// all against the bitwise reference.
+void CheckMethod(bench::Report& report, const Algorithm& algorithm, const Method& method, const std::vector<uint8_t>& data) {
+    const std::string name = std::string(algorithm.name) + "/" + method.name;
+    const uint8_t digits[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    if (Compute(algorithm, &method, digits, sizeof(digits)) != algorithm.check) {
+        report.Fail(name + ": wrong check value");
+    }
+
+    std::mt19937 random(12345);
+    const std::size_t size = std::min<std::size_t>(data.size(), 1U << 16U);
+    core::CrcState state(algorithm.algorithm, method.method);
+    for (std::size_t offset = 0; offset < size;) {
+        const std::size_t chunk = std::min<std::size_t>(size - offset, random() % 300U);
+        state.Update(data.data() + offset, chunk);
+        offset += chunk;
+    }
+    if (state.Finalize() != algorithm.bitwise(data.data(), size)) {
+        report.Fail(name + ": chunked stream does not match the bitwise CRC");
+    }
+
+    for (int i = 0; i < 500; ++i) {
+        const std::size_t length = random() % 2048U;
+        const std::size_t offset = random() % (data.size() - length);
+        if (Compute(algorithm, &method, data.data() + offset, length) != algorithm.bitwise(data.data() + offset, length)) {
+            report.Fail(name + ": " + std::to_string(length) + " bytes at offset " + std::to_string(offset) +
+                        " do not match the bitwise CRC");
+            break;
+        }
+    }
+}
+
+// Every catalogue entry reproduces its check value at run time too, and non-reflected models
+// (normal register) run through the same slice-by-8.
+void RunCatalogue(bench::Report& report, const std::vector<uint8_t>& data, double perCase) {
+    const uint8_t digits[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    for (const core::CrcCatalogueEntry& entry : core::CrcCatalogue()) {
+        if (entry.Compute(digits, sizeof(digits)) != entry.model.check) {
+            report.Fail(std::string(entry.name) + ": wrong check value");
+        }
+        if (core::FindCrc(entry.name) != &entry) {
+            report.Fail(std::string(entry.name) + ": not found by name");
+        }
+
+        const std::size_t size = 4096;
+        std::uint64_t bytes = 0;
+        const auto start = bench::Clock::now();
+        do {
+            crcSink = entry.Compute(data.data(), size);
+            bytes += size;
+        } while (bench::SecondsSince(start) < perCase);
+        const double seconds = bench::SecondsSince(start);
+
+        bench::Case& result = report.Add("catalogue/" + std::string(entry.name) + "/size=" + std::to_string(size));
+        result.Set("gb_per_sec", static_cast<double>(bytes) / 1e9 / seconds);
+    }
+    if (core::FindCrc("crc-16/ccitt-false") != core::FindCrc("CRC-16/IBM-3740") || core::FindCrc("CRC-99/NONE") != nullptr) {
+        report.Fail("catalogue: alias lookup");
+    }
+}
+
+void RunCrc(const bench::Options& options, bench::Report& report) {
+    std::vector<uint8_t> data(1U << 20U);
+    std::mt19937 random(42);
+    for (uint8_t& byte : data) {
+        byte = static_cast<uint8_t>(random());
+    }
+
+    const double perCase = std::min(0.25, options.seconds / 10.0);
+    for (const Algorithm& algorithm : kAlgorithms) {
+        if (Compute(algorithm, nullptr, reinterpret_cast<const uint8_t*>("123456789"), 9U) != algorithm.check) {
+            report.Fail(std::string(algorithm.name) + "/bitwise: wrong check value");
+        }
+        std::vector<const Method*> methods = {nullptr};
+        for (const Method& method : kMethods) {
+            // Unsupported methods fall back to slice-by-8: nothing new to check or measure.
+            if (!core::CrcMethodSupported(algorithm.algorithm, method.method)) {
+                continue;
+            }
+            CheckMethod(report, algorithm, method, data);
+            methods.push_back(&method);
+        }
+
+        for (const Method* method : methods) {
+            for (const std::size_t size : {std::size_t{64}, std::size_t{4096}, data.size()}) {
+                std::uint64_t bytes = 0;
+                const auto start = bench::Clock::now();
+                do {
+                    crcSink = Compute(algorithm, method, data.data(), size);
+                    bytes += size;
+                } while (bench::SecondsSince(start) < perCase);
+                const double seconds = bench::SecondsSince(start);
+
+                const char* methodName = method != nullptr ? method->name : "bitwise";
+                bench::Case& result = report.Add(std::string(algorithm.name) + "/" + methodName + "/size=" + std::to_string(size));
+                result.Set("gb_per_sec", static_cast<double>(bytes) / 1e9 / seconds);
+            }
+        }
+    }
+    RunCatalogue(report, data, perCase / 2.0);
+}
+
+const bench::SuiteRegistrar kCrc("crc", &RunCrc);
+
+} // namespace
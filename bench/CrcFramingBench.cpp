@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench/Bench.h"
+#include "core/CrcModel.h"
+#include "serial/CrcFraming.h"
+
+namespace {
+
+struct Read {
+    std::size_t offset;
+    std::size_t size;
+    std::int64_t timestampNs;
+};
+
+// Received stream: frames with their CRC appended, every 16th one with a flipped
+// payload bit, each split into reads of 1..maxRead bytes a few microseconds apart and separated
+// from the next frame by a 5 ms gap.
+struct Stream {
+    std::vector<uint8_t> bytes;
+    std::vector<Read> reads;
+    std::uint64_t frames = 0;
+    std::uint64_t corrupted = 0;
+};
+
+constexpr std::int64_t kReadSpacingNs = 20000;
+constexpr std::int64_t kFrameGapNs = 5000000;
+
+Stream MakeStream(const serial::CrcFraming& sender, std::size_t frameBytes, std::size_t streamBytes, std::mt19937& random) {
+    constexpr std::size_t kCorruptEvery = 16;
+    Stream stream;
+    std::int64_t now = 0;
+    std::vector<uint8_t> frame;
+    while (stream.bytes.size() < streamBytes) {
+        frame.resize(frameBytes);
+        std::generate(frame.begin(), frame.end(), [&] { return static_cast<uint8_t>(random()); });
+        sender.Append(&frame);
+        if (stream.frames % kCorruptEvery == kCorruptEvery - 1U) {
+            frame[random() % frameBytes] ^= static_cast<uint8_t>(1U << (random() % 8U));
+            ++stream.corrupted;
+        }
+        ++stream.frames;
+
+        const std::size_t maxRead = std::max<std::size_t>(frame.size() / 3U, 1U);
+        for (std::size_t offset = 0; offset < frame.size();) {
+            const std::size_t size = std::min<std::size_t>(1U + random() % maxRead, frame.size() - offset);
+            stream.reads.push_back(Read{stream.bytes.size() + offset, size, now});
+            offset += size;
+            now += kReadSpacingNs;
+        }
+        stream.bytes.insert(stream.bytes.end(), frame.begin(), frame.end());
+        now += kFrameGapNs;
+    }
+    return stream;
+}
+
+void Feed(serial::CrcFraming& framing, const Stream& stream, std::int64_t baseNs) {
+    for (const Read& read : stream.reads) {
+        framing.Feed(std::span<const uint8_t>(stream.bytes).subspan(read.offset, read.size), baseNs + read.timestampNs);
+    }
+}
+
+struct Model {
+    const char* name;
+    core::CrcModel model;
+    bool bigEndian;
+};
+
+void RunCrcFraming(const bench::Options& options, bench::Report& report) {
+    const Model models[] = {
+        {"crc16_modbus", core::kCrc16Modbus, false},
+        {"crc16_ccitt_false", core::kCrc16Ibm3740, true},
+        {"crc32", core::kCrc32IsoHdlc, false},
+    };
+    const std::size_t frameSizes[] = {8, 256, 4096};
+    constexpr std::size_t kStreamBytes = 4U << 20U;
+    const double secondsPerCase = options.seconds / static_cast<double>(std::size(models) * std::size(frameSizes));
+
+    volatile std::uint32_t sink = 0;
+    std::mt19937 random(11);
+    for (const Model& model : models) {
+        serial::CrcFramingSettings settings;
+        settings.model = model.model;
+        settings.bigEndian = model.bigEndian;
+        serial::CrcFraming sender;
+        sender.Configure(settings);
+
+        for (const std::size_t frameBytes : frameSizes) {
+            const Stream stream = MakeStream(sender, frameBytes, kStreamBytes, random);
+            const std::string caseName = std::string(model.name) + "/frame=" + std::to_string(frameBytes);
+            serial::CrcFraming framing;
+            framing.Configure(settings);
+
+            // Every pass shifts the clock past the last read by a gap, so the last frame of a pass
+            // ends when the next one starts.
+            std::uint64_t passes = 0;
+            std::int64_t baseNs = 0;
+            const auto start = bench::Clock::now();
+            do {
+                Feed(framing, stream, baseNs);
+                baseNs += stream.reads.back().timestampNs + kFrameGapNs;
+                ++passes;
+            } while (bench::SecondsSince(start) < secondsPerCase);
+            const double elapsed = bench::SecondsSince(start);
+
+            // The last frame waits for the line to stay quiet for the gap.
+            const std::uint64_t pending = framing.Stats().frames;
+            framing.Expire(baseNs - kFrameGapNs + settings.gapNs / 2);
+            const bool endedEarly = framing.Stats().frames != pending;
+            framing.Expire(baseNs);
+
+            // The same bytes through the bare CRC as one buffer: the floor for the stage.
+            const core::RuntimeCrc crc(model.model);
+            const auto crcStart = bench::Clock::now();
+            for (std::uint64_t i = 0; i < passes; ++i) {
+                sink = sink ^ crc.Compute(stream.bytes.data(), stream.bytes.size());
+            }
+            const double crcElapsed = bench::SecondsSince(crcStart);
+
+            const double bytes = static_cast<double>(stream.bytes.size()) * static_cast<double>(passes);
+            const serial::CrcFramingStats stats = framing.Stats();
+            bench::Case& result = report.Add(caseName);
+            result.Set("frames", static_cast<double>(stats.frames));
+            result.Set("reads_per_frame", static_cast<double>(stream.reads.size()) / static_cast<double>(stream.frames));
+            result.Set("gb_per_sec", bytes / elapsed / 1e9);
+            result.Set("crc_only_gb_per_sec", bytes / crcElapsed / 1e9);
+            result.Set("ns_per_frame", elapsed * 1e9 / static_cast<double>(stats.frames));
+
+            const std::uint64_t failed = stream.corrupted * passes;
+            if (stats.frames != stream.frames * passes || stats.failed != failed || stats.passed != stats.frames - failed ||
+                stats.bytes != static_cast<std::uint64_t>(bytes) || endedEarly) {
+                report.Fail(caseName + ": " + std::to_string(stats.passed) + " passed, " + std::to_string(stats.failed) +
+                            " failed of " + std::to_string(stats.frames) + " frames, expected " + std::to_string(failed) +
+                            " failed of " + std::to_string(stream.frames * passes) + (endedEarly ? ", ended before the gap" : ""));
+            }
+
+            // The log holds the latest checks in stream order, each starting where the previous ended.
+            std::vector<serial::CrcFrameCheck> checks(64);
+            std::uint64_t cursor = framing.NextSequence() - checks.size();
+            checks.resize(framing.Read(&cursor, checks));
+            for (std::size_t i = 1; i < checks.size(); ++i) {
+                if (checks[i].offset != checks[i - 1U].offset + checks[i - 1U].length) {
+                    report.Fail(caseName + ": frame log is not contiguous");
+                    break;
+                }
+            }
+        }
+    }
+}
+
+const bench::SuiteRegistrar kCrcFraming("crc_framing", &RunCrcFraming);
+
+} // namespace
@@ -0,0 +1,259 @@
+#include <poll.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench/Bench.h"
+#include "bench/PtyPair.h"
+#include "serial/FileSender.h"
+
+namespace {
+
+constexpr unsigned kPatternPeriod = 251;
+constexpr uint8_t kXon = 0x11;
+constexpr uint8_t kXoff = 0x13;
+constexpr auto kHold = std::chrono::milliseconds(1500);
+
+// Temporary file holding the byte pattern, removed on destruction.
+class PatternFile final {
+public:
+    explicit PatternFile(std::uint64_t size) {
+        char name[] = "/tmp/comterminal-filesend-XXXXXX";
+        const int fd = ::mkstemp(name);
+        if (fd < 0) {
+            return;
+        }
+        path_ = name;
+
+        std::vector<uint8_t> block(static_cast<std::size_t>(kPatternPeriod) * 1024U);
+        for (std::size_t i = 0; i < block.size(); ++i) {
+            block[i] = static_cast<uint8_t>(i % kPatternPeriod);
+        }
+        for (std::uint64_t written = 0; written < size;) {
+            const auto chunk = static_cast<std::size_t>(std::min<std::uint64_t>(block.size(), size - written));
+            if (::write(fd, block.data(), chunk) != static_cast<ssize_t>(chunk)) {
+                path_.clear();
+                break;
+            }
+            written += chunk;
+        }
+        ::close(fd);
+    }
+
+    ~PatternFile() {
+        if (!path_.empty()) {
+            ::unlink(path_.c_str());
+        }
+    }
+
+    [[nodiscard]] bool IsValid() const noexcept { return !path_.empty(); }
+    [[nodiscard]] std::wstring Path() const { return std::wstring(path_.begin(), path_.end()); }
+
+private:
+    std::string path_;
+};
+
+// Drains the pty master and checks the pattern, standing in for the receiving device.
+struct MasterReader {
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> received{0};
+    std::uint64_t mismatches = 0;
+
+    void Run(int fd) {
+        std::vector<uint8_t> buffer(65536);
+        unsigned expected = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            pollfd wait{fd, POLLIN, 0};
+            if (::poll(&wait, 1, 10) <= 0) {
+                continue;
+            }
+            const ssize_t size = ::read(fd, buffer.data(), buffer.size());
+            if (size <= 0) {
+                break;
+            }
+            for (ssize_t i = 0; i < size; ++i) {
+                if (buffer[static_cast<std::size_t>(i)] != expected) {
+                    ++mismatches;
+                    expected = buffer[static_cast<std::size_t>(i)];
+                }
+                expected = (expected + 1U) % kPatternPeriod;
+            }
+            received.fetch_add(static_cast<std::uint64_t>(size), std::memory_order_release);
+        }
+    }
+};
+
+long MaxRssKiB() {
+    rusage usage{};
+    ::getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// Streams a file and, with holdWithXoff, stops the port with XOFF for kHold part way through.
+void RunCase(bench::Report& report, const std::string& caseName, std::uint64_t fileSize, bool holdWithXoff) {
+    PatternFile file(fileSize);
+    bench::PtyPair pty;
+    if (!file.IsValid() || !pty.IsValid()) {
+        report.Fail(caseName + ": cannot create the file or the pseudo-terminal");
+        return;
+    }
+
+    serial::SerialPort port;
+    serial::PortSettings settings{};
+    settings.baudRate = 3000000;
+    settings.dataBits = 8;
+    settings.flowControl = holdWithXoff ? serial::FlowControlMode::Software : serial::FlowControlMode::None;
+    if (!port.Open(pty.SlaveName(), settings)) {
+        report.Fail(caseName + ": cannot open the port");
+        return;
+    }
+
+    MasterReader reader;
+    std::thread readerThread([&reader, &pty] { reader.Run(pty.Master()); });
+
+    std::atomic<std::uint64_t> progressCalls{0};
+    serial::FileSender sender(port);
+    const long rssBefore = MaxRssKiB();
+    if (!sender.Start(file.Path(), [&progressCalls](const serial::FileSendProgress&) { ++progressCalls; })) {
+        report.Fail(caseName + ": cannot start the sender");
+        reader.stop = true;
+        readerThread.join();
+        return;
+    }
+
+    std::uint64_t heldBytes = 0;
+    bool stallReported = false;
+    if (holdWithXoff) {
+        while (reader.received.load(std::memory_order_acquire) < fileSize / 4U && sender.IsRunning()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        [[maybe_unused]] const ssize_t stopped = ::write(pty.Master(), &kXoff, 1);
+        // Whatever was already past the line discipline still drains, then the line goes quiet.
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        const std::uint64_t atHold = reader.received.load(std::memory_order_acquire);
+        std::this_thread::sleep_for(kHold);
+        heldBytes = reader.received.load(std::memory_order_acquire) - atHold;
+        stallReported = sender.Progress().stalled;
+        [[maybe_unused]] const ssize_t resumed = ::write(pty.Master(), &kXon, 1);
+    }
+
+    const bool finished = sender.Wait(std::chrono::seconds(120));
+    const serial::FileSendProgress progress = sender.Progress();
+    const long rssAfter = MaxRssKiB();
+
+    const auto drainDeadline = bench::Clock::now() + std::chrono::seconds(2);
+    while (reader.received.load(std::memory_order_acquire) < fileSize && bench::Clock::now() < drainDeadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    reader.stop = true;
+    readerThread.join();
+    port.Close();
+
+    const std::uint64_t received = reader.received.load(std::memory_order_acquire);
+    bench::Case& result = report.Add(caseName);
+    result.Set("file_mb", static_cast<double>(fileSize) / (1024.0 * 1024.0));
+    result.Set("bytes_per_sec", progress.bytesPerSecond);
+    result.Set("bytes_received", static_cast<double>(received));
+    result.Set("mismatches", static_cast<double>(reader.mismatches));
+    result.Set("max_rss_growth_mb", static_cast<double>(rssAfter - rssBefore) / 1024.0);
+    result.Set("progress_callbacks", static_cast<double>(progressCalls.load()));
+    result.Set("stalls", static_cast<double>(progress.stalls));
+    if (holdWithXoff) {
+        result.Set("bytes_during_hold", static_cast<double>(heldBytes));
+    }
+
+    if (!finished || !progress.ok || progress.sentBytes != fileSize) {
+        report.Fail(caseName + ": transfer did not complete");
+    }
+    if (received != fileSize || reader.mismatches != 0) {
+        report.Fail(caseName + ": received data differs from the file");
+    }
+    // The sender holds one 4 MiB view and an 8-chunk window whatever the file size.
+    if (rssAfter - rssBefore > 32L * 1024L) {
+        report.Fail(caseName + ": memory grew with the file size");
+    }
+    if (holdWithXoff && (heldBytes != 0 || !stallReported || progress.stalls == 0)) {
+        report.Fail(caseName + ": XOFF did not hold the transfer or the stall went unreported");
+    }
+}
+
+// Cancels while XOFF holds the line: the transfer must end at once with the line still held,
+// and the port must carry new writes once the peer sends XON.
+void RunCancelCase(bench::Report& report, const std::string& caseName, std::uint64_t fileSize) {
+    PatternFile file(fileSize);
+    bench::PtyPair pty;
+    if (!file.IsValid() || !pty.IsValid()) {
+        report.Fail(caseName + ": cannot create the file or the pseudo-terminal");
+        return;
+    }
+
+    serial::SerialPort port;
+    serial::PortSettings settings{};
+    settings.baudRate = 3000000;
+    settings.dataBits = 8;
+    settings.flowControl = serial::FlowControlMode::Software;
+    if (!port.Open(pty.SlaveName(), settings)) {
+        report.Fail(caseName + ": cannot open the port");
+        return;
+    }
+
+    MasterReader reader;
+    std::thread readerThread([&reader, &pty] { reader.Run(pty.Master()); });
+
+    serial::FileSender sender(port);
+    bool finished = false;
+    double cancelMs = 0.0;
+    double endMs = 0.0;
+    serial::FileSendProgress progress;
+    if (sender.Start(file.Path())) {
+        while (reader.received.load(std::memory_order_acquire) < fileSize / 4U && sender.IsRunning()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        [[maybe_unused]] const ssize_t stopped = ::write(pty.Master(), &kXoff, 1);
+        while (!sender.Progress().stalled && sender.IsRunning()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        const auto start = bench::Clock::now();
+        sender.Cancel();
+        cancelMs = bench::SecondsSince(start) * 1e3;
+        finished = sender.Wait(std::chrono::seconds(2));
+        endMs = bench::SecondsSince(start) * 1e3;
+        progress = sender.Progress();
+    }
+
+    // The purged bytes never reach the peer; a write queued after the purge does.
+    [[maybe_unused]] const ssize_t resumed = ::write(pty.Master(), &kXon, 1);
+    DWORD written = 0;
+    const uint8_t probe = 0;
+    const bool probeOk = port.Write(&probe, 1, &written) && written == 1;
+    reader.stop = true;
+    readerThread.join();
+    port.Close();
+
+    bench::Case& result = report.Add(caseName);
+    result.Set("cancel_call_ms", cancelMs);
+    result.Set("cancel_to_end_ms", endMs);
+    result.Set("sent_bytes", static_cast<double>(progress.sentBytes));
+    if (!finished || progress.ok || progress.sentBytes >= fileSize) {
+        report.Fail(caseName + ": cancel did not end the held transfer");
+    }
+    if (!probeOk) {
+        report.Fail(caseName + ": port did not write after the purge");
+    }
+}
+
+void RunFileSend(const bench::Options&, bench::Report& report) {
+    RunCase(report, "stream/64MiB", 64ULL * 1024U * 1024U, false);
+    RunCase(report, "xoff_hold/4MiB", 4ULL * 1024U * 1024U, true);
+    RunCancelCase(report, "xoff_cancel/4MiB", 4ULL * 1024U * 1024U);
+}
+
+const bench::SuiteRegistrar kFileSend("file_send", &RunFileSend);
+
+} // namespace
@@ -0,0 +1,73 @@
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench/Bench.h"
+#include "core/Hex.h"
+
+namespace {
+
+volatile std::size_t hexSink = 0;
+
+// Runs fn until the case's share of the time is spent; returns the elapsed seconds and the
+// number of calls in *calls.
+template <typename Fn>
+double Repeat(double seconds, std::uint64_t* calls, Fn&& fn) {
+    std::uint64_t count = 0;
+    const auto start = bench::Clock::now();
+    do {
+        for (int i = 0; i < 16; ++i) {
+            fn();
+        }
+        count += 16;
+    } while (bench::SecondsSince(start) < seconds);
+    *calls = count;
+    return bench::SecondsSince(start);
+}
+
+void SetRates(bench::Case& result, std::size_t bytes, std::uint64_t calls, double seconds) {
+    const double total = static_cast<double>(bytes) * static_cast<double>(calls);
+    result.Set("mb_per_sec", total / (1024.0 * 1024.0) / seconds);
+    result.Set("ns_per_byte", seconds * 1e9 / total);
+}
+
+// Formatting into a fresh string as the log does, appending into a reused one as the capture
+// export does, and parsing the formatted text back as the send box does. Rates are per input
+// byte, so the three are comparable.
+void RunHex(const bench::Options& options, bench::Report& report) {
+    const std::size_t sizes[] = {16, 4096, 1U << 20U};
+    const double secondsPerCase = options.seconds / static_cast<double>(std::size(sizes) * 3U);
+
+    std::mt19937 random(5);
+    for (const std::size_t size : sizes) {
+        std::vector<uint8_t> bytes(size);
+        for (uint8_t& byte : bytes) {
+            byte = static_cast<uint8_t>(random());
+        }
+        const std::string suffix = "/bytes=" + std::to_string(size);
+
+        std::uint64_t calls = 0;
+        double seconds = Repeat(secondsPerCase, &calls, [&] { hexSink = hexSink + core::BytesToHex(bytes).size(); });
+        SetRates(report.Add("bytes_to_hex" + suffix), size, calls, seconds);
+
+        std::wstring text;
+        seconds = Repeat(secondsPerCase, &calls, [&] {
+            text.clear();
+            core::AppendHex(bytes, &text);
+            hexSink = hexSink + text.size();
+        });
+        SetRates(report.Add("append_hex" + suffix), size, calls, seconds);
+
+        seconds = Repeat(secondsPerCase, &calls, [&] { hexSink = hexSink + core::ParseHex(text).size(); });
+        SetRates(report.Add("parse_hex" + suffix), size, calls, seconds);
+
+        if (text.size() != size * 3U - 1U || core::BytesToHex(bytes) != text || core::ParseHex(text) != bytes) {
+            report.Fail("hex" + suffix + ": round trip mismatch");
+        }
+    }
+}
+
+const bench::SuiteRegistrar kHex("hex", &RunHex);
+
+} // namespace
@@ -0,0 +1,142 @@
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "bench/Bench.h"
+#include "core/Hex.h"
+#include "core/LogVirtualizer.h"
+
+namespace {
+
+constexpr std::size_t kDistinctLines = 1024;
+constexpr COLORREF kColor = 0x00C0C0C0U;
+
+volatile std::size_t logSink = 0;
+
+// Log lines as the read path produces them: a timestamp, a direction and 4..32 bytes in hex.
+std::vector<std::wstring> MakeLines() {
+    std::mt19937 random(3);
+    std::vector<std::wstring> lines;
+    lines.reserve(kDistinctLines);
+    std::vector<uint8_t> bytes;
+    for (std::size_t i = 0; i < kDistinctLines; ++i) {
+        bytes.resize(4U + random() % 29U);
+        for (uint8_t& byte : bytes) {
+            byte = static_cast<uint8_t>(random());
+        }
+        std::wstring line = L"12:34:56.789 RX  ";
+        core::AppendHex(bytes, &line);
+        line += L"\r\n";
+        lines.push_back(std::move(line));
+    }
+    return lines;
+}
+
+// Fills a buffer of the given size, keeps appending once it is full (every line now evicts the
+// oldest), then takes snapshots, as the window does on every rewrite. The snapshot must hold
+// exactly the latest lines.
+void RunBuffered(bench::Report& report, const std::vector<std::wstring>& lines, std::size_t capacity, double secondsPerCase) {
+    const std::string name = "lines=" + std::to_string(capacity);
+    core::LogVirtualizer log(capacity, capacity, capacity * 64U * sizeof(wchar_t));
+
+    const auto fillStart = bench::Clock::now();
+    for (std::size_t i = 0; i < capacity; ++i) {
+        log.AppendLine(lines[i % kDistinctLines], kColor, false);
+    }
+    const double fillSeconds = bench::SecondsSince(fillStart);
+    std::uint64_t appended = capacity;
+
+    std::uint64_t evicting = 0;
+    const auto steadyStart = bench::Clock::now();
+    do {
+        for (int i = 0; i < 256; ++i) {
+            log.AppendLine(lines[appended % kDistinctLines], kColor, false);
+            ++appended;
+        }
+        evicting += 256;
+    } while (bench::SecondsSince(steadyStart) < secondsPerCase / 2.0);
+    const double steadySeconds = bench::SecondsSince(steadyStart);
+
+    std::uint64_t snapshots = 0;
+    bool intact = true;
+    const auto snapshotStart = bench::Clock::now();
+    do {
+        const std::vector<core::VirtualLogLine> snapshot = log.SnapshotBuffer();
+        logSink = logSink + snapshot.size();
+        if (snapshots == 0) {
+            intact = snapshot.size() == capacity && snapshot.front().text == lines[(appended - capacity) % kDistinctLines] &&
+                     snapshot.back().text == lines[(appended - 1U) % kDistinctLines];
+        }
+        ++snapshots;
+    } while (bench::SecondsSince(snapshotStart) < secondsPerCase / 2.0);
+    const double snapshotSeconds = bench::SecondsSince(snapshotStart);
+
+    bench::Case& result = report.Add(name);
+    result.Set("append_fill_ns", fillSeconds * 1e9 / static_cast<double>(capacity));
+    result.Set("append_evicting_ns", steadySeconds * 1e9 / static_cast<double>(evicting));
+    result.Set("snapshot_ms", snapshotSeconds * 1e3 / static_cast<double>(snapshots));
+    result.Set("snapshot_ns_per_line", snapshotSeconds * 1e9 / static_cast<double>(snapshots * capacity));
+    if (!intact) {
+        report.Fail(name + ": snapshot does not hold the latest lines");
+    }
+}
+
+// Appends with persistToDisk: each line is converted to UTF-8, written and flushed.
+void AppendPersisted(bench::Report& report, const std::vector<std::wstring>& lines, const std::filesystem::path& directory, double seconds) {
+    core::LogVirtualizer log(2000, 5000, 5U * 1024U * 1024U);
+    if (!log.Initialize(directory.wstring())) {
+        report.Fail("persist: cannot open a session file in " + directory.string());
+        return;
+    }
+
+    std::uint64_t appended = 0;
+    std::uint64_t failures = 0;
+    std::uint64_t chars = 0;
+    const auto start = bench::Clock::now();
+    do {
+        for (int i = 0; i < 64; ++i) {
+            const std::wstring& line = lines[appended % kDistinctLines];
+            failures += log.AppendLine(line, kColor, true) ? 0U : 1U;
+            chars += line.size();
+            ++appended;
+        }
+    } while (bench::SecondsSince(start) < seconds);
+    const double elapsed = bench::SecondsSince(start);
+
+    // Hex lines are ASCII: one byte per character after the 3-byte BOM.
+    std::error_code ec;
+    const std::uintmax_t fileBytes = std::filesystem::file_size(log.SessionFilePath(), ec);
+
+    bench::Case& result = report.Add("persist/lines=2000");
+    result.Set("append_ns", elapsed * 1e9 / static_cast<double>(appended));
+    result.Set("mb_per_sec", static_cast<double>(chars) / (1024.0 * 1024.0) / elapsed);
+    if (failures != 0 || ec || fileBytes != chars + 3U) {
+        report.Fail("persist: session file does not hold every line");
+    }
+}
+
+void RunLogVirtualizer(const bench::Options& options, bench::Report& report) {
+    const std::vector<std::wstring> lines = MakeLines();
+    const std::size_t capacities[] = {2000, 100000, 1000000};
+    const double secondsPerCase = options.seconds / static_cast<double>(std::size(capacities) + 1U);
+    for (const std::size_t capacity : capacities) {
+        RunBuffered(report, lines, capacity, secondsPerCase);
+    }
+
+    std::error_code ec;
+    const std::filesystem::path directory =
+        std::filesystem::temp_directory_path(ec) / ("comterminal_bench_log_" + std::to_string(std::random_device{}()));
+    if (ec) {
+        report.Fail("persist: no temporary directory");
+        return;
+    }
+    AppendPersisted(report, lines, directory, secondsPerCase);
+    std::filesystem::remove_all(directory, ec);
+}
+
+const bench::SuiteRegistrar kLogVirtualizer("log_virtualizer", &RunLogVirtualizer);
+
+} // namespace
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "bench/Bench.h"
+#include "core/BufferPool.h"
+#include "core/Hex.h"
+#include "core/MirroredRing.h"
+
+namespace {
+
+constexpr std::size_t kCapacity = 64U * 1024U;
+constexpr unsigned kPatternPeriod = 251;
+// Leaves a remainder on every pass, so the readable region keeps crossing the wrap point.
+constexpr std::size_t kOddTail = 37;
+
+std::vector<uint8_t> Pattern(std::size_t size) {
+    std::vector<uint8_t> pattern(size + kPatternPeriod);
+    for (std::size_t i = 0; i < pattern.size(); ++i) {
+        pattern[i] = static_cast<uint8_t>(i % kPatternPeriod);
+    }
+    return pattern;
+}
+
+// What a decoder sees: BufferPool copies the readable bytes out first, MirroredRing hands them
+// over in place. Both compare the bytes against the pattern, which doubles as the work.
+struct CopyingReader {
+    core::BufferPool pool{kCapacity};
+    std::vector<uint8_t> scratch = std::vector<uint8_t>(kCapacity);
+
+    bool Write(const uint8_t* data, std::size_t size) { return pool.Write(data, size); }
+
+    template <typename Visit>
+    std::size_t Drain(Visit&& visit) {
+        const std::size_t read = pool.Read(scratch.data(), scratch.size());
+        visit(std::span<const uint8_t>(scratch.data(), read));
+        return read;
+    }
+};
+
+struct MirroredReader {
+    core::MirroredRing ring;
+
+    MirroredReader() { ring.Create(kCapacity); }
+
+    bool Write(const uint8_t* data, std::size_t size) { return ring.Write(data, size); }
+
+    template <typename Visit>
+    std::size_t Drain(Visit&& visit) {
+        const std::span<const uint8_t> data = ring.Peek();
+        visit(data);
+        ring.Consume(data.size());
+        return data.size();
+    }
+};
+
+// The producer fills the ring to about three quarters in chunks, then the consumer drains it.
+template <typename Reader>
+void RunDrain(const bench::Options& options, bench::Report& report, const std::string& name, std::size_t chunk) {
+    Reader reader;
+    const std::vector<uint8_t> pattern = Pattern(kCapacity);
+    std::uint64_t produced = 0;
+    std::uint64_t consumed = 0;
+    std::uint64_t mismatches = 0;
+    const auto start = bench::Clock::now();
+    while (bench::SecondsSince(start) < options.seconds / 2.0) {
+        while ((produced - consumed) + chunk <= kCapacity * 3U / 4U) {
+            reader.Write(pattern.data() + produced % kPatternPeriod, chunk);
+            produced += chunk;
+        }
+        reader.Drain([&](std::span<const uint8_t> data) {
+            mismatches += std::memcmp(data.data(), pattern.data() + consumed % kPatternPeriod, data.size()) == 0 ? 0U : 1U;
+            consumed += data.size();
+        });
+    }
+    const double seconds = bench::SecondsSince(start);
+
+    const std::string caseName = "drain/" + name + "/chunk=" + std::to_string(chunk);
+    bench::Case& result = report.Add(caseName);
+    result.Set("mb_per_sec", static_cast<double>(consumed) / (1024.0 * 1024.0) / seconds);
+    if (mismatches != 0) {
+        report.Fail(caseName + ": data corrupted");
+    }
+}
+
+// Formats every readable region as hex, the log's hot path in hex mode.
+template <typename Reader>
+void RunHex(const bench::Options& options, bench::Report& report, const std::string& name) {
+    constexpr std::size_t kChunk = 4096U + kOddTail;
+    Reader reader;
+    const std::vector<uint8_t> pattern = Pattern(kChunk);
+    std::wstring text;
+    std::uint64_t bytes = 0;
+    const auto start = bench::Clock::now();
+    while (bench::SecondsSince(start) < options.seconds / 2.0) {
+        reader.Write(pattern.data() + bytes % kPatternPeriod, kChunk);
+        bytes += reader.Drain([&](std::span<const uint8_t> data) {
+            text.clear();
+            core::AppendHex(data, &text);
+        });
+    }
+    const double seconds = bench::SecondsSince(start);
+
+    bench::Case& result = report.Add("hex/" + name);
+    result.Set("mb_per_sec", static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds);
+    result.Set("ns_per_byte", seconds * 1e9 / static_cast<double>(bytes));
+}
+
+void RunMirroredRing(const bench::Options& options, bench::Report& report) {
+    core::MirroredRing probe;
+    if (!probe.Create(kCapacity)) {
+        report.Fail("mirrored_ring: cannot map mirrored memory");
+        return;
+    }
+    for (const std::size_t chunk : {std::size_t{64} + kOddTail, std::size_t{4096} + kOddTail}) {
+        RunDrain<CopyingReader>(options, report, "buffer_pool", chunk);
+        RunDrain<MirroredReader>(options, report, "mirrored", chunk);
+    }
+    RunHex<CopyingReader>(options, report, "buffer_pool");
+    RunHex<MirroredReader>(options, report, "mirrored");
+}
+
+const bench::SuiteRegistrar kMirroredRing("mirrored_ring", &RunMirroredRing);
+
+} // namespace
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "bench/Bench.h"
+#include "bench/PtyPair.h"
+#include "serial/PortScanner.h"
+
+namespace {
+
+constexpr int kScanRepeats = 20;
+
+using PtyList = std::vector<std::unique_ptr<bench::PtyPair>>;
+
+// Average microseconds per call of scan, which is run kScanRepeats times.
+template <typename Fn>
+double MeasureMicros(Fn&& scan) {
+    const auto start = bench::Clock::now();
+    for (int i = 0; i < kScanRepeats; ++i) {
+        scan();
+    }
+    return bench::SecondsSince(start) * 1e6 / kScanRepeats;
+}
+
+std::size_t CountNamed(const std::vector<serial::PortInfo>& ports, const std::set<std::wstring>& names) {
+    return static_cast<std::size_t>(std::count_if(ports.begin(), ports.end(), [&names](const serial::PortInfo& port) {
+        return names.count(port.portName) != 0;
+    }));
+}
+
+std::set<std::wstring> SlaveNames(const PtyList& ptys, std::size_t first, std::size_t count) {
+    std::set<std::wstring> names;
+    for (std::size_t i = first; i < first + count; ++i) {
+        names.insert(ptys[i]->SlaveName());
+    }
+    return names;
+}
+
+bool AllocatePtys(PtyList* ptys, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        ptys->push_back(std::make_unique<bench::PtyPair>());
+        if (!ptys->back()->IsValid()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void RunCase(bench::Report& report, std::size_t ptyCount) {
+    const std::string caseName = "ptys=" + std::to_string(ptyCount);
+    PtyList ptys;
+    if (!AllocatePtys(&ptys, ptyCount)) {
+        report.Fail(caseName + ": cannot allocate pseudo-terminals");
+        return;
+    }
+    const std::set<std::wstring> allNames = SlaveNames(ptys, 0, ptys.size());
+
+    std::size_t listed = 0;
+    const double fullUs = MeasureMicros([&] { listed = CountNamed(serial::PortScanner::Scan(), allNames); });
+
+    serial::PortScanner scanner;
+    const auto coldStart = bench::Clock::now();
+    const serial::PortDiff initial = scanner.Rescan();
+    const double coldUs = bench::SecondsSince(coldStart) * 1e6;
+
+    std::size_t idleChanges = 0;
+    const double idleUs = MeasureMicros([&] {
+        const serial::PortDiff diff = scanner.Rescan();
+        idleChanges += diff.added.size() + diff.removed.size();
+    });
+
+    // Churn a tenth of the ptys: the diff has to name exactly the closed and the new ones.
+    const std::size_t churn = std::max<std::size_t>(1U, ptyCount / 10U);
+    const std::set<std::wstring> closedNames = SlaveNames(ptys, 0, churn);
+    ptys.erase(ptys.begin(), ptys.begin() + static_cast<std::ptrdiff_t>(churn));
+    const std::size_t keep = ptys.size();
+    if (!AllocatePtys(&ptys, churn)) {
+        report.Fail(caseName + ": cannot allocate pseudo-terminals");
+        return;
+    }
+    const std::set<std::wstring> openedNames = SlaveNames(ptys, keep, churn);
+
+    const auto churnStart = bench::Clock::now();
+    const serial::PortDiff changed = scanner.Rescan();
+    const double churnUs = bench::SecondsSince(churnStart) * 1e6;
+
+    // Same churn again, this time picked up by the first scan of the background thread.
+    ptys.erase(ptys.begin(), ptys.begin() + static_cast<std::ptrdiff_t>(churn));
+    AllocatePtys(&ptys, churn);
+    std::mutex mutex;
+    std::condition_variable delivered;
+    std::vector<serial::PortDiff> diffs;
+    const auto asyncStart = bench::Clock::now();
+    scanner.Start([&](const serial::PortDiff& diff) {
+        std::lock_guard<std::mutex> lock(mutex);
+        diffs.push_back(diff);
+        delivered.notify_one();
+    });
+    double asyncUs = 0.0;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (delivered.wait_for(lock, std::chrono::seconds(2), [&diffs] { return !diffs.empty(); })) {
+            asyncUs = bench::SecondsSince(asyncStart) * 1e6;
+        }
+    }
+    scanner.Stop();
+
+    bench::Case& result = report.Add(caseName);
+    result.Set("full_scan_us", fullUs);
+    result.Set("cold_rescan_us", coldUs);
+    result.Set("idle_rescan_us", idleUs);
+    result.Set("churn_rescan_us", churnUs);
+    result.Set("async_diff_us", asyncUs);
+    result.Set("ports_listed", static_cast<double>(listed));
+    result.Set("diff_added", static_cast<double>(CountNamed(changed.added, openedNames)));
+    result.Set("diff_removed", static_cast<double>(CountNamed(changed.removed, closedNames)));
+
+    if (listed != ptyCount || CountNamed(initial.added, allNames) != ptyCount) {
+        report.Fail(caseName + ": scan missed pseudo-terminals");
+    }
+    if (idleChanges != 0) {
+        report.Fail(caseName + ": rescan without changes reported a diff");
+    }
+    if (CountNamed(changed.added, openedNames) != churn || CountNamed(changed.removed, closedNames) != churn) {
+        report.Fail(caseName + ": diff does not match the churned pseudo-terminals");
+    }
+    if (asyncUs == 0.0) {
+        report.Fail(caseName + ": background scan delivered no diff");
+    }
+}
+
+void RunPortScan(const bench::Options&, bench::Report& report) {
+    for (const std::size_t ptyCount : {100U, 400U}) {
+        RunCase(report, ptyCount);
+    }
+}
+
+const bench::SuiteRegistrar kPortScan("port_scan", &RunPortScan);
+
+} // namespace
@@ -0,0 +1,44 @@
+#include "bench/PtyPair.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <termios.h>
+
+namespace bench {
+
+PtyPair::PtyPair() : master_(::posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC)) {
+    if (!master_.IsValid() || ::grantpt(master_.Get()) != 0 || ::unlockpt(master_.Get()) != 0) {
+        master_.Reset();
+        return;
+    }
+
+    char name[128] = {};
+    if (::ptsname_r(master_.Get(), name, sizeof(name)) != 0) {
+        master_.Reset();
+        return;
+    }
+
+    // Raw master side: no echo or newline translation of what the port transmits.
+    termios tty{};
+    if (::tcgetattr(master_.Get(), &tty) == 0) {
+        ::cfmakeraw(&tty);
+        ::tcsetattr(master_.Get(), TCSANOW, &tty);
+    }
+
+    const std::string narrow = name;
+    slaveName_.assign(narrow.begin(), narrow.end());
+}
+
+bool PtyPair::IsValid() const noexcept {
+    return master_.IsValid();
+}
+
+int PtyPair::Master() const noexcept {
+    return master_.Get();
+}
+
+const std::wstring& PtyPair::SlaveName() const noexcept {
+    return slaveName_;
+}
+
+} // namespace bench
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+
+#include "core/UniqueFd.h"
+
+namespace bench {
+
+// Pseudo-terminal pair: SerialPort opens SlaveName(), the benchmark drives Master().
+class PtyPair final {
+public:
+    PtyPair();
+
+    [[nodiscard]] bool IsValid() const noexcept;
+    [[nodiscard]] int Master() const noexcept;
+    [[nodiscard]] const std::wstring& SlaveName() const noexcept;
+
+private:
+    core::UniqueFd master_;
+    std::wstring slaveName_;
+};
+
+} // namespace bench
@@ -0,0 +1,226 @@
+#include <poll.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench/Bench.h"
+#include "bench/PtyPair.h"
+#include "serial/PortReactor.h"
+#include "serial/SerialPort.h"
+
+namespace {
+
+constexpr unsigned kPatternPeriod = 251;
+constexpr DWORD kPortBaudRate = 115200;
+constexpr std::size_t kTxProbeBytes = 256;
+
+struct PortChecker {
+    std::atomic<std::uint64_t> received{0};
+    std::uint64_t mismatches = 0;
+    unsigned expected = 0;
+
+    void Consume(std::span<const uint8_t> bytes) {
+        for (const uint8_t byte : bytes) {
+            if (byte != expected) {
+                ++mismatches;
+                expected = byte;
+            }
+            expected = (expected + 1U) % kPatternPeriod;
+        }
+        received.fetch_add(bytes.size(), std::memory_order_release);
+    }
+};
+
+struct Usage {
+    double cpuSeconds;
+    long contextSwitches;
+};
+
+Usage ProcessUsage() {
+    rusage usage{};
+    ::getrusage(RUSAGE_SELF, &usage);
+    const auto seconds = [](const timeval& tv) { return static_cast<double>(tv.tv_sec) + tv.tv_usec / 1e6; };
+    return {seconds(usage.ru_utime) + seconds(usage.ru_stime), usage.ru_nvcsw + usage.ru_nivcsw};
+}
+
+// One writer thread streams the pattern into every master at the 8N1 rate of kPortBaudRate.
+std::uint64_t WriteAllPaced(const std::vector<std::unique_ptr<bench::PtyPair>>& ptys, double seconds) {
+    const double bytesPerSecond = kPortBaudRate / 10.0;
+    std::vector<uint8_t> chunk(4096);
+    std::uint64_t sentPerPort = 0;
+
+    const auto start = bench::Clock::now();
+    for (;;) {
+        const double elapsed = bench::SecondsSince(start);
+        if (elapsed >= seconds) {
+            break;
+        }
+
+        const auto due = static_cast<std::uint64_t>(elapsed * bytesPerSecond);
+        if (due <= sentPerPort) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        const std::size_t size = static_cast<std::size_t>(std::min<std::uint64_t>(due - sentPerPort, chunk.size()));
+        for (std::size_t i = 0; i < size; ++i) {
+            chunk[i] = static_cast<uint8_t>((sentPerPort + i) % kPatternPeriod);
+        }
+        for (const auto& pty : ptys) {
+            std::size_t offset = 0;
+            while (offset < size) {
+                const ssize_t written = ::write(pty->Master(), chunk.data() + offset, size - offset);
+                if (written <= 0) {
+                    return sentPerPort;
+                }
+                offset += static_cast<std::size_t>(written);
+            }
+        }
+        sentPerPort += size;
+    }
+    return sentPerPort;
+}
+
+// Reads back what the ports transmitted; returns the number of masters that got every probe byte.
+std::size_t CountTxProbes(const std::vector<std::unique_ptr<bench::PtyPair>>& ptys) {
+    std::size_t complete = 0;
+    for (const auto& pty : ptys) {
+        std::size_t got = 0;
+        uint8_t buffer[kTxProbeBytes];
+        const auto deadline = bench::Clock::now() + std::chrono::seconds(1);
+        while (got < kTxProbeBytes && bench::Clock::now() < deadline) {
+            pollfd wait{pty->Master(), POLLIN, 0};
+            if (::poll(&wait, 1, 10) <= 0) {
+                continue;
+            }
+            const ssize_t size = ::read(pty->Master(), buffer, sizeof(buffer));
+            if (size <= 0) {
+                break;
+            }
+            got += static_cast<std::size_t>(size);
+        }
+        complete += (got == kTxProbeBytes) ? 1U : 0U;
+    }
+    return complete;
+}
+
+void RunCase(const bench::Options& options, bench::Report& report, std::size_t portCount, bool useReactor) {
+    std::vector<std::unique_ptr<bench::PtyPair>> ptys;
+    std::vector<std::unique_ptr<PortChecker>> checkers;
+    for (std::size_t i = 0; i < portCount; ++i) {
+        ptys.push_back(std::make_unique<bench::PtyPair>());
+        checkers.push_back(std::make_unique<PortChecker>());
+        if (!ptys.back()->IsValid()) {
+            report.Fail("cannot allocate " + std::to_string(portCount) + " pseudo-terminals");
+            return;
+        }
+    }
+
+    serial::PortSettings settings{};
+    settings.baudRate = kPortBaudRate;
+    settings.dataBits = 8;
+    settings.readProfile = serial::ReadProfile::Balanced;
+
+    const std::string caseName = std::string(useReactor ? "reactor" : "thread_per_port") + "/ports=" + std::to_string(portCount);
+    const std::vector<uint8_t> probe(kTxProbeBytes, 0xA5);
+
+    // Ids are handed out in AddPort order starting from 1, so id - 1 indexes checkers.
+    serial::PortReactor reactor;
+    std::vector<serial::PortReactor::PortId> ids;
+    std::vector<std::unique_ptr<serial::SerialPort>> ports;
+
+    if (useReactor) {
+        reactor.Start([&checkers](serial::PortReactor::PortId port, std::span<const uint8_t> data, std::int64_t) {
+            checkers[port - 1U]->Consume(data);
+        });
+        for (const auto& pty : ptys) {
+            ids.push_back(reactor.AddPort(pty->SlaveName(), settings));
+            if (ids.back() == serial::PortReactor::kInvalidPort) {
+                report.Fail(caseName + ": cannot add a port");
+                return;
+            }
+        }
+    } else {
+        for (std::size_t i = 0; i < portCount; ++i) {
+            ports.push_back(std::make_unique<serial::SerialPort>());
+            PortChecker* checker = checkers[i].get();
+            ports.back()->SetDataCallback([checker](std::span<const uint8_t> data, std::int64_t) { checker->Consume(data); });
+            if (!ports.back()->Open(ptys[i]->SlaveName(), settings)) {
+                report.Fail(caseName + ": cannot open a port");
+                return;
+            }
+        }
+    }
+
+    const Usage before = ProcessUsage();
+    const auto start = bench::Clock::now();
+    const std::uint64_t sentPerPort = WriteAllPaced(ptys, options.seconds);
+
+    const auto drainDeadline = bench::Clock::now() + std::chrono::seconds(2);
+    const auto allReceived = [&] {
+        for (const auto& checker : checkers) {
+            if (checker->received.load(std::memory_order_acquire) < sentPerPort) {
+                return false;
+            }
+        }
+        return true;
+    };
+    while (!allReceived() && bench::Clock::now() < drainDeadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const double seconds = bench::SecondsSince(start);
+    const Usage after = ProcessUsage();
+
+    for (std::size_t i = 0; i < portCount; ++i) {
+        if (useReactor) {
+            reactor.WriteAsync(ids[i], probe.data(), static_cast<DWORD>(probe.size()));
+        } else {
+            ports[i]->WriteAsync(probe.data(), static_cast<DWORD>(probe.size()));
+        }
+    }
+    const std::size_t txComplete = CountTxProbes(ptys);
+
+    reactor.Stop();
+    ports.clear();
+
+    std::uint64_t received = 0;
+    std::uint64_t drops = 0;
+    for (const auto& checker : checkers) {
+        const std::uint64_t got = checker->received.load(std::memory_order_acquire);
+        received += got;
+        drops += ((got < sentPerPort) ? sentPerPort - got : 0U) + checker->mismatches;
+    }
+    const double megabytes = static_cast<double>(received) / (1024.0 * 1024.0);
+
+    bench::Case& result = report.Add(caseName);
+    result.Set("io_threads", static_cast<double>(useReactor ? 1U : portCount * 2U));
+    result.Set("bytes_per_sec", static_cast<double>(received) / seconds);
+    result.Set("bytes_received", static_cast<double>(received));
+    result.Set("drops", static_cast<double>(drops));
+    result.Set("cpu_ms_per_mb", megabytes > 0.0 ? (after.cpuSeconds - before.cpuSeconds) * 1000.0 / megabytes : 0.0);
+    result.Set("context_switches_per_mb", megabytes > 0.0 ? static_cast<double>(after.contextSwitches - before.contextSwitches) / megabytes : 0.0);
+    result.Set("tx_ports_ok", static_cast<double>(txComplete));
+
+    if (drops != 0) {
+        report.Fail(caseName + ": dropped or corrupted bytes");
+    }
+    if (txComplete != portCount) {
+        report.Fail(caseName + ": transmit probe missing on " + std::to_string(portCount - txComplete) + " ports");
+    }
+}
+
+void RunReactor(const bench::Options& options, bench::Report& report) {
+    for (const std::size_t portCount : {16U, 64U}) {
+        RunCase(options, report, portCount, true);
+        RunCase(options, report, portCount, false);
+    }
+}
+
+const bench::SuiteRegistrar kReactor("reactor", &RunReactor);
+
+} // namespace
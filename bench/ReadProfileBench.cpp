@@ -0,0 +1,168 @@
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench/Bench.h"
+#include "bench/PtyPair.h"
+#include "serial/SerialPort.h"
+
+namespace {
+
+// Samples pair a running byte count with the time it was reached, on either side of the port.
+struct Sample {
+    std::uint64_t bytes;
+    std::int64_t nanos;
+};
+
+constexpr std::size_t kMaxSamples = 1U << 20U;
+
+std::int64_t NanosSince(bench::Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(bench::Clock::now() - start).count();
+}
+
+// Writes small paced chunks the way a device streams at line rate, noting when each one left.
+std::vector<Sample> WritePaced(int fd, double bytesPerSecond, double seconds, bench::Clock::time_point epoch) {
+    std::vector<Sample> samples;
+    samples.reserve(kMaxSamples);
+    std::vector<uint8_t> chunk(4096, 0x55);
+    std::uint64_t sent = 0;
+
+    const auto start = bench::Clock::now();
+    for (;;) {
+        const double elapsed = bench::SecondsSince(start);
+        if (elapsed >= seconds) {
+            break;
+        }
+
+        const auto due = static_cast<std::uint64_t>(elapsed * bytesPerSecond);
+        if (due <= sent) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            continue;
+        }
+
+        const std::size_t size = static_cast<std::size_t>(std::min<std::uint64_t>(due - sent, chunk.size()));
+        std::size_t offset = 0;
+        while (offset < size) {
+            const ssize_t written = ::write(fd, chunk.data() + offset, size - offset);
+            if (written <= 0) {
+                return samples;
+            }
+            offset += static_cast<std::size_t>(written);
+        }
+        sent += size;
+        if (samples.size() < kMaxSamples) {
+            samples.push_back({sent, NanosSince(epoch)});
+        }
+    }
+    return samples;
+}
+
+double Percentile(std::vector<double> values, double fraction) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    const auto index = static_cast<std::size_t>(fraction * static_cast<double>(values.size() - 1U));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+    return values[index];
+}
+
+const char* ProfileName(serial::ReadProfile profile) {
+    switch (profile) {
+    case serial::ReadProfile::LowLatency:
+        return "low_latency";
+    case serial::ReadProfile::Balanced:
+        return "balanced";
+    case serial::ReadProfile::Bulk:
+        return "bulk";
+    }
+    return "unknown";
+}
+
+void RunCase(const bench::Options& options, bench::Report& report, DWORD baudRate, serial::ReadProfile profile) {
+    bench::PtyPair pty;
+    if (!pty.IsValid()) {
+        report.Fail("cannot allocate a pseudo-terminal");
+        return;
+    }
+
+    const auto epoch = bench::Clock::now();
+    std::vector<Sample> delivered;
+    delivered.reserve(kMaxSamples);
+    std::atomic<std::uint64_t> received{0};
+
+    serial::SerialPort port;
+    port.SetDataCallback([&](std::span<const uint8_t> bytes, std::int64_t) {
+        const std::uint64_t total = received.load(std::memory_order_relaxed) + bytes.size();
+        if (delivered.size() < kMaxSamples) {
+            delivered.push_back({total, NanosSince(epoch)});
+        }
+        received.store(total, std::memory_order_release);
+    });
+
+    serial::PortSettings settings{};
+    settings.baudRate = baudRate;
+    settings.dataBits = 8;
+    settings.readProfile = profile;
+    if (!port.Open(pty.SlaveName(), settings)) {
+        report.Fail("cannot open " + std::string(pty.SlaveName().begin(), pty.SlaveName().end()));
+        return;
+    }
+
+    const double bytesPerSecond = baudRate / 10.0;
+    const std::vector<Sample> sent = WritePaced(pty.Master(), bytesPerSecond, options.seconds, epoch);
+    const std::uint64_t sentBytes = sent.empty() ? 0U : sent.back().bytes;
+
+    const auto drainDeadline = bench::Clock::now() + std::chrono::seconds(2);
+    while (received.load(std::memory_order_acquire) < sentBytes && bench::Clock::now() < drainDeadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    port.Close();
+
+    // Latency of the last byte of each written chunk: first callback whose running total covers it.
+    std::vector<double> latencies;
+    latencies.reserve(sent.size());
+    std::size_t next = 0;
+    for (const Sample& write : sent) {
+        while (next < delivered.size() && delivered[next].bytes < write.bytes) {
+            ++next;
+        }
+        if (next == delivered.size()) {
+            break;
+        }
+        latencies.push_back(static_cast<double>(delivered[next].nanos - write.nanos) / 1e6);
+    }
+
+    const std::uint64_t total = received.load(std::memory_order_acquire);
+    const double megabytes = static_cast<double>(total) / (1024.0 * 1024.0);
+    const serial::ReadTiming timing = serial::MakeReadTiming(profile, baudRate, settings.readBufferSize);
+
+    bench::Case& result = report.Add(std::string(ProfileName(profile)) + "/baud=" + std::to_string(baudRate));
+    result.Set("gap_ms", timing.gapMs);
+    result.Set("min_chunk_bytes", timing.minChunkBytes);
+    result.Set("bytes_received", static_cast<double>(total));
+    result.Set("callbacks", static_cast<double>(delivered.size()));
+    result.Set("wakeups_per_mb", megabytes > 0.0 ? static_cast<double>(delivered.size()) / megabytes : 0.0);
+    result.Set("avg_chunk_bytes", delivered.empty() ? 0.0 : static_cast<double>(total) / static_cast<double>(delivered.size()));
+    result.Set("p50_latency_ms", Percentile(latencies, 0.50));
+    result.Set("p99_latency_ms", Percentile(latencies, 0.99));
+
+    if (total != sentBytes) {
+        report.Fail(result.Name() + ": dropped bytes");
+    }
+}
+
+void RunRxProfiles(const bench::Options& options, bench::Report& report) {
+    for (const DWORD baudRate : {115200U, 921600U, 3000000U}) {
+        for (const auto profile : {serial::ReadProfile::LowLatency, serial::ReadProfile::Balanced, serial::ReadProfile::Bulk}) {
+            RunCase(options, report, baudRate, profile);
+        }
+    }
+}
+
+const bench::SuiteRegistrar kRxProfiles("rx_profiles", &RunRxProfiles);
+
+} // namespace
@@ -0,0 +1,136 @@
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench/Bench.h"
+#include "bench/PtyPair.h"
+#include "serial/SerialPort.h"
+
+namespace {
+
+// Prime period, so a dropped or duplicated chunk never lines up with the pattern again.
+constexpr unsigned kPatternPeriod = 251;
+
+struct PatternChecker {
+    std::atomic<std::uint64_t> received{0};
+    std::atomic<std::uint64_t> callbacks{0};
+    std::uint64_t mismatches = 0;
+    unsigned expected = 0;
+
+    void Consume(std::span<const uint8_t> bytes) {
+        for (const uint8_t byte : bytes) {
+            if (byte != expected) {
+                ++mismatches;
+                expected = byte;
+            }
+            expected = (expected + 1U) % kPatternPeriod;
+        }
+        callbacks.fetch_add(1U, std::memory_order_relaxed);
+        received.fetch_add(bytes.size(), std::memory_order_release);
+    }
+};
+
+// Writes the pattern into the pty master at bytesPerSecond, the way a device would at line rate.
+std::uint64_t WritePaced(int fd, double bytesPerSecond, double seconds) {
+    std::vector<uint8_t> chunk(4096);
+    std::uint64_t sent = 0;
+    unsigned next = 0;
+
+    const auto start = bench::Clock::now();
+    for (;;) {
+        const double elapsed = bench::SecondsSince(start);
+        if (elapsed >= seconds) {
+            break;
+        }
+
+        const auto due = static_cast<std::uint64_t>(elapsed * bytesPerSecond);
+        if (due <= sent) {
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+            continue;
+        }
+
+        const std::size_t size = static_cast<std::size_t>(std::min<std::uint64_t>(due - sent, chunk.size()));
+        for (std::size_t i = 0; i < size; ++i) {
+            chunk[i] = static_cast<uint8_t>((next + i) % kPatternPeriod);
+        }
+
+        std::size_t offset = 0;
+        while (offset < size) {
+            const ssize_t written = ::write(fd, chunk.data() + offset, size - offset);
+            if (written <= 0) {
+                return sent + offset;
+            }
+            offset += static_cast<std::size_t>(written);
+        }
+        next = static_cast<unsigned>((next + size) % kPatternPeriod);
+        sent += size;
+    }
+    return sent;
+}
+
+void RunCase(const bench::Options& options, bench::Report& report, DWORD baudRate, DWORD readDepth) {
+    bench::PtyPair pty;
+    if (!pty.IsValid()) {
+        report.Fail("cannot allocate a pseudo-terminal");
+        return;
+    }
+
+    PatternChecker checker;
+    serial::SerialPort port;
+    port.SetDataCallback([&checker](std::span<const uint8_t> bytes, std::int64_t) { checker.Consume(bytes); });
+
+    serial::PortSettings settings{};
+    settings.baudRate = 115200;
+    settings.dataBits = 8;
+    settings.readDepth = readDepth;
+    settings.readBufferSize = 4096;
+    if (!port.Open(pty.SlaveName(), settings)) {
+        report.Fail("cannot open " + std::string(pty.SlaveName().begin(), pty.SlaveName().end()));
+        return;
+    }
+
+    // A pty has no baud rate of its own; the writer paces the stream to the 8N1 byte rate.
+    const double bytesPerSecond = baudRate / 10.0;
+    const auto start = bench::Clock::now();
+    const std::uint64_t sent = WritePaced(pty.Master(), bytesPerSecond, options.seconds);
+    const double writeSeconds = bench::SecondsSince(start);
+
+    const auto drainDeadline = bench::Clock::now() + std::chrono::seconds(2);
+    while (checker.received.load(std::memory_order_acquire) < sent && bench::Clock::now() < drainDeadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    port.Close();
+
+    const std::uint64_t received = checker.received.load(std::memory_order_acquire);
+    const std::uint64_t callbacks = checker.callbacks.load(std::memory_order_relaxed);
+    const std::uint64_t lost = (sent > received) ? sent - received : 0U;
+
+    bench::Case& result = report.Add("baud=" + std::to_string(baudRate) + "/depth=" + std::to_string(readDepth));
+    result.Set("target_bytes_per_sec", bytesPerSecond);
+    result.Set("achieved_bytes_per_sec", static_cast<double>(sent) / writeSeconds);
+    result.Set("bytes_sent", static_cast<double>(sent));
+    result.Set("bytes_received", static_cast<double>(received));
+    result.Set("drops", static_cast<double>(lost + checker.mismatches));
+    result.Set("callbacks", static_cast<double>(callbacks));
+    result.Set("avg_chunk_bytes", callbacks > 0 ? static_cast<double>(received) / static_cast<double>(callbacks) : 0.0);
+
+    if (lost != 0 || checker.mismatches != 0) {
+        report.Fail(result.Name() + ": dropped or corrupted bytes");
+    }
+}
+
+void RunRxStress(const bench::Options& options, bench::Report& report) {
+    for (const DWORD baudRate : {921600U, 3000000U, 12000000U}) {
+        for (const DWORD readDepth : {1U, 4U, 16U}) {
+            RunCase(options, report, baudRate, readDepth);
+        }
+    }
+}
+
+const bench::SuiteRegistrar kRxStress("rx_stress", &RunRxStress);
+
+} // namespace
@@ -0,0 +1,140 @@
+#include <poll.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench/Bench.h"
+#include "bench/PtyPair.h"
+#include "serial/SerialPort.h"
+
+namespace {
+
+constexpr unsigned kPatternPeriod = 251;
+
+// Drains the pty master and checks the byte pattern, standing in for the remote device.
+struct MasterReader {
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> received{0};
+    std::uint64_t mismatches = 0;
+
+    void Run(int fd) {
+        std::vector<uint8_t> buffer(16384);
+        unsigned expected = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            pollfd wait{fd, POLLIN, 0};
+            if (::poll(&wait, 1, 10) <= 0) {
+                continue;
+            }
+            const ssize_t size = ::read(fd, buffer.data(), buffer.size());
+            if (size <= 0) {
+                break;
+            }
+            for (ssize_t i = 0; i < size; ++i) {
+                if (buffer[static_cast<std::size_t>(i)] != expected) {
+                    ++mismatches;
+                    expected = buffer[static_cast<std::size_t>(i)];
+                }
+                expected = (expected + 1U) % kPatternPeriod;
+            }
+            received.fetch_add(static_cast<std::uint64_t>(size), std::memory_order_release);
+        }
+    }
+};
+
+void RunCase(const bench::Options& options, bench::Report& report, DWORD messageSize, bool async) {
+    bench::PtyPair pty;
+    if (!pty.IsValid()) {
+        report.Fail("cannot allocate a pseudo-terminal");
+        return;
+    }
+
+    serial::SerialPort port;
+    serial::PortSettings settings{};
+    settings.baudRate = 115200;
+    settings.dataBits = 8;
+    if (!port.Open(pty.SlaveName(), settings)) {
+        report.Fail("cannot open " + std::string(pty.SlaveName().begin(), pty.SlaveName().end()));
+        return;
+    }
+
+    MasterReader reader;
+    std::thread readerThread([&reader, &pty] { reader.Run(pty.Master()); });
+
+    std::atomic<std::uint64_t> completed{0};
+    std::atomic<std::uint64_t> failed{0};
+    const serial::WriteCallback done = [&completed, &failed](bool ok, DWORD) {
+        (ok ? completed : failed).fetch_add(1U, std::memory_order_relaxed);
+    };
+
+    std::vector<uint8_t> message(messageSize);
+    std::uint64_t requests = 0;
+    std::uint64_t rejected = 0;
+    unsigned next = 0;
+
+    const auto start = bench::Clock::now();
+    while (bench::SecondsSince(start) < options.seconds) {
+        for (std::size_t i = 0; i < message.size(); ++i) {
+            message[i] = static_cast<uint8_t>((next + i) % kPatternPeriod);
+        }
+
+        bool ok = false;
+        if (async) {
+            ok = port.WriteAsync(message.data(), messageSize, done);
+        } else {
+            DWORD written = 0;
+            ok = port.Write(message.data(), messageSize, &written) && written == messageSize;
+        }
+
+        if (!ok) {
+            // Backpressure: give the writer thread the CPU instead of spinning on a full queue.
+            ++rejected;
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            continue;
+        }
+        next = static_cast<unsigned>((next + messageSize) % kPatternPeriod);
+        ++requests;
+    }
+
+    const std::uint64_t sent = requests * messageSize;
+    const auto drainDeadline = bench::Clock::now() + std::chrono::seconds(2);
+    while (reader.received.load(std::memory_order_acquire) < sent && bench::Clock::now() < drainDeadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const double seconds = bench::SecondsSince(start);
+
+    port.Close();
+    reader.stop.store(true);
+    readerThread.join();
+
+    const std::uint64_t received = reader.received.load(std::memory_order_acquire);
+    const std::uint64_t lost = (sent > received) ? sent - received : 0U;
+
+    bench::Case& result = report.Add(std::string(async ? "async" : "blocking") + "/msg=" + std::to_string(messageSize));
+    result.Set("requests_per_sec", static_cast<double>(requests) / seconds);
+    result.Set("bytes_per_sec", static_cast<double>(received) / seconds);
+    result.Set("bytes_sent", static_cast<double>(sent));
+    result.Set("bytes_received", static_cast<double>(received));
+    result.Set("rejected", static_cast<double>(rejected));
+    if (async) {
+        result.Set("completed", static_cast<double>(completed.load()));
+        result.Set("failed", static_cast<double>(failed.load()));
+    }
+
+    if (lost != 0 || reader.mismatches != 0) {
+        report.Fail(result.Name() + ": dropped or corrupted bytes");
+    }
+}
+
+void RunTxCoalesce(const bench::Options& options, bench::Report& report) {
+    for (const DWORD messageSize : {8U, 64U, 512U}) {
+        RunCase(options, report, messageSize, false);
+        RunCase(options, report, messageSize, true);
+    }
+}
+
+const bench::SuiteRegistrar kTxCoalesce("tx_coalesce", &RunTxCoalesce);
+
+} // namespace
@@ -0,0 +1,185 @@
+#include <poll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench/Bench.h"
+#include "bench/PtyPair.h"
+#include "core/Clock.h"
+#include "serial/TxScheduler.h"
+
+namespace {
+
+constexpr std::size_t kFrameBytes = 16;
+constexpr std::size_t kInterByteFrameBytes = 32;
+
+// Stamps every read on the pty master, standing in for a device that timestamps reception.
+struct ArrivalRecorder {
+    std::atomic<bool> stop{false};
+    std::vector<std::pair<std::int64_t, std::size_t>> arrivals; // (stamp, bytes)
+
+    void Run(int fd) {
+        uint8_t buffer[4096];
+        while (!stop.load(std::memory_order_relaxed)) {
+            pollfd wait{fd, POLLIN, 0};
+            if (::poll(&wait, 1, 10) <= 0) {
+                continue;
+            }
+            const ssize_t size = ::read(fd, buffer, sizeof(buffer));
+            const std::int64_t now = core::MonotonicNanos();
+            if (size <= 0) {
+                break;
+            }
+            arrivals.emplace_back(now, static_cast<std::size_t>(size));
+        }
+    }
+};
+
+struct GapErrors {
+    double p50Us = 0.0;
+    double p99Us = 0.0;
+    double maxUs = 0.0;
+    double meanGapUs = 0.0;
+};
+
+// Splits the arrivals into units of unitBytes and compares the gaps between unit starts with
+// the requested one. Reads are assumed to end on unit boundaries, which the gaps guarantee.
+GapErrors MeasureGaps(const std::vector<std::pair<std::int64_t, std::size_t>>& arrivals, std::size_t unitBytes, std::int64_t requestedNs, std::size_t* units) {
+    std::vector<std::int64_t> starts;
+    std::size_t offset = 0;
+    for (const auto& [stamp, size] : arrivals) {
+        for (std::size_t byte = 0; byte < size; ++byte, ++offset) {
+            if (offset % unitBytes == 0) {
+                starts.push_back(stamp);
+            }
+        }
+    }
+    *units = starts.size();
+
+    GapErrors result;
+    if (starts.size() < 2) {
+        return result;
+    }
+    std::vector<double> errors;
+    double gapSum = 0.0;
+    for (std::size_t i = 1; i < starts.size(); ++i) {
+        const std::int64_t gap = starts[i] - starts[i - 1];
+        gapSum += static_cast<double>(gap);
+        errors.push_back(std::abs(static_cast<double>(gap - requestedNs)) / 1000.0);
+    }
+    std::sort(errors.begin(), errors.end());
+    result.p50Us = errors[errors.size() / 2];
+    result.p99Us = errors[std::min(errors.size() - 1, errors.size() * 99 / 100)];
+    result.maxUs = errors.back();
+    result.meanGapUs = gapSum / static_cast<double>(errors.size()) / 1000.0;
+    return result;
+}
+
+// count units of unitBytes, requestedNs apart start to start. paced uses TxScheduler, otherwise
+// the writes are spaced with sleep_for like the scripts this replaces.
+void RunCase(bench::Report& report, const std::string& caseName, std::size_t count, std::int64_t requestedNs, bool interByte, bool paced) {
+    bench::PtyPair pty;
+    serial::SerialPort port;
+    serial::PortSettings settings{};
+    settings.baudRate = 115200;
+    settings.dataBits = 8;
+    if (!pty.IsValid() || !port.Open(pty.SlaveName(), settings)) {
+        report.Fail(caseName + ": cannot open a pseudo-terminal");
+        return;
+    }
+
+    ArrivalRecorder recorder;
+    recorder.arrivals.reserve(count * (interByte ? kInterByteFrameBytes : 1U) + 16U);
+    std::thread recorderThread([&recorder, &pty] { recorder.Run(pty.Master()); });
+
+    const std::size_t unitBytes = interByte ? 1U : kFrameBytes;
+    const std::size_t totalBytes = count * unitBytes;
+    std::vector<uint8_t> frame(interByte ? kInterByteFrameBytes : kFrameBytes, 0x55);
+
+    // A pty has no wire time, so delays count from the previous write.
+    serial::TxScheduler scheduler(port, 0);
+    serial::PacingStats stats;
+    if (paced) {
+        scheduler.Start();
+        if (interByte) {
+            for (std::size_t i = 0; i < count / kInterByteFrameBytes; ++i) {
+                scheduler.Enqueue(serial::PacedFrame{frame, requestedNs, requestedNs});
+            }
+        } else {
+            for (std::size_t i = 0; i < count; ++i) {
+                scheduler.Enqueue(serial::PacedFrame{frame, i == 0 ? 0 : requestedNs, 0});
+            }
+        }
+        scheduler.WaitIdle(std::chrono::seconds(30));
+        stats = scheduler.Stats();
+        scheduler.Stop();
+    } else {
+        for (std::size_t i = 0; i < count; ++i) {
+            if (i > 0) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(requestedNs));
+            }
+            DWORD written = 0;
+            port.Write(frame.data(), static_cast<DWORD>(unitBytes), &written);
+        }
+    }
+
+    const auto receivedBytes = [&recorder] {
+        std::size_t total = 0;
+        for (const auto& arrival : recorder.arrivals) {
+            total += arrival.second;
+        }
+        return total;
+    };
+    // The recorder owns arrivals until it is joined, so give the tail a fixed grace period.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    recorder.stop = true;
+    recorderThread.join();
+    port.Close();
+
+    std::size_t units = 0;
+    const GapErrors errors = MeasureGaps(recorder.arrivals, unitBytes, requestedNs, &units);
+
+    bench::Case& result = report.Add(caseName);
+    result.Set("requested_gap_us", static_cast<double>(requestedNs) / 1000.0);
+    result.Set("mean_gap_us", errors.meanGapUs);
+    result.Set("p50_gap_error_us", errors.p50Us);
+    result.Set("p99_gap_error_us", errors.p99Us);
+    result.Set("max_gap_error_us", errors.maxUs);
+    if (paced) {
+        result.Set("p50_release_error_us", static_cast<double>(stats.p50ErrorNs) / 1000.0);
+        result.Set("p99_release_error_us", static_cast<double>(stats.p99ErrorNs) / 1000.0);
+        result.Set("max_release_error_us", static_cast<double>(stats.maxErrorNs) / 1000.0);
+    }
+
+    if (receivedBytes() != totalBytes || units != count) {
+        report.Fail(caseName + ": received " + std::to_string(receivedBytes()) + " of " + std::to_string(totalBytes) + " bytes");
+    }
+    if (paced && (stats.failedWrites != 0 || errors.p50Us > 250.0)) {
+        report.Fail(caseName + ": pacing error above 250 us at the median");
+    }
+}
+
+void RunTxPacing(const bench::Options&, bench::Report& report) {
+    struct Spec {
+        const char* name;
+        std::size_t count;
+        std::int64_t gapNs;
+        bool interByte;
+    };
+    for (const Spec& spec : {Spec{"frame_gap=1ms", 300, 1000000, false},
+                             Spec{"frame_gap=5ms", 100, 5000000, false},
+                             Spec{"frame_gap=20ms", 50, 20000000, false},
+                             Spec{"byte_gap=500us", 256, 500000, true}}) {
+        RunCase(report, std::string("scheduler/") + spec.name, spec.count, spec.gapNs, spec.interByte, true);
+        RunCase(report, std::string("sleep_loop/") + spec.name, spec.count, spec.gapNs, spec.interByte, false);
+    }
+}
+
+const bench::SuiteRegistrar kTxPacing("tx_pacing", &RunTxPacing);
+
+} // namespace
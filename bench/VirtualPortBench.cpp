@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench/Bench.h"
+#include "core/BufferPool.h"
+#include "core/Clock.h"
+#include "core/Hex.h"
+#include "serial/SerialPort.h"
+#include "serial/TrafficGenerator.h"
+
+namespace {
+
+// Same buffer size as the UI (MainWindow.cpp).
+constexpr std::size_t kRxBufferBytes = 1024U * 1024U;
+constexpr std::size_t kMaxLatencySamples = 1U << 20U;
+constexpr std::size_t kEchoMessageBytes = 64;
+
+double Percentile(std::vector<double> values, double fraction) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    const auto index = static_cast<std::size_t>(fraction * static_cast<double>(values.size() - 1U));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+    return values[index];
+}
+
+// The UI thread's half of the RX path: drain records, check the bytes, format them as hex lines.
+struct Consumer {
+    explicit Consumer(const serial::TrafficSpec& spec) : reference(spec) { latenciesMs.reserve(kMaxLatencySamples); }
+
+    void Drain(core::BufferPool& buffer) {
+        std::int64_t stamp = 0;
+        while (buffer.ReadRecord(&record, &stamp)) {
+            Verify(record);
+
+            const std::int64_t formatStart = core::MonotonicNanos();
+            line.assign(L"RX: ");
+            core::AppendHex(record, &line);
+            formatNanos += core::MonotonicNanos() - formatStart;
+            formattedChars += line.size();
+
+            if (latenciesMs.size() < kMaxLatencySamples) {
+                latenciesMs.push_back(static_cast<double>(core::MonotonicNanos() - stamp) / 1e6);
+            }
+            received.fetch_add(record.size(), std::memory_order_release);
+        }
+    }
+
+    void Verify(std::span<const uint8_t> bytes) {
+        expected.resize(bytes.size());
+        reference.Fill(expected);
+        if (!std::equal(bytes.begin(), bytes.end(), expected.begin())) {
+            ++mismatches;
+        }
+    }
+
+    serial::TrafficGenerator reference;
+    std::vector<uint8_t> expected;
+    std::vector<uint8_t> record;
+    std::wstring line;
+    std::vector<double> latenciesMs;
+    std::atomic<std::uint64_t> received{0};
+    std::uint64_t mismatches = 0;
+    std::uint64_t formattedChars = 0;
+    std::int64_t formatNanos = 0;
+};
+
+// Expected average rate: bursts at line rate separated by silent gaps.
+double TargetBytesPerSecond(const serial::TrafficSpec& spec) {
+    const double rate = static_cast<double>(spec.bytesPerSecond);
+    if (spec.burstBytes == 0) {
+        return rate;
+    }
+    const double burstSeconds = static_cast<double>(spec.burstBytes) / rate;
+    return static_cast<double>(spec.burstBytes) / (burstSeconds + spec.gapMs / 1000.0);
+}
+
+void RunCase(const bench::Options& options, bench::Report& report, const std::wstring& portName, DWORD baudRate) {
+    const std::string caseName = std::string(portName.begin() + 8, portName.end()) + "/baud=" + std::to_string(baudRate);
+    serial::TrafficSpec spec{};
+    if (!serial::ParseVirtualPortName(portName, baudRate, &spec)) {
+        report.Fail(caseName + ": bad port name");
+        return;
+    }
+
+    // Echo cases check the loopback against what was sent, so the reference is the sender's stream.
+    const bool echo = (spec.pattern == serial::TrafficPattern::Echo);
+    serial::TrafficSpec referenceSpec = spec;
+    if (echo) {
+        referenceSpec.pattern = serial::TrafficPattern::Random;
+    }
+
+    core::BufferPool buffer(kRxBufferBytes);
+    Consumer consumer(referenceSpec);
+    std::atomic<std::uint64_t> callbacks{0};
+
+    serial::SerialPort port;
+    port.SetDataCallback([&](std::span<const uint8_t> bytes, std::int64_t timestampNs) {
+        buffer.WriteRecord(bytes, timestampNs);
+        callbacks.fetch_add(1U, std::memory_order_relaxed);
+    });
+
+    serial::PortSettings settings{};
+    settings.baudRate = baudRate;
+    settings.dataBits = 8;
+    if (!port.Open(portName, settings)) {
+        report.Fail(caseName + ": cannot open the virtual port");
+        return;
+    }
+
+    std::atomic<bool> consuming{true};
+    std::thread ui([&] {
+        while (consuming.load()) {
+            consumer.Drain(buffer);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        consumer.Drain(buffer);
+    });
+
+    std::uint64_t sent = 0;
+    const auto start = bench::Clock::now();
+    if (echo) {
+        // Paced at the port's line rate; a full queue just means waiting for the writer.
+        serial::TrafficGenerator source(referenceSpec);
+        std::vector<uint8_t> message(kEchoMessageBytes);
+        while (bench::SecondsSince(start) < options.seconds) {
+            const auto due = static_cast<std::uint64_t>(bench::SecondsSince(start) * static_cast<double>(spec.bytesPerSecond));
+            if (due < sent + message.size()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            source.Fill(message);
+            while (!port.WriteAsync(message.data(), static_cast<DWORD>(message.size()))) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            sent += message.size();
+        }
+        const auto drainDeadline = bench::Clock::now() + std::chrono::seconds(2);
+        while (consumer.received.load(std::memory_order_acquire) < sent && bench::Clock::now() < drainDeadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    } else {
+        std::this_thread::sleep_for(std::chrono::duration<double>(options.seconds));
+    }
+    const double seconds = bench::SecondsSince(start);
+    port.Close();
+    consuming.store(false);
+    ui.join();
+
+    const std::uint64_t received = consumer.received.load(std::memory_order_acquire);
+    const double target = TargetBytesPerSecond(spec);
+    const double achieved = static_cast<double>(received) / seconds;
+
+    bench::Case& result = report.Add(caseName);
+    result.Set("target_bytes_per_sec", target);
+    result.Set("bytes_per_sec", achieved);
+    result.Set("rate_ratio", achieved / target);
+    result.Set("bytes_received", static_cast<double>(received));
+    result.Set("callbacks", static_cast<double>(callbacks.load()));
+    result.Set("mismatched_records", static_cast<double>(consumer.mismatches));
+    result.Set("buffer_dropped_bytes", static_cast<double>(buffer.DroppedBytes()));
+    result.Set("p50_pipeline_latency_ms", Percentile(consumer.latenciesMs, 0.50));
+    result.Set("p99_pipeline_latency_ms", Percentile(consumer.latenciesMs, 0.99));
+    result.Set("format_ns_per_byte", received > 0 ? static_cast<double>(consumer.formatNanos) / static_cast<double>(received) : 0.0);
+    result.Set("formatted_chars", static_cast<double>(consumer.formattedChars));
+
+    if (buffer.DroppedBytes() != 0) {
+        report.Fail(caseName + ": receive buffer overran");
+    } else if (consumer.mismatches != 0) {
+        report.Fail(caseName + ": received stream differs from the generator");
+    }
+    if (echo && received != sent) {
+        report.Fail(caseName + ": echoed " + std::to_string(received) + " of " + std::to_string(sent) + " bytes");
+    }
+}
+
+void RunVirtualPort(const bench::Options& options, bench::Report& report) {
+    for (const DWORD baudRate : {3000000U, 12000000U}) {
+        for (const wchar_t* name : {L"virtual:text", L"virtual:random", L"virtual:prbs", L"virtual:bursty", L"virtual:echo"}) {
+            RunCase(options, report, name, baudRate);
+        }
+    }
+}
+
+const bench::SuiteRegistrar kVirtualPort("virtual_port", &RunVirtualPort);
+
+} // namespace
@@ -34,6 +34,34 @@
 #define IDS_TX_PREFIX 1102
 #define IDS_RX_PREFIX 1103
 #define IDS_PORT_IS_NOT_OPEN 1104
+#define IDS_TX_QUEUE_FULL 1105
+#define IDS_PORT_ADDED 1106
+#define IDS_PORT_REMOVED 1107
+#define IDS_FILE_SEND_STARTED 1108
+#define IDS_FILE_SEND_DONE 1109
+#define IDS_FILE_SEND_STOPPED 1110
+#define IDS_FILE_OPEN_FAILED 1111
+#define IDS_FILE_PROGRESS 1112
+#define IDS_FILE_PROGRESS_STALLED 1113
+#define IDS_AUTODETECT_STARTED 1117
+#define IDS_AUTODETECT_DONE 1118
+#define IDS_AUTODETECT_FAILED 1119
+#define IDS_AUTODETECT_CLOSE_PORT 1120
+#define IDS_BRIDGE_STARTED 1123
+#define IDS_BRIDGE_STOPPED 1124
+#define IDS_BRIDGE_FAILED 1125
+#define IDS_BRIDGE_CLOSE_PORT 1126
+#define IDS_CAPTURE_STARTED 1132
+#define IDS_CAPTURE_STOPPED 1133
+#define IDS_CAPTURE_FAILED 1134
+#define IDS_REPLAY_STARTED 1135
+#define IDS_REPLAY_DONE 1136
+#define IDS_REPLAY_FAILED 1137
+#define IDS_REPLAY_CLOSE_PORT 1138
+#define IDS_CRC_FRAMING_ON 1144
+#define IDS_CRC_FRAMING_OFF 1145
+#define IDS_CRC_FRAME_BAD 1146
+#define IDS_CRC_CHECKS_LOST 1147
 // Tooltips IDs
 #define IDS_TIP_COMBO_PORT 1022
 #define IDS_TIP_COMBO_BAUD 1023
@@ -91,6 +119,21 @@
 #define IDM_VIEW_SYSTEM 1068
 #define IDM_VIEW_DARK_THEME 1069
 #define IDM_VIEW_LIGHT_THEME 1070
+#define IDM_PORT_SEND_FILE 1114
+#define IDM_PORT_CANCEL_FILE 1115
+#define IDM_PORT_AUTODETECT 1116
+#define IDM_PORT_BRIDGE_TCP 1121
+#define IDM_PORT_BRIDGE_STOP 1122
+#define IDM_FILE_CAPTURE_START 1127
+#define IDM_FILE_CAPTURE_STOP 1128
+#define IDM_FILE_REPLAY 1129
+#define IDM_FILE_REPLAY_FAST 1130
+#define IDM_FILE_REPLAY_STOP 1131
+#define IDM_PORT_CRC_NONE 1139
+#define IDM_PORT_CRC_MODBUS 1140
+#define IDM_PORT_CRC_CCITT 1141
+#define IDM_PORT_CRC_XMODEM 1142
+#define IDM_PORT_CRC_32 1143
 
 // Control IDs
 #define IDC_STATUS_BAR 1071
@@ -0,0 +1,207 @@
+#include "core/BroadcastRing.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+namespace core {
+
+BroadcastRing::BroadcastRing(std::size_t capacity, std::size_t maxConsumers)
+    : capacity_(std::bit_ceil(std::max<std::size_t>(capacity, kRecordHeaderBytes + 1U))),
+      storage_(std::make_unique<uint8_t[]>(capacity_)),
+      slotCount_(std::max<std::size_t>(maxConsumers, 1U)),
+      slots_(std::make_unique<Slot[]>(slotCount_)),
+      head_(0),
+      reserved_(0),
+      published_(0),
+      spillConsumers_(0) {}
+
+BroadcastRing::~BroadcastRing() = default;
+
+bool BroadcastRing::Publish(std::span<const uint8_t> payload, std::int64_t timestampNs) noexcept {
+    const std::size_t total = kRecordHeaderBytes + payload.size();
+    if (payload.size() > std::numeric_limits<std::uint32_t>::max() || total > capacity_) {
+        return false;
+    }
+
+    // Announce the range first: a consumer that copied from it finds out afterwards.
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    reserved_.store(head + total, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    uint8_t header[kRecordHeaderBytes];
+    const auto size = static_cast<std::uint32_t>(payload.size());
+    std::memcpy(header, &size, sizeof(size));
+    std::memcpy(header + sizeof(size), &timestampNs, sizeof(timestampNs));
+    detail::RingCopyIn(storage_.get(), capacity_, head, header, sizeof(header));
+    detail::RingCopyIn(storage_.get(), capacity_, head + sizeof(header), payload.data(), payload.size());
+    head_.store(head + total, std::memory_order_release);
+    published_.fetch_add(1U, std::memory_order_relaxed);
+
+    FeedSpillConsumers(payload, timestampNs);
+    return true;
+}
+
+int BroadcastRing::AddConsumer(LagPolicy policy, const SpillToFile& spill) {
+    std::lock_guard<std::mutex> lock(registryMutex_);
+    for (std::size_t i = 0; i < slotCount_; ++i) {
+        Slot& slot = slots_[i];
+        if (slot.active.load(std::memory_order_relaxed)) {
+            continue;
+        }
+
+        slot.policy.store(policy, std::memory_order_relaxed);
+        if (policy == LagPolicy::Spill) {
+            try {
+                slot.spill = std::make_unique<SpillPool>(capacity_, spill);
+            } catch (const std::bad_alloc&) {
+                return -1;
+            }
+            spillConsumers_.fetch_add(1U, std::memory_order_relaxed);
+        }
+        slot.cursor.store(head_.load(std::memory_order_acquire), std::memory_order_relaxed);
+        slot.records.store(0, std::memory_order_relaxed);
+        slot.lostBytes.store(0, std::memory_order_relaxed);
+        slot.skips.store(0, std::memory_order_relaxed);
+        slot.active.store(true, std::memory_order_seq_cst);
+        return static_cast<int>(i);
+    }
+    return -1;
+}
+
+void BroadcastRing::RemoveConsumer(int id) {
+    std::lock_guard<std::mutex> lock(registryMutex_);
+    Slot* slot = ConsumerSlot(id);
+    if (slot == nullptr) {
+        return;
+    }
+
+    slot->active.store(false, std::memory_order_seq_cst);
+    if (slot->spill) {
+        // The producer may be in the middle of a WriteRecord into this pool.
+        while (slot->producerBusy.load(std::memory_order_seq_cst)) {
+            std::this_thread::yield();
+        }
+        slot->spill.reset();
+        spillConsumers_.fetch_sub(1U, std::memory_order_relaxed);
+    }
+}
+
+bool BroadcastRing::Read(int id, std::vector<uint8_t>* payload, std::int64_t* timestampNs) {
+    Slot* slot = ConsumerSlot(id);
+    if (slot == nullptr || payload == nullptr) {
+        return false;
+    }
+    if (slot->policy.load(std::memory_order_relaxed) == LagPolicy::Spill) {
+        if (!slot->spill->ReadRecord(payload, timestampNs)) {
+            return false;
+        }
+        slot->records.fetch_add(1U, std::memory_order_relaxed);
+        return true;
+    }
+    return ReadShared(*slot, payload, timestampNs);
+}
+
+std::size_t BroadcastRing::Capacity() const noexcept {
+    return capacity_;
+}
+
+std::uint64_t BroadcastRing::PublishedRecords() const noexcept {
+    return published_.load(std::memory_order_relaxed);
+}
+
+BroadcastConsumerStats BroadcastRing::ConsumerStats(int id) const noexcept {
+    BroadcastConsumerStats stats;
+    const Slot* slot = ConsumerSlot(id);
+    if (slot == nullptr) {
+        return stats;
+    }
+
+    stats.records = slot->records.load(std::memory_order_relaxed);
+    stats.lostBytes = slot->lostBytes.load(std::memory_order_relaxed);
+    stats.skips = slot->skips.load(std::memory_order_relaxed);
+    if (slot->spill) {
+        const BufferPoolStats spill = slot->spill->Stats();
+        stats.lagBytes = slot->spill->Size();
+        stats.lostBytes += spill.droppedBytes;
+        stats.spilledBytes = spill.spilledBytes;
+    } else {
+        const std::size_t cursor = slot->cursor.load(std::memory_order_relaxed);
+        stats.lagBytes = head_.load(std::memory_order_acquire) - cursor;
+    }
+    return stats;
+}
+
+BroadcastRing::Slot* BroadcastRing::ConsumerSlot(int id) const noexcept {
+    if (id < 0 || static_cast<std::size_t>(id) >= slotCount_) {
+        return nullptr;
+    }
+    Slot* slot = &slots_[static_cast<std::size_t>(id)];
+    return slot->active.load(std::memory_order_acquire) ? slot : nullptr;
+}
+
+bool BroadcastRing::ReadShared(Slot& slot, std::vector<uint8_t>* payload, std::int64_t* timestampNs) {
+    for (;;) {
+        const std::size_t cursor = slot.cursor.load(std::memory_order_relaxed);
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        if (cursor == head) {
+            return false;
+        }
+        if (head - cursor > capacity_) {
+            SkipTo(slot, cursor, head);
+            continue;
+        }
+
+        uint8_t header[kRecordHeaderBytes];
+        detail::RingCopyOut(storage_.get(), capacity_, cursor, header, sizeof(header));
+        std::uint32_t size = 0;
+        std::memcpy(&size, header, sizeof(size));
+        // A header read from overwritten bytes can claim anything; never trust it past head.
+        const bool fits = size <= head - cursor - sizeof(header);
+        if (fits) {
+            payload->resize(size);
+            detail::RingCopyOut(storage_.get(), capacity_, cursor + sizeof(header), payload->data(), size);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (!fits || reserved_.load(std::memory_order_relaxed) - cursor > capacity_) {
+            SkipTo(slot, cursor, head_.load(std::memory_order_acquire));
+            continue;
+        }
+
+        if (timestampNs != nullptr) {
+            std::memcpy(timestampNs, header + sizeof(size), sizeof(*timestampNs));
+        }
+        slot.cursor.store(cursor + sizeof(header) + size, std::memory_order_relaxed);
+        slot.records.fetch_add(1U, std::memory_order_relaxed);
+        return true;
+    }
+}
+
+void BroadcastRing::SkipTo(Slot& slot, std::size_t cursor, std::size_t head) noexcept {
+    slot.lostBytes.fetch_add(head - cursor, std::memory_order_relaxed);
+    slot.skips.fetch_add(1U, std::memory_order_relaxed);
+    slot.cursor.store(head, std::memory_order_relaxed);
+}
+
+void BroadcastRing::FeedSpillConsumers(std::span<const uint8_t> payload, std::int64_t timestampNs) noexcept {
+    if (spillConsumers_.load(std::memory_order_relaxed) == 0U) {
+        return;
+    }
+    for (std::size_t i = 0; i < slotCount_; ++i) {
+        Slot& slot = slots_[i];
+        if (!slot.active.load(std::memory_order_acquire) || slot.policy.load(std::memory_order_relaxed) != LagPolicy::Spill) {
+            continue;
+        }
+        // Pairs with RemoveConsumer: either it sees busy and waits, or we see inactive.
+        slot.producerBusy.store(true, std::memory_order_seq_cst);
+        if (slot.active.load(std::memory_order_seq_cst)) {
+            slot.spill->WriteRecord(payload, timestampNs);
+        }
+        slot.producerBusy.store(false, std::memory_order_release);
+    }
+}
+
+} // namespace core
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "core/BufferPool.h"
+
+namespace core {
+
+// What happens to a consumer that falls a whole ring behind the producer.
+enum class LagPolicy {
+    Skip,  // Jumps to the newest data; the skipped bytes are counted as lost.
+    Spill, // Gets a private SpillToFile pool that the producer feeds alongside the ring.
+};
+
+struct BroadcastConsumerStats {
+    std::uint64_t records = 0;      // Records delivered.
+    std::size_t lagBytes = 0;       // Published but not yet read (spilled ones included).
+    std::uint64_t lostBytes = 0;    // Payload and header bytes skipped or dropped.
+    std::uint64_t skips = 0;        // Times the consumer was lapped and jumped ahead.
+    std::uint64_t spilledBytes = 0; // Spill: bytes that went through the file.
+};
+
+// Single-producer/multi-consumer ring of timestamped records in the BufferPool record format.
+// The producer never waits for anyone: it overwrites the oldest bytes, and each consumer keeps
+// its own cursor and detects being lapped after copying a record out (the producer announces
+// the range it is about to overwrite before touching it). Spill consumers cost the producer one
+// more copy into their own BasicBufferPool<kDynamicCapacity, SpillToFile>.
+//
+// Consumers may be added and removed from any thread while the producer runs; each consumer id
+// is then read from one thread at a time.
+class BroadcastRing final {
+public:
+    static constexpr std::size_t kRecordHeaderBytes = BufferPool::kRecordHeaderBytes;
+
+    // The capacity is rounded up to a power of two.
+    explicit BroadcastRing(std::size_t capacity, std::size_t maxConsumers = 8);
+    ~BroadcastRing();
+
+    BroadcastRing(const BroadcastRing&) = delete;
+    BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+    // Producer side. False only for a record larger than the ring.
+    bool Publish(std::span<const uint8_t> payload, std::int64_t timestampNs = 0) noexcept;
+
+    // A new consumer starts at the next published record. -1 when every slot is taken or the
+    // spill pool cannot be created.
+    int AddConsumer(LagPolicy policy = LagPolicy::Skip, const SpillToFile& spill = {});
+    void RemoveConsumer(int id);
+
+    // Moves the consumer's next record into payload; false when it has caught up.
+    bool Read(int id, std::vector<uint8_t>* payload, std::int64_t* timestampNs = nullptr);
+
+    [[nodiscard]] std::size_t Capacity() const noexcept;
+    [[nodiscard]] std::uint64_t PublishedRecords() const noexcept;
+    // For a live id; 0s for an unknown one.
+    [[nodiscard]] BroadcastConsumerStats ConsumerStats(int id) const noexcept;
+
+private:
+    static constexpr std::size_t kCacheLine = 64;
+    using SpillPool = BasicBufferPool<kDynamicCapacity, SpillToFile>;
+
+    struct alignas(kCacheLine) Slot {
+        std::atomic<bool> active{false};
+        std::atomic<bool> producerBusy{false}; // Producer is writing into spill.
+        std::atomic<LagPolicy> policy{LagPolicy::Skip};
+        std::unique_ptr<SpillPool> spill;
+        std::atomic<std::size_t> cursor{0};
+        std::atomic<std::uint64_t> records{0};
+        std::atomic<std::uint64_t> lostBytes{0};
+        std::atomic<std::uint64_t> skips{0};
+    };
+
+    [[nodiscard]] Slot* ConsumerSlot(int id) const noexcept;
+    bool ReadShared(Slot& slot, std::vector<uint8_t>* payload, std::int64_t* timestampNs);
+    void SkipTo(Slot& slot, std::size_t cursor, std::size_t head) noexcept;
+    void FeedSpillConsumers(std::span<const uint8_t> payload, std::int64_t timestampNs) noexcept;
+
+    std::size_t capacity_;
+    std::unique_ptr<uint8_t[]> storage_;
+    std::size_t slotCount_;
+    std::unique_ptr<Slot[]> slots_;
+    std::mutex registryMutex_; // Serializes AddConsumer/RemoveConsumer.
+
+    alignas(kCacheLine) std::atomic<std::size_t> head_;    // End of the last published record.
+    std::atomic<std::size_t> reserved_;                     // End of the record being written.
+    std::atomic<std::uint64_t> published_;
+    std::atomic<std::size_t> spillConsumers_;
+};
+
+} // namespace core
@@ -1,84 +1,19 @@
 #include "core/BufferPool.h"
 
-#include <algorithm>
+namespace core::detail {
 
-namespace core {
-
-BufferPool::BufferPool() : head_(0), tail_(0) {
-    ::InitializeCriticalSection(&cs_);
-}
-
-BufferPool::~BufferPool() {
-    ::DeleteCriticalSection(&cs_);
-}
-
-bool BufferPool::Write(const char* buffer, DWORD size) {
-    if (buffer == nullptr || size == 0) {
-        return false;
-    }
-
-    ::EnterCriticalSection(&cs_);
-
-    for (DWORD i = 0; i < size; ++i) {
-        const DWORD next = (head_ + 1U) % kCapacity;
-        if (next == tail_) {
-            DiscardOldest();
-        }
-        data_[head_] = buffer[i];
-        head_ = next;
-    }
-
-    ::LeaveCriticalSection(&cs_);
-    return true;
-}
-
-bool BufferPool::Read(char* buffer, DWORD size, DWORD* readBytes) {
-    return ReadInternal(buffer, size, readBytes, true);
-}
-
-bool BufferPool::Peek(char* buffer, DWORD size, DWORD* readBytes) {
-    return ReadInternal(buffer, size, readBytes, false);
-}
-
-void BufferPool::DiscardOldest() {
-    if (tail_ != head_) {
-        tail_ = (tail_ + 1U) % kCapacity;
-    }
-}
-
-bool BufferPool::ReadInternal(char* buffer, DWORD size, DWORD* readBytes, bool consume) {
-    if (buffer == nullptr || size == 0 || readBytes == nullptr) {
-        return false;
-    }
-
-    *readBytes = 0;
-
-    ::EnterCriticalSection(&cs_);
-
-    DWORD tail = tail_;
-    const DWORD available = SizeLocked();
-    const DWORD toRead = std::min(size, available);
-
-    for (DWORD i = 0; i < toRead; ++i) {
-        buffer[i] = data_[tail];
-        tail = (tail + 1U) % kCapacity;
-    }
-
-    if (consume) {
-        tail_ = tail;
-    }
-
-    *readBytes = toRead;
-
-    ::LeaveCriticalSection(&cs_);
-    return true;
+void RingCopyIn(uint8_t* ring, std::size_t capacity, std::size_t position, const uint8_t* data, std::size_t size) noexcept {
+    const std::size_t offset = position & (capacity - 1U);
+    const std::size_t first = std::min(size, capacity - offset);
+    std::memcpy(ring + offset, data, first);
+    std::memcpy(ring, data + first, size - first);
 }
 
-DWORD BufferPool::SizeLocked() const noexcept {
-    if (head_ >= tail_) {
-        return head_ - tail_;
-    }
-    return kCapacity - (tail_ - head_);
+void RingCopyOut(const uint8_t* ring, std::size_t capacity, std::size_t position, uint8_t* buffer, std::size_t size) noexcept {
+    const std::size_t offset = position & (capacity - 1U);
+    const std::size_t first = std::min(size, capacity - offset);
+    std::memcpy(buffer, ring + offset, first);
+    std::memcpy(buffer + first, ring, size - first);
 }
 
-} // namespace core
\ No newline at end of file
+} // namespace core::detail
@@ -1,34 +1,546 @@
 #pragma once
 
-#include <windows.h>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
-#include <array>
+#include "core/SpillFile.h"
 
 namespace core {
 
-class BufferPool final {
+// StaticCapacity argument of BasicBufferPool meaning "chosen at construction".
+inline constexpr std::size_t kDynamicCapacity = 0;
+
+// Overflow policies: what the producer does with data that does not fit.
+struct DropNewest {}; // Drops the incoming write.
+struct DropOldest {}; // Discards the oldest bytes (or whole records) to make room.
+struct Block {        // Waits for the consumer, then drops the incoming write.
+    std::chrono::microseconds timeout{std::chrono::milliseconds(100)};
+};
+struct SpillToFile {  // Continues into a file used as a second ring, then drops.
+    std::wstring path; // Empty: a new file in the temporary directory.
+    std::uint64_t limitBytes = 256ULL * 1024ULL * 1024ULL;
+};
+
+namespace detail {
+
+// Copies into and out of a ring of power-of-two capacity, split in two where it wraps. Kept out
+// of line: inlined into the pool, the compiler turns these memcpy calls into a slower rep movsb.
+void RingCopyIn(uint8_t* ring, std::size_t capacity, std::size_t position, const uint8_t* data, std::size_t size) noexcept;
+void RingCopyOut(const uint8_t* ring, std::size_t capacity, std::size_t position, uint8_t* buffer, std::size_t size) noexcept;
+
+} // namespace detail
+
+struct BufferPoolStats {
+    std::uint64_t overruns = 0;      // Writes that lost data, new or old.
+    std::uint64_t droppedBytes = 0;  // Payload bytes lost.
+    std::size_t highWaterMark = 0;   // Most bytes seen buffered in memory.
+    std::uint64_t blockedWrites = 0; // Block: writes that had to wait.
+    std::uint64_t spilledBytes = 0;  // SpillToFile: bytes that went through the file.
+};
+
+// Single-producer/single-consumer byte ring. The capacity is a power of two so positions wrap
+// with a mask; head and tail are free-running counters, each on its own cache line next to the
+// producer's or consumer's cached copy of the other one, so the two threads only touch each
+// other's line when the cached value runs out. Data moves with at most two memcpy calls per
+// operation. StaticCapacity fixes the size for an instantiation; kDynamicCapacity takes it from
+// the constructor instead.
+//
+// A pool carries either plain bytes (Write/Read) or records (WriteRecord/ReadRecord), never
+// both: a record is a size and a timestamp followed by the payload, published in one step.
+template <std::size_t StaticCapacity = kDynamicCapacity, typename Policy = DropNewest>
+class BasicBufferPool final {
+    static constexpr bool kDropsOldest = std::is_same_v<Policy, DropOldest>;
+    static constexpr bool kBlocks = std::is_same_v<Policy, Block>;
+    static constexpr bool kSpills = std::is_same_v<Policy, SpillToFile>;
+    static_assert(
+        std::is_same_v<Policy, DropNewest> || kDropsOldest || kBlocks || kSpills,
+        "unknown BufferPool overflow policy");
+
 public:
-    BufferPool();
-    ~BufferPool();
+    static constexpr std::size_t kDefaultCapacity = 64U * 1024U;
+    static constexpr std::size_t kRecordHeaderBytes = sizeof(std::uint32_t) + sizeof(std::int64_t);
+    static_assert(
+        StaticCapacity == kDynamicCapacity || (std::has_single_bit(StaticCapacity) && StaticCapacity > kRecordHeaderBytes),
+        "BufferPool capacity must be a power of two larger than a record header");
+
+    // Dynamic capacity is rounded up to a power of two.
+    explicit BasicBufferPool(std::size_t capacity = kDefaultCapacity, Policy policy = {})
+        requires(StaticCapacity == kDynamicCapacity)
+        : BasicBufferPool(std::bit_ceil(std::max<std::size_t>(capacity, kRecordHeaderBytes + 1U)), std::move(policy), 0) {}
+
+    explicit BasicBufferPool(Policy policy = {})
+        requires(StaticCapacity != kDynamicCapacity)
+        : BasicBufferPool(StaticCapacity, std::move(policy), 0) {}
+
+    BasicBufferPool(const BasicBufferPool&) = delete;
+    BasicBufferPool& operator=(const BasicBufferPool&) = delete;
 
-    BufferPool(const BufferPool&) = delete;
-    BufferPool& operator=(const BufferPool&) = delete;
+    // Producer side. All or nothing unless the policy is DropOldest, which keeps the newest
+    // capacity bytes of an oversized Write.
+    bool Write(const uint8_t* data, std::size_t size) noexcept {
+        if (data == nullptr || size == 0U) {
+            return false;
+        }
+        return Publish({data, size}, nullptr);
+    }
 
-    bool Write(const char* buffer, DWORD size);
-    bool Read(char* buffer, DWORD size, DWORD* readBytes);
-    bool Peek(char* buffer, DWORD size, DWORD* readBytes);
-    void DiscardOldest();
+    bool WriteRecord(std::span<const uint8_t> payload, std::int64_t timestampNs = 0) noexcept {
+        if (payload.size() > std::numeric_limits<std::uint32_t>::max()) {
+            CountDrop(payload.size());
+            return false;
+        }
+        uint8_t header[kRecordHeaderBytes];
+        const auto size = static_cast<std::uint32_t>(payload.size());
+        std::memcpy(header, &size, sizeof(size));
+        std::memcpy(header + sizeof(size), &timestampNs, sizeof(timestampNs));
+        return Publish(payload, header);
+    }
+
+    // Consumer side; each returns the bytes it took.
+    std::size_t Read(uint8_t* buffer, std::size_t size) noexcept {
+        if (buffer == nullptr || size == 0U) {
+            return 0;
+        }
+        const std::size_t count = ReadRing(buffer, size);
+        if constexpr (kSpills) {
+            if (count < size) {
+                return count + ReadSpill(buffer + count, size - count);
+            }
+        }
+        return count;
+    }
+
+    [[nodiscard]] std::size_t Peek(uint8_t* buffer, std::size_t size) const noexcept {
+        if (buffer == nullptr || size == 0U) {
+            return 0;
+        }
+        for (;;) {
+            const std::size_t tail = tail_.load(kDropsOldest ? std::memory_order_acquire : std::memory_order_relaxed);
+            const std::size_t count = std::min(size, head_.load(std::memory_order_acquire) - tail);
+            CopyOut(tail, buffer, count);
+            if constexpr (!kDropsOldest) {
+                return count;
+            } else {
+                // Seqlock check: the fence keeps the copy before the reload, pairing with the
+                // release fence in MakeRoom.
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (tail_.load(std::memory_order_relaxed) == tail) {
+                    readTail_ = tail;
+                    return count;
+                }
+            }
+        }
+    }
+
+    // Skips buffered bytes in memory; spilled data is only reachable through Read. Under
+    // DropOldest it skips from where the last Peek began and returns 0 if the producer has
+    // discarded those bytes since: they are already counted as dropped, and the bytes now at
+    // tail were never seen. Peek again then.
+    std::size_t Discard(std::size_t size) noexcept {
+        const std::size_t tail = kDropsOldest ? readTail_ : tail_.load(std::memory_order_relaxed);
+        const std::size_t count = std::min(size, RefreshHead(tail, size) - tail);
+        return CommitRead(tail, tail + count) ? count : 0U;
+    }
+
+    // Moves the oldest record into payload (resized to fit); false when there is none.
+    bool ReadRecord(std::vector<uint8_t>* payload, std::int64_t* timestampNs = nullptr) {
+        if (ReadRingRecord(payload, timestampNs)) {
+            return true;
+        }
+        if constexpr (kSpills) {
+            return ReadSpillRecord(payload, timestampNs);
+        }
+        return false;
+    }
+
+    [[nodiscard]] std::size_t Capacity() const noexcept {
+        return CapacityValue();
+    }
+
+    // Bytes waiting, spilled ones included. Exact on the producer or consumer thread, a snapshot
+    // anywhere else.
+    [[nodiscard]] std::size_t Size() const noexcept {
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        const std::size_t ring = head_.load(std::memory_order_acquire) - tail;
+        const std::uint64_t spillTail = spillTail_.load(std::memory_order_acquire);
+        return ring + static_cast<std::size_t>(spillHead_.load(std::memory_order_acquire) - spillTail);
+    }
+
+    [[nodiscard]] std::uint64_t Overruns() const noexcept {
+        return overruns_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::uint64_t DroppedBytes() const noexcept {
+        return droppedBytes_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::size_t HighWaterMark() const noexcept {
+        return highWater_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] BufferPoolStats Stats() const noexcept {
+        BufferPoolStats stats;
+        stats.overruns = Overruns();
+        stats.droppedBytes = DroppedBytes();
+        stats.highWaterMark = HighWaterMark();
+        stats.blockedWrites = blockedWrites_.load(std::memory_order_relaxed);
+        stats.spilledBytes = spilledBytes_.load(std::memory_order_relaxed);
+        return stats;
+    }
 
 private:
-    static constexpr DWORD kCapacity = 65536;
+    static constexpr std::size_t kCacheLine = 64;
+    static constexpr unsigned kBlockSpins = 64;
+
+    BasicBufferPool(std::size_t capacity, Policy policy, int)
+        : policy_(std::move(policy)),
+          capacity_(capacity),
+          storage_(std::make_unique<uint8_t[]>(capacity)),
+          head_(0),
+          cachedTail_(0),
+          spillHead_(0),
+          spillFailed_(false),
+          tail_(0),
+          cachedHead_(0),
+          readTail_(0),
+          spillTail_(0),
+          overruns_(0),
+          droppedBytes_(0),
+          highWater_(0),
+          blockedWrites_(0),
+          spilledBytes_(0) {}
+
+    [[nodiscard]] constexpr std::size_t CapacityValue() const noexcept {
+        if constexpr (StaticCapacity == kDynamicCapacity) {
+            return capacity_;
+        } else {
+            return StaticCapacity;
+        }
+    }
 
-    bool ReadInternal(char* buffer, DWORD size, DWORD* readBytes, bool consume);
-    [[nodiscard]] DWORD SizeLocked() const noexcept;
+    bool Publish(std::span<const uint8_t> payload, const uint8_t* header) noexcept {
+        const std::size_t headerBytes = header != nullptr ? kRecordHeaderBytes : 0U;
+        std::size_t total = headerBytes + payload.size();
+        const std::size_t head = head_.load(std::memory_order_relaxed);
 
-    CRITICAL_SECTION cs_;
-    std::array<char, kCapacity> data_;
-    DWORD head_;
-    DWORD tail_;
+        if constexpr (kDropsOldest) {
+            if (total > CapacityValue()) {
+                if (header != nullptr) {
+                    CountDrop(payload.size());
+                    return false;
+                }
+                CountDrop(payload.size() - CapacityValue());
+                payload = payload.last(CapacityValue());
+                total = CapacityValue();
+            }
+            MakeRoom(head, total, header != nullptr);
+        } else if constexpr (kBlocks) {
+            if (!HasRoom(head, total) && !WaitForRoom(head, total)) {
+                CountDrop(payload.size());
+                return false;
+            }
+        } else if constexpr (kSpills) {
+            // Once anything is in the file, later data follows it there to keep the order.
+            if (spillHead_.load(std::memory_order_relaxed) != spillTail_.load(std::memory_order_acquire) ||
+                !HasRoom(head, total)) {
+                return Spill(payload, header);
+            }
+        } else {
+            if (!HasRoom(head, total)) {
+                CountDrop(payload.size());
+                return false;
+            }
+        }
+
+        if (header != nullptr) {
+            CopyIn(head, header, headerBytes);
+        }
+        CopyIn(head + headerBytes, payload.data(), payload.size());
+        head_.store(head + total, std::memory_order_release);
+        return true;
+    }
+
+    // Room for size bytes at head, refreshing the cached tail only when needed.
+    [[nodiscard]] bool HasRoom(std::size_t head, std::size_t size) noexcept {
+        if (CapacityValue() - (head - cachedTail_) >= size) {
+            return true;
+        }
+        cachedTail_ = tail_.load(std::memory_order_acquire);
+        NoteLevel(head - cachedTail_);
+        return CapacityValue() - (head - cachedTail_) >= size;
+    }
+
+    [[nodiscard]] bool WaitForRoom(std::size_t head, std::size_t size) noexcept {
+        if (size > CapacityValue()) {
+            return false;
+        }
+        blockedWrites_.fetch_add(1U, std::memory_order_relaxed);
+        const auto deadline = std::chrono::steady_clock::now() + policy_.timeout;
+        for (unsigned spin = 0; !HasRoom(head, size); ++spin) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            if (spin < kBlockSpins) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+        return true;
+    }
+
+    // DropOldest: the producer moves tail itself, racing the consumer with compare-exchange.
+    // Records are discarded whole; the header at tail is always intact because only the
+    // producer writes the storage.
+    void MakeRoom(std::size_t head, std::size_t size, bool records) noexcept {
+        if (CapacityValue() - (head - cachedTail_) >= size) {
+            return;
+        }
+        std::size_t tail = tail_.load(std::memory_order_acquire);
+        bool discarded = false;
+        while (CapacityValue() - (head - tail) < size) {
+            std::size_t step = size - (CapacityValue() - (head - tail));
+            std::size_t lost = step;
+            if (records) {
+                std::uint32_t recordSize = 0;
+                CopyOut(tail, reinterpret_cast<uint8_t*>(&recordSize), sizeof(recordSize));
+                step = kRecordHeaderBytes + recordSize;
+                lost = recordSize;
+            }
+            if (tail_.compare_exchange_weak(tail, tail + step, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                tail += step;
+                droppedBytes_.fetch_add(lost, std::memory_order_relaxed);
+                discarded = true;
+            }
+        }
+        if (discarded) {
+            overruns_.fetch_add(1U, std::memory_order_relaxed);
+            NoteLevel(head + size - tail);
+            // Publish's CopyIn overwrites what was just discarded; a Peek that copies any of it
+            // then sees the moved tail after its acquire fence.
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+        cachedTail_ = tail;
+    }
+
+    // Head as seen by the consumer, reloaded when the cached value holds fewer than wanted bytes.
+    std::size_t RefreshHead(std::size_t tail, std::size_t wanted) noexcept {
+        if (kDropsOldest || cachedHead_ - tail < wanted) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            NoteLevel(cachedHead_ - tail);
+        }
+        return cachedHead_;
+    }
+
+    // Moves tail past a finished read. Under DropOldest the producer may have discarded the
+    // bytes meanwhile (and started overwriting them), so the copy only counts if tail is
+    // still where the read began.
+    bool CommitRead(std::size_t tail, std::size_t newTail) noexcept {
+        if constexpr (kDropsOldest) {
+            std::size_t expected = tail;
+            const bool committed =
+                tail_.compare_exchange_strong(expected, newTail, std::memory_order_acq_rel, std::memory_order_acquire);
+            readTail_ = committed ? newTail : expected;
+            return committed;
+        } else {
+            tail_.store(newTail, std::memory_order_release);
+            return true;
+        }
+    }
+
+    std::size_t ReadRing(uint8_t* buffer, std::size_t size) noexcept {
+        for (;;) {
+            const std::size_t tail = tail_.load(kDropsOldest ? std::memory_order_acquire : std::memory_order_relaxed);
+            const std::size_t count = std::min(size, RefreshHead(tail, size) - tail);
+            CopyOut(tail, buffer, count);
+            if (CommitRead(tail, tail + count)) {
+                return count;
+            }
+        }
+    }
+
+    bool ReadRingRecord(std::vector<uint8_t>* payload, std::int64_t* timestampNs) {
+        for (;;) {
+            const std::size_t tail = tail_.load(kDropsOldest ? std::memory_order_acquire : std::memory_order_relaxed);
+            const std::size_t available = RefreshHead(tail, kRecordHeaderBytes) - tail;
+            if (available < kRecordHeaderBytes) {
+                return false;
+            }
+
+            // The producer publishes header and payload together, so the whole record is visible.
+            uint8_t header[kRecordHeaderBytes];
+            CopyOut(tail, header, sizeof(header));
+            std::uint32_t size = 0;
+            std::memcpy(&size, header, sizeof(size));
+            if (kDropsOldest && sizeof(header) + size > available) {
+                continue; // Header overwritten under us: tail has moved.
+            }
+            payload->resize(size);
+            CopyOut(tail + sizeof(header), payload->data(), size);
+            if (CommitRead(tail, tail + sizeof(header) + size)) {
+                if (timestampNs != nullptr) {
+                    std::memcpy(timestampNs, header + sizeof(size), sizeof(*timestampNs));
+                }
+                return true;
+            }
+        }
+    }
+
+    bool Spill(std::span<const uint8_t> payload, const uint8_t* header) noexcept {
+        const std::size_t headerBytes = header != nullptr ? kRecordHeaderBytes : 0U;
+        const std::uint64_t total = headerBytes + payload.size();
+        const std::uint64_t spillHead = spillHead_.load(std::memory_order_relaxed);
+        if (policy_.limitBytes - (spillHead - spillTail_.load(std::memory_order_acquire)) < total || !OpenSpill() ||
+            (header != nullptr && !SpillWrite(spillHead, header, headerBytes)) ||
+            !SpillWrite(spillHead + headerBytes, payload.data(), payload.size())) {
+            CountDrop(payload.size());
+            return false;
+        }
+        spillHead_.store(spillHead + total, std::memory_order_release);
+        spilledBytes_.fetch_add(total, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Opened on first use, so pools that never overflow leave no file behind.
+    bool OpenSpill() noexcept {
+        if (spill_.IsOpen()) {
+            return true;
+        }
+        if (spillFailed_) {
+            return false;
+        }
+        try {
+            spillFailed_ = !spill_.Open(policy_.path);
+        } catch (const std::exception&) {
+            spillFailed_ = true;
+        }
+        return !spillFailed_;
+    }
+
+    // The file is a ring of limitBytes, addressed like the memory one.
+    bool SpillWrite(std::uint64_t position, const uint8_t* data, std::size_t size) noexcept {
+        const std::uint64_t offset = position % policy_.limitBytes;
+        const auto first = static_cast<std::size_t>(std::min<std::uint64_t>(size, policy_.limitBytes - offset));
+        return spill_.WriteAt(offset, data, first) && spill_.WriteAt(0, data + first, size - first);
+    }
+
+    bool SpillRead(std::uint64_t position, uint8_t* buffer, std::size_t size) const noexcept {
+        const std::uint64_t offset = position % policy_.limitBytes;
+        const auto first = static_cast<std::size_t>(std::min<std::uint64_t>(size, policy_.limitBytes - offset));
+        return spill_.ReadAt(offset, buffer, first) && spill_.ReadAt(0, buffer + first, size - first);
+    }
+
+    // Memory data is always older than spilled data: the producer only writes to memory while
+    // the file is empty. Seeing the file's head also makes every earlier memory write visible,
+    // so the consumer checks memory once more before taking from the file.
+    [[nodiscard]] bool SpillReady(std::uint64_t spillTail, std::uint64_t* spillHead) noexcept {
+        *spillHead = spillHead_.load(std::memory_order_acquire);
+        return *spillHead != spillTail && head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_relaxed);
+    }
+
+    // A failed file read loses everything spilled so far.
+    void DropSpill(std::uint64_t spillTail, std::uint64_t spillHead) noexcept {
+        CountDrop(static_cast<std::size_t>(spillHead - spillTail));
+        spillTail_.store(spillHead, std::memory_order_release);
+    }
+
+    std::size_t ReadSpill(uint8_t* buffer, std::size_t size) noexcept {
+        const std::uint64_t spillTail = spillTail_.load(std::memory_order_relaxed);
+        std::uint64_t spillHead = 0;
+        if (!SpillReady(spillTail, &spillHead)) {
+            return 0;
+        }
+        const auto count = static_cast<std::size_t>(std::min<std::uint64_t>(size, spillHead - spillTail));
+        if (!SpillRead(spillTail, buffer, count)) {
+            DropSpill(spillTail, spillHead);
+            return 0;
+        }
+        spillTail_.store(spillTail + count, std::memory_order_release);
+        return count;
+    }
+
+    bool ReadSpillRecord(std::vector<uint8_t>* payload, std::int64_t* timestampNs) {
+        const std::uint64_t spillTail = spillTail_.load(std::memory_order_relaxed);
+        std::uint64_t spillHead = 0;
+        if (!SpillReady(spillTail, &spillHead)) {
+            // Either nothing is spilled or a memory record arrived first.
+            return spillHead != spillTail && ReadRingRecord(payload, timestampNs);
+        }
+
+        uint8_t header[kRecordHeaderBytes];
+        if (!SpillRead(spillTail, header, sizeof(header))) {
+            DropSpill(spillTail, spillHead);
+            return false;
+        }
+        std::uint32_t size = 0;
+        std::memcpy(&size, header, sizeof(size));
+        payload->resize(size);
+        if (!SpillRead(spillTail + sizeof(header), payload->data(), size)) {
+            DropSpill(spillTail, spillHead);
+            return false;
+        }
+        if (timestampNs != nullptr) {
+            std::memcpy(timestampNs, header + sizeof(size), sizeof(*timestampNs));
+        }
+        spillTail_.store(spillTail + sizeof(header) + size, std::memory_order_release);
+        return true;
+    }
+
+    void CopyIn(std::size_t position, const uint8_t* data, std::size_t size) noexcept {
+        detail::RingCopyIn(storage_.get(), CapacityValue(), position, data, size);
+    }
+
+    void CopyOut(std::size_t position, uint8_t* buffer, std::size_t size) const noexcept {
+        detail::RingCopyOut(storage_.get(), CapacityValue(), position, buffer, size);
+    }
+
+    void CountDrop(std::size_t size) noexcept {
+        overruns_.fetch_add(1U, std::memory_order_relaxed);
+        droppedBytes_.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    // Both sides report the fill level whenever they reload the other's counter.
+    void NoteLevel(std::size_t level) noexcept {
+        std::size_t seen = highWater_.load(std::memory_order_relaxed);
+        while (level > seen && !highWater_.compare_exchange_weak(seen, level, std::memory_order_relaxed)) {
+        }
+    }
+
+    Policy policy_;
+    std::size_t capacity_;
+    std::unique_ptr<uint8_t[]> storage_;
+    SpillFile spill_;
+
+    alignas(kCacheLine) std::atomic<std::size_t> head_;
+    std::size_t cachedTail_; // Producer's view of tail_.
+    std::atomic<std::uint64_t> spillHead_;
+    bool spillFailed_;
+    alignas(kCacheLine) std::atomic<std::size_t> tail_;
+    std::size_t cachedHead_; // Consumer's view of head_.
+    // DropOldest: where the consumer's last read ended or its last Peek began.
+    mutable std::size_t readTail_;
+    std::atomic<std::uint64_t> spillTail_;
+    alignas(kCacheLine) std::atomic<std::uint64_t> overruns_;
+    std::atomic<std::uint64_t> droppedBytes_;
+    std::atomic<std::size_t> highWater_;
+    std::atomic<std::uint64_t> blockedWrites_;
+    std::atomic<std::uint64_t> spilledBytes_;
 };
 
-} // namespace core
\ No newline at end of file
+// Run-time capacity, drops what does not fit.
+using BufferPool = BasicBufferPool<>;
+
+} // namespace core
@@ -0,0 +1,127 @@
+#include "core/Clock.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace {
+
+constexpr std::int64_t kNanosPerSecond = 1000000000;
+constexpr std::int64_t kRecalibrateIntervalNs = 10 * kNanosPerSecond;
+// Larger disagreements mean the system clock was set, not that it drifted: start over.
+constexpr std::int64_t kStepThresholdNs = kNanosPerSecond;
+constexpr double kMaxRateCorrection = 500e-6;
+constexpr int kCalibrationTries = 5;
+
+#ifdef _WIN32
+// FILETIME counts 100 ns ticks since 1601-01-01.
+constexpr std::int64_t kFileTimeToUnixTicks = 116444736000000000LL;
+
+std::int64_t PerformanceFrequency() noexcept {
+    LARGE_INTEGER frequency{};
+    ::QueryPerformanceFrequency(&frequency);
+    return frequency.QuadPart;
+}
+#endif
+
+} // namespace
+
+namespace core {
+
+std::int64_t MonotonicNanos() noexcept {
+#ifdef _WIN32
+    static const std::int64_t frequency = PerformanceFrequency();
+    LARGE_INTEGER counter{};
+    ::QueryPerformanceCounter(&counter);
+    // Split to keep counter * 1e9 from overflowing.
+    const std::int64_t seconds = counter.QuadPart / frequency;
+    const std::int64_t remainder = counter.QuadPart % frequency;
+    return seconds * kNanosPerSecond + remainder * kNanosPerSecond / frequency;
+#else
+    timespec now{};
+    ::clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<std::int64_t>(now.tv_sec) * kNanosPerSecond + now.tv_nsec;
+#endif
+}
+
+std::int64_t WallNanos() noexcept {
+#ifdef _WIN32
+    FILETIME fileTime{};
+    ::GetSystemTimePreciseAsFileTime(&fileTime);
+    const std::int64_t ticks =
+        (static_cast<std::int64_t>(fileTime.dwHighDateTime) << 32) | fileTime.dwLowDateTime;
+    return (ticks - kFileTimeToUnixTicks) * 100;
+#else
+    timespec now{};
+    ::clock_gettime(CLOCK_REALTIME, &now);
+    return static_cast<std::int64_t>(now.tv_sec) * kNanosPerSecond + now.tv_nsec;
+#endif
+}
+
+WallClockMapper::WallClockMapper() : anchor_(TakeSample()), rate_(1.0), lastSample_(anchor_) {}
+
+std::int64_t WallClockMapper::ToWallNanos(std::int64_t monotonicNanos) {
+    if (MonotonicNanos() - anchor_.monotonic >= kRecalibrateIntervalNs) {
+        Recalibrate();
+    }
+    return Map(monotonicNanos);
+}
+
+void WallClockMapper::Recalibrate() {
+    const Sample sample = TakeSample();
+    const std::int64_t error = sample.wall - Map(sample.monotonic);
+    const std::int64_t elapsed = sample.monotonic - lastSample_.monotonic;
+
+    if (std::llabs(error) >= kStepThresholdNs || elapsed <= 0) {
+        anchor_ = sample;
+        rate_ = 1.0;
+        lastSample_ = sample;
+        return;
+    }
+    if (elapsed < kNanosPerSecond) {
+        // Too short for a meaningful frequency estimate.
+        return;
+    }
+
+    // Frequency from the raw samples, plus a phase term that pays the current error off over the
+    // next interval. The new anchor sits on the old line, so mapped stamps never jump.
+    const double frequency = static_cast<double>(sample.wall - lastSample_.wall) / static_cast<double>(elapsed);
+    const double phase = static_cast<double>(error) / static_cast<double>(kRecalibrateIntervalNs);
+    anchor_ = Sample{sample.monotonic, Map(sample.monotonic)};
+    rate_ = std::clamp(frequency + phase, 1.0 - kMaxRateCorrection, 1.0 + kMaxRateCorrection);
+    lastSample_ = sample;
+}
+
+double WallClockMapper::DriftPpm() const noexcept {
+    return (rate_ - 1.0) * 1e6;
+}
+
+WallClockMapper::Sample WallClockMapper::TakeSample() noexcept {
+    // Bracket the wall-clock read between two monotonic reads and keep the tightest bracket,
+    // so a preemption in the middle does not skew the pair.
+    Sample best{};
+    std::int64_t bestWidth = -1;
+    for (int i = 0; i < kCalibrationTries; ++i) {
+        const std::int64_t before = MonotonicNanos();
+        const std::int64_t wall = WallNanos();
+        const std::int64_t after = MonotonicNanos();
+        if (bestWidth < 0 || after - before < bestWidth) {
+            bestWidth = after - before;
+            best = Sample{before + (after - before) / 2, wall};
+        }
+    }
+    return best;
+}
+
+std::int64_t WallClockMapper::Map(std::int64_t monotonicNanos) const noexcept {
+    const double delta = static_cast<double>(monotonicNanos - anchor_.monotonic) * rate_;
+    return anchor_.wall + static_cast<std::int64_t>(std::llround(delta));
+}
+
+} // namespace core
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+namespace core {
+
+// Nanoseconds on the monotonic clock (QueryPerformanceCounter / CLOCK_MONOTONIC). Cheap enough
+// to stamp every chunk on the read path; the epoch is arbitrary.
+std::int64_t MonotonicNanos() noexcept;
+
+// Nanoseconds since the Unix epoch (GetSystemTimePreciseAsFileTime / CLOCK_REALTIME).
+std::int64_t WallNanos() noexcept;
+
+// Converts monotonic stamps to wall-clock time. Periodic recalibration steers the mapping towards
+// the system clock by adjusting its rate instead of stepping it, so converted stamps stay
+// monotonic and intervals between them stay accurate. Not thread-safe.
+class WallClockMapper final {
+public:
+    WallClockMapper();
+
+    [[nodiscard]] std::int64_t ToWallNanos(std::int64_t monotonicNanos);
+    void Recalibrate();
+
+    // Current rate correction in parts per million, for diagnostics.
+    [[nodiscard]] double DriftPpm() const noexcept;
+
+private:
+    struct Sample {
+        std::int64_t monotonic;
+        std::int64_t wall;
+    };
+
+    static Sample TakeSample() noexcept;
+    [[nodiscard]] std::int64_t Map(std::int64_t monotonicNanos) const noexcept;
+
+    Sample anchor_;     // Mapping passes through this point...
+    double rate_;       // ...with this many wall nanoseconds per monotonic nanosecond.
+    Sample lastSample_; // Raw sample from the previous calibration, for the frequency estimate.
+};
+
+} // namespace core
@@ -1,7 +1,63 @@
 #include "core/Crc.h"
 
+#include "core/CrcHardware.h"
+#include "core/CrcModel.h"
+
 namespace {
 
+// Entry points of the compile-time CRCs behind each CrcAlgorithm.
+struct AlgorithmOps {
+    std::uint32_t initRegister;
+    std::uint32_t xorOut;
+    std::uint32_t (*table)(std::uint32_t crc, const uint8_t* data, std::size_t size) noexcept;
+    std::uint32_t (*sliceBy8)(std::uint32_t crc, const uint8_t* data, std::size_t size) noexcept;
+};
+
+// CrcState keeps a reflected register, so finalizing is just the xor.
+template <core::CrcModel Model>
+constexpr AlgorithmOps MakeOps() noexcept {
+    static_assert(Model.reflectIn && Model.reflectOut, "CrcState expects a reflected CRC");
+    return {core::Crc<Model>::kInitRegister, Model.xorOut, &core::Crc<Model>::UpdateBytewise, &core::Crc<Model>::Update};
+}
+
+constexpr AlgorithmOps kCrc8Ops = MakeOps<core::kCrc8MaximDow>();
+constexpr AlgorithmOps kCrc16Ops = MakeOps<core::kCrc16Arc>();
+constexpr AlgorithmOps kCrc32Ops = MakeOps<core::kCrc32IsoHdlc>();
+constexpr AlgorithmOps kCrc32cOps = MakeOps<core::kCrc32Iscsi>();
+
+const AlgorithmOps& Ops(core::CrcAlgorithm algorithm) noexcept {
+    switch (algorithm) {
+    case core::CrcAlgorithm::Crc8Dallas:
+        return kCrc8Ops;
+    case core::CrcAlgorithm::Crc16Ibm:
+        return kCrc16Ops;
+    case core::CrcAlgorithm::Crc32c:
+        return kCrc32cOps;
+    case core::CrcAlgorithm::Crc32IsoHdlc:
+        break;
+    }
+    return kCrc32Ops;
+}
+
+// Folds the 16-byte multiples; the tail goes through the tables.
+std::uint32_t UpdateClmul(core::CrcAlgorithm algorithm, const AlgorithmOps& ops, std::uint32_t crc, const uint8_t* data,
+                          std::size_t size) noexcept {
+    if (size >= core::detail::kClmulMinBytes) {
+        const std::size_t bulk = size & ~std::size_t{15};
+        const core::detail::ClmulConstants& constants =
+            algorithm == core::CrcAlgorithm::Crc32c ? core::detail::kClmulCrc32c : core::detail::kClmulCrc32IsoHdlc;
+        crc = core::detail::FoldClmul(constants, crc, data, bulk);
+        data += bulk;
+        size -= bulk;
+    }
+    return ops.sliceBy8(crc, data, size);
+}
+
+std::uint32_t UpdateInstruction(core::CrcAlgorithm algorithm, std::uint32_t crc, const uint8_t* data, std::size_t size) noexcept {
+    return algorithm == core::CrcAlgorithm::Crc32c ? core::detail::Crc32cInstruction(crc, data, size)
+                                                   : core::detail::Crc32Instruction(crc, data, size);
+}
+
 uint8_t Reflect8(uint8_t value) noexcept {
     uint8_t result = 0;
     for (int i = 0; i < 8; ++i) {
@@ -32,11 +88,36 @@ uint32_t Reflect32(uint32_t value) noexcept {
     return result;
 }
 
+std::uint32_t OneShot(core::CrcAlgorithm algorithm, const uint8_t* data, std::size_t size) noexcept {
+    if (data == nullptr || size == 0U) {
+        return 0U;
+    }
+    core::CrcState state(algorithm);
+    state.Update(data, size);
+    return state.Finalize();
+}
+
 } // namespace
 
 namespace core {
 
 uint8_t Crc8Dallas(const uint8_t* data, std::size_t size) noexcept {
+    return data == nullptr || size == 0U ? 0U : Crc<kCrc8MaximDow>::Compute(data, size);
+}
+
+uint16_t Crc16Ibm(const uint8_t* data, std::size_t size) noexcept {
+    return data == nullptr || size == 0U ? 0U : Crc<kCrc16Arc>::Compute(data, size);
+}
+
+uint32_t Crc32IsoHdlc(const uint8_t* data, std::size_t size) noexcept {
+    return OneShot(CrcAlgorithm::Crc32IsoHdlc, data, size);
+}
+
+uint32_t Crc32c(const uint8_t* data, std::size_t size) noexcept {
+    return OneShot(CrcAlgorithm::Crc32c, data, size);
+}
+
+uint8_t Crc8DallasBitwise(const uint8_t* data, std::size_t size) noexcept {
     if (data == nullptr || size == 0U) {
         return 0U;
     }
@@ -56,7 +137,7 @@ uint8_t Crc8Dallas(const uint8_t* data, std::size_t size) noexcept {
     return Reflect8(crc);
 }
 
-uint16_t Crc16Ibm(const uint8_t* data, std::size_t size) noexcept {
+uint16_t Crc16IbmBitwise(const uint8_t* data, std::size_t size) noexcept {
     if (data == nullptr || size == 0U) {
         return 0U;
     }
@@ -76,7 +157,7 @@ uint16_t Crc16Ibm(const uint8_t* data, std::size_t size) noexcept {
     return Reflect16(crc);
 }
 
-uint32_t Crc32IsoHdlc(const uint8_t* data, std::size_t size) noexcept {
+uint32_t Crc32IsoHdlcBitwise(const uint8_t* data, std::size_t size) noexcept {
     if (data == nullptr || size == 0U) {
         return 0U;
     }
@@ -98,4 +179,97 @@ uint32_t Crc32IsoHdlc(const uint8_t* data, std::size_t size) noexcept {
     return crc ^ 0xFFFFFFFFU;
 }
 
-} // namespace core
\ No newline at end of file
+uint32_t Crc32cBitwise(const uint8_t* data, std::size_t size) noexcept {
+    if (data == nullptr || size == 0U) {
+        return 0U;
+    }
+
+    uint32_t crc = 0xFFFFFFFFU;
+    for (std::size_t i = 0; i < size; ++i) {
+        uint32_t current = Reflect8(data[i]);
+        crc ^= (current << 24U);
+        for (int bit = 0; bit < 8; ++bit) {
+            const bool msb = (crc & 0x80000000U) != 0U;
+            crc <<= 1U;
+            if (msb) {
+                crc ^= 0x1EDC6F41U;
+            }
+        }
+    }
+
+    crc = Reflect32(crc);
+    return crc ^ 0xFFFFFFFFU;
+}
+
+bool CrcMethodSupported(CrcAlgorithm algorithm, CrcMethod method) noexcept {
+    const bool crc32 = algorithm == CrcAlgorithm::Crc32IsoHdlc || algorithm == CrcAlgorithm::Crc32c;
+    const detail::CrcCpuFeatures& cpu = detail::CrcFeatures();
+    switch (method) {
+    case CrcMethod::Table:
+    case CrcMethod::SliceBy8:
+    case CrcMethod::Best:
+        return true;
+    case CrcMethod::Clmul:
+        return crc32 && cpu.clmul;
+    case CrcMethod::Instruction:
+        return algorithm == CrcAlgorithm::Crc32c ? cpu.crc32c : algorithm == CrcAlgorithm::Crc32IsoHdlc && cpu.crc32;
+    }
+    return false;
+}
+
+CrcState::CrcState(CrcAlgorithm algorithm, CrcMethod method) noexcept
+    : algorithm_(algorithm), method_(CrcMethodSupported(algorithm, method) ? method : CrcMethod::SliceBy8),
+      crc_(Ops(algorithm).initRegister) {}
+
+void CrcState::Reset() noexcept {
+    crc_ = Ops(algorithm_).initRegister;
+}
+
+void CrcState::Update(std::span<const uint8_t> data) noexcept {
+    Update(data.data(), data.size());
+}
+
+void CrcState::Update(const uint8_t* data, std::size_t size) noexcept {
+    if (data == nullptr || size == 0U) {
+        return;
+    }
+    const AlgorithmOps& ops = Ops(algorithm_);
+    switch (method_) {
+    case CrcMethod::Table:
+        crc_ = ops.table(crc_, data, size);
+        return;
+    case CrcMethod::SliceBy8:
+        break;
+    case CrcMethod::Clmul:
+        crc_ = UpdateClmul(algorithm_, ops, crc_, data, size);
+        return;
+    case CrcMethod::Instruction:
+        crc_ = UpdateInstruction(algorithm_, crc_, data, size);
+        return;
+    case CrcMethod::Best:
+        if (size >= detail::kClmulMinBytes && CrcMethodSupported(algorithm_, CrcMethod::Clmul)) {
+            crc_ = UpdateClmul(algorithm_, ops, crc_, data, size);
+            return;
+        }
+        if (CrcMethodSupported(algorithm_, CrcMethod::Instruction)) {
+            crc_ = UpdateInstruction(algorithm_, crc_, data, size);
+            return;
+        }
+        break;
+    }
+    crc_ = ops.sliceBy8(crc_, data, size);
+}
+
+std::uint32_t CrcState::Finalize() const noexcept {
+    return crc_ ^ Ops(algorithm_).xorOut;
+}
+
+CrcAlgorithm CrcState::Algorithm() const noexcept {
+    return algorithm_;
+}
+
+CrcMethod CrcState::Method() const noexcept {
+    return method_;
+}
+
+} // namespace core
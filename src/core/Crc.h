@@ -2,11 +2,60 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <span>
 
 namespace core {
 
+enum class CrcAlgorithm {
+    Crc8Dallas,   // CRC-8/MAXIM-DOW: poly 0x31, reflected, init 0.
+    Crc16Ibm,     // CRC-16/ARC: poly 0x8005, reflected, init 0.
+    Crc32IsoHdlc, // CRC-32/ISO-HDLC: poly 0x04C11DB7, reflected, init and xorout 0xFFFFFFFF.
+    Crc32c,       // CRC-32/ISCSI (Castagnoli): poly 0x1EDC6F41, reflected, init and xorout 0xFFFFFFFF.
+};
+
+enum class CrcMethod {
+    Table,       // One table lookup per byte.
+    SliceBy8,    // Eight bytes per step through eight tables.
+    Clmul,       // Carry-less multiply folding (PCLMULQDQ, PMULL); 32-bit CRCs only.
+    Instruction, // CPU CRC instruction: SSE4.2 for CRC-32C, ARMv8 CRC32 for both 32-bit CRCs.
+    Best,        // Clmul for large updates, else Instruction, else SliceBy8.
+};
+
+// One-shot CRCs of a complete buffer, with CrcMethod::Best.
 uint8_t Crc8Dallas(const uint8_t* data, std::size_t size) noexcept;
 uint16_t Crc16Ibm(const uint8_t* data, std::size_t size) noexcept;
 uint32_t Crc32IsoHdlc(const uint8_t* data, std::size_t size) noexcept;
+uint32_t Crc32c(const uint8_t* data, std::size_t size) noexcept;
+
+// Reference implementations, one bit per step; the table-driven ones must match them.
+uint8_t Crc8DallasBitwise(const uint8_t* data, std::size_t size) noexcept;
+uint16_t Crc16IbmBitwise(const uint8_t* data, std::size_t size) noexcept;
+uint32_t Crc32IsoHdlcBitwise(const uint8_t* data, std::size_t size) noexcept;
+uint32_t Crc32cBitwise(const uint8_t* data, std::size_t size) noexcept;
+
+// Whether this CPU and build can run the method for the algorithm. Table, SliceBy8 and Best
+// always can.
+[[nodiscard]] bool CrcMethodSupported(CrcAlgorithm algorithm, CrcMethod method) noexcept;
+
+// CRC carried across chunks: Update() with each chunk in stream order, Finalize() for the
+// value of everything so far (Update() may continue afterwards). An unsupported method falls
+// back to SliceBy8.
+class CrcState final {
+public:
+    explicit CrcState(CrcAlgorithm algorithm, CrcMethod method = CrcMethod::Best) noexcept;
+
+    void Reset() noexcept;
+    void Update(std::span<const uint8_t> data) noexcept;
+    void Update(const uint8_t* data, std::size_t size) noexcept;
+    [[nodiscard]] std::uint32_t Finalize() const noexcept;
+
+    [[nodiscard]] CrcAlgorithm Algorithm() const noexcept;
+    [[nodiscard]] CrcMethod Method() const noexcept;
+
+private:
+    CrcAlgorithm algorithm_;
+    CrcMethod method_;
+    std::uint32_t crc_; // Reflected register, before the final xor.
+};
 
-} // namespace core
\ No newline at end of file
+} // namespace core
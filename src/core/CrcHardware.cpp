@@ -0,0 +1,248 @@
+#include "core/CrcHardware.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CRC_HARDWARE_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#elif defined(__aarch64__) && defined(__linux__)
+#define CRC_HARDWARE_ARM64 1
+#include <arm_acle.h>
+#include <arm_neon.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+// MSVC allows intrinsics anywhere; GCC and Clang need the feature enabled per function so the
+// rest of the file still runs on CPUs without it.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define CRC_TARGET(features)
+#else
+#define CRC_TARGET(features) __attribute__((target(features)))
+#endif
+
+namespace {
+
+core::detail::CrcCpuFeatures DetectFeatures() noexcept {
+    core::detail::CrcCpuFeatures features;
+#if defined(CRC_HARDWARE_X86)
+    unsigned int ecx = 0;
+#if defined(_MSC_VER)
+    int registers[4] = {};
+    __cpuid(registers, 1);
+    ecx = static_cast<unsigned int>(registers[2]);
+#else
+    unsigned int eax = 0;
+    unsigned int ebx = 0;
+    unsigned int edx = 0;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0) {
+        return features;
+    }
+#endif
+    const bool sse41 = (ecx & (1U << 19U)) != 0U;
+    features.clmul = (ecx & (1U << 1U)) != 0U && sse41;
+    features.crc32c = (ecx & (1U << 20U)) != 0U;
+#elif defined(CRC_HARDWARE_ARM64)
+    const unsigned long hwcap = getauxval(AT_HWCAP);
+    features.clmul = (hwcap & HWCAP_PMULL) != 0U;
+    features.crc32 = (hwcap & HWCAP_CRC32) != 0U;
+    features.crc32c = features.crc32;
+#endif
+    return features;
+}
+
+#if defined(CRC_HARDWARE_X86)
+
+CRC_TARGET("pclmul,sse4.1")
+inline __m128i Fold(__m128i x, __m128i constants, __m128i next) noexcept {
+    const __m128i low = _mm_clmulepi64_si128(x, constants, 0x00);
+    const __m128i high = _mm_clmulepi64_si128(x, constants, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(low, high), next);
+}
+
+CRC_TARGET("pclmul,sse4.1")
+inline __m128i Load(const uint8_t* data) noexcept {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+#elif defined(CRC_HARDWARE_ARM64)
+
+CRC_TARGET("arch=armv8-a+crypto")
+inline uint64x2_t Clmul(std::uint64_t a, std::uint64_t b) noexcept {
+    return vreinterpretq_u64_p128(vmull_p64(static_cast<poly64_t>(a), static_cast<poly64_t>(b)));
+}
+
+CRC_TARGET("arch=armv8-a+crypto")
+inline uint64x2_t Fold(uint64x2_t x, std::uint64_t low, std::uint64_t high, uint64x2_t next) noexcept {
+    return veorq_u64(veorq_u64(Clmul(vgetq_lane_u64(x, 0), low), Clmul(vgetq_lane_u64(x, 1), high)), next);
+}
+
+inline uint64x2_t Load(const uint8_t* data) noexcept {
+    return vreinterpretq_u64_u8(vld1q_u8(data));
+}
+
+#endif
+
+} // namespace
+
+namespace core::detail {
+
+const CrcCpuFeatures& CrcFeatures() noexcept {
+    static const CrcCpuFeatures features = DetectFeatures();
+    return features;
+}
+
+#if defined(CRC_HARDWARE_X86)
+
+// Folding as in Intel's "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ":
+// four registers fold 64 bytes ahead, collapse to one, then 128 -> 64 -> 32 bits and a
+// Barrett reduction.
+CRC_TARGET("pclmul,sse4.1")
+std::uint32_t FoldClmul(const ClmulConstants& constants, std::uint32_t crc, const uint8_t* data, std::size_t size) noexcept {
+    __m128i x1 = _mm_xor_si128(Load(data), _mm_cvtsi32_si128(static_cast<int>(crc)));
+    __m128i x2 = Load(data + 16);
+    __m128i x3 = Load(data + 32);
+    __m128i x4 = Load(data + 48);
+    data += 64;
+    size -= 64U;
+
+    const __m128i fold4 = _mm_set_epi64x(static_cast<long long>(constants.fold4High), static_cast<long long>(constants.fold4Low));
+    for (; size >= 64U; data += 64, size -= 64U) {
+        x1 = Fold(x1, fold4, Load(data));
+        x2 = Fold(x2, fold4, Load(data + 16));
+        x3 = Fold(x3, fold4, Load(data + 32));
+        x4 = Fold(x4, fold4, Load(data + 48));
+    }
+
+    const __m128i fold1 = _mm_set_epi64x(static_cast<long long>(constants.fold1High), static_cast<long long>(constants.fold1Low));
+    x1 = Fold(x1, fold1, x2);
+    x1 = Fold(x1, fold1, x3);
+    x1 = Fold(x1, fold1, x4);
+    for (; size >= 16U; data += 16, size -= 16U) {
+        x1 = Fold(x1, fold1, Load(data));
+    }
+
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(x1, fold1, 0x10), _mm_srli_si128(x1, 8));
+
+    const __m128i mask32 = _mm_setr_epi32(-1, 0, 0, 0);
+    const __m128i fold64 = _mm_set_epi64x(0, static_cast<long long>(constants.fold64));
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask32), fold64, 0x00), _mm_srli_si128(x1, 4));
+
+    const __m128i barrett = _mm_set_epi64x(static_cast<long long>(constants.mu), static_cast<long long>(constants.poly));
+    __m128i t = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), barrett, 0x10);
+    t = _mm_clmulepi64_si128(_mm_and_si128(t, mask32), barrett, 0x00);
+    return static_cast<std::uint32_t>(_mm_extract_epi32(_mm_xor_si128(x1, t), 1));
+}
+
+std::uint32_t Crc32Instruction(std::uint32_t crc, const uint8_t*, std::size_t) noexcept {
+    return crc; // x86 only has the CRC-32C instruction.
+}
+
+CRC_TARGET("sse4.2")
+std::uint32_t Crc32cInstruction(std::uint32_t crc, const uint8_t* data, std::size_t size) noexcept {
+#if defined(__x86_64__) || defined(_M_X64)
+    std::uint64_t crc64 = crc;
+    for (; size >= 8U; data += 8, size -= 8U) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, data, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+    crc = static_cast<std::uint32_t>(crc64);
+#else
+    for (; size >= 4U; data += 4, size -= 4U) {
+        std::uint32_t word = 0;
+        std::memcpy(&word, data, sizeof(word));
+        crc = _mm_crc32_u32(crc, word);
+    }
+#endif
+    for (; size > 0U; ++data, --size) {
+        crc = _mm_crc32_u8(crc, *data);
+    }
+    return crc;
+}
+
+#elif defined(CRC_HARDWARE_ARM64)
+
+// The same folding with PMULL; vextq_u8 against zero stands in for the byte shifts.
+CRC_TARGET("arch=armv8-a+crypto")
+std::uint32_t FoldClmul(const ClmulConstants& constants, std::uint32_t crc, const uint8_t* data, std::size_t size) noexcept {
+    const uint64x2_t zero = vdupq_n_u64(0);
+    uint64x2_t x1 = veorq_u64(Load(data), vsetq_lane_u64(crc, zero, 0));
+    uint64x2_t x2 = Load(data + 16);
+    uint64x2_t x3 = Load(data + 32);
+    uint64x2_t x4 = Load(data + 48);
+    data += 64;
+    size -= 64U;
+
+    for (; size >= 64U; data += 64, size -= 64U) {
+        x1 = Fold(x1, constants.fold4Low, constants.fold4High, Load(data));
+        x2 = Fold(x2, constants.fold4Low, constants.fold4High, Load(data + 16));
+        x3 = Fold(x3, constants.fold4Low, constants.fold4High, Load(data + 32));
+        x4 = Fold(x4, constants.fold4Low, constants.fold4High, Load(data + 48));
+    }
+
+    x1 = Fold(x1, constants.fold1Low, constants.fold1High, x2);
+    x1 = Fold(x1, constants.fold1Low, constants.fold1High, x3);
+    x1 = Fold(x1, constants.fold1Low, constants.fold1High, x4);
+    for (; size >= 16U; data += 16, size -= 16U) {
+        x1 = Fold(x1, constants.fold1Low, constants.fold1High, Load(data));
+    }
+
+    x1 = veorq_u64(Clmul(vgetq_lane_u64(x1, 0), constants.fold1High), vsetq_lane_u64(vgetq_lane_u64(x1, 1), zero, 0));
+
+    const uint64x2_t shifted = vreinterpretq_u64_u8(vextq_u8(vreinterpretq_u8_u64(x1), vdupq_n_u8(0), 4));
+    x1 = veorq_u64(Clmul(vgetq_lane_u64(x1, 0) & 0xFFFFFFFFU, constants.fold64), shifted);
+
+    uint64x2_t t = Clmul(vgetq_lane_u64(x1, 0) & 0xFFFFFFFFU, constants.mu);
+    t = Clmul(vgetq_lane_u64(t, 0) & 0xFFFFFFFFU, constants.poly);
+    return vgetq_lane_u32(vreinterpretq_u32_u64(veorq_u64(x1, t)), 1);
+}
+
+CRC_TARGET("arch=armv8-a+crc")
+std::uint32_t Crc32Instruction(std::uint32_t crc, const uint8_t* data, std::size_t size) noexcept {
+    for (; size >= 8U; data += 8, size -= 8U) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, data, sizeof(word));
+        crc = __crc32d(crc, word);
+    }
+    for (; size > 0U; ++data, --size) {
+        crc = __crc32b(crc, *data);
+    }
+    return crc;
+}
+
+CRC_TARGET("arch=armv8-a+crc")
+std::uint32_t Crc32cInstruction(std::uint32_t crc, const uint8_t* data, std::size_t size) noexcept {
+    for (; size >= 8U; data += 8, size -= 8U) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, data, sizeof(word));
+        crc = __crc32cd(crc, word);
+    }
+    for (; size > 0U; ++data, --size) {
+        crc = __crc32cb(crc, *data);
+    }
+    return crc;
+}
+
+#else
+
+std::uint32_t FoldClmul(const ClmulConstants&, std::uint32_t crc, const uint8_t*, std::size_t) noexcept {
+    return crc;
+}
+
+std::uint32_t Crc32Instruction(std::uint32_t crc, const uint8_t*, std::size_t) noexcept {
+    return crc;
+}
+
+std::uint32_t Crc32cInstruction(std::uint32_t crc, const uint8_t*, std::size_t) noexcept {
+    return crc;
+}
+
+#endif
+
+} // namespace core::detail
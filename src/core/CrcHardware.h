@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// CPU-specific CRC-32 kernels behind core::CrcState. Callers check CrcCpuFeatures() first;
+// on a CPU or build without the feature the kernel is never called.
+namespace core::detail {
+
+struct CrcCpuFeatures {
+    bool clmul = false;  // PCLMULQDQ (x86) or PMULL (ARMv8 crypto).
+    bool crc32 = false;  // CRC-32/ISO-HDLC instruction (ARMv8 CRC32).
+    bool crc32c = false; // CRC-32C instruction (SSE4.2 or ARMv8 CRC32).
+};
+
+// Detected on first use.
+const CrcCpuFeatures& CrcFeatures() noexcept;
+
+// Folding constants of a reflected 32-bit polynomial P: R(n) = reflect32(x^n mod P) << 1,
+// poly = reflect33(P), mu = reflect33(x^64 div P).
+struct ClmulConstants {
+    std::uint64_t fold4Low;  // R(4*128+32): four registers 64 bytes ahead.
+    std::uint64_t fold4High; // R(4*128-32)
+    std::uint64_t fold1Low;  // R(128+32): one register 16 bytes ahead.
+    std::uint64_t fold1High; // R(128-32)
+    std::uint64_t fold64;    // R(64)
+    std::uint64_t poly;
+    std::uint64_t mu;
+};
+
+inline constexpr ClmulConstants kClmulCrc32IsoHdlc{0x154442BD4U, 0x1C6E41596U, 0x1751997D0U, 0x0CCAA009EU,
+                                                   0x163CD6124U, 0x1DB710641U, 0x1F7011641U};
+inline constexpr ClmulConstants kClmulCrc32c{0x0740EEF02U, 0x09E4ADDF8U, 0x0F20C0DFEU, 0x14CD00BD6U,
+                                             0x0DD45AAB8U, 0x105EC76F1U, 0x0DEA713F1U};
+
+constexpr std::size_t kClmulMinBytes = 64;
+
+// size is at least kClmulMinBytes and a multiple of 16. crc is the reflected register before
+// the final xor, as kept by CrcState.
+std::uint32_t FoldClmul(const ClmulConstants& constants, std::uint32_t crc, const uint8_t* data, std::size_t size) noexcept;
+
+std::uint32_t Crc32Instruction(std::uint32_t crc, const uint8_t* data, std::size_t size) noexcept;
+std::uint32_t Crc32cInstruction(std::uint32_t crc, const uint8_t* data, std::size_t size) noexcept;
+
+} // namespace core::detail
@@ -0,0 +1,134 @@
+#include "core/CrcModel.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr uint8_t kCheckInput[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+
+template <core::CrcModel Model>
+std::uint32_t FinalizeWide(std::uint32_t crc) noexcept {
+    return core::Crc<Model>::Finalize(crc);
+}
+
+template <core::CrcModel Model>
+constexpr core::CrcCatalogueEntry Entry(std::string_view name) noexcept {
+    static_assert(core::Crc<Model>::Compute(kCheckInput, sizeof(kCheckInput)) == Model.check,
+                  "CRC model does not reproduce its check value");
+    return {name, Model, core::Crc<Model>::kInitRegister, &core::Crc<Model>::Update, &FinalizeWide<Model>};
+}
+
+constexpr core::CrcCatalogueEntry kCatalogue[] = {
+    Entry<core::kCrc5Usb>("CRC-5/USB"),
+    Entry<core::kCrc7Mmc>("CRC-7/MMC"),
+    Entry<core::kCrc8Smbus>("CRC-8/SMBUS"),
+    Entry<core::kCrc8MaximDow>("CRC-8/MAXIM-DOW"),
+    Entry<core::kCrc8Autosar>("CRC-8/AUTOSAR"),
+    Entry<core::kCrc8Bluetooth>("CRC-8/BLUETOOTH"),
+    Entry<core::kCrc8Cdma2000>("CRC-8/CDMA2000"),
+    Entry<core::kCrc8DvbS2>("CRC-8/DVB-S2"),
+    Entry<core::kCrc8I4321>("CRC-8/I-432-1"),
+    Entry<core::kCrc8Rohc>("CRC-8/ROHC"),
+    Entry<core::kCrc8SaeJ1850>("CRC-8/SAE-J1850"),
+    Entry<core::kCrc8Wcdma>("CRC-8/WCDMA"),
+    Entry<core::kCrc16Arc>("CRC-16/ARC"),
+    Entry<core::kCrc16Modbus>("CRC-16/MODBUS"),
+    Entry<core::kCrc16Usb>("CRC-16/USB"),
+    Entry<core::kCrc16MaximDow>("CRC-16/MAXIM-DOW"),
+    Entry<core::kCrc16Umts>("CRC-16/UMTS"),
+    Entry<core::kCrc16Ibm3740>("CRC-16/IBM-3740"),
+    Entry<core::kCrc16Xmodem>("CRC-16/XMODEM"),
+    Entry<core::kCrc16Kermit>("CRC-16/KERMIT"),
+    Entry<core::kCrc16IbmSdlc>("CRC-16/IBM-SDLC"),
+    Entry<core::kCrc16Genibus>("CRC-16/GENIBUS"),
+    Entry<core::kCrc16SpiFujitsu>("CRC-16/SPI-FUJITSU"),
+    Entry<core::kCrc16Dnp>("CRC-16/DNP"),
+    Entry<core::kCrc32IsoHdlc>("CRC-32/ISO-HDLC"),
+    Entry<core::kCrc32Iscsi>("CRC-32/ISCSI"),
+    Entry<core::kCrc32Autosar>("CRC-32/AUTOSAR"),
+    Entry<core::kCrc32Jamcrc>("CRC-32/JAMCRC"),
+    Entry<core::kCrc32Bzip2>("CRC-32/BZIP2"),
+    Entry<core::kCrc32Mpeg2>("CRC-32/MPEG-2"),
+    Entry<core::kCrc32Cksum>("CRC-32/CKSUM"),
+};
+
+struct Alias {
+    std::string_view alias;
+    std::string_view name;
+};
+
+constexpr Alias kAliases[] = {
+    {"CRC-8", "CRC-8/SMBUS"},
+    {"CRC-8/MAXIM", "CRC-8/MAXIM-DOW"},
+    {"CRC-8/ITU", "CRC-8/I-432-1"},
+    {"CRC-16", "CRC-16/ARC"},
+    {"CRC-16/IBM", "CRC-16/ARC"},
+    {"CRC-16/BUYPASS", "CRC-16/UMTS"},
+    {"CRC-16/CCITT-FALSE", "CRC-16/IBM-3740"},
+    {"CRC-16/AUTOSAR", "CRC-16/IBM-3740"},
+    {"CRC-16/ZMODEM", "CRC-16/XMODEM"},
+    {"CRC-16/CCITT", "CRC-16/KERMIT"},
+    {"CRC-16/X-25", "CRC-16/IBM-SDLC"},
+    {"CRC-16/AUG-CCITT", "CRC-16/SPI-FUJITSU"},
+    {"CRC-32", "CRC-32/ISO-HDLC"},
+    {"CRC-32C", "CRC-32/ISCSI"},
+    {"CRC-32/POSIX", "CRC-32/CKSUM"},
+};
+
+bool EqualsIgnoreCase(std::string_view a, std::string_view b) noexcept {
+    const auto lower = [](char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; };
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [&](char x, char y) { return lower(x) == lower(y); });
+}
+
+const core::CrcCatalogueEntry* FindCanonical(std::string_view name) noexcept {
+    for (const core::CrcCatalogueEntry& entry : kCatalogue) {
+        if (EqualsIgnoreCase(entry.name, name)) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+namespace core {
+
+RuntimeCrc::RuntimeCrc(const CrcModel& model) noexcept : model_(model), tables_(detail::MakeCrcTables(model)) {}
+
+std::uint32_t RuntimeCrc::InitRegister() const noexcept {
+    return detail::CrcInitRegister(model_);
+}
+
+std::uint32_t RuntimeCrc::Update(std::uint32_t crc, const uint8_t* data, std::size_t size) const noexcept {
+    return model_.reflectIn ? detail::CrcUpdate<true>(tables_, crc, data, size) : detail::CrcUpdate<false>(tables_, crc, data, size);
+}
+
+std::uint32_t RuntimeCrc::Finalize(std::uint32_t crc) const noexcept {
+    return detail::CrcFinalize(model_, crc);
+}
+
+std::uint32_t RuntimeCrc::Compute(const uint8_t* data, std::size_t size) const noexcept {
+    return Finalize(Update(InitRegister(), data, size));
+}
+
+const CrcModel& RuntimeCrc::Model() const noexcept {
+    return model_;
+}
+
+std::span<const CrcCatalogueEntry> CrcCatalogue() noexcept {
+    return kCatalogue;
+}
+
+const CrcCatalogueEntry* FindCrc(std::string_view name) noexcept {
+    if (const CrcCatalogueEntry* entry = FindCanonical(name)) {
+        return entry;
+    }
+    for (const Alias& alias : kAliases) {
+        if (EqualsIgnoreCase(alias.alias, name)) {
+            return FindCanonical(alias.name);
+        }
+    }
+    return nullptr;
+}
+
+} // namespace core
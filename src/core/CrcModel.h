@@ -0,0 +1,229 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+namespace core {
+
+// Rocksoft model of a CRC (Williams, "A Painless Guide to CRC Error Detection Algorithms"),
+// as listed in the reveng catalogue.
+struct CrcModel {
+    unsigned width;     // 1..32 bits.
+    std::uint32_t poly; // Normal form, without the x^width term.
+    std::uint32_t init;
+    bool reflectIn;
+    bool reflectOut;
+    std::uint32_t xorOut;
+    std::uint32_t check; // CRC of "123456789".
+};
+
+namespace detail {
+
+using CrcTables = std::array<std::array<std::uint32_t, 256>, 8>;
+
+constexpr std::uint32_t CrcWidthMask(unsigned width) noexcept {
+    return width >= 32U ? 0xFFFFFFFFU : (1U << width) - 1U;
+}
+
+constexpr std::uint32_t ReflectBits(std::uint32_t value, unsigned width) noexcept {
+    std::uint32_t result = 0;
+    for (unsigned i = 0; i < width; ++i) {
+        result = (result << 1U) | (value & 1U);
+        value >>= 1U;
+    }
+    return result;
+}
+
+// Slice k advances a byte through k further zero bytes: slice 0 is the classic byte table.
+// A reflected register sits in the low bits, a normal one at the top of 32 bits.
+constexpr CrcTables MakeCrcTables(const CrcModel& model) noexcept {
+    CrcTables tables{};
+    if (model.reflectIn) {
+        const std::uint32_t poly = ReflectBits(model.poly, model.width);
+        for (std::uint32_t byte = 0; byte < 256U; ++byte) {
+            std::uint32_t crc = byte;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1U) != 0U ? (crc >> 1U) ^ poly : crc >> 1U;
+            }
+            tables[0][byte] = crc;
+        }
+        for (std::size_t slice = 1; slice < tables.size(); ++slice) {
+            for (std::size_t byte = 0; byte < 256U; ++byte) {
+                const std::uint32_t previous = tables[slice - 1U][byte];
+                tables[slice][byte] = (previous >> 8U) ^ tables[0][previous & 0xFFU];
+            }
+        }
+    } else {
+        const std::uint32_t poly = model.poly << (32U - model.width);
+        for (std::uint32_t byte = 0; byte < 256U; ++byte) {
+            std::uint32_t crc = byte << 24U;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 0x80000000U) != 0U ? (crc << 1U) ^ poly : crc << 1U;
+            }
+            tables[0][byte] = crc;
+        }
+        for (std::size_t slice = 1; slice < tables.size(); ++slice) {
+            for (std::size_t byte = 0; byte < 256U; ++byte) {
+                const std::uint32_t previous = tables[slice - 1U][byte];
+                tables[slice][byte] = (previous << 8U) ^ tables[0][previous >> 24U];
+            }
+        }
+    }
+    return tables;
+}
+
+constexpr std::uint32_t CrcInitRegister(const CrcModel& model) noexcept {
+    return model.reflectIn ? ReflectBits(model.init, model.width) : model.init << (32U - model.width);
+}
+
+template <bool Reflected>
+constexpr std::uint32_t CrcUpdateBytewise(const CrcTables& t, std::uint32_t crc, const uint8_t* data, std::size_t size) noexcept {
+    for (std::size_t i = 0; i < size; ++i) {
+        if constexpr (Reflected) {
+            crc = (crc >> 8U) ^ t[0][(crc ^ data[i]) & 0xFFU];
+        } else {
+            crc = (crc << 8U) ^ t[0][(crc >> 24U) ^ data[i]];
+        }
+    }
+    return crc;
+}
+
+// Eight bytes per step. The words are assembled byte by byte, so the loop is independent of
+// host byte order and stays constexpr; compilers fold it into plain loads.
+template <bool Reflected>
+constexpr std::uint32_t CrcUpdate(const CrcTables& t, std::uint32_t crc, const uint8_t* data, std::size_t size) noexcept {
+    for (; size >= 8U; data += 8, size -= 8U) {
+        if constexpr (Reflected) {
+            crc ^= static_cast<std::uint32_t>(data[0]) | (static_cast<std::uint32_t>(data[1]) << 8U) |
+                   (static_cast<std::uint32_t>(data[2]) << 16U) | (static_cast<std::uint32_t>(data[3]) << 24U);
+            crc = t[7][crc & 0xFFU] ^ t[6][(crc >> 8U) & 0xFFU] ^ t[5][(crc >> 16U) & 0xFFU] ^ t[4][crc >> 24U] ^
+                  t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+        } else {
+            crc ^= (static_cast<std::uint32_t>(data[0]) << 24U) | (static_cast<std::uint32_t>(data[1]) << 16U) |
+                   (static_cast<std::uint32_t>(data[2]) << 8U) | static_cast<std::uint32_t>(data[3]);
+            crc = t[7][crc >> 24U] ^ t[6][(crc >> 16U) & 0xFFU] ^ t[5][(crc >> 8U) & 0xFFU] ^ t[4][crc & 0xFFU] ^
+                  t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+        }
+    }
+    return CrcUpdateBytewise<Reflected>(t, crc, data, size);
+}
+
+constexpr std::uint32_t CrcFinalize(const CrcModel& model, std::uint32_t crc) noexcept {
+    std::uint32_t value = model.reflectIn ? crc : crc >> (32U - model.width);
+    if (model.reflectIn != model.reflectOut) {
+        value = ReflectBits(value, model.width);
+    }
+    return (value ^ model.xorOut) & CrcWidthMask(model.width);
+}
+
+} // namespace detail
+
+// A CRC fixed at compile time: tables are built by the compiler and every call goes straight
+// to the slice-by-8 loop. Usable in constant expressions.
+template <CrcModel Model>
+class Crc final {
+    static_assert(Model.width >= 1U && Model.width <= 32U, "CRC width must be 1..32 bits");
+
+public:
+    using Value = std::conditional_t<(Model.width <= 8U), std::uint8_t,
+                                     std::conditional_t<(Model.width <= 16U), std::uint16_t, std::uint32_t>>;
+
+    static constexpr detail::CrcTables kTables = detail::MakeCrcTables(Model);
+    static constexpr std::uint32_t kInitRegister = detail::CrcInitRegister(Model);
+
+    static constexpr Value Compute(const uint8_t* data, std::size_t size) noexcept {
+        return Finalize(Update(kInitRegister, data, size));
+    }
+
+    static constexpr Value Compute(std::span<const uint8_t> data) noexcept {
+        return Compute(data.data(), data.size());
+    }
+
+    static constexpr std::uint32_t Update(std::uint32_t crc, const uint8_t* data, std::size_t size) noexcept {
+        return detail::CrcUpdate<Model.reflectIn>(kTables, crc, data, size);
+    }
+
+    static constexpr std::uint32_t UpdateBytewise(std::uint32_t crc, const uint8_t* data, std::size_t size) noexcept {
+        return detail::CrcUpdateBytewise<Model.reflectIn>(kTables, crc, data, size);
+    }
+
+    static constexpr Value Finalize(std::uint32_t crc) noexcept {
+        return static_cast<Value>(detail::CrcFinalize(Model, crc));
+    }
+};
+
+// The same CRC for a model known only at run time, e.g. one being searched for; the tables are
+// built in the constructor.
+class RuntimeCrc final {
+public:
+    explicit RuntimeCrc(const CrcModel& model) noexcept;
+
+    [[nodiscard]] std::uint32_t InitRegister() const noexcept;
+    [[nodiscard]] std::uint32_t Update(std::uint32_t crc, const uint8_t* data, std::size_t size) const noexcept;
+    [[nodiscard]] std::uint32_t Finalize(std::uint32_t crc) const noexcept;
+    [[nodiscard]] std::uint32_t Compute(const uint8_t* data, std::size_t size) const noexcept;
+
+    [[nodiscard]] const CrcModel& Model() const noexcept;
+
+private:
+    CrcModel model_;
+    detail::CrcTables tables_;
+};
+
+// The catalogue: the CRCs our devices and protocols use. The registry checks each one against
+// its check value at compile time.
+inline constexpr CrcModel kCrc5Usb{5, 0x05U, 0x1FU, true, true, 0x1FU, 0x19U};
+inline constexpr CrcModel kCrc7Mmc{7, 0x09U, 0x00U, false, false, 0x00U, 0x75U};
+inline constexpr CrcModel kCrc8Smbus{8, 0x07U, 0x00U, false, false, 0x00U, 0xF4U};
+inline constexpr CrcModel kCrc8MaximDow{8, 0x31U, 0x00U, true, true, 0x00U, 0xA1U};
+inline constexpr CrcModel kCrc8Autosar{8, 0x2FU, 0xFFU, false, false, 0xFFU, 0xDFU};
+inline constexpr CrcModel kCrc8Bluetooth{8, 0xA7U, 0x00U, true, true, 0x00U, 0x26U};
+inline constexpr CrcModel kCrc8Cdma2000{8, 0x9BU, 0xFFU, false, false, 0x00U, 0xDAU};
+inline constexpr CrcModel kCrc8DvbS2{8, 0xD5U, 0x00U, false, false, 0x00U, 0xBCU};
+inline constexpr CrcModel kCrc8I4321{8, 0x07U, 0x00U, false, false, 0x55U, 0xA1U};
+inline constexpr CrcModel kCrc8Rohc{8, 0x07U, 0xFFU, true, true, 0x00U, 0xD0U};
+inline constexpr CrcModel kCrc8SaeJ1850{8, 0x1DU, 0xFFU, false, false, 0xFFU, 0x4BU};
+inline constexpr CrcModel kCrc8Wcdma{8, 0x9BU, 0x00U, true, true, 0x00U, 0x25U};
+inline constexpr CrcModel kCrc16Arc{16, 0x8005U, 0x0000U, true, true, 0x0000U, 0xBB3DU};
+inline constexpr CrcModel kCrc16Modbus{16, 0x8005U, 0xFFFFU, true, true, 0x0000U, 0x4B37U};
+inline constexpr CrcModel kCrc16Usb{16, 0x8005U, 0xFFFFU, true, true, 0xFFFFU, 0xB4C8U};
+inline constexpr CrcModel kCrc16MaximDow{16, 0x8005U, 0x0000U, true, true, 0xFFFFU, 0x44C2U};
+inline constexpr CrcModel kCrc16Umts{16, 0x8005U, 0x0000U, false, false, 0x0000U, 0xFEE8U};
+inline constexpr CrcModel kCrc16Ibm3740{16, 0x1021U, 0xFFFFU, false, false, 0x0000U, 0x29B1U};
+inline constexpr CrcModel kCrc16Xmodem{16, 0x1021U, 0x0000U, false, false, 0x0000U, 0x31C3U};
+inline constexpr CrcModel kCrc16Kermit{16, 0x1021U, 0x0000U, true, true, 0x0000U, 0x2189U};
+inline constexpr CrcModel kCrc16IbmSdlc{16, 0x1021U, 0xFFFFU, true, true, 0xFFFFU, 0x906EU};
+inline constexpr CrcModel kCrc16Genibus{16, 0x1021U, 0xFFFFU, false, false, 0xFFFFU, 0xD64EU};
+inline constexpr CrcModel kCrc16SpiFujitsu{16, 0x1021U, 0x1D0FU, false, false, 0x0000U, 0xE5CCU};
+inline constexpr CrcModel kCrc16Dnp{16, 0x3D65U, 0x0000U, true, true, 0xFFFFU, 0xEA82U};
+inline constexpr CrcModel kCrc32IsoHdlc{32, 0x04C11DB7U, 0xFFFFFFFFU, true, true, 0xFFFFFFFFU, 0xCBF43926U};
+inline constexpr CrcModel kCrc32Iscsi{32, 0x1EDC6F41U, 0xFFFFFFFFU, true, true, 0xFFFFFFFFU, 0xE3069283U};
+inline constexpr CrcModel kCrc32Autosar{32, 0xF4ACFB13U, 0xFFFFFFFFU, true, true, 0xFFFFFFFFU, 0x1697D06AU};
+inline constexpr CrcModel kCrc32Jamcrc{32, 0x04C11DB7U, 0xFFFFFFFFU, true, true, 0x00000000U, 0x340BC6D9U};
+inline constexpr CrcModel kCrc32Bzip2{32, 0x04C11DB7U, 0xFFFFFFFFU, false, false, 0xFFFFFFFFU, 0xFC891918U};
+inline constexpr CrcModel kCrc32Mpeg2{32, 0x04C11DB7U, 0xFFFFFFFFU, false, false, 0x00000000U, 0x0376E6E7U};
+inline constexpr CrcModel kCrc32Cksum{32, 0x04C11DB7U, 0x00000000U, false, false, 0xFFFFFFFFU, 0x765E7680U};
+
+// Run-time access to the catalogue by name, e.g. for a CRC chosen in a settings file.
+struct CrcCatalogueEntry {
+    std::string_view name; // reveng name, e.g. "CRC-16/MODBUS".
+    CrcModel model;
+    std::uint32_t initRegister;
+    std::uint32_t (*update)(std::uint32_t crc, const uint8_t* data, std::size_t size) noexcept;
+    std::uint32_t (*finalize)(std::uint32_t crc) noexcept;
+
+    [[nodiscard]] std::uint32_t Compute(const uint8_t* data, std::size_t size) const noexcept {
+        return finalize(update(initRegister, data, size));
+    }
+};
+
+[[nodiscard]] std::span<const CrcCatalogueEntry> CrcCatalogue() noexcept;
+
+// Case-insensitive; also accepts common aliases ("CRC-16/CCITT-FALSE", "CRC-32C", ...).
+[[nodiscard]] const CrcCatalogueEntry* FindCrc(std::string_view name) noexcept;
+
+} // namespace core
@@ -0,0 +1,77 @@
+#include "core/Hex.h"
+
+namespace {
+
+constexpr wchar_t kDigits[] = L"0123456789ABCDEF";
+
+int HexValue(wchar_t ch) noexcept {
+    if (ch >= L'0' && ch <= L'9') {
+        return ch - L'0';
+    }
+    if (ch >= L'a' && ch <= L'f') {
+        return ch - L'a' + 10;
+    }
+    if (ch >= L'A' && ch <= L'F') {
+        return ch - L'A' + 10;
+    }
+    return -1;
+}
+
+void AppendRun(std::wstring_view run, std::vector<uint8_t>* bytes) {
+    std::size_t i = 0;
+    for (; i + 1 < run.size(); i += 2) {
+        bytes->push_back(static_cast<uint8_t>((HexValue(run[i]) << 4) | HexValue(run[i + 1])));
+    }
+    if (i < run.size()) {
+        bytes->push_back(static_cast<uint8_t>(HexValue(run[i])));
+    }
+}
+
+} // namespace
+
+namespace core {
+
+std::wstring BytesToHex(std::span<const uint8_t> bytes) {
+    std::wstring text;
+    AppendHex(bytes, &text);
+    return text;
+}
+
+void AppendHex(std::span<const uint8_t> bytes, std::wstring* out) {
+    if (bytes.empty()) {
+        return;
+    }
+
+    // Sized once and filled in place: this runs for every RX chunk in hex mode.
+    const std::size_t start = out->size();
+    out->resize(start + bytes.size() * 3U - 1U);
+    wchar_t* cursor = out->data() + start;
+    for (std::size_t i = 0; i < bytes.size(); ++i) {
+        if (i > 0) {
+            *cursor++ = L' ';
+        }
+        *cursor++ = kDigits[bytes[i] >> 4U];
+        *cursor++ = kDigits[bytes[i] & 0x0FU];
+    }
+}
+
+std::vector<uint8_t> ParseHex(std::wstring_view text) {
+    std::vector<uint8_t> bytes;
+    bytes.reserve(text.size() / 2U + 1U);
+
+    std::size_t runStart = 0;
+    for (std::size_t i = 0; i <= text.size(); ++i) {
+        if (i < text.size() && HexValue(text[i]) >= 0) {
+            continue;
+        }
+        const std::wstring_view run = text.substr(runStart, i - runStart);
+        // A lone digit counts only at the very end of the text, as the send box always did.
+        if (run.size() >= 2U || (i == text.size() && !run.empty())) {
+            AppendRun(run, &bytes);
+        }
+        runStart = i + 1U;
+    }
+    return bytes;
+}
+
+} // namespace core
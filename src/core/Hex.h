@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace core {
+
+// "0A 1B FF": uppercase pairs separated by single spaces, as shown in the log.
+std::wstring BytesToHex(std::span<const uint8_t> bytes);
+void AppendHex(std::span<const uint8_t> bytes, std::wstring* out);
+
+// Lenient parser for the send box: any non-hex character separates runs of digits, each run is
+// read two digits per byte and an odd trailing digit becomes 0X.
+std::vector<uint8_t> ParseHex(std::wstring_view text);
+
+} // namespace core
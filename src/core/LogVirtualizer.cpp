@@ -1,9 +1,14 @@
 #include "core/LogVirtualizer.h"
 
 #include <algorithm>
+#include <cwchar>
 #include <filesystem>
 #include <system_error>
 
+#ifndef _WIN32
+#include <time.h>
+#endif
+
 namespace core {
 
 LogVirtualizer::LogVirtualizer(
@@ -27,10 +32,11 @@ bool LogVirtualizer::Initialize(const std::wstring& logDirectory) {
         return false;
     }
 
+    wchar_t fileName[64] = {};
+#ifdef _WIN32
     SYSTEMTIME st{};
     ::GetLocalTime(&st);
 
-    wchar_t fileName[64] = {};
     ::swprintf_s(
         fileName,
         L"log_%04u%02u%02u_%02u%02u%02u.txt",
@@ -40,6 +46,22 @@ bool LogVirtualizer::Initialize(const std::wstring& logDirectory) {
         st.wHour,
         st.wMinute,
         st.wSecond);
+#else
+    const time_t now = ::time(nullptr);
+    tm local{};
+    ::localtime_r(&now, &local);
+
+    std::swprintf(
+        fileName,
+        sizeof(fileName) / sizeof(fileName[0]),
+        L"log_%04d%02d%02d_%02d%02d%02d.txt",
+        local.tm_year + 1900,
+        local.tm_mon + 1,
+        local.tm_mday,
+        local.tm_hour,
+        local.tm_min,
+        local.tm_sec);
+#endif
 
     const std::filesystem::path path = std::filesystem::path(logDirectory) / fileName;
     sessionFilePath_ = path.wstring();
@@ -108,6 +130,7 @@ std::string LogVirtualizer::ToUtf8(const std::wstring& text) {
         return {};
     }
 
+#ifdef _WIN32
     const int bytes = ::WideCharToMultiByte(
         CP_UTF8,
         0,
@@ -135,6 +158,33 @@ std::string LogVirtualizer::ToUtf8(const std::wstring& text) {
         nullptr);
 
     return utf8;
+#else
+    // wchar_t holds whole code points here; invalid ones become U+FFFD, as on Windows.
+    std::string utf8;
+    utf8.reserve(text.size());
+    for (const wchar_t ch : text) {
+        auto code = static_cast<std::uint32_t>(ch);
+        if (code > 0x10FFFFU || (code >= 0xD800U && code <= 0xDFFFU)) {
+            code = 0xFFFDU;
+        }
+        if (code < 0x80U) {
+            utf8.push_back(static_cast<char>(code));
+        } else if (code < 0x800U) {
+            utf8.push_back(static_cast<char>(0xC0U | (code >> 6U)));
+            utf8.push_back(static_cast<char>(0x80U | (code & 0x3FU)));
+        } else if (code < 0x10000U) {
+            utf8.push_back(static_cast<char>(0xE0U | (code >> 12U)));
+            utf8.push_back(static_cast<char>(0x80U | ((code >> 6U) & 0x3FU)));
+            utf8.push_back(static_cast<char>(0x80U | (code & 0x3FU)));
+        } else {
+            utf8.push_back(static_cast<char>(0xF0U | (code >> 18U)));
+            utf8.push_back(static_cast<char>(0x80U | ((code >> 12U) & 0x3FU)));
+            utf8.push_back(static_cast<char>(0x80U | ((code >> 6U) & 0x3FU)));
+            utf8.push_back(static_cast<char>(0x80U | (code & 0x3FU)));
+        }
+    }
+    return utf8;
+#endif
 }
 
 } // namespace core
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <windows.h>
+#include "core/Platform.h"
 
 #include <cstddef>
 #include <cstdint>
@@ -0,0 +1,101 @@
+#include "core/MappedFile.h"
+
+#include <algorithm>
+
+namespace {
+
+std::uint64_t AllocationGranularity() noexcept {
+    SYSTEM_INFO info{};
+    ::GetSystemInfo(&info);
+    return info.dwAllocationGranularity;
+}
+
+} // namespace
+
+namespace core {
+
+MappedFile::MappedFile() noexcept : size_(0), view_(nullptr), viewSize_(0) {}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const std::wstring& path) {
+    Close();
+
+    file_.Reset(::CreateFileW(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr));
+    LARGE_INTEGER size{};
+    if (!file_.IsValid() || !::GetFileSizeEx(file_.Get(), &size)) {
+        Close();
+        return false;
+    }
+    size_ = static_cast<std::uint64_t>(size.QuadPart);
+
+    // Windows cannot map an empty file; it simply has nothing to Map().
+    if (size_ > 0) {
+        HANDLE mapping = ::CreateFileMappingW(file_.Get(), nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) {
+            Close();
+            return false;
+        }
+        mapping_.Reset(mapping);
+    }
+    return true;
+}
+
+void MappedFile::Close() noexcept {
+    Unmap();
+    mapping_.Reset();
+    file_.Reset();
+    size_ = 0;
+}
+
+bool MappedFile::IsOpen() const noexcept {
+    return file_.IsValid();
+}
+
+std::uint64_t MappedFile::Size() const noexcept {
+    return size_;
+}
+
+std::span<const uint8_t> MappedFile::Map(std::uint64_t offset, std::size_t size) {
+    Unmap();
+    if (!mapping_.IsValid() || offset >= size_ || size == 0) {
+        return {};
+    }
+
+    static const std::uint64_t granularity = AllocationGranularity();
+    const std::uint64_t start = offset - offset % granularity;
+    const std::uint64_t end = std::min<std::uint64_t>(size_, offset + size);
+    const auto length = static_cast<SIZE_T>(end - start);
+
+    void* view = ::MapViewOfFile(
+        mapping_.Get(),
+        FILE_MAP_READ,
+        static_cast<DWORD>(start >> 32U),
+        static_cast<DWORD>(start & 0xFFFFFFFFU),
+        length);
+    if (view == nullptr) {
+        return {};
+    }
+    view_ = view;
+    viewSize_ = length;
+    return {static_cast<const uint8_t*>(view) + (offset - start), static_cast<std::size_t>(end - offset)};
+}
+
+void MappedFile::Unmap() noexcept {
+    if (view_ != nullptr) {
+        ::UnmapViewOfFile(view_);
+        view_ = nullptr;
+        viewSize_ = 0;
+    }
+}
+
+} // namespace core
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+#ifdef _WIN32
+#include "core/SafeHandle.h"
+#else
+#include "core/UniqueFd.h"
+#endif
+
+namespace core {
+
+// Read-only file mapped through one sliding view, so files larger than the address space budget
+// can be streamed with a fixed amount of mapped memory. Not thread-safe.
+class MappedFile final {
+public:
+    MappedFile() noexcept;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::wstring& path);
+    void Close() noexcept;
+    [[nodiscard]] bool IsOpen() const noexcept;
+    [[nodiscard]] std::uint64_t Size() const noexcept;
+
+    // Replaces the current view with [offset, offset + size), clipped to the end of the file.
+    // The span stays valid until the next Map() or Close(); empty on failure or past the end.
+    std::span<const uint8_t> Map(std::uint64_t offset, std::size_t size);
+
+private:
+    void Unmap() noexcept;
+
+#ifdef _WIN32
+    SafeHandle file_;
+    SafeHandle mapping_;
+#else
+    UniqueFd file_;
+#endif
+    std::uint64_t size_;
+    void* view_;           // Start of the mapped view, aligned down from the requested offset.
+    std::size_t viewSize_;
+};
+
+} // namespace core
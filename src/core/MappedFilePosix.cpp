@@ -0,0 +1,85 @@
+#include "core/MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <filesystem>
+
+namespace core {
+
+MappedFile::MappedFile() noexcept : size_(0), view_(nullptr), viewSize_(0) {}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const std::wstring& path) {
+    Close();
+
+    std::string narrow;
+    try {
+        narrow = std::filesystem::path(path).string();
+    } catch (const std::exception&) {
+        return false;
+    }
+
+    file_.Reset(::open(narrow.c_str(), O_RDONLY | O_CLOEXEC));
+    struct stat info{};
+    if (!file_.IsValid() || ::fstat(file_.Get(), &info) != 0 || !S_ISREG(info.st_mode)) {
+        Close();
+        return false;
+    }
+    size_ = static_cast<std::uint64_t>(info.st_size);
+    ::posix_fadvise(file_.Get(), 0, 0, POSIX_FADV_SEQUENTIAL);
+    return true;
+}
+
+void MappedFile::Close() noexcept {
+    Unmap();
+    file_.Reset();
+    size_ = 0;
+}
+
+bool MappedFile::IsOpen() const noexcept {
+    return file_.IsValid();
+}
+
+std::uint64_t MappedFile::Size() const noexcept {
+    return size_;
+}
+
+std::span<const uint8_t> MappedFile::Map(std::uint64_t offset, std::size_t size) {
+    Unmap();
+    if (!file_.IsValid() || offset >= size_ || size == 0) {
+        return {};
+    }
+
+    static const auto pageSize = static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+    const std::uint64_t start = offset - offset % pageSize;
+    const std::uint64_t end = std::min<std::uint64_t>(size_, offset + size);
+    const auto length = static_cast<std::size_t>(end - start);
+
+    void* view = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, file_.Get(), static_cast<off_t>(start));
+    if (view == MAP_FAILED) {
+        return {};
+    }
+    // The view is read front to back once: ask for readahead now and let the pages go when unmapped.
+    ::madvise(view, length, MADV_SEQUENTIAL);
+    ::madvise(view, length, MADV_WILLNEED);
+    view_ = view;
+    viewSize_ = length;
+    return {static_cast<const uint8_t*>(view) + (offset - start), static_cast<std::size_t>(end - offset)};
+}
+
+void MappedFile::Unmap() noexcept {
+    if (view_ != nullptr) {
+        ::munmap(view_, viewSize_);
+        view_ = nullptr;
+        viewSize_ = 0;
+    }
+}
+
+} // namespace core
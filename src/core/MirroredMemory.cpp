@@ -0,0 +1,139 @@
+#include "core/MirroredMemory.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "core/SafeHandle.h"
+
+// Placeholder flags from newer SDKs; the values are fixed by the Windows ABI.
+#ifndef MEM_RESERVE_PLACEHOLDER
+#define MEM_RESERVE_PLACEHOLDER 0x00040000
+#endif
+#ifndef MEM_REPLACE_PLACEHOLDER
+#define MEM_REPLACE_PLACEHOLDER 0x00004000
+#endif
+#ifndef MEM_PRESERVE_PLACEHOLDER
+#define MEM_PRESERVE_PLACEHOLDER 0x00000002
+#endif
+
+namespace {
+
+// VirtualAlloc2 and MapViewOfFile3 appeared in Windows 10 1803; looked up at run time so the
+// binary still starts on older systems and builds against older SDKs. The extended parameter
+// arrays are always null here.
+using VirtualAlloc2Fn = PVOID(WINAPI*)(HANDLE, PVOID, SIZE_T, ULONG, ULONG, void*, ULONG);
+using MapViewOfFile3Fn = PVOID(WINAPI*)(HANDLE, HANDLE, PVOID, ULONG64, SIZE_T, ULONG, ULONG, void*, ULONG);
+
+struct PlaceholderApi {
+    VirtualAlloc2Fn virtualAlloc2 = nullptr;
+    MapViewOfFile3Fn mapViewOfFile3 = nullptr;
+};
+
+const PlaceholderApi& Api() {
+    static const PlaceholderApi api = [] {
+        PlaceholderApi result;
+        const HMODULE kernelBase = ::GetModuleHandleW(L"kernelbase.dll");
+        if (kernelBase != nullptr) {
+            result.virtualAlloc2 = reinterpret_cast<VirtualAlloc2Fn>(::GetProcAddress(kernelBase, "VirtualAlloc2"));
+            result.mapViewOfFile3 = reinterpret_cast<MapViewOfFile3Fn>(::GetProcAddress(kernelBase, "MapViewOfFile3"));
+        }
+        return result;
+    }();
+    return api;
+}
+
+} // namespace
+
+namespace core {
+
+MirroredMemory::~MirroredMemory() {
+    Release();
+}
+
+bool MirroredMemory::Create(std::size_t size) {
+    Release();
+
+    const PlaceholderApi& api = Api();
+    if (api.virtualAlloc2 == nullptr || api.mapViewOfFile3 == nullptr) {
+        return false;
+    }
+
+    const std::size_t mapped = std::bit_ceil(std::max(size, Granularity()));
+    const auto mappedSize = static_cast<std::uint64_t>(mapped);
+    // Pagefile-backed section; the views hold a reference, so the handle can close afterwards.
+    SafeHandle section(::CreateFileMappingW(
+        INVALID_HANDLE_VALUE,
+        nullptr,
+        PAGE_READWRITE,
+        static_cast<DWORD>(mappedSize >> 32U),
+        static_cast<DWORD>(mappedSize),
+        nullptr));
+    if (!section.IsValid()) {
+        return false;
+    }
+
+    // One placeholder for both halves, split in two, each half replaced by a view.
+    auto* base = static_cast<uint8_t*>(api.virtualAlloc2(
+        nullptr, nullptr, mapped * 2U, MEM_RESERVE | MEM_RESERVE_PLACEHOLDER, PAGE_NOACCESS, nullptr, 0));
+    if (base == nullptr) {
+        return false;
+    }
+    if (!::VirtualFree(base, mapped, MEM_RELEASE | MEM_PRESERVE_PLACEHOLDER)) {
+        ::VirtualFree(base, 0, MEM_RELEASE);
+        return false;
+    }
+
+    void* first = api.mapViewOfFile3(
+        section.Get(), nullptr, base, 0, mapped, MEM_REPLACE_PLACEHOLDER, PAGE_READWRITE, nullptr, 0);
+    void* second = api.mapViewOfFile3(
+        section.Get(), nullptr, base + mapped, 0, mapped, MEM_REPLACE_PLACEHOLDER, PAGE_READWRITE, nullptr, 0);
+    if (first == nullptr || second == nullptr) {
+        if (first != nullptr) {
+            ::UnmapViewOfFile(first);
+        } else {
+            ::VirtualFree(base, 0, MEM_RELEASE);
+        }
+        if (second != nullptr) {
+            ::UnmapViewOfFile(second);
+        } else {
+            ::VirtualFree(base + mapped, 0, MEM_RELEASE);
+        }
+        return false;
+    }
+
+    data_ = base;
+    size_ = mapped;
+    return true;
+}
+
+void MirroredMemory::Release() noexcept {
+    if (data_ != nullptr) {
+        ::UnmapViewOfFile(data_);
+        ::UnmapViewOfFile(data_ + size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+}
+
+bool MirroredMemory::IsValid() const noexcept {
+    return data_ != nullptr;
+}
+
+uint8_t* MirroredMemory::Data() const noexcept {
+    return data_;
+}
+
+std::size_t MirroredMemory::Size() const noexcept {
+    return size_;
+}
+
+std::size_t MirroredMemory::Granularity() noexcept {
+    static const std::size_t granularity = [] {
+        SYSTEM_INFO info{};
+        ::GetSystemInfo(&info);
+        return static_cast<std::size_t>(info.dwAllocationGranularity);
+    }();
+    return granularity;
+}
+
+} // namespace core
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace core {
+
+// Size bytes of memory mapped twice back to back: Data()[i] and Data()[i + Size()] are the same
+// byte, so any run of up to Size() bytes starting inside the first copy is contiguous.
+class MirroredMemory final {
+public:
+    MirroredMemory() noexcept = default;
+    ~MirroredMemory();
+
+    MirroredMemory(const MirroredMemory&) = delete;
+    MirroredMemory& operator=(const MirroredMemory&) = delete;
+
+    // Rounds size up to a power of two no smaller than the mapping granularity (a page on Linux,
+    // 64 KiB on Windows). False if the system cannot map memory this way.
+    bool Create(std::size_t size);
+    void Release() noexcept;
+
+    [[nodiscard]] bool IsValid() const noexcept;
+    [[nodiscard]] uint8_t* Data() const noexcept;
+    [[nodiscard]] std::size_t Size() const noexcept;
+
+    [[nodiscard]] static std::size_t Granularity() noexcept;
+
+private:
+    uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+} // namespace core
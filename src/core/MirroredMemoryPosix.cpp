@@ -0,0 +1,69 @@
+#include "core/MirroredMemory.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+
+#include "core/UniqueFd.h"
+
+namespace core {
+
+MirroredMemory::~MirroredMemory() {
+    Release();
+}
+
+bool MirroredMemory::Create(std::size_t size) {
+    Release();
+
+    const std::size_t mapped = std::bit_ceil(std::max(size, Granularity()));
+    UniqueFd memory(::memfd_create("comterminal-ring", MFD_CLOEXEC));
+    if (!memory.IsValid() || ::ftruncate(memory.Get(), static_cast<off_t>(mapped)) != 0) {
+        return false;
+    }
+
+    // Reserve both halves first so nothing else can land between the two views.
+    void* base = ::mmap(nullptr, mapped * 2U, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    auto* bytes = static_cast<uint8_t*>(base);
+    for (uint8_t* half : {bytes, bytes + mapped}) {
+        if (::mmap(half, mapped, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, memory.Get(), 0) == MAP_FAILED) {
+            ::munmap(base, mapped * 2U);
+            return false;
+        }
+    }
+    // The mappings keep the memory alive; the descriptor is no longer needed.
+    data_ = bytes;
+    size_ = mapped;
+    return true;
+}
+
+void MirroredMemory::Release() noexcept {
+    if (data_ != nullptr) {
+        ::munmap(data_, size_ * 2U);
+    }
+    data_ = nullptr;
+    size_ = 0;
+}
+
+bool MirroredMemory::IsValid() const noexcept {
+    return data_ != nullptr;
+}
+
+uint8_t* MirroredMemory::Data() const noexcept {
+    return data_;
+}
+
+std::size_t MirroredMemory::Size() const noexcept {
+    return size_;
+}
+
+std::size_t MirroredMemory::Granularity() noexcept {
+    static const auto pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    return pageSize;
+}
+
+} // namespace core
@@ -0,0 +1,88 @@
+#include "core/MirroredRing.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace core {
+
+MirroredRing::MirroredRing() noexcept : mask_(0), head_(0), tail_(0), overruns_(0), droppedBytes_(0) {}
+
+bool MirroredRing::Create(std::size_t capacity) {
+    if (!memory_.Create(capacity)) {
+        return false;
+    }
+    mask_ = memory_.Size() - 1U;
+    head_.store(0, std::memory_order_relaxed);
+    tail_.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+bool MirroredRing::IsValid() const noexcept {
+    return memory_.IsValid();
+}
+
+std::span<uint8_t> MirroredRing::WriteSpan() noexcept {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    const std::size_t tail = tail_.load(std::memory_order_acquire);
+    return {memory_.Data() + (head & mask_), memory_.Size() - (head - tail)};
+}
+
+void MirroredRing::Commit(std::size_t size) noexcept {
+    head_.store(head_.load(std::memory_order_relaxed) + size, std::memory_order_release);
+}
+
+bool MirroredRing::Write(const uint8_t* data, std::size_t size) noexcept {
+    if (data == nullptr || size == 0U || !memory_.IsValid()) {
+        return false;
+    }
+
+    const std::span<uint8_t> free = WriteSpan();
+    if (free.size() < size) {
+        overruns_.fetch_add(1U, std::memory_order_relaxed);
+        droppedBytes_.fetch_add(size, std::memory_order_relaxed);
+        return false;
+    }
+    std::memcpy(free.data(), data, size);
+    Commit(size);
+    return true;
+}
+
+std::span<const uint8_t> MirroredRing::Peek() const noexcept {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    const std::size_t head = head_.load(std::memory_order_acquire);
+    return {memory_.Data() + (tail & mask_), head - tail};
+}
+
+void MirroredRing::Consume(std::size_t size) noexcept {
+    tail_.store(tail_.load(std::memory_order_relaxed) + size, std::memory_order_release);
+}
+
+std::size_t MirroredRing::Read(uint8_t* buffer, std::size_t size) noexcept {
+    if (buffer == nullptr || size == 0U) {
+        return 0;
+    }
+    const std::span<const uint8_t> data = Peek();
+    const std::size_t count = std::min(size, data.size());
+    std::memcpy(buffer, data.data(), count);
+    Consume(count);
+    return count;
+}
+
+std::size_t MirroredRing::Capacity() const noexcept {
+    return memory_.Size();
+}
+
+std::size_t MirroredRing::Size() const noexcept {
+    const std::size_t tail = tail_.load(std::memory_order_acquire);
+    return head_.load(std::memory_order_acquire) - tail;
+}
+
+std::uint64_t MirroredRing::Overruns() const noexcept {
+    return overruns_.load(std::memory_order_relaxed);
+}
+
+std::uint64_t MirroredRing::DroppedBytes() const noexcept {
+    return droppedBytes_.load(std::memory_order_relaxed);
+}
+
+} // namespace core
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "core/MirroredMemory.h"
+
+namespace core {
+
+// Single-producer/single-consumer byte ring on MirroredMemory. Because the storage is mapped
+// twice back to back, the free space and the readable data are each one contiguous span even
+// across the wrap: the producer can read from a port straight into WriteSpan(), and a decoder or
+// formatter can work on Peek() in place instead of copying out.
+class MirroredRing final {
+public:
+    MirroredRing() noexcept;
+
+    MirroredRing(const MirroredRing&) = delete;
+    MirroredRing& operator=(const MirroredRing&) = delete;
+
+    // The capacity is rounded like MirroredMemory::Create(). False where mirroring is unavailable.
+    bool Create(std::size_t capacity);
+    [[nodiscard]] bool IsValid() const noexcept;
+
+    // Producer side. WriteSpan() is all the free space; Commit() publishes its first size bytes.
+    [[nodiscard]] std::span<uint8_t> WriteSpan() noexcept;
+    void Commit(std::size_t size) noexcept;
+    // All or nothing: data that does not fit is dropped and counted.
+    bool Write(const uint8_t* data, std::size_t size) noexcept;
+
+    // Consumer side. Peek() is every readable byte, valid until the matching Consume().
+    [[nodiscard]] std::span<const uint8_t> Peek() const noexcept;
+    void Consume(std::size_t size) noexcept;
+    std::size_t Read(uint8_t* buffer, std::size_t size) noexcept;
+
+    [[nodiscard]] std::size_t Capacity() const noexcept;
+    // Exact on the producer or consumer thread, a snapshot anywhere else.
+    [[nodiscard]] std::size_t Size() const noexcept;
+    [[nodiscard]] std::uint64_t Overruns() const noexcept;
+    [[nodiscard]] std::uint64_t DroppedBytes() const noexcept;
+
+private:
+    static constexpr std::size_t kCacheLine = 64;
+
+    MirroredMemory memory_;
+    std::size_t mask_;
+
+    alignas(kCacheLine) std::atomic<std::size_t> head_;
+    alignas(kCacheLine) std::atomic<std::size_t> tail_;
+    alignas(kCacheLine) std::atomic<std::uint64_t> overruns_;
+    std::atomic<std::uint64_t> droppedBytes_;
+};
+
+} // namespace core
@@ -0,0 +1,23 @@
+#pragma once
+
+#ifdef _WIN32
+
+// Before windows.h, which would otherwise pull in the old winsock.h.
+#include <winsock2.h>
+#include <windows.h>
+
+#else
+
+#include <cstdint>
+
+using DWORD = std::uint32_t;
+using BYTE = std::uint8_t;
+using COLORREF = std::uint32_t;
+
+// Same bit values as GetCommModemStatus, so GetModemStatus() masks match on every platform.
+constexpr DWORD MS_CTS_ON = 0x0010U;
+constexpr DWORD MS_DSR_ON = 0x0020U;
+constexpr DWORD MS_RING_ON = 0x0040U;
+constexpr DWORD MS_RLSD_ON = 0x0080U;
+
+#endif
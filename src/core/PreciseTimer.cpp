@@ -0,0 +1,68 @@
+#include "core/PreciseTimer.h"
+
+#include "core/Clock.h"
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+namespace {
+
+HANDLE CreateTimer() {
+    // High-resolution timers (Windows 10 1803+) are not tied to the 15.6 ms system tick.
+    HANDLE timer = ::CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    if (timer == nullptr) {
+        timer = ::CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+    }
+    return timer;
+}
+
+} // namespace
+
+namespace core {
+
+PreciseTimer::PreciseTimer()
+    : timer_(CreateTimer()),
+      interrupt_(::CreateEventW(nullptr, TRUE, FALSE, nullptr)) {}
+
+bool PreciseTimer::IsValid() const noexcept {
+    return timer_.IsValid() && interrupt_.IsValid();
+}
+
+bool PreciseTimer::WaitUntil(std::int64_t deadlineNs, std::int64_t spinNs) {
+    if (!IsValid()) {
+        return false;
+    }
+
+    // Waitable timers take relative due times in 100 ns units (negative means relative).
+    const std::int64_t sleepNs = deadlineNs - spinNs - MonotonicNanos();
+    if (sleepNs > 0) {
+        LARGE_INTEGER due{};
+        due.QuadPart = -(sleepNs / 100);
+        if (!::SetWaitableTimer(timer_.Get(), &due, 0, nullptr, nullptr, FALSE)) {
+            return false;
+        }
+        HANDLE waits[2] = {interrupt_.Get(), timer_.Get()};
+        if (::WaitForMultipleObjects(2, waits, FALSE, INFINITE) != WAIT_OBJECT_0 + 1U) {
+            return false;
+        }
+    }
+
+    while (MonotonicNanos() < deadlineNs) {
+        if (::WaitForSingleObject(interrupt_.Get(), 0) == WAIT_OBJECT_0) {
+            return false;
+        }
+        ::SwitchToThread();
+    }
+    return ::WaitForSingleObject(interrupt_.Get(), 0) != WAIT_OBJECT_0;
+}
+
+void PreciseTimer::Interrupt() {
+    ::SetEvent(interrupt_.Get());
+}
+
+void PreciseTimer::ClearInterrupt() {
+    ::ResetEvent(interrupt_.Get());
+}
+
+} // namespace core
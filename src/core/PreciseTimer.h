@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+#ifdef _WIN32
+#include "core/SafeHandle.h"
+#else
+#include "core/UniqueFd.h"
+#endif
+
+namespace core {
+
+// Waits for core::MonotonicNanos() deadlines with microsecond accuracy. The OS timer
+// (high-resolution waitable timer / timerfd with minimal timer slack) wakes the thread spinNs
+// before the deadline and the remainder is spent re-reading the clock, yielding in between so a
+// single core is not monopolized. One waiting thread at a time; Interrupt() may come from any.
+class PreciseTimer final {
+public:
+    static constexpr std::int64_t kDefaultSpinNs = 100 * 1000;
+
+    PreciseTimer();
+    ~PreciseTimer() = default;
+
+    PreciseTimer(const PreciseTimer&) = delete;
+    PreciseTimer& operator=(const PreciseTimer&) = delete;
+
+    [[nodiscard]] bool IsValid() const noexcept;
+
+    // Returns false if interrupted (or the timer is unusable) before the deadline.
+    bool WaitUntil(std::int64_t deadlineNs, std::int64_t spinNs = kDefaultSpinNs);
+    // Makes the current and every later WaitUntil() return false until ClearInterrupt().
+    void Interrupt();
+    void ClearInterrupt();
+
+private:
+#ifdef _WIN32
+    SafeHandle timer_;
+    SafeHandle interrupt_;
+#else
+    UniqueFd timer_;
+    UniqueFd interrupt_;
+#endif
+};
+
+} // namespace core
@@ -0,0 +1,94 @@
+#include "core/PreciseTimer.h"
+
+#include <poll.h>
+#include <sched.h>
+#include <sys/eventfd.h>
+#include <sys/prctl.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+#include "core/Clock.h"
+
+namespace {
+
+constexpr std::int64_t kNanosPerSecond = 1000000000;
+
+// Timer slack is per thread and defaults to 50 us, which would swallow the whole spin margin.
+void MinimizeTimerSlack() {
+    thread_local bool done = false;
+    if (!done) {
+        ::prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+        done = true;
+    }
+}
+
+bool IsSignaled(int eventFd) {
+    pollfd wait{eventFd, POLLIN, 0};
+    return ::poll(&wait, 1, 0) > 0;
+}
+
+} // namespace
+
+namespace core {
+
+PreciseTimer::PreciseTimer()
+    : timer_(::timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK)),
+      interrupt_(::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {}
+
+bool PreciseTimer::IsValid() const noexcept {
+    return timer_.IsValid() && interrupt_.IsValid();
+}
+
+bool PreciseTimer::WaitUntil(std::int64_t deadlineNs, std::int64_t spinNs) {
+    if (!IsValid()) {
+        return false;
+    }
+    MinimizeTimerSlack();
+
+    // CLOCK_MONOTONIC is the clock behind MonotonicNanos(), so the deadline arms the timer as is.
+    const std::int64_t wakeNs = deadlineNs - spinNs;
+    if (wakeNs > MonotonicNanos()) {
+        itimerspec spec{};
+        spec.it_value.tv_sec = static_cast<time_t>(wakeNs / kNanosPerSecond);
+        spec.it_value.tv_nsec = static_cast<long>(wakeNs % kNanosPerSecond);
+        if (::timerfd_settime(timer_.Get(), TFD_TIMER_ABSTIME, &spec, nullptr) != 0) {
+            return false;
+        }
+
+        pollfd waits[2] = {{interrupt_.Get(), POLLIN, 0}, {timer_.Get(), POLLIN, 0}};
+        for (;;) {
+            const int ready = ::poll(waits, 2, -1);
+            if (ready < 0 && errno == EINTR) {
+                continue;
+            }
+            if (ready < 0 || (waits[0].revents & POLLIN) != 0) {
+                return false;
+            }
+            break;
+        }
+        std::uint64_t expirations = 0;
+        [[maybe_unused]] const ssize_t ignored = ::read(timer_.Get(), &expirations, sizeof(expirations));
+    }
+
+    while (MonotonicNanos() < deadlineNs) {
+        if (IsSignaled(interrupt_.Get())) {
+            return false;
+        }
+        ::sched_yield();
+    }
+    return !IsSignaled(interrupt_.Get());
+}
+
+void PreciseTimer::Interrupt() {
+    const std::uint64_t one = 1;
+    [[maybe_unused]] const ssize_t ignored = ::write(interrupt_.Get(), &one, sizeof(one));
+}
+
+void PreciseTimer::ClearInterrupt() {
+    std::uint64_t value = 0;
+    [[maybe_unused]] const ssize_t ignored = ::read(interrupt_.Get(), &value, sizeof(value));
+}
+
+} // namespace core
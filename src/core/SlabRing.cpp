@@ -0,0 +1,111 @@
+#include "core/SlabRing.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace core {
+
+SlabRing::SlabRing(std::size_t slabCount, std::size_t slabSize)
+    : slabCount_(std::max<std::size_t>(slabCount, 1U)),
+      slabSize_(std::max<std::size_t>(slabSize, 1U)),
+      storage_(std::make_unique<uint8_t[]>(slabCount_ * slabSize_)),
+      sizes_(std::make_unique<std::size_t[]>(slabCount_)),
+      timestamps_(std::make_unique<std::int64_t[]>(slabCount_)),
+      head_(0),
+      tail_(0),
+      overruns_(0),
+      droppedBytes_(0) {
+}
+
+SlabRing::~SlabRing() = default;
+
+std::span<uint8_t> SlabRing::AcquireWrite() noexcept {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    const std::size_t tail = tail_.load(std::memory_order_acquire);
+    if (head - tail >= slabCount_) {
+        return {};
+    }
+    return {SlabData(head), slabSize_};
+}
+
+void SlabRing::CommitWrite(std::size_t size, std::int64_t timestampNs) noexcept {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    sizes_[head % slabCount_] = std::min(size, slabSize_);
+    timestamps_[head % slabCount_] = timestampNs;
+    head_.store(head + 1U, std::memory_order_release);
+}
+
+bool SlabRing::Publish(const uint8_t* data, std::size_t size, std::int64_t timestampNs) noexcept {
+    if (data == nullptr || size == 0U) {
+        return false;
+    }
+
+    std::size_t offset = 0;
+    while (offset < size) {
+        const std::span<uint8_t> slab = AcquireWrite();
+        if (slab.empty()) {
+            overruns_.fetch_add(1U, std::memory_order_relaxed);
+            droppedBytes_.fetch_add(size - offset, std::memory_order_relaxed);
+            return false;
+        }
+
+        const std::size_t chunk = std::min(size - offset, slab.size());
+        std::memcpy(slab.data(), data + offset, chunk);
+        CommitWrite(chunk, timestampNs);
+        offset += chunk;
+    }
+    return true;
+}
+
+std::span<const uint8_t> SlabRing::Front() const noexcept {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    const std::size_t head = head_.load(std::memory_order_acquire);
+    if (tail == head) {
+        return {};
+    }
+    return {SlabData(tail), sizes_[tail % slabCount_]};
+}
+
+std::int64_t SlabRing::FrontTimestamp() const noexcept {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    const std::size_t head = head_.load(std::memory_order_acquire);
+    if (tail == head) {
+        return 0;
+    }
+    return timestamps_[tail % slabCount_];
+}
+
+void SlabRing::Release() noexcept {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire)) {
+        return;
+    }
+    tail_.store(tail + 1U, std::memory_order_release);
+}
+
+std::size_t SlabRing::SlabCount() const noexcept {
+    return slabCount_;
+}
+
+std::size_t SlabRing::SlabSize() const noexcept {
+    return slabSize_;
+}
+
+std::size_t SlabRing::InFlight() const noexcept {
+    const std::size_t tail = tail_.load(std::memory_order_acquire);
+    return head_.load(std::memory_order_acquire) - tail;
+}
+
+std::uint64_t SlabRing::Overruns() const noexcept {
+    return overruns_.load(std::memory_order_relaxed);
+}
+
+std::uint64_t SlabRing::DroppedBytes() const noexcept {
+    return droppedBytes_.load(std::memory_order_relaxed);
+}
+
+uint8_t* SlabRing::SlabData(std::size_t sequence) const noexcept {
+    return storage_.get() + (sequence % slabCount_) * slabSize_;
+}
+
+} // namespace core
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+namespace core {
+
+// Single-producer/single-consumer ring of fixed-size slabs, allocated once up front.
+// The producer (read thread) fills and commits slabs, the consumer reads and releases them.
+class SlabRing final {
+public:
+    SlabRing(std::size_t slabCount, std::size_t slabSize);
+    ~SlabRing();
+
+    SlabRing(const SlabRing&) = delete;
+    SlabRing& operator=(const SlabRing&) = delete;
+
+    // Producer side.
+    [[nodiscard]] std::span<uint8_t> AcquireWrite() noexcept;
+    void CommitWrite(std::size_t size, std::int64_t timestampNs = 0) noexcept;
+    bool Publish(const uint8_t* data, std::size_t size, std::int64_t timestampNs = 0) noexcept;
+
+    // Consumer side.
+    [[nodiscard]] std::span<const uint8_t> Front() const noexcept;
+    // Timestamp committed with the Front() slab; 0 when the ring is empty.
+    [[nodiscard]] std::int64_t FrontTimestamp() const noexcept;
+    void Release() noexcept;
+
+    [[nodiscard]] std::size_t SlabCount() const noexcept;
+    [[nodiscard]] std::size_t SlabSize() const noexcept;
+    [[nodiscard]] std::size_t InFlight() const noexcept;
+    [[nodiscard]] std::uint64_t Overruns() const noexcept;
+    [[nodiscard]] std::uint64_t DroppedBytes() const noexcept;
+
+private:
+    static constexpr std::size_t kCacheLine = 64;
+
+    [[nodiscard]] uint8_t* SlabData(std::size_t sequence) const noexcept;
+
+    std::size_t slabCount_;
+    std::size_t slabSize_;
+    std::unique_ptr<uint8_t[]> storage_;
+    std::unique_ptr<std::size_t[]> sizes_;
+    std::unique_ptr<std::int64_t[]> timestamps_;
+
+    alignas(kCacheLine) std::atomic<std::size_t> head_;
+    alignas(kCacheLine) std::atomic<std::size_t> tail_;
+    alignas(kCacheLine) std::atomic<std::uint64_t> overruns_;
+    std::atomic<std::uint64_t> droppedBytes_;
+};
+
+} // namespace core
@@ -0,0 +1,92 @@
+#include "core/SpillFile.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr DWORD kMaxTransfer = 1U << 30;
+
+std::wstring TempSpillPath() {
+    wchar_t directory[MAX_PATH + 1] = {};
+    wchar_t path[MAX_PATH + 1] = {};
+    if (::GetTempPathW(MAX_PATH + 1, directory) == 0 || ::GetTempFileNameW(directory, L"cts", 0, path) == 0) {
+        return {};
+    }
+    return path;
+}
+
+OVERLAPPED AtOffset(std::uint64_t offset) noexcept {
+    OVERLAPPED overlapped{};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32U);
+    return overlapped;
+}
+
+} // namespace
+
+namespace core {
+
+SpillFile::~SpillFile() {
+    Close();
+}
+
+bool SpillFile::Open(const std::wstring& path) {
+    Close();
+
+    const std::wstring target = path.empty() ? TempSpillPath() : path;
+    if (target.empty()) {
+        return false;
+    }
+    // Temporary files stay in the cache as long as memory allows; the system deletes the file
+    // when the handle closes, including after a crash.
+    file_.Reset(::CreateFileW(
+        target.c_str(),
+        GENERIC_READ | GENERIC_WRITE,
+        FILE_SHARE_DELETE,
+        nullptr,
+        CREATE_ALWAYS,
+        FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE,
+        nullptr));
+    return file_.IsValid();
+}
+
+void SpillFile::Close() noexcept {
+    file_.Reset();
+}
+
+bool SpillFile::IsOpen() const noexcept {
+    return file_.IsValid();
+}
+
+bool SpillFile::WriteAt(std::uint64_t offset, const uint8_t* data, std::size_t size) noexcept {
+    while (size > 0) {
+        // An explicit offset in OVERLAPPED leaves the handle's file pointer alone.
+        OVERLAPPED overlapped = AtOffset(offset);
+        const auto chunk = static_cast<DWORD>(std::min<std::size_t>(size, kMaxTransfer));
+        DWORD written = 0;
+        if (!::WriteFile(file_.Get(), data, chunk, &written, &overlapped) || written == 0) {
+            return false;
+        }
+        data += written;
+        size -= written;
+        offset += written;
+    }
+    return true;
+}
+
+bool SpillFile::ReadAt(std::uint64_t offset, uint8_t* buffer, std::size_t size) const noexcept {
+    while (size > 0) {
+        OVERLAPPED overlapped = AtOffset(offset);
+        const auto chunk = static_cast<DWORD>(std::min<std::size_t>(size, kMaxTransfer));
+        DWORD read = 0;
+        if (!::ReadFile(file_.Get(), buffer, chunk, &read, &overlapped) || read == 0) {
+            return false;
+        }
+        buffer += read;
+        size -= read;
+        offset += read;
+    }
+    return true;
+}
+
+} // namespace core
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifdef _WIN32
+#include "core/SafeHandle.h"
+#else
+#include "core/UniqueFd.h"
+#endif
+
+namespace core {
+
+// Scratch file addressed by offset, removed when closed. One thread may write while another
+// reads different offsets; neither moves a shared file position.
+class SpillFile final {
+public:
+    SpillFile() noexcept = default;
+    ~SpillFile();
+
+    SpillFile(const SpillFile&) = delete;
+    SpillFile& operator=(const SpillFile&) = delete;
+
+    // Creates the file, replacing an existing one; an empty path picks a new file in the
+    // temporary directory.
+    bool Open(const std::wstring& path);
+    void Close() noexcept;
+    [[nodiscard]] bool IsOpen() const noexcept;
+
+    // Whole transfer or false.
+    bool WriteAt(std::uint64_t offset, const uint8_t* data, std::size_t size) noexcept;
+    bool ReadAt(std::uint64_t offset, uint8_t* buffer, std::size_t size) const noexcept;
+
+private:
+#ifdef _WIN32
+    SafeHandle file_;
+#else
+    UniqueFd file_;
+#endif
+};
+
+} // namespace core
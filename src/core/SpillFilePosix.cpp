@@ -0,0 +1,81 @@
+#include "core/SpillFile.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+namespace core {
+
+SpillFile::~SpillFile() {
+    Close();
+}
+
+bool SpillFile::Open(const std::wstring& path) {
+    Close();
+
+    std::string narrow;
+    try {
+        narrow = path.empty() ? (std::filesystem::temp_directory_path() / "comterminal-spill-XXXXXX").string()
+                              : std::filesystem::path(path).string();
+    } catch (const std::exception&) {
+        return false;
+    }
+
+    if (path.empty()) {
+        file_.Reset(::mkostemp(narrow.data(), O_CLOEXEC));
+    } else {
+        file_.Reset(::open(narrow.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600));
+    }
+    if (!file_.IsValid()) {
+        return false;
+    }
+    // Nothing else needs the name; the data goes away with the descriptor.
+    ::unlink(narrow.c_str());
+    return true;
+}
+
+void SpillFile::Close() noexcept {
+    file_.Reset();
+}
+
+bool SpillFile::IsOpen() const noexcept {
+    return file_.IsValid();
+}
+
+bool SpillFile::WriteAt(std::uint64_t offset, const uint8_t* data, std::size_t size) noexcept {
+    while (size > 0) {
+        const ssize_t written = ::pwrite(file_.Get(), data, size, static_cast<off_t>(offset));
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+        offset += static_cast<std::uint64_t>(written);
+    }
+    return true;
+}
+
+bool SpillFile::ReadAt(std::uint64_t offset, uint8_t* buffer, std::size_t size) const noexcept {
+    while (size > 0) {
+        const ssize_t read = ::pread(file_.Get(), buffer, size, static_cast<off_t>(offset));
+        if (read < 0 && errno == EINTR) {
+            continue;
+        }
+        if (read <= 0) {
+            return false;
+        }
+        buffer += read;
+        size -= static_cast<std::size_t>(read);
+        offset += static_cast<std::uint64_t>(read);
+    }
+    return true;
+}
+
+} // namespace core
@@ -0,0 +1,45 @@
+#include "core/UniqueFd.h"
+
+#include <unistd.h>
+
+namespace core {
+
+UniqueFd::UniqueFd() noexcept : fd_(-1) {}
+
+UniqueFd::UniqueFd(int fd) noexcept : fd_(fd) {}
+
+UniqueFd::~UniqueFd() noexcept {
+    Reset();
+}
+
+UniqueFd::UniqueFd(UniqueFd&& other) noexcept : fd_(other.Release()) {}
+
+UniqueFd& UniqueFd::operator=(UniqueFd&& other) noexcept {
+    if (this != &other) {
+        Reset(other.Release());
+    }
+    return *this;
+}
+
+bool UniqueFd::IsValid() const noexcept {
+    return fd_ >= 0;
+}
+
+int UniqueFd::Get() const noexcept {
+    return fd_;
+}
+
+int UniqueFd::Release() noexcept {
+    const int current = fd_;
+    fd_ = -1;
+    return current;
+}
+
+void UniqueFd::Reset(int fd) noexcept {
+    if (IsValid()) {
+        ::close(fd_);
+    }
+    fd_ = fd;
+}
+
+} // namespace core
@@ -0,0 +1,27 @@
+#pragma once
+
+namespace core {
+
+class UniqueFd final {
+public:
+    UniqueFd() noexcept;
+    explicit UniqueFd(int fd) noexcept;
+    ~UniqueFd() noexcept;
+
+    UniqueFd(const UniqueFd&) = delete;
+    UniqueFd& operator=(const UniqueFd&) = delete;
+
+    UniqueFd(UniqueFd&& other) noexcept;
+    UniqueFd& operator=(UniqueFd&& other) noexcept;
+
+    [[nodiscard]] bool IsValid() const noexcept;
+    [[nodiscard]] int Get() const noexcept;
+
+    int Release() noexcept;
+    void Reset(int fd = -1) noexcept;
+
+private:
+    int fd_;
+};
+
+} // namespace core
@@ -0,0 +1,313 @@
+#include "serial/AutoBaud.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <thread>
+
+#include "serial/SerialPort.h"
+
+namespace {
+
+using serial::AutoBaudCandidate;
+using serial::LineCapture;
+using serial::ParityMode;
+using serial::PortSettings;
+using serial::StopBitsMode;
+
+// Below this many samples per bit the centre of a bit cannot be found reliably, so oversampled
+// captures only score rates at least this far below the sample rate.
+constexpr double kMinOversampling = 4.0;
+
+// Errors outweigh everything else; the plausibility terms only separate clean decodings.
+constexpr double kErrorWeight = 10.0;
+constexpr double kPrintableWeight = 1.0;
+constexpr double kEntropyWeight = 0.25;
+// Equally clean decodings prefer the plainer format: a receiver set to 8N1 also reads 8N2 and a
+// receiver set to 7N1 reads 7N2, so the extra bits would only be a guess.
+constexpr double kShortDataPenalty = 0.02;
+constexpr double kParityPenalty = 0.03;
+constexpr double kExtraStopPenalty = 0.02;
+
+struct Task {
+    std::size_t capture;
+    PortSettings settings;
+};
+
+PortSettings Format(DWORD baudRate, BYTE dataBits, ParityMode parity, StopBitsMode stopBits) {
+    PortSettings settings{};
+    settings.baudRate = baudRate;
+    settings.dataBits = dataBits;
+    settings.parity = parity;
+    settings.stopBits = stopBits;
+    settings.flowControl = serial::FlowControlMode::None;
+    return settings;
+}
+
+// Combinations a Windows DCB accepts: 1.5 stop bits only with 5 data bits, 2 only with 6 to 8.
+std::vector<PortSettings> Formats(DWORD baudRate) {
+    std::vector<PortSettings> formats;
+    for (BYTE dataBits = 5; dataBits <= 8; ++dataBits) {
+        for (const ParityMode parity : {ParityMode::None, ParityMode::Odd, ParityMode::Even, ParityMode::Mark, ParityMode::Space}) {
+            formats.push_back(Format(baudRate, dataBits, parity, StopBitsMode::One));
+            formats.push_back(Format(baudRate, dataBits, parity, dataBits == 5 ? StopBitsMode::OnePointFive : StopBitsMode::Two));
+        }
+    }
+    return formats;
+}
+
+std::vector<std::size_t> FallingEdges(const LineCapture& capture) {
+    std::vector<std::size_t> edges;
+    for (std::size_t i = 1; i < capture.samples.size(); ++i) {
+        if (capture.samples[i] == 0 && capture.samples[i - 1] != 0) {
+            edges.push_back(i);
+        }
+    }
+    return edges;
+}
+
+bool ParityOk(ParityMode parity, unsigned ones, unsigned bit) {
+    switch (parity) {
+    case ParityMode::Odd:
+        return ((ones + bit) & 1U) == 1U;
+    case ParityMode::Even:
+        return ((ones + bit) & 1U) == 0U;
+    case ParityMode::Mark:
+        return bit == 1U;
+    case ParityMode::Space:
+        return bit == 0U;
+    case ParityMode::None:
+        break;
+    }
+    return true;
+}
+
+bool IsPrintable(unsigned value) {
+    return (value >= 0x20U && value <= 0x7EU) || value == '\r' || value == '\n' || value == '\t';
+}
+
+// Software UART: waits for a falling edge, samples each bit in its centre and checks parity and
+// stop bits. After a frame, good or not, it waits for the line to go back to mark like a real
+// receiver would.
+AutoBaudCandidate Decode(const LineCapture& capture, const std::vector<std::size_t>& edges, const PortSettings& settings, std::size_t maxFrames) {
+    AutoBaudCandidate result;
+    result.settings = settings;
+
+    const double samplesPerBit = static_cast<double>(capture.sampleRate) / settings.baudRate;
+    const bool hasParity = settings.parity != ParityMode::None;
+    const double stopStart = 1.0 + settings.dataBits + (hasParity ? 1.0 : 0.0);
+    const double lastStopCentre = stopStart + (settings.stopBits == StopBitsMode::Two ? 1.5 :
+                                               settings.stopBits == StopBitsMode::OnePointFive ? 1.25 : 0.5);
+    const std::size_t frameSamples = static_cast<std::size_t>(std::ceil((lastStopCentre + 0.5) * samplesPerBit));
+
+    std::array<std::size_t, 256> histogram{};
+    std::size_t nextFree = 0;
+    for (const std::size_t start : edges) {
+        if (result.frames >= maxFrames || start + frameSamples > capture.samples.size()) {
+            break;
+        }
+        if (start < nextFree) {
+            continue;
+        }
+        const auto level = [&](double bit) {
+            return static_cast<unsigned>(capture.samples[start + static_cast<std::size_t>(bit * samplesPerBit)] != 0);
+        };
+        if (level(0.5) != 0U) {
+            continue; // Glitch shorter than half a bit.
+        }
+
+        unsigned value = 0;
+        unsigned ones = 0;
+        for (unsigned bit = 0; bit < settings.dataBits; ++bit) {
+            const unsigned sample = level(1.5 + bit);
+            value |= sample << bit;
+            ones += sample;
+        }
+        if (hasParity && !ParityOk(settings.parity, ones, level(stopStart - 0.5))) {
+            ++result.parityErrors;
+        }
+        bool framed = level(stopStart + 0.5) == 1U;
+        if (settings.stopBits != StopBitsMode::One) {
+            framed = framed && level(lastStopCentre) == 1U;
+        }
+        result.framingErrors += framed ? 0U : 1U;
+
+        ++result.frames;
+        ++histogram[value];
+        nextFree = start + static_cast<std::size_t>(lastStopCentre * samplesPerBit);
+    }
+
+    if (result.frames == 0) {
+        return result;
+    }
+    const double frames = static_cast<double>(result.frames);
+    std::size_t printable = 0;
+    for (std::size_t value = 0; value < histogram.size(); ++value) {
+        if (histogram[value] == 0) {
+            continue;
+        }
+        const double p = static_cast<double>(histogram[value]) / frames;
+        result.entropy -= p * std::log2(p);
+        printable += IsPrintable(static_cast<unsigned>(value)) ? histogram[value] : 0U;
+    }
+    // Per eight bits for every format: normalizing by dataBits would favour shorter characters.
+    result.entropy /= 8.0;
+    result.printableRatio = (settings.dataBits >= 7) ? static_cast<double>(printable) / frames : 0.0;
+
+    const double errorRate = static_cast<double>(result.framingErrors + result.parityErrors) / frames;
+    result.score = kPrintableWeight * result.printableRatio + kEntropyWeight * result.entropy - kErrorWeight * errorRate -
+        kShortDataPenalty * (8 - settings.dataBits) - (hasParity ? kParityPenalty : 0.0) -
+        (settings.stopBits != StopBitsMode::One ? kExtraStopPenalty : 0.0);
+    return result;
+}
+
+void AppendLevel(std::vector<uint8_t>& samples, uint8_t level, double bits, double samplesPerBit, double* phase) {
+    // Carries the fractional part over, so non-integer ratios do not drift.
+    *phase += bits * samplesPerBit;
+    const auto count = static_cast<std::size_t>(*phase);
+    *phase -= static_cast<double>(count);
+    samples.insert(samples.end(), count, level);
+}
+
+} // namespace
+
+namespace serial {
+
+void LineCapture::AppendIdle(std::size_t count) {
+    samples.insert(samples.end(), count, uint8_t{1});
+}
+
+void LineCapture::AppendFrames(std::span<const uint8_t> bytes, const PortSettings& format, DWORD baudRate, std::size_t idleBits) {
+    if (baudRate == 0 || sampleRate < baudRate) {
+        return;
+    }
+    const double samplesPerBit = static_cast<double>(sampleRate) / baudRate;
+    const double stopBits = format.stopBits == StopBitsMode::Two ? 2.0 : format.stopBits == StopBitsMode::OnePointFive ? 1.5 : 1.0;
+    double phase = 0.0;
+
+    for (const uint8_t byte : bytes) {
+        AppendLevel(samples, 0, 1.0, samplesPerBit, &phase);
+        unsigned ones = 0;
+        for (unsigned bit = 0; bit < format.dataBits; ++bit) {
+            const auto level = static_cast<uint8_t>((byte >> bit) & 1U);
+            ones += level;
+            AppendLevel(samples, level, 1.0, samplesPerBit, &phase);
+        }
+        if (format.parity != ParityMode::None) {
+            const uint8_t parity = format.parity == ParityMode::Odd ? static_cast<uint8_t>((ones & 1U) ^ 1U) :
+                format.parity == ParityMode::Even                  ? static_cast<uint8_t>(ones & 1U) :
+                format.parity == ParityMode::Mark                  ? uint8_t{1} :
+                                                                     uint8_t{0};
+            AppendLevel(samples, parity, 1.0, samplesPerBit, &phase);
+        }
+        AppendLevel(samples, 1, stopBits + static_cast<double>(idleBits), samplesPerBit, &phase);
+    }
+}
+
+LineCapture LineCapture::FromReceived(std::span<const uint8_t> bytes, DWORD baudRate) {
+    LineCapture capture;
+    capture.sampleRate = baudRate;
+    capture.exactRate = true;
+    capture.AppendIdle(1);
+    capture.AppendFrames(bytes, Format(baudRate, 8, ParityMode::None, StopBitsMode::One), baudRate);
+    return capture;
+}
+
+std::vector<DWORD> AutoBaud::StandardBaudRates() {
+    return {300, 600, 1200, 2400, 4800, 9600, 14400, 19200, 38400, 57600, 115200, 230400, 460800, 921600};
+}
+
+std::vector<AutoBaudCandidate> AutoBaud::Rank(std::span<const LineCapture> captures, const AutoBaudOptions& options) {
+    const std::vector<DWORD> baudRates = options.baudRates.empty() ? StandardBaudRates() : options.baudRates;
+
+    std::vector<Task> tasks;
+    std::vector<std::vector<std::size_t>> edges(captures.size());
+    for (std::size_t i = 0; i < captures.size(); ++i) {
+        const LineCapture& capture = captures[i];
+        if (capture.sampleRate == 0) {
+            continue;
+        }
+        edges[i] = FallingEdges(capture);
+        for (const DWORD baud : baudRates) {
+            const bool usable = capture.exactRate ? baud == capture.sampleRate :
+                                                    static_cast<double>(capture.sampleRate) / baud >= kMinOversampling;
+            if (!usable) {
+                continue;
+            }
+            for (const PortSettings& format : Formats(baud)) {
+                tasks.push_back(Task{i, format});
+            }
+        }
+    }
+
+    // Candidates are independent, so workers just pull the next index.
+    std::vector<AutoBaudCandidate> results(tasks.size());
+    std::atomic<std::size_t> next{0};
+    const auto work = [&] {
+        for (std::size_t i = next.fetch_add(1); i < tasks.size(); i = next.fetch_add(1)) {
+            results[i] = Decode(captures[tasks[i].capture], edges[tasks[i].capture], tasks[i].settings, options.maxFrames);
+        }
+    };
+    const unsigned cores = options.threads != 0 ? options.threads : std::max(1U, std::thread::hardware_concurrency());
+    const std::size_t workers = std::min<std::size_t>(cores, tasks.size());
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < workers; ++i) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    std::erase_if(results, [&options](const AutoBaudCandidate& candidate) { return candidate.frames < options.minFrames; });
+    // Stable, so equal scores keep a deterministic order.
+    std::stable_sort(results.begin(), results.end(), [](const AutoBaudCandidate& a, const AutoBaudCandidate& b) {
+        return a.score > b.score;
+    });
+    return results;
+}
+
+std::optional<AutoBaudCandidate> AutoBaud::Detect(std::span<const LineCapture> captures, const AutoBaudOptions& options) {
+    std::vector<AutoBaudCandidate> ranked = Rank(captures, options);
+    if (ranked.empty()) {
+        return std::nullopt;
+    }
+    return ranked.front();
+}
+
+std::vector<LineCapture> AutoBaud::Capture(const std::wstring& portName, const AutoBaudOptions& options, const std::function<bool(DWORD)>& onRate) {
+    std::vector<LineCapture> captures;
+    const std::vector<DWORD> baudRates = options.baudRates.empty() ? StandardBaudRates() : options.baudRates;
+
+    for (const DWORD baud : baudRates) {
+        if (onRate && !onRate(baud)) {
+            break;
+        }
+
+        std::mutex mutex;
+        std::vector<uint8_t> received;
+        SerialPort port;
+        port.SetDataCallback([&mutex, &received](std::span<const uint8_t> data, std::int64_t) {
+            std::lock_guard<std::mutex> lock(mutex);
+            received.insert(received.end(), data.begin(), data.end());
+        });
+
+        PortSettings settings = Format(baud, 8, ParityMode::None, StopBitsMode::One);
+        settings.rts = true;
+        settings.dtr = true;
+        settings.readProfile = ReadProfile::Balanced;
+        if (!port.Open(portName, settings)) {
+            break;
+        }
+        std::this_thread::sleep_for(options.burst);
+        port.Close();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        captures.push_back(LineCapture::FromReceived(received, baud));
+    }
+    return captures;
+}
+
+} // namespace serial
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "core/Platform.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "serial/PortSettings.h"
+
+namespace serial {
+
+// Line levels sampled at a fixed rate: 1 is mark (idle), 0 is space. Comes either from a logic
+// analyser style recording (sampleRate well above the baud rate) or is rebuilt from bytes a UART
+// received at sampleRate, in which case only that baud rate can be scored (exactRate).
+struct LineCapture {
+    DWORD sampleRate = 0;
+    bool exactRate = false;
+    std::vector<uint8_t> samples;
+
+    void AppendIdle(std::size_t count);
+    // One asynchronous frame per byte at sampleRate / baudRate samples per bit.
+    void AppendFrames(std::span<const uint8_t> bytes, const PortSettings& format, DWORD baudRate, std::size_t idleBits = 0);
+
+    // Bytes received at baudRate in 8N1: the ten bit slots hold any ten-bit frame, so 7E1, 7O1,
+    // 7N2, 8N1 and shorter formats decode exactly. Longer frames lose their last bits.
+    static LineCapture FromReceived(std::span<const uint8_t> bytes, DWORD baudRate);
+};
+
+struct AutoBaudCandidate {
+    PortSettings settings{};
+    std::size_t frames = 0;
+    std::size_t framingErrors = 0;
+    std::size_t parityErrors = 0;
+    double entropy = 0.0;        // Bits per character of the decoded data, divided by 8.
+    double printableRatio = 0.0; // Share of decoded characters that are printable ASCII or CR/LF/TAB.
+    double score = 0.0;
+};
+
+struct AutoBaudOptions {
+    // Empty means the standard rates from 300 to 921600.
+    std::vector<DWORD> baudRates;
+    // Fewer decoded frames disqualify a candidate.
+    std::size_t minFrames = 16;
+    // Decoding stops after this many frames per candidate.
+    std::size_t maxFrames = 4096;
+    // 0 uses every core.
+    unsigned threads = 0;
+    // Live detection: how long each baud rate listens.
+    std::chrono::milliseconds burst{250};
+};
+
+// Finds the baud rate and character format of an unknown transmitter. Every combination of baud
+// rate, data bits, parity and stop bits is decoded by a software UART and scored by framing and
+// parity errors, then by the printable ratio and entropy of what it decoded. Candidates are
+// scored in parallel; everything except Capture() works offline on recorded captures.
+class AutoBaud final {
+public:
+    // Best first; disqualified candidates are left out.
+    static std::vector<AutoBaudCandidate> Rank(std::span<const LineCapture> captures, const AutoBaudOptions& options = {});
+    static std::optional<AutoBaudCandidate> Detect(std::span<const LineCapture> captures, const AutoBaudOptions& options = {});
+
+    // Listens on the port for options.burst at each baud rate in 8N1 and returns what arrived,
+    // one capture per rate. onRate(baud) is called before each; returning false stops early.
+    static std::vector<LineCapture> Capture(
+        const std::wstring& portName, const AutoBaudOptions& options = {}, const std::function<bool(DWORD)>& onRate = {});
+
+    static std::vector<DWORD> StandardBaudRates();
+};
+
+} // namespace serial
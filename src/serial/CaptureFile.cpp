@@ -0,0 +1,356 @@
+#include "serial/CaptureFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+#include "core/Clock.h"
+
+namespace {
+
+constexpr char kMagic[8] = {'C', 'O', 'M', 'T', 'C', 'A', 'P', '\0'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kHeaderBytes = 32;
+// Varint delta, kind, varint size.
+constexpr std::size_t kMaxRecordHeaderBytes = 10 + 1 + 10;
+// A crash loses at most this much of what was already appended.
+constexpr std::chrono::milliseconds kFlushInterval{100};
+
+void PutLe(std::vector<uint8_t>& out, std::uint64_t value, std::size_t bytes) {
+    for (std::size_t i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8U * i)));
+    }
+}
+
+std::uint64_t GetLe(const uint8_t* in, std::size_t bytes) {
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<std::uint64_t>(in[i]) << (8U * i);
+    }
+    return value;
+}
+
+void PutVarint(std::vector<uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80U) {
+        out.push_back(static_cast<uint8_t>(value | 0x80U));
+        value >>= 7U;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// Returns the bytes consumed, 0 if the varint does not end within in.
+std::size_t GetVarint(std::span<const uint8_t> in, std::uint64_t* value) {
+    std::uint64_t result = 0;
+    for (std::size_t i = 0; i < in.size() && i < 10; ++i) {
+        result |= static_cast<std::uint64_t>(in[i] & 0x7FU) << (7U * i);
+        if ((in[i] & 0x80U) == 0) {
+            *value = result;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+// Timestamps from different threads may arrive slightly out of order, so deltas are signed.
+std::uint64_t ZigZag(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1U) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+std::int64_t UnZigZag(std::uint64_t value) {
+    return static_cast<std::int64_t>(value >> 1U) ^ -static_cast<std::int64_t>(value & 1U);
+}
+
+} // namespace
+
+namespace serial {
+
+CaptureWriter::CaptureWriter()
+    : open_(false),
+      closing_(false),
+      lastTimestampNs_(0),
+      lostBytes_(0) {}
+
+CaptureWriter::~CaptureWriter() {
+    Close();
+}
+
+bool CaptureWriter::Open(const std::wstring& path) {
+    Close();
+
+    file_.open(std::filesystem::path(path), std::ios::binary | std::ios::out | std::ios::trunc);
+    if (!file_.is_open()) {
+        return false;
+    }
+
+    const std::int64_t originMonotonic = core::MonotonicNanos();
+    const std::int64_t originWall = core::WallNanos();
+    std::vector<uint8_t> header(std::begin(kMagic), std::end(kMagic));
+    PutLe(header, kVersion, 4);
+    PutLe(header, kHeaderBytes, 4);
+    PutLe(header, static_cast<std::uint64_t>(originMonotonic), 8);
+    PutLe(header, static_cast<std::uint64_t>(originWall), 8);
+    file_.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+    file_.flush();
+    if (!file_) {
+        file_.close();
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        path_ = path;
+        open_ = true;
+        closing_ = false;
+        pending_.clear();
+        pending_.reserve(2 * kFlushBytes);
+        lastTimestampNs_ = originMonotonic;
+        lostBytes_ = 0;
+        stats_ = CaptureWriterStats{};
+        stats_.fileBytes = header.size();
+    }
+    try {
+        thread_ = std::thread(&CaptureWriter::ThreadMain, this);
+    } catch (const std::system_error&) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        open_ = false;
+        file_.close();
+        return false;
+    }
+    return true;
+}
+
+void CaptureWriter::Close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        open_ = false;
+        closing_ = true;
+    }
+    changed_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    if (file_.is_open()) {
+        file_.close();
+    }
+}
+
+bool CaptureWriter::IsOpen() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return open_;
+}
+
+bool CaptureWriter::Append(CaptureKind kind, std::int64_t timestampNs, std::span<const uint8_t> payload) {
+    bool ok = true;
+    bool flush = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!open_) {
+            return false;
+        }
+        do {
+            const std::span<const uint8_t> part = payload.first(std::min(payload.size(), kMaxPayloadBytes));
+            if (pending_.size() + kMaxRecordHeaderBytes + part.size() > kMaxPendingBytes) {
+                ++stats_.droppedRecords;
+                stats_.droppedBytes += part.size();
+                lostBytes_ += part.size();
+                ok = false;
+            } else {
+                EncodeLocked(kind, timestampNs, part);
+            }
+            payload = payload.subspan(part.size());
+        } while (!payload.empty());
+        flush = pending_.size() >= kFlushBytes;
+    }
+    if (flush) {
+        changed_.notify_one();
+    }
+    return ok;
+}
+
+bool CaptureWriter::AppendModem(const ModemEvent& event) {
+    uint8_t payload[8];
+    for (std::size_t i = 0; i < 4; ++i) {
+        payload[i] = static_cast<uint8_t>(event.status >> (8U * i));
+        payload[4 + i] = static_cast<uint8_t>(event.changed >> (8U * i));
+    }
+    return Append(CaptureKind::Modem, event.timestampNs, payload);
+}
+
+CaptureWriterStats CaptureWriter::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+std::wstring CaptureWriter::Path() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return path_;
+}
+
+void CaptureWriter::EncodeLocked(CaptureKind kind, std::int64_t timestampNs, std::span<const uint8_t> payload) {
+    // The gap is recorded in front of the first record that made it, so replay sees where data is missing.
+    if (lostBytes_ != 0) {
+        const std::uint64_t lost = lostBytes_;
+        lostBytes_ = 0;
+        uint8_t count[8];
+        for (std::size_t i = 0; i < sizeof(count); ++i) {
+            count[i] = static_cast<uint8_t>(lost >> (8U * i));
+        }
+        EncodeLocked(CaptureKind::Lost, timestampNs, count);
+    }
+
+    PutVarint(pending_, ZigZag(timestampNs - lastTimestampNs_));
+    pending_.push_back(static_cast<uint8_t>(kind));
+    PutVarint(pending_, payload.size());
+    pending_.insert(pending_.end(), payload.begin(), payload.end());
+    lastTimestampNs_ = timestampNs;
+    ++stats_.records;
+    stats_.payloadBytes += payload.size();
+}
+
+void CaptureWriter::ThreadMain() {
+    std::vector<uint8_t> chunk;
+    chunk.reserve(2 * kFlushBytes);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        changed_.wait_for(lock, kFlushInterval, [this] { return closing_ || pending_.size() >= kFlushBytes; });
+        if (pending_.empty()) {
+            if (closing_) {
+                break;
+            }
+            continue;
+        }
+        // Appenders keep filling the other buffer while this one goes to disk.
+        chunk.swap(pending_);
+        lock.unlock();
+        file_.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+        file_.flush();
+        const bool ok = static_cast<bool>(file_);
+        lock.lock();
+        stats_.fileBytes += ok ? chunk.size() : 0U;
+        stats_.writeFailed = stats_.writeFailed || !ok;
+        chunk.clear();
+    }
+}
+
+CaptureReader::CaptureReader()
+    : viewOffset_(0),
+      offset_(0),
+      lastTimestampNs_(0),
+      originMonotonicNs_(0),
+      originWallNs_(0),
+      truncated_(false) {}
+
+bool CaptureReader::Open(const std::wstring& path) {
+    Close();
+    if (!file_.Open(path)) {
+        return false;
+    }
+    const uint8_t* header = file_.Size() >= kHeaderBytes ? Window(0, kHeaderBytes) : nullptr;
+    if (header == nullptr || std::memcmp(header, kMagic, sizeof(kMagic)) != 0 || GetLe(header + 8, 4) != kVersion ||
+        GetLe(header + 12, 4) < kHeaderBytes) {
+        Close();
+        return false;
+    }
+    originMonotonicNs_ = static_cast<std::int64_t>(GetLe(header + 16, 8));
+    originWallNs_ = static_cast<std::int64_t>(GetLe(header + 24, 8));
+    Rewind();
+    return true;
+}
+
+void CaptureReader::Close() noexcept {
+    file_.Close();
+    view_ = {};
+    viewOffset_ = 0;
+    offset_ = 0;
+    truncated_ = false;
+}
+
+bool CaptureReader::IsOpen() const noexcept {
+    return file_.IsOpen();
+}
+
+void CaptureReader::Rewind() noexcept {
+    offset_ = kHeaderBytes;
+    lastTimestampNs_ = originMonotonicNs_;
+    truncated_ = false;
+}
+
+bool CaptureReader::Next(CaptureRecord* record) {
+    if (!file_.IsOpen() || truncated_ || offset_ >= file_.Size()) {
+        return false;
+    }
+
+    const std::size_t available = static_cast<std::size_t>(std::min<std::uint64_t>(file_.Size() - offset_, kMaxRecordHeaderBytes));
+    const uint8_t* header = Window(offset_, available);
+    std::uint64_t delta = 0;
+    std::uint64_t size = 0;
+    std::size_t used = header != nullptr ? GetVarint({header, available}, &delta) : 0;
+    if (used == 0 || used >= available || header[used] > static_cast<uint8_t>(CaptureKind::Lost)) {
+        truncated_ = true;
+        return false;
+    }
+    const auto kind = static_cast<CaptureKind>(header[used++]);
+    const std::size_t sizeBytes = GetVarint({header + used, available - used}, &size);
+    used += sizeBytes;
+    if (sizeBytes == 0 || size > CaptureWriter::kMaxPayloadBytes || offset_ + used + size > file_.Size()) {
+        truncated_ = true;
+        return false;
+    }
+
+    const uint8_t* payload = Window(offset_ + used, static_cast<std::size_t>(size));
+    if (payload == nullptr && size != 0) {
+        truncated_ = true;
+        return false;
+    }
+    lastTimestampNs_ += UnZigZag(delta);
+    offset_ += used + size;
+
+    record->kind = kind;
+    record->timestampNs = lastTimestampNs_;
+    record->payload = {payload, static_cast<std::size_t>(size)};
+    return true;
+}
+
+bool CaptureReader::Truncated() const noexcept {
+    return truncated_;
+}
+
+std::int64_t CaptureReader::OriginMonotonicNs() const noexcept {
+    return originMonotonicNs_;
+}
+
+std::int64_t CaptureReader::OriginWallNs() const noexcept {
+    return originWallNs_;
+}
+
+bool CaptureReader::DecodeModem(const CaptureRecord& record, ModemEvent* event) {
+    if (record.kind != CaptureKind::Modem || record.payload.size() != 8) {
+        return false;
+    }
+    event->timestampNs = record.timestampNs;
+    event->status = static_cast<DWORD>(GetLe(record.payload.data(), 4));
+    event->changed = static_cast<DWORD>(GetLe(record.payload.data() + 4, 4));
+    return true;
+}
+
+bool CaptureReader::DecodeLost(const CaptureRecord& record, std::uint64_t* bytes) {
+    if (record.kind != CaptureKind::Lost || record.payload.size() != 8) {
+        return false;
+    }
+    *bytes = GetLe(record.payload.data(), 8);
+    return true;
+}
+
+const uint8_t* CaptureReader::Window(std::uint64_t offset, std::size_t size) {
+    if (offset >= viewOffset_ && offset + size <= viewOffset_ + view_.size()) {
+        return view_.data() + (offset - viewOffset_);
+    }
+    view_ = file_.Map(offset, std::max(size, kViewBytes));
+    viewOffset_ = offset;
+    return view_.size() >= size && !view_.empty() ? view_.data() : nullptr;
+}
+
+} // namespace serial
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "core/Platform.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/MappedFile.h"
+#include "serial/ModemEvents.h"
+
+namespace serial {
+
+enum class CaptureKind : uint8_t {
+    Rx = 0,
+    Tx = 1,
+    Modem = 2, // Payload: status and changed, 32-bit little-endian each.
+    Lost = 3   // Payload: 64-bit little-endian count of bytes the writer dropped before this record.
+};
+
+struct CaptureRecord {
+    CaptureKind kind = CaptureKind::Rx;
+    std::int64_t timestampNs = 0; // core::MonotonicNanos() of the recording session.
+    std::span<const uint8_t> payload;
+};
+
+struct CaptureWriterStats {
+    std::uint64_t records = 0;
+    std::uint64_t payloadBytes = 0;
+    std::uint64_t fileBytes = 0;      // Written to disk so far, header included.
+    std::uint64_t droppedRecords = 0; // Refused because the disk fell kMaxPendingBytes behind.
+    std::uint64_t droppedBytes = 0;
+    bool writeFailed = false;
+};
+
+// Append-only binary capture of raw port traffic. The file starts with a 32-byte header (magic,
+// version, monotonic and wall-clock origin); each record is a zigzag varint timestamp delta
+// from the previous record, the kind byte, a varint payload size and the payload. A session cut
+// short leaves at most one partial record at the end, which the reader reports and skips.
+class CaptureWriter final {
+public:
+    static constexpr std::size_t kFlushBytes = 256U * 1024U;
+    static constexpr std::size_t kMaxPendingBytes = 64U * 1024U * 1024U;
+    static constexpr std::size_t kMaxPayloadBytes = 1024U * 1024U;
+
+    CaptureWriter();
+    ~CaptureWriter();
+
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    // Creates or truncates the file and starts the writer thread.
+    bool Open(const std::wstring& path);
+    // Writes what is pending and closes the file.
+    void Close();
+    [[nodiscard]] bool IsOpen() const;
+
+    // Thread-safe and cheap: the record is encoded into memory and the writer thread puts it on
+    // disk. Larger payloads are split into kMaxPayloadBytes records. Returns false if the file
+    // is not open or the record was dropped.
+    bool Append(CaptureKind kind, std::int64_t timestampNs, std::span<const uint8_t> payload);
+    bool AppendModem(const ModemEvent& event);
+
+    [[nodiscard]] CaptureWriterStats Stats() const;
+    [[nodiscard]] std::wstring Path() const;
+
+private:
+    void ThreadMain();
+    void EncodeLocked(CaptureKind kind, std::int64_t timestampNs, std::span<const uint8_t> payload);
+
+    std::ofstream file_;
+    std::wstring path_;
+    std::thread thread_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    bool open_;
+    bool closing_;
+    std::vector<uint8_t> pending_; // Encoded records the writer thread has not taken yet.
+    std::int64_t lastTimestampNs_;
+    std::uint64_t lostBytes_;      // Dropped since the last Lost record.
+    CaptureWriterStats stats_;
+};
+
+// Sequential reader over a capture file, mapped through a sliding core::MappedFile view.
+// Not thread-safe.
+class CaptureReader final {
+public:
+    static constexpr std::size_t kViewBytes = 4U * 1024U * 1024U;
+
+    CaptureReader();
+
+    CaptureReader(const CaptureReader&) = delete;
+    CaptureReader& operator=(const CaptureReader&) = delete;
+
+    bool Open(const std::wstring& path);
+    void Close() noexcept;
+    [[nodiscard]] bool IsOpen() const noexcept;
+    // Back to the first record.
+    void Rewind() noexcept;
+
+    // The payload stays valid until the next call. False at the end of the file, or at a record
+    // that is cut off or malformed (then Truncated() is true).
+    bool Next(CaptureRecord* record);
+    [[nodiscard]] bool Truncated() const noexcept;
+
+    [[nodiscard]] std::int64_t OriginMonotonicNs() const noexcept;
+    [[nodiscard]] std::int64_t OriginWallNs() const noexcept;
+
+    static bool DecodeModem(const CaptureRecord& record, ModemEvent* event);
+    static bool DecodeLost(const CaptureRecord& record, std::uint64_t* bytes);
+
+private:
+    // Makes [offset, offset + size) readable; the returned pointer covers at least size bytes.
+    const uint8_t* Window(std::uint64_t offset, std::size_t size);
+
+    core::MappedFile file_;
+    std::span<const uint8_t> view_;
+    std::uint64_t viewOffset_;
+    std::uint64_t offset_;
+    std::int64_t lastTimestampNs_;
+    std::int64_t originMonotonicNs_;
+    std::int64_t originWallNs_;
+    bool truncated_;
+};
+
+} // namespace serial
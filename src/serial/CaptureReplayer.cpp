@@ -0,0 +1,136 @@
+#include "serial/CaptureReplayer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <system_error>
+
+#include "core/Clock.h"
+
+namespace serial {
+
+CaptureReplayer::CaptureReplayer()
+    : running_(false),
+      stop_(false) {}
+
+CaptureReplayer::~CaptureReplayer() {
+    Stop();
+}
+
+bool CaptureReplayer::Start(const std::wstring& path, RecordCallback onRecord, const ReplayOptions& options, DoneCallback onDone) {
+    Stop();
+    if (!onRecord || options.speed < 0.0 || !timer_.IsValid() || !reader_.Open(path)) {
+        return false;
+    }
+
+    options_ = options;
+    onRecord_ = std::move(onRecord);
+    onDone_ = std::move(onDone);
+    timer_.ClearInterrupt();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = true;
+        stop_ = false;
+        stats_ = ReplayStats{};
+    }
+    try {
+        thread_ = std::thread(&CaptureReplayer::ThreadMain, this);
+    } catch (const std::system_error&) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+        reader_.Close();
+        return false;
+    }
+    return true;
+}
+
+void CaptureReplayer::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    timer_.Interrupt();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    reader_.Close();
+}
+
+bool CaptureReplayer::IsRunning() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_;
+}
+
+ReplayStats CaptureReplayer::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+bool CaptureReplayer::Wait(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return changed_.wait_for(lock, timeout, [this] { return !running_; });
+}
+
+void CaptureReplayer::ThreadMain() {
+    const std::int64_t startNs = core::MonotonicNanos();
+    std::int64_t firstRecordNs = 0;
+    std::int64_t lateSumNs = 0;
+    std::uint64_t delivered = 0;
+    bool stopped = false;
+    const auto stopRequested = [this] {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stop_;
+    };
+
+    CaptureRecord record;
+    while (reader_.Next(&record)) {
+        if (stopRequested()) {
+            stopped = true;
+            break;
+        }
+        if (delivered++ == 0) {
+            firstRecordNs = record.timestampNs;
+        }
+
+        std::int64_t dueNs = startNs;
+        if (options_.speed > 0.0) {
+            // Records stamped out of order by different threads are simply not waited for.
+            const auto offsetNs = std::max<std::int64_t>(record.timestampNs - firstRecordNs, 0);
+            dueNs = startNs + std::llround(static_cast<double>(offsetNs) / options_.speed);
+            if (!timer_.WaitUntil(dueNs)) {
+                stopped = true;
+                break;
+            }
+        }
+
+        const std::int64_t nowNs = core::MonotonicNanos();
+        onRecord_(record, nowNs);
+
+        const std::int64_t lateNs = options_.speed > 0.0 ? std::max<std::int64_t>(nowNs - dueNs, 0) : 0;
+        lateSumNs += lateNs;
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.records = delivered;
+        stats_.bytes += record.payload.size();
+        stats_.maxLateNs = std::max(stats_.maxLateNs, lateNs);
+        stats_.meanLateNs = lateSumNs / static_cast<std::int64_t>(delivered);
+        stats_.elapsedNs = nowNs - startNs;
+    }
+
+    ReplayStats done;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.elapsedNs = core::MonotonicNanos() - startNs;
+        stats_.finished = true;
+        stats_.ok = !stopped && !reader_.Truncated();
+        done = stats_;
+    }
+    if (onDone_) {
+        onDone_(done);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    changed_.notify_all();
+}
+
+} // namespace serial
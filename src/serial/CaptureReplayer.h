@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "core/PreciseTimer.h"
+#include "serial/CaptureFile.h"
+
+namespace serial {
+
+struct ReplayOptions {
+    // 1 keeps the recorded timing, 2 plays twice as fast; 0 delivers records as fast as possible.
+    double speed = 1.0;
+};
+
+struct ReplayStats {
+    std::uint64_t records = 0;
+    std::uint64_t bytes = 0;        // Payload bytes of the delivered records.
+    std::int64_t elapsedNs = 0;
+    std::int64_t maxLateNs = 0;     // Worst delivery behind the scaled recorded time.
+    std::int64_t meanLateNs = 0;
+    bool finished = false;
+    bool ok = false;                // With finished: the whole file played without truncation.
+};
+
+// Plays a capture back on its own thread. Each record goes to onRecord at its recorded offset
+// from the first record, divided by speed; the waits use core::PreciseTimer, so intervals are
+// kept to microseconds. replayNs is core::MonotonicNanos() at delivery, the stamp a live port
+// would have put on the data.
+class CaptureReplayer final {
+public:
+    using RecordCallback = std::function<void(const CaptureRecord& record, std::int64_t replayNs)>;
+    using DoneCallback = std::function<void(const ReplayStats& stats)>;
+
+    CaptureReplayer();
+    ~CaptureReplayer();
+
+    CaptureReplayer(const CaptureReplayer&) = delete;
+    CaptureReplayer& operator=(const CaptureReplayer&) = delete;
+
+    // Opens the file and starts the replay thread; onDone runs on it once at the end.
+    bool Start(const std::wstring& path, RecordCallback onRecord, const ReplayOptions& options = {}, DoneCallback onDone = {});
+    // Interrupts a pending wait and stops before the next record.
+    void Stop();
+    [[nodiscard]] bool IsRunning() const;
+    [[nodiscard]] ReplayStats Stats() const;
+    // Waits for the replay to end; false on timeout.
+    bool Wait(std::chrono::milliseconds timeout);
+
+private:
+    void ThreadMain();
+
+    CaptureReader reader_;
+    ReplayOptions options_;
+    RecordCallback onRecord_;
+    DoneCallback onDone_;
+    core::PreciseTimer timer_;
+    std::thread thread_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    bool running_;
+    bool stop_;
+    ReplayStats stats_;
+};
+
+} // namespace serial
@@ -0,0 +1,564 @@
+#include "serial/ChecksumAnalyzer.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdio>
+#include <map>
+#include <optional>
+#include <thread>
+
+namespace {
+
+using serial::ChecksumKind;
+using serial::ChecksumLayout;
+using serial::ChecksumMatch;
+using Frames = std::span<const std::vector<uint8_t>>;
+
+// Enough differences to shrink the GCD to the polynomial; more only cost time.
+constexpr std::size_t kMaxDifferences = 16;
+// A GCD this many degrees above the width leaves 2^n cofactors to try; beyond that the frames
+// do not pin the polynomial down.
+constexpr int kMaxExtraDegree = 20;
+constexpr std::size_t kMaxCandidates = 8;
+
+constexpr uint8_t kCheckInput[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+
+enum class Family {
+    Catalogue,
+    Simple,
+    Polynomial,
+};
+
+struct Task {
+    ChecksumLayout layout;
+    Family family;
+    bool reflected;
+};
+
+std::size_t FieldBytes(unsigned width) {
+    return (width + 7U) / 8U;
+}
+
+std::size_t CoveredSize(const std::vector<uint8_t>& frame, const ChecksumLayout& layout) {
+    return frame.size() - layout.begin - layout.trailing - layout.fieldBytes;
+}
+
+std::uint32_t FieldValue(const std::vector<uint8_t>& frame, const ChecksumLayout& layout) {
+    const std::size_t offset = frame.size() - layout.trailing - layout.fieldBytes;
+    std::uint32_t value = 0;
+    for (std::size_t i = 0; i < layout.fieldBytes; ++i) {
+        const std::size_t index = layout.bigEndian ? i : layout.fieldBytes - 1U - i;
+        value = (value << 8U) | frame[offset + index];
+    }
+    return value;
+}
+
+bool HasConstantByte(std::span<const std::vector<uint8_t>> frames, const ChecksumLayout& layout) {
+    for (std::size_t i = 0; i < layout.fieldBytes; ++i) {
+        const auto byte = [&](const std::vector<uint8_t>& frame) { return frame[frame.size() - layout.trailing - layout.fieldBytes + i]; };
+        const uint8_t first = byte(frames.front());
+        if (std::all_of(frames.begin(), frames.end(), [&](const std::vector<uint8_t>& frame) { return byte(frame) == first; })) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::uint32_t SimpleChecksum(ChecksumKind kind, const uint8_t* data, std::size_t size) {
+    std::uint32_t sum = 0;
+    std::uint32_t parity = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        sum += data[i];
+        parity ^= data[i];
+    }
+    switch (kind) {
+    case ChecksumKind::Sum8:
+        return sum & 0xFFU;
+    case ChecksumKind::Lrc8:
+        return (0U - sum) & 0xFFU;
+    case ChecksumKind::InvertedSum8:
+        return ~sum & 0xFFU;
+    case ChecksumKind::Xor8:
+        return parity;
+    case ChecksumKind::Sum16:
+        return sum & 0xFFFFU;
+    case ChecksumKind::Crc:
+        break;
+    }
+    return 0;
+}
+
+std::vector<ChecksumMatch> MatchCatalogue(Frames frames, const ChecksumLayout& layout) {
+    std::vector<ChecksumMatch> matches;
+    for (const core::CrcCatalogueEntry& entry : core::CrcCatalogue()) {
+        if (FieldBytes(entry.model.width) != layout.fieldBytes) {
+            continue;
+        }
+        const bool all = std::all_of(frames.begin(), frames.end(), [&](const std::vector<uint8_t>& frame) {
+            return entry.Compute(frame.data() + layout.begin, CoveredSize(frame, layout)) == FieldValue(frame, layout);
+        });
+        if (all) {
+            matches.push_back(ChecksumMatch{ChecksumKind::Crc, entry.model, entry.name, layout});
+        }
+    }
+    return matches;
+}
+
+std::vector<ChecksumMatch> MatchSimple(Frames frames, const ChecksumLayout& layout) {
+    std::vector<ChecksumKind> kinds;
+    if (layout.fieldBytes == 1U) {
+        kinds = {ChecksumKind::Sum8, ChecksumKind::Lrc8, ChecksumKind::InvertedSum8, ChecksumKind::Xor8};
+    } else if (layout.fieldBytes == 2U) {
+        kinds = {ChecksumKind::Sum16};
+    }
+
+    std::vector<ChecksumMatch> matches;
+    for (const ChecksumKind kind : kinds) {
+        const bool all = std::all_of(frames.begin(), frames.end(), [&](const std::vector<uint8_t>& frame) {
+            return SimpleChecksum(kind, frame.data() + layout.begin, CoveredSize(frame, layout)) == FieldValue(frame, layout);
+        });
+        if (all) {
+            matches.push_back(ChecksumMatch{kind, {}, {}, layout});
+        }
+    }
+    return matches;
+}
+
+// GF(2) polynomial: bit i is the coefficient of x^i.
+using Poly = std::vector<std::uint64_t>;
+
+int Degree(const Poly& poly) {
+    for (std::size_t i = poly.size(); i-- > 0;) {
+        if (poly[i] != 0U) {
+            return static_cast<int>(i * 64U) + std::bit_width(poly[i]) - 1;
+        }
+    }
+    return -1;
+}
+
+void XorShifted(Poly& a, const Poly& b, std::size_t shift) {
+    const std::size_t words = shift / 64U;
+    const std::size_t bits = shift % 64U;
+    for (std::size_t i = 0; i < b.size() && i + words < a.size(); ++i) {
+        a[i + words] ^= b[i] << bits;
+        if (bits != 0U && i + words + 1U < a.size()) {
+            a[i + words + 1U] ^= b[i] >> (64U - bits);
+        }
+    }
+}
+
+Poly Gcd(Poly a, Poly b) {
+    while (Degree(b) >= 0) {
+        const int degreeB = Degree(b);
+        for (int degreeA = Degree(a); degreeA >= degreeB; degreeA = Degree(a)) {
+            XorShifted(a, b, static_cast<std::size_t>(degreeA - degreeB));
+        }
+        std::swap(a, b);
+    }
+    return a;
+}
+
+// Remainder and quotient of polynomials that fit in 64 bits.
+std::uint64_t Mod64(std::uint64_t a, std::uint64_t b) {
+    const int degreeB = std::bit_width(b) - 1;
+    for (int degreeA = std::bit_width(a) - 1; degreeA >= degreeB; degreeA = std::bit_width(a) - 1) {
+        a ^= b << (degreeA - degreeB);
+    }
+    return a;
+}
+
+std::uint64_t Div64(std::uint64_t a, std::uint64_t b) {
+    const int degreeB = std::bit_width(b) - 1;
+    std::uint64_t quotient = 0;
+    for (int degreeA = std::bit_width(a) - 1; degreeA >= degreeB; degreeA = std::bit_width(a) - 1) {
+        a ^= b << (degreeA - degreeB);
+        quotient |= std::uint64_t{1} << (degreeA - degreeB);
+    }
+    return quotient;
+}
+
+// Two equal-length messages with CRC registers r1 and r2 satisfy
+// (m1 + m2) * x^w + (r1 + r2) = 0 mod P, whatever init and xorOut are.
+Poly DifferencePoly(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b, std::uint32_t fieldDifference, unsigned width) {
+    Poly poly((a.size() * 8U + width + 63U) / 64U, 0U);
+    const auto place = [&poly](std::uint64_t value, std::size_t position) {
+        poly[position / 64U] |= value << (position % 64U);
+        if (position % 64U != 0U && position / 64U + 1U < poly.size()) {
+            poly[position / 64U + 1U] |= value >> (64U - position % 64U);
+        }
+    };
+    place(fieldDifference, 0);
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        place(static_cast<uint8_t>(a[i] ^ b[i]), width + (a.size() - 1U - i) * 8U);
+    }
+    return poly;
+}
+
+// init and xorOut for a known polynomial. Work is in the normal (unreflected) domain, where a
+// CRC with init 0 and xorOut 0 is linear: field = CRC0(data) ^ E_len(init) ^ xorOut, with E_len
+// the effect of init after len bytes. Frames of different lengths give linear equations for init.
+std::optional<ChecksumMatch> SolveInit(std::uint32_t poly, unsigned width, bool reflected, const std::vector<std::vector<uint8_t>>& data,
+                                       const std::vector<std::uint32_t>& fields, const ChecksumLayout& layout) {
+    const core::RuntimeCrc crc(core::CrcModel{width, poly, 0U, false, false, 0U, 0U});
+    std::size_t longest = 0;
+    for (const std::vector<uint8_t>& bytes : data) {
+        longest = std::max(longest, bytes.size());
+    }
+    const std::vector<uint8_t> zeros(longest, 0U);
+    const auto initEffect = [&](std::uint32_t init, std::size_t length) {
+        return crc.Finalize(crc.Update(init << (32U - width), zeros.data(), length));
+    };
+
+    std::vector<std::uint32_t> residues(data.size());
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        residues[i] = fields[i] ^ crc.Compute(data[i].data(), data[i].size());
+    }
+    const auto consistent = [&](std::uint32_t init, std::uint32_t* xorOut) {
+        const std::uint32_t expected = residues[0] ^ initEffect(init, data[0].size());
+        for (std::size_t i = 1; i < data.size(); ++i) {
+            if ((residues[i] ^ initEffect(init, data[i].size())) != expected) {
+                return false;
+            }
+        }
+        *xorOut = expected;
+        return true;
+    };
+
+    const std::uint32_t mask = core::detail::CrcWidthMask(width);
+    // Common inits first: they read best, and with frames of one length any init works.
+    std::uint32_t xorOut = 0;
+    std::optional<std::uint32_t> init;
+    for (const std::uint32_t guess : {0U, mask}) {
+        if (consistent(guess, &xorOut)) {
+            init = guess;
+            break;
+        }
+    }
+    if (!init) {
+        // Gaussian elimination; a row's pivot is its highest coefficient.
+        std::array<std::uint32_t, 32> rows{};
+        std::array<std::uint32_t, 32> rhs{};
+        std::array<bool, 32> used{};
+        std::map<std::size_t, std::array<std::uint32_t, 32>> columns;
+        const auto columnsFor = [&](std::size_t length) -> const std::array<std::uint32_t, 32>& {
+            auto [it, inserted] = columns.try_emplace(length);
+            if (inserted) {
+                for (unsigned bit = 0; bit < width; ++bit) {
+                    it->second[bit] = initEffect(1U << bit, length);
+                }
+            }
+            return it->second;
+        };
+        for (std::size_t i = 1; i < data.size(); ++i) {
+            if (data[i].size() == data[0].size()) {
+                continue;
+            }
+            const std::array<std::uint32_t, 32>& first = columnsFor(data[0].size());
+            const std::array<std::uint32_t, 32>& current = columnsFor(data[i].size());
+            for (unsigned output = 0; output < width; ++output) {
+                std::uint32_t row = 0;
+                for (unsigned bit = 0; bit < width; ++bit) {
+                    row |= (((first[bit] ^ current[bit]) >> output) & 1U) << bit;
+                }
+                std::uint32_t value = ((residues[0] ^ residues[i]) >> output) & 1U;
+                while (row != 0U) {
+                    const int pivot = std::bit_width(row) - 1;
+                    if (!used[pivot]) {
+                        rows[pivot] = row;
+                        rhs[pivot] = value;
+                        used[pivot] = true;
+                        break;
+                    }
+                    row ^= rows[pivot];
+                    value ^= rhs[pivot];
+                }
+                if (row == 0U && value != 0U) {
+                    return std::nullopt;
+                }
+            }
+        }
+        // Free unknowns stay 0.
+        std::uint32_t solved = 0;
+        for (unsigned bit = 0; bit < width; ++bit) {
+            if (used[bit] && ((rhs[bit] ^ static_cast<std::uint32_t>(std::popcount(rows[bit] & solved))) & 1U) != 0U) {
+                solved |= 1U << bit;
+            }
+        }
+        if (!consistent(solved, &xorOut)) {
+            return std::nullopt;
+        }
+        init = solved;
+    }
+
+    ChecksumMatch match;
+    match.kind = ChecksumKind::Crc;
+    match.model = core::CrcModel{width, poly, *init, reflected, reflected, reflected ? core::detail::ReflectBits(xorOut, width) : xorOut, 0U};
+    match.model.check = core::RuntimeCrc(match.model).Compute(kCheckInput, sizeof(kCheckInput));
+    match.layout = layout;
+    match.initAmbiguous = std::all_of(data.begin(), data.end(), [&](const std::vector<uint8_t>& bytes) {
+        return bytes.size() == data[0].size();
+    });
+    return match;
+}
+
+std::vector<ChecksumMatch> SearchPolynomials(Frames frames, const ChecksumLayout& layout, bool reflected) {
+    const auto width = static_cast<unsigned>(layout.fieldBytes * 8U);
+
+    // A reflected CRC is the normal one over bit-reversed bytes, with the register reflected.
+    std::vector<std::vector<uint8_t>> data(frames.size());
+    std::vector<std::uint32_t> fields(frames.size());
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+        const auto first = frames[i].begin() + static_cast<std::ptrdiff_t>(layout.begin);
+        data[i].assign(first, first + static_cast<std::ptrdiff_t>(CoveredSize(frames[i], layout)));
+        fields[i] = FieldValue(frames[i], layout);
+        if (reflected) {
+            for (uint8_t& byte : data[i]) {
+                byte = static_cast<uint8_t>(core::detail::ReflectBits(byte, 8U));
+            }
+            fields[i] = core::detail::ReflectBits(fields[i], width);
+        }
+    }
+
+    std::optional<Poly> gcd;
+    std::map<std::size_t, std::size_t> firstOfLength;
+    std::size_t differences = 0;
+    for (std::size_t i = 0; i < data.size() && differences < kMaxDifferences; ++i) {
+        const auto [it, inserted] = firstOfLength.try_emplace(data[i].size(), i);
+        const std::size_t j = it->second;
+        if (inserted || (data[i] == data[j] && fields[i] == fields[j])) {
+            continue;
+        }
+        Poly difference = DifferencePoly(data[i], data[j], fields[i] ^ fields[j], width);
+        gcd = gcd ? Gcd(std::move(*gcd), std::move(difference)) : std::move(difference);
+        ++differences;
+        if (Degree(*gcd) <= static_cast<int>(width)) {
+            break;
+        }
+    }
+    if (!gcd) {
+        return {};
+    }
+    const int degree = Degree(*gcd);
+    if (degree < static_cast<int>(width) || degree > 63) {
+        return {};
+    }
+
+    // The polynomial is a degree-width divisor of the GCD: try whichever is fewer, the
+    // cofactors or all polynomials of that width.
+    const std::uint64_t g = (*gcd)[0];
+    const int extra = degree - static_cast<int>(width);
+    std::vector<std::uint64_t> candidates;
+    if (extra == 0) {
+        candidates.push_back(g);
+    } else if (extra <= std::min(kMaxExtraDegree, static_cast<int>(width) - 1)) {
+        for (std::uint64_t q = std::uint64_t{1} << extra; q < (std::uint64_t{2} << extra) && candidates.size() < kMaxCandidates; ++q) {
+            if (Mod64(g, q) == 0U) {
+                candidates.push_back(Div64(g, q));
+            }
+        }
+    } else if (static_cast<int>(width) - 1 <= kMaxExtraDegree) {
+        for (std::uint64_t p = (std::uint64_t{1} << width) | 1U; p < (std::uint64_t{2} << width) && candidates.size() < kMaxCandidates; p += 2U) {
+            if (Mod64(g, p) == 0U) {
+                candidates.push_back(p);
+            }
+        }
+    }
+
+    std::vector<ChecksumMatch> matches;
+    for (const std::uint64_t candidate : candidates) {
+        // Every CRC polynomial has the x^0 term. x^8 + 1 is the XOR of all bytes, reported as XOR-8.
+        if ((candidate & 1U) == 0U || (width == 8U && candidate == 0x101U)) {
+            continue;
+        }
+        const auto poly = static_cast<std::uint32_t>(candidate & core::detail::CrcWidthMask(width));
+        std::optional<ChecksumMatch> match = SolveInit(poly, width, reflected, data, fields, layout);
+        if (!match) {
+            continue;
+        }
+        // Check on the frames as captured, through the same code a user of the model would run.
+        const core::RuntimeCrc crc(match->model);
+        const bool all = std::all_of(frames.begin(), frames.end(), [&](const std::vector<uint8_t>& frame) {
+            return crc.Compute(frame.data() + layout.begin, CoveredSize(frame, layout)) == FieldValue(frame, layout);
+        });
+        if (all) {
+            matches.push_back(*match);
+        }
+    }
+    return matches;
+}
+
+bool SameModel(const core::CrcModel& a, const core::CrcModel& b) {
+    return a.width == b.width && a.poly == b.poly && a.init == b.init && a.reflectIn == b.reflectIn && a.reflectOut == b.reflectOut &&
+           a.xorOut == b.xorOut;
+}
+
+bool SameLayout(const ChecksumLayout& a, const ChecksumLayout& b) {
+    return a.begin == b.begin && a.trailing == b.trailing && a.fieldBytes == b.fieldBytes && a.bigEndian == b.bigEndian;
+}
+
+// Catalogue CRCs, simple sums, then searched CRCs, those with init and xorOut of 0 or all ones
+// first. Covering a constant sync byte is the same as another init, so the plain one is
+// usually the documented form.
+int KindRank(const ChecksumMatch& match) {
+    if (match.kind != ChecksumKind::Crc) {
+        return 1;
+    }
+    if (!match.name.empty()) {
+        return 0;
+    }
+    const std::uint32_t mask = core::detail::CrcWidthMask(match.model.width);
+    const bool plain = (match.model.init == 0U || match.model.init == mask) && (match.model.xorOut == 0U || match.model.xorOut == mask);
+    return plain ? 2 : 3;
+}
+
+const char* SimpleName(ChecksumKind kind) {
+    switch (kind) {
+    case ChecksumKind::Sum8:
+        return "SUM-8";
+    case ChecksumKind::Lrc8:
+        return "LRC-8";
+    case ChecksumKind::InvertedSum8:
+        return "~SUM-8";
+    case ChecksumKind::Xor8:
+        return "XOR-8";
+    case ChecksumKind::Sum16:
+        return "SUM-16";
+    case ChecksumKind::Crc:
+        break;
+    }
+    return "CRC";
+}
+
+} // namespace
+
+namespace serial {
+
+std::vector<ChecksumMatch> ChecksumAnalyzer::Analyze(std::span<const std::vector<uint8_t>> frames, const ChecksumAnalyzerOptions& options) {
+    if (frames.size() < 2U) {
+        return {};
+    }
+    std::size_t shortest = frames[0].size();
+    for (const std::vector<uint8_t>& frame : frames) {
+        shortest = std::min(shortest, frame.size());
+    }
+
+    std::vector<Task> tasks;
+    for (std::size_t begin = 0; begin <= options.maxLeading; ++begin) {
+        for (std::size_t trailing = 0; trailing <= options.maxTrailing; ++trailing) {
+            for (const std::size_t fieldBytes : {std::size_t{1}, std::size_t{2}, std::size_t{4}}) {
+                // At least one covered byte in every frame.
+                if (begin + trailing + fieldBytes >= shortest) {
+                    continue;
+                }
+                for (const bool bigEndian : {false, true}) {
+                    if (fieldBytes == 1U && bigEndian) {
+                        continue;
+                    }
+                    const ChecksumLayout layout{begin, trailing, fieldBytes, bigEndian};
+                    // A checksum byte that never changes is not a checksum byte, though a CRC over
+                    // data and its own CRC does yield a constant that may match a fixed end marker.
+                    if (HasConstantByte(frames, layout)) {
+                        continue;
+                    }
+                    tasks.push_back(Task{layout, Family::Catalogue, false});
+                    tasks.push_back(Task{layout, Family::Simple, false});
+                    if (options.searchPolynomials) {
+                        tasks.push_back(Task{layout, Family::Polynomial, false});
+                        tasks.push_back(Task{layout, Family::Polynomial, true});
+                    }
+                }
+            }
+        }
+    }
+
+    // Layouts are independent, so workers just pull the next index.
+    std::vector<std::vector<ChecksumMatch>> results(tasks.size());
+    std::atomic<std::size_t> next{0};
+    const auto work = [&] {
+        for (std::size_t i = next.fetch_add(1); i < tasks.size(); i = next.fetch_add(1)) {
+            const Task& task = tasks[i];
+            switch (task.family) {
+            case Family::Catalogue:
+                results[i] = MatchCatalogue(frames, task.layout);
+                break;
+            case Family::Simple:
+                results[i] = MatchSimple(frames, task.layout);
+                break;
+            case Family::Polynomial:
+                results[i] = SearchPolynomials(frames, task.layout, task.reflected);
+                break;
+            }
+        }
+    };
+    const unsigned cores = options.threads != 0 ? options.threads : std::max(1U, std::thread::hardware_concurrency());
+    const std::size_t workers = std::min<std::size_t>(cores, tasks.size());
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < workers; ++i) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // A searched CRC that is in the catalogue takes its name; the catalogue task found it too.
+    std::vector<ChecksumMatch> matches;
+    for (std::vector<ChecksumMatch>& result : results) {
+        for (ChecksumMatch& match : result) {
+            if (match.kind == ChecksumKind::Crc && match.name.empty()) {
+                for (const core::CrcCatalogueEntry& entry : core::CrcCatalogue()) {
+                    if (SameModel(entry.model, match.model)) {
+                        match.name = entry.name;
+                        break;
+                    }
+                }
+            }
+            const bool duplicate = std::any_of(matches.begin(), matches.end(), [&](const ChecksumMatch& other) {
+                return other.kind == match.kind && SameLayout(other.layout, match.layout) &&
+                       (match.kind != ChecksumKind::Crc || SameModel(other.model, match.model));
+            });
+            if (!duplicate) {
+                matches.push_back(match);
+            }
+        }
+    }
+
+    std::stable_sort(matches.begin(), matches.end(), [](const ChecksumMatch& a, const ChecksumMatch& b) {
+        if (a.layout.fieldBytes != b.layout.fieldBytes) {
+            return a.layout.fieldBytes > b.layout.fieldBytes;
+        }
+        if (KindRank(a) != KindRank(b)) {
+            return KindRank(a) < KindRank(b);
+        }
+        if (a.layout.begin != b.layout.begin) {
+            return a.layout.begin < b.layout.begin;
+        }
+        return a.layout.trailing < b.layout.trailing;
+    });
+    return matches;
+}
+
+std::string ChecksumAnalyzer::Describe(const ChecksumMatch& match) {
+    char algorithm[160];
+    if (match.kind != ChecksumKind::Crc) {
+        std::snprintf(algorithm, sizeof(algorithm), "%s", SimpleName(match.kind));
+    } else if (!match.name.empty()) {
+        std::snprintf(algorithm, sizeof(algorithm), "%.*s", static_cast<int>(match.name.size()), match.name.data());
+    } else {
+        const core::CrcModel& model = match.model;
+        std::snprintf(algorithm, sizeof(algorithm), "CRC-%u poly=0x%X init=0x%X refin=%s refout=%s xorout=0x%X check=0x%X%s",
+                      model.width, model.poly, model.init, model.reflectIn ? "true" : "false", model.reflectOut ? "true" : "false",
+                      model.xorOut, model.check, match.initAmbiguous ? " (init ambiguous)" : "");
+    }
+
+    const ChecksumLayout& layout = match.layout;
+    const std::size_t fieldFromEnd = layout.trailing + layout.fieldBytes;
+    const char* order = layout.fieldBytes == 1U ? "" : layout.bigEndian ? "big-endian " : "little-endian ";
+    char text[256];
+    std::snprintf(text, sizeof(text), "%s over [%zu, end-%zu), %sat end-%zu", algorithm, layout.begin, fieldFromEnd, order, fieldFromEnd);
+    return text;
+}
+
+} // namespace serial
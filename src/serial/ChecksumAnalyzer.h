@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/CrcModel.h"
+
+namespace serial {
+
+enum class ChecksumKind {
+    Crc,
+    Sum8,         // Byte sum modulo 256.
+    Lrc8,         // Two's complement of the byte sum (Modbus ASCII LRC).
+    InvertedSum8, // One's complement of the byte sum.
+    Xor8,         // XOR of all bytes.
+    Sum16,        // Byte sum modulo 65536.
+};
+
+// Where the checksum sits: it covers frame[begin, size - trailing - fieldBytes) and is stored in
+// the fieldBytes after that, followed by trailing bytes such as ETX or CR LF.
+struct ChecksumLayout {
+    std::size_t begin = 0;
+    std::size_t trailing = 0;
+    std::size_t fieldBytes = 1;
+    bool bigEndian = false;
+};
+
+struct ChecksumMatch {
+    ChecksumKind kind = ChecksumKind::Crc;
+    core::CrcModel model{}; // For ChecksumKind::Crc.
+    std::string_view name;  // Catalogue name; empty for a CRC outside the catalogue.
+    ChecksumLayout layout;
+    // Every frame had the same length, so init and xorOut are only known in combination: the
+    // reported pair reproduces these frames, other lengths may need another one.
+    bool initAmbiguous = false;
+};
+
+struct ChecksumAnalyzerOptions {
+    // The covered range may skip this many leading bytes (sync, start of frame).
+    std::size_t maxLeading = 4;
+    // This many bytes may follow the checksum.
+    std::size_t maxTrailing = 2;
+    // Also search any 8-, 16- and 32-bit polynomial, init and xorOut, not only the catalogue.
+    bool searchPolynomials = true;
+    // 0 uses every core.
+    unsigned threads = 0;
+};
+
+// Finds the checksum of an undocumented protocol from captured frames. Every layout (skipped
+// leading bytes, trailing bytes, field size and byte order) is tried against the CRC
+// catalogue, simple sums and, given frames of equal length, any CRC polynomial: the XOR of two
+// equal-length frames cancels init and xorOut, so the polynomial divides every such difference
+// and falls out of their GCD; init and xorOut are then solved as a linear system. Layouts are
+// searched in parallel.
+class ChecksumAnalyzer final {
+public:
+    // Every hypothesis that holds for all frames: wider fields first, then catalogue CRCs,
+    // simple sums and other CRCs, then by layout. Needs at least two frames; more frames rule
+    // out accidental matches, which are likely for 8-bit fields.
+    static std::vector<ChecksumMatch> Analyze(std::span<const std::vector<uint8_t>> frames, const ChecksumAnalyzerOptions& options = {});
+
+    // For example "CRC-16/MODBUS over [0, end-2), little-endian at end-2".
+    static std::string Describe(const ChecksumMatch& match);
+};
+
+} // namespace serial
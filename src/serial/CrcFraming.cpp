@@ -0,0 +1,210 @@
+#include "serial/CrcFraming.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace serial {
+
+CrcFraming::CrcFraming(std::size_t logCapacity)
+    : fieldBytes_(0),
+      register_(0),
+      tail_{},
+      tailBytes_(0),
+      frameBytes_(0),
+      frameOffset_(0),
+      streamOffset_(0),
+      lastReadNs_(0),
+      log_(std::max<std::size_t>(logCapacity, 1U)),
+      first_(0),
+      next_(0) {
+}
+
+void CrcFraming::Configure(const CrcFramingSettings& settings) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    settings_ = settings;
+    if (settings.model.width == 0U) {
+        crc_.reset();
+        fieldBytes_ = 0;
+    } else {
+        crc_.emplace(settings.model);
+        fieldBytes_ = (settings.model.width + 7U) / 8U;
+        settings_.maxFrameBytes = std::clamp<std::size_t>(
+            settings.maxFrameBytes, fieldBytes_ + 1U, std::numeric_limits<std::uint32_t>::max());
+    }
+    StartFrame();
+}
+
+CrcFramingSettings CrcFraming::Settings() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return settings_;
+}
+
+bool CrcFraming::Enabled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return crc_.has_value();
+}
+
+std::size_t CrcFraming::Append(std::vector<uint8_t>* frame) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!crc_ || frame == nullptr) {
+        return 0;
+    }
+    const std::uint32_t value = crc_->Compute(frame->data(), frame->size());
+    for (std::size_t i = 0; i < fieldBytes_; ++i) {
+        const std::size_t shift = settings_.bigEndian ? fieldBytes_ - 1U - i : i;
+        frame->push_back(static_cast<uint8_t>(value >> (shift * 8U)));
+    }
+    return fieldBytes_;
+}
+
+void CrcFraming::Feed(std::span<const uint8_t> data, std::int64_t timestampNs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!crc_) {
+        streamOffset_ += data.size();
+        return;
+    }
+    if (frameBytes_ != 0 && timestampNs - lastReadNs_ >= settings_.gapNs) {
+        EndFrame(lastReadNs_);
+    }
+    lastReadNs_ = timestampNs;
+    stats_.bytes += data.size();
+
+    while (!data.empty()) {
+        const std::span<const uint8_t> part = data.first(std::min(data.size(), settings_.maxFrameBytes - frameBytes_));
+        Absorb(part);
+        data = data.subspan(part.size());
+        if (frameBytes_ == settings_.maxFrameBytes) {
+            EndFrame(timestampNs);
+        }
+    }
+}
+
+void CrcFraming::Expire(std::int64_t nowNs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (crc_ && frameBytes_ != 0 && nowNs - lastReadNs_ >= settings_.gapNs) {
+        EndFrame(lastReadNs_);
+    }
+}
+
+void CrcFraming::Flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (crc_) {
+        EndFrame(lastReadNs_);
+    }
+}
+
+void CrcFraming::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_ = {};
+    streamOffset_ = 0;
+    lastReadNs_ = 0;
+    // Sequence numbers keep counting, so cursors held by readers stay meaningful.
+    first_ = next_;
+    StartFrame();
+}
+
+CrcFramingStats CrcFraming::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+std::size_t CrcFraming::Read(std::uint64_t* cursor, std::span<CrcFrameCheck> out, std::uint64_t* lost) const {
+    if (cursor == nullptr) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    *cursor = std::max(*cursor, first_);
+    const std::uint64_t oldest = (next_ > log_.size()) ? next_ - log_.size() : 0U;
+    if (*cursor < oldest) {
+        if (lost != nullptr) {
+            *lost += oldest - *cursor;
+        }
+        *cursor = oldest;
+    }
+    if (*cursor > next_) {
+        *cursor = next_;
+    }
+
+    const std::size_t count = static_cast<std::size_t>(std::min<std::uint64_t>(next_ - *cursor, out.size()));
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = log_[(*cursor + i) % log_.size()];
+    }
+    *cursor += count;
+    return count;
+}
+
+std::uint64_t CrcFraming::NextSequence() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return next_;
+}
+
+void CrcFraming::Absorb(std::span<const uint8_t> data) {
+    frameBytes_ += data.size();
+    streamOffset_ += data.size();
+
+    const std::size_t total = tailBytes_ + data.size();
+    if (total <= fieldBytes_) {
+        std::copy(data.begin(), data.end(), tail_.begin() + static_cast<std::ptrdiff_t>(tailBytes_));
+        tailBytes_ = total;
+        return;
+    }
+
+    // Everything but the last fieldBytes_ bytes goes through the register: first what waited in
+    // the tail, then the bulk of data in one call.
+    const std::size_t release = total - fieldBytes_;
+    const std::size_t fromTail = std::min(tailBytes_, release);
+    const std::size_t fromData = release - fromTail;
+    register_ = crc_->Update(register_, tail_.data(), fromTail);
+    register_ = crc_->Update(register_, data.data(), fromData);
+
+    std::array<uint8_t, 4> tail{};
+    std::size_t kept = 0;
+    for (std::size_t i = fromTail; i < tailBytes_; ++i) {
+        tail[kept++] = tail_[i];
+    }
+    for (std::size_t i = fromData; i < data.size(); ++i) {
+        tail[kept++] = data[i];
+    }
+    tail_ = tail;
+    tailBytes_ = kept;
+}
+
+void CrcFraming::EndFrame(std::int64_t timestampNs) {
+    if (frameBytes_ == 0) {
+        return;
+    }
+
+    CrcFrameCheck check{};
+    check.timestampNs = timestampNs;
+    check.offset = frameOffset_;
+    check.length = static_cast<std::uint32_t>(frameBytes_);
+    if (frameBytes_ > fieldBytes_) {
+        check.received = FieldValue();
+        check.computed = crc_->Finalize(register_);
+        check.ok = check.received == check.computed;
+    }
+    ++stats_.frames;
+    ++(check.ok ? stats_.passed : stats_.failed);
+    log_[next_ % log_.size()] = check;
+    ++next_;
+    StartFrame();
+}
+
+void CrcFraming::StartFrame() {
+    register_ = crc_ ? crc_->InitRegister() : 0U;
+    tailBytes_ = 0;
+    frameBytes_ = 0;
+    frameOffset_ = streamOffset_;
+}
+
+std::uint32_t CrcFraming::FieldValue() const {
+    std::uint32_t value = 0;
+    for (std::size_t i = 0; i < fieldBytes_; ++i) {
+        const std::size_t index = settings_.bigEndian ? i : fieldBytes_ - 1U - i;
+        value = (value << 8U) | tail_[index];
+    }
+    return value;
+}
+
+} // namespace serial
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "core/CrcModel.h"
+
+namespace serial {
+
+struct CrcFramingSettings {
+    // A width of 0 turns the stage off.
+    core::CrcModel model{};
+    // Byte order of the CRC field on the wire.
+    bool bigEndian = false;
+    // Silence between two reads that ends a received frame.
+    std::int64_t gapNs = 2000000;
+    // A run without a gap is cut into frames of this size.
+    std::size_t maxFrameBytes = 64U * 1024U;
+};
+
+struct CrcFrameCheck {
+    std::int64_t timestampNs; // Read that ended the frame.
+    std::uint64_t offset;     // Position of the frame's first byte in the received stream.
+    std::uint32_t length;     // Including the CRC field.
+    std::uint32_t received;   // CRC field as sent.
+    std::uint32_t computed;   // CRC of the rest of the frame.
+    bool ok;                  // False as well for a frame too short to carry a CRC.
+};
+
+struct CrcFramingStats {
+    std::uint64_t frames = 0;
+    std::uint64_t passed = 0;
+    std::uint64_t failed = 0;
+    std::uint64_t bytes = 0; // Received while enabled.
+};
+
+// Appends a CRC to outgoing frames and checks the CRC of incoming ones. The receiving side is fed
+// straight from the read thread and keeps only a running register and the last few bytes of the
+// frame, so every byte is run through the CRC once, at slice-by-8 speed, whatever the read
+// sizes. Results are counted and recorded in a ring that readers consume with their own cursor,
+// like ModemEventLog; the oldest checks are overwritten when a reader falls behind.
+//
+// Frames are delimited by silence: a frame ends when the next read arrives after the gap, or
+// when Expire() finds the line quiet for that long. Ending a frame as soon as its CRC matches
+// would misfire: a read that stops one byte short of the end matches once in 256 for a CRC-16.
+class CrcFraming final {
+public:
+    explicit CrcFraming(std::size_t logCapacity = 1024);
+
+    CrcFraming(const CrcFraming&) = delete;
+    CrcFraming& operator=(const CrcFraming&) = delete;
+
+    // Drops the pending frame; counters and the log are kept.
+    void Configure(const CrcFramingSettings& settings);
+    [[nodiscard]] CrcFramingSettings Settings() const;
+    [[nodiscard]] bool Enabled() const;
+
+    // Sending side: appends the CRC field to *frame. Returns the number of bytes added, 0 when off.
+    std::size_t Append(std::vector<uint8_t>* frame) const;
+
+    // Receiving side, one call per read in stream order.
+    void Feed(std::span<const uint8_t> data, std::int64_t timestampNs);
+    // Ends the pending frame if nothing has been fed for the gap; nowNs is core::MonotonicNanos(),
+    // the clock of the read timestamps. Lets a reply be checked without waiting for more traffic.
+    void Expire(std::int64_t nowNs);
+    // Checks the pending frame now, e.g. when the port closes.
+    void Flush();
+    // Starts a new stream: drops the pending frame and zeroes the counters and offsets.
+    void Reset();
+
+    [[nodiscard]] CrcFramingStats Stats() const;
+
+    // Copies checks from sequence *cursor on into out and advances *cursor past them. Checks that
+    // were overwritten before the reader got to them are skipped and added to *lost.
+    std::size_t Read(std::uint64_t* cursor, std::span<CrcFrameCheck> out, std::uint64_t* lost = nullptr) const;
+    // Sequence number the next check will get; a cursor starting here sees only new checks.
+    [[nodiscard]] std::uint64_t NextSequence() const;
+
+private:
+    void Absorb(std::span<const uint8_t> data);
+    void EndFrame(std::int64_t timestampNs);
+    void StartFrame();
+    [[nodiscard]] std::uint32_t FieldValue() const;
+
+    mutable std::mutex mutex_;
+    CrcFramingSettings settings_;
+    std::optional<core::RuntimeCrc> crc_;
+    std::size_t fieldBytes_;
+    // Pending frame: the register covers all but its last fieldBytes_ bytes, which wait in tail_.
+    std::uint32_t register_;
+    std::array<uint8_t, 4> tail_;
+    std::size_t tailBytes_;
+    std::size_t frameBytes_;
+    std::uint64_t frameOffset_;
+    std::uint64_t streamOffset_;
+    std::int64_t lastReadNs_;
+    CrcFramingStats stats_;
+    std::vector<CrcFrameCheck> log_;
+    std::uint64_t first_; // Oldest sequence still valid after Reset().
+    std::uint64_t next_;
+};
+
+} // namespace serial
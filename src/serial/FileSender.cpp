@@ -0,0 +1,235 @@
+#include "serial/FileSender.h"
+
+#include <algorithm>
+#include <system_error>
+
+#include "core/Clock.h"
+
+namespace {
+
+// How long to back off when the port's TxQueue is full of someone else's data.
+constexpr std::chrono::milliseconds kQueueFullRetry{5};
+
+} // namespace
+
+namespace serial {
+
+FileSender::FileSender(SerialPort& port)
+    : port_(port),
+      startNs_(0),
+      endNs_(0),
+      lastCompletionNs_(0),
+      totalBytes_(0),
+      confirmedBytes_(0),
+      inFlightBytes_(0),
+      stalls_(0),
+      stalled_(false),
+      failed_(false),
+      cancel_(false),
+      running_(false),
+      finished_(false) {}
+
+FileSender::~FileSender() {
+    Cancel();
+    Join();
+}
+
+bool FileSender::Start(const std::wstring& path, ProgressCallback onProgress, const FileSendOptions& options) {
+    Cancel();
+    Join();
+
+    if (options.chunkBytes == 0 || options.windowBytes < options.chunkBytes || !file_.Open(path)) {
+        return false;
+    }
+
+    options_ = options;
+    onProgress_ = std::move(onProgress);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        startNs_ = core::MonotonicNanos();
+        lastCompletionNs_ = startNs_;
+        endNs_ = 0;
+        totalBytes_ = file_.Size();
+        confirmedBytes_ = 0;
+        inFlightBytes_ = 0;
+        stalls_ = 0;
+        stalled_ = false;
+        failed_ = false;
+        cancel_ = false;
+        running_ = true;
+        finished_ = false;
+    }
+
+    try {
+        thread_ = std::thread(&FileSender::ThreadMain, this);
+    } catch (const std::system_error&) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+        file_.Close();
+        return false;
+    }
+    return true;
+}
+
+void FileSender::Cancel() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancel_ = true;
+    }
+    changed_.notify_all();
+}
+
+void FileSender::Join() {
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool FileSender::IsRunning() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_;
+}
+
+FileSendProgress FileSender::Progress() const {
+    const std::int64_t now = core::MonotonicNanos();
+    std::lock_guard<std::mutex> lock(mutex_);
+    return SnapshotLocked(now);
+}
+
+bool FileSender::Wait(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return changed_.wait_for(lock, timeout, [this] { return !running_; });
+}
+
+void FileSender::ThreadMain() {
+    std::uint64_t offset = 0;
+    std::span<const uint8_t> view;
+    std::uint64_t viewOffset = 0;
+    std::int64_t nextProgressNs = 0;
+    bool purged = false;
+    const std::int64_t progressIntervalNs =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(options_.progressInterval).count();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        const bool queuedAll = offset == totalBytes_;
+        const auto canQueue = [&] {
+            return !queuedAll && inFlightBytes_ + options_.chunkBytes <= options_.windowBytes;
+        };
+        if (cancel_ || failed_) {
+            if (inFlightBytes_ == 0) {
+                break;
+            }
+        } else if (queuedAll && inFlightBytes_ == 0) {
+            break;
+        }
+        // Done here rather than in Cancel(), so no chunk can be queued after the purge.
+        if (cancel_ && !purged) {
+            purged = true;
+            lock.unlock();
+            port_.PurgeTx();
+            lock.lock();
+            continue;
+        }
+
+        if (!canQueue() || cancel_ || failed_) {
+            changed_.wait_for(lock, options_.progressInterval);
+        }
+
+        const std::int64_t now = core::MonotonicNanos();
+        const bool stalled = inFlightBytes_ > 0 && now - lastCompletionNs_ >= kStallNs;
+        if (stalled && !stalled_) {
+            ++stalls_;
+        }
+        stalled_ = stalled;
+        if (onProgress_ && now >= nextProgressNs) {
+            nextProgressNs = now + progressIntervalNs;
+            const FileSendProgress progress = SnapshotLocked(now);
+            lock.unlock();
+            onProgress_(progress);
+            lock.lock();
+        }
+
+        if (!canQueue() || cancel_ || failed_) {
+            continue;
+        }
+
+        // Mapping a view can fault in pages from disk, keep the lock out of it.
+        lock.unlock();
+        if (offset < viewOffset || offset >= viewOffset + view.size()) {
+            view = file_.Map(offset, kViewBytes);
+            viewOffset = offset;
+        }
+        if (view.empty()) {
+            lock.lock();
+            failed_ = true;
+            continue;
+        }
+        const std::size_t inView = static_cast<std::size_t>(offset - viewOffset);
+        const auto size = static_cast<DWORD>(std::min(options_.chunkBytes, view.size() - inView));
+
+        lock.lock();
+        inFlightBytes_ += size;
+        lock.unlock();
+        const bool queued = port_.WriteAsync(view.data() + inView, size, [this, size](bool ok, DWORD written) {
+            OnWritten(size, ok, written);
+        });
+        lock.lock();
+
+        if (queued) {
+            offset += size;
+            continue;
+        }
+        inFlightBytes_ -= size;
+        if (!port_.IsOpen()) {
+            failed_ = true;
+        } else {
+            changed_.wait_for(lock, kQueueFullRetry);
+        }
+    }
+
+    // WriteAsync copies each chunk out of the view before it returns, so only this thread ever
+    // reads the mapping. It is closed here rather than in Cancel(), which no longer joins and
+    // would otherwise unmap a view the loop may still be copying from.
+    file_.Close();
+
+    running_ = false;
+    finished_ = true;
+    endNs_ = core::MonotonicNanos();
+    const FileSendProgress progress = SnapshotLocked(endNs_);
+    lock.unlock();
+    changed_.notify_all();
+    if (onProgress_) {
+        onProgress_(progress);
+    }
+}
+
+void FileSender::OnWritten(DWORD size, bool ok, DWORD written) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        inFlightBytes_ -= size;
+        lastCompletionNs_ = core::MonotonicNanos();
+        // Writes complete in order, so after the first failure nothing is contiguous any more.
+        if (!failed_) {
+            confirmedBytes_ += written;
+            failed_ = !ok;
+        }
+    }
+    changed_.notify_all();
+}
+
+FileSendProgress FileSender::SnapshotLocked(std::int64_t now) const {
+    FileSendProgress progress;
+    progress.sentBytes = confirmedBytes_;
+    progress.totalBytes = totalBytes_;
+    progress.elapsedNs = (finished_ ? endNs_ : now) - startNs_;
+    progress.bytesPerSecond =
+        progress.elapsedNs > 0 ? static_cast<double>(confirmedBytes_) * 1e9 / static_cast<double>(progress.elapsedNs) : 0.0;
+    progress.stalls = stalls_;
+    progress.stalled = stalled_;
+    progress.finished = finished_;
+    progress.ok = finished_ && !failed_ && confirmedBytes_ == totalBytes_;
+    return progress;
+}
+
+} // namespace serial
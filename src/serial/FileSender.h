@@ -0,0 +1,92 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "core/MappedFile.h"
+#include "serial/SerialPort.h"
+
+namespace serial {
+
+struct FileSendProgress {
+    std::uint64_t sentBytes = 0;  // Confirmed by the port's writer, contiguous from the file start.
+    std::uint64_t totalBytes = 0;
+    std::int64_t elapsedNs = 0;
+    double bytesPerSecond = 0.0;  // sentBytes over elapsedNs.
+    std::uint32_t stalls = 0;     // Times the port took nothing for FileSender::kStallNs.
+    bool stalled = false;         // Currently held back, typically by RTS/CTS or XON/XOFF.
+    bool finished = false;
+    bool ok = false;              // With finished: every byte was written.
+};
+
+struct FileSendOptions {
+    std::size_t chunkBytes = SerialPort::kMaxTxBatchBytes;
+    // Bytes queued or in the driver at once. Must leave room in the port's TxQueue for other writers.
+    std::size_t windowBytes = 8U * SerialPort::kMaxTxBatchBytes;
+    std::chrono::milliseconds progressInterval{100};
+};
+
+// Streams a file to a SerialPort through WriteAsync. The file is read through a sliding
+// MappedFile view and at most windowBytes are handed to the port at a time, so memory use does
+// not depend on the file size while the writer always has the next chunks ready. When the peer
+// holds the line (flow control) completions simply stop arriving; the window keeps the sender
+// from buffering further and progress reports the stall.
+class FileSender final {
+public:
+    using ProgressCallback = std::function<void(const FileSendProgress& progress)>;
+
+    static constexpr std::size_t kViewBytes = 4U * 1024U * 1024U;
+    static constexpr std::int64_t kStallNs = 500 * 1000 * 1000;
+
+    explicit FileSender(SerialPort& port);
+    ~FileSender();
+
+    FileSender(const FileSender&) = delete;
+    FileSender& operator=(const FileSender&) = delete;
+
+    // Opens the file and starts the sender thread. onProgress runs on that thread at most once
+    // per progressInterval, and once more with finished set.
+    bool Start(const std::wstring& path, ProgressCallback onProgress = {}, const FileSendOptions& options = {});
+    // Stops queuing and has the port drop what it has not sent yet (SerialPort::PurgeTx), so a
+    // peer holding the line cannot keep the transfer alive. Returns without waiting; the
+    // transfer ends with the final progress callback. Start() and the destructor join the thread.
+    void Cancel();
+    [[nodiscard]] bool IsRunning() const;
+    [[nodiscard]] FileSendProgress Progress() const;
+    // Waits for the transfer to end; false on timeout.
+    bool Wait(std::chrono::milliseconds timeout);
+
+private:
+    void Join();
+    void ThreadMain();
+    void OnWritten(DWORD size, bool ok, DWORD written);
+    FileSendProgress SnapshotLocked(std::int64_t now) const;
+
+    SerialPort& port_;
+    core::MappedFile file_;
+    FileSendOptions options_;
+    ProgressCallback onProgress_;
+    std::thread thread_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    std::int64_t startNs_;
+    std::int64_t endNs_;
+    std::int64_t lastCompletionNs_;
+    std::uint64_t totalBytes_;
+    std::uint64_t confirmedBytes_;
+    std::size_t inFlightBytes_;
+    std::uint32_t stalls_;
+    bool stalled_;
+    bool failed_;
+    bool cancel_;
+    bool running_;
+    bool finished_;
+};
+
+} // namespace serial
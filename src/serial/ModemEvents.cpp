@@ -0,0 +1,70 @@
+#include "serial/ModemEvents.h"
+
+#include <algorithm>
+
+namespace serial {
+
+ModemEventLog::ModemEventLog(std::size_t capacity)
+    : events_(std::max<std::size_t>(capacity, 1U)),
+      first_(0),
+      next_(0) {
+}
+
+void ModemEventLog::Push(const ModemEvent& event) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_[next_ % events_.size()] = event;
+    ++next_;
+}
+
+void ModemEventLog::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Sequence numbers keep counting, so cursors held by readers stay meaningful.
+    first_ = next_;
+}
+
+std::size_t ModemEventLog::Read(std::uint64_t* cursor, std::span<ModemEvent> out, std::uint64_t* lost) const {
+    if (cursor == nullptr) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Events dropped by Clear() are not lost, the reader just starts after them.
+    *cursor = std::max(*cursor, first_);
+    const std::uint64_t oldest = (next_ > events_.size()) ? next_ - events_.size() : 0U;
+    if (*cursor < oldest) {
+        if (lost != nullptr) {
+            *lost += oldest - *cursor;
+        }
+        *cursor = oldest;
+    }
+    if (*cursor > next_) {
+        *cursor = next_;
+    }
+
+    const std::size_t count = static_cast<std::size_t>(std::min<std::uint64_t>(next_ - *cursor, out.size()));
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = events_[(*cursor + i) % events_.size()];
+    }
+    *cursor += count;
+    return count;
+}
+
+bool ModemEventLog::Latest(ModemEvent* event) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (event == nullptr || next_ == first_) {
+        return false;
+    }
+    *event = events_[(next_ - 1U) % events_.size()];
+    return true;
+}
+
+std::uint64_t ModemEventLog::NextSequence() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return next_;
+}
+
+std::size_t ModemEventLog::Capacity() const noexcept {
+    return events_.size();
+}
+
+} // namespace serial
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "core/Platform.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace serial {
+
+// MS_CTS_ON | MS_DSR_ON | MS_RING_ON | MS_RLSD_ON: the input lines a ModemMonitor watches.
+constexpr DWORD kModemInputLines = MS_CTS_ON | MS_DSR_ON | MS_RING_ON | MS_RLSD_ON;
+
+struct ModemEvent {
+    std::int64_t timestampNs; // core::MonotonicNanos() when the driver reported the change.
+    DWORD status;             // Line state after the change, GetModemStatus() masks.
+    DWORD changed;            // Lines that toggled since the previous event. A bit can be set while
+                              // status is unchanged: the line pulsed faster than the monitor woke up.
+};
+
+// Fixed-capacity ring of modem events. One writer (the monitor thread), any number of readers,
+// each keeping its own cursor; the oldest events are overwritten when a reader falls behind.
+class ModemEventLog final {
+public:
+    explicit ModemEventLog(std::size_t capacity);
+
+    ModemEventLog(const ModemEventLog&) = delete;
+    ModemEventLog& operator=(const ModemEventLog&) = delete;
+
+    void Push(const ModemEvent& event);
+    void Clear();
+
+    // Copies events from sequence *cursor on into out and advances *cursor past them. Events that
+    // were overwritten before the reader got to them are skipped and added to *lost.
+    std::size_t Read(std::uint64_t* cursor, std::span<ModemEvent> out, std::uint64_t* lost = nullptr) const;
+    bool Latest(ModemEvent* event) const;
+
+    // Sequence number the next pushed event will get; a cursor starting here sees only new events.
+    [[nodiscard]] std::uint64_t NextSequence() const;
+    [[nodiscard]] std::size_t Capacity() const noexcept;
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<ModemEvent> events_;
+    std::uint64_t first_; // Oldest sequence still valid after Clear().
+    std::uint64_t next_;
+};
+
+} // namespace serial
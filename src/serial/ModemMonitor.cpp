@@ -0,0 +1,148 @@
+#include "serial/ModemMonitor.h"
+
+#include "core/Clock.h"
+
+namespace {
+
+constexpr DWORD kCommEvents = EV_CTS | EV_DSR | EV_RING | EV_RLSD;
+
+DWORD LinesFromEvents(DWORD events) noexcept {
+    DWORD lines = 0;
+    lines |= ((events & EV_CTS) != 0) ? MS_CTS_ON : 0U;
+    lines |= ((events & EV_DSR) != 0) ? MS_DSR_ON : 0U;
+    lines |= ((events & EV_RING) != 0) ? MS_RING_ON : 0U;
+    lines |= ((events & EV_RLSD) != 0) ? MS_RLSD_ON : 0U;
+    return lines;
+}
+
+} // namespace
+
+namespace serial {
+
+ModemMonitor::ModemMonitor(std::size_t capacity)
+    : port_(INVALID_HANDLE_VALUE),
+      status_(0),
+      running_(false),
+      events_(capacity) {
+}
+
+ModemMonitor::~ModemMonitor() {
+    Stop();
+}
+
+bool ModemMonitor::Start(HANDLE port, EventCallback onEvent) {
+    Stop();
+
+    DWORD status = 0;
+    if (port == nullptr || port == INVALID_HANDLE_VALUE || !::GetCommModemStatus(port, &status)) {
+        return false;
+    }
+    if (!::SetCommMask(port, kCommEvents)) {
+        return false;
+    }
+
+    HANDLE rawWaitEvent = ::CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    HANDLE rawStopEvent = ::CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    waitEvent_.Reset(rawWaitEvent);
+    stopEvent_.Reset(rawStopEvent);
+    if (rawWaitEvent == nullptr || rawStopEvent == nullptr) {
+        ::SetCommMask(port, 0);
+        Stop();
+        return false;
+    }
+
+    port_ = port;
+    onEvent_ = std::move(onEvent);
+    events_.Clear();
+    Record(core::MonotonicNanos(), status & kModemInputLines, 0);
+
+    running_.store(true);
+    HANDLE rawThread = ::CreateThread(nullptr, 0, &ModemMonitor::ThreadProc, this, 0, nullptr);
+    if (rawThread == nullptr) {
+        Stop();
+        return false;
+    }
+    threadHandle_.Reset(rawThread);
+    return true;
+}
+
+void ModemMonitor::Stop() {
+    if (running_.exchange(false)) {
+        ::SetEvent(stopEvent_.Get());
+    }
+    // No timeout: the thread owns an OVERLAPPED on its stack until WaitCommEvent is reaped.
+    if (threadHandle_.IsValid()) {
+        ::WaitForSingleObject(threadHandle_.Get(), INFINITE);
+        ::SetCommMask(port_, 0);
+    }
+    threadHandle_.Reset();
+    waitEvent_.Reset();
+    stopEvent_.Reset();
+    port_ = INVALID_HANDLE_VALUE;
+}
+
+bool ModemMonitor::IsRunning() const noexcept {
+    return running_.load();
+}
+
+DWORD WINAPI ModemMonitor::ThreadProc(LPVOID param) {
+    static_cast<ModemMonitor*>(param)->ThreadMain();
+    return 0;
+}
+
+void ModemMonitor::ThreadMain() {
+    const HANDLE handles[] = {waitEvent_.Get(), stopEvent_.Get()};
+
+    while (running_.load()) {
+        DWORD mask = 0;
+        OVERLAPPED overlapped{};
+        overlapped.hEvent = waitEvent_.Get();
+        ::ResetEvent(overlapped.hEvent);
+
+        if (!::WaitCommEvent(port_, &mask, &overlapped)) {
+            if (::GetLastError() != ERROR_IO_PENDING) {
+                break;
+            }
+            const DWORD wait = ::WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+            DWORD ignored = 0;
+            if (wait != WAIT_OBJECT_0) {
+                // mask and overlapped live on this stack: reap the cancelled wait before leaving.
+                ::CancelIoEx(port_, &overlapped);
+                ::GetOverlappedResult(port_, &overlapped, &ignored, TRUE);
+                break;
+            }
+            if (!::GetOverlappedResult(port_, &overlapped, &ignored, FALSE)) {
+                break;
+            }
+        }
+
+        const std::int64_t timestamp = core::MonotonicNanos();
+        DWORD status = 0;
+        if (!::GetCommModemStatus(port_, &status)) {
+            break;
+        }
+        status &= kModemInputLines;
+
+        // The event mask catches pulses that are already over by the time the status is read.
+        const DWORD changed = (LinesFromEvents(mask) | (status ^ status_)) & kModemInputLines;
+        if (changed != 0) {
+            Record(timestamp, status, changed);
+        }
+    }
+    running_.store(false);
+}
+
+void ModemMonitor::Record(std::int64_t timestampNs, DWORD status, DWORD changed) {
+    status_ = status;
+    const ModemEvent event{timestampNs, status, changed};
+    events_.Push(event);
+    if (onEvent_) {
+        onEvent_(event);
+    }
+}
+
+const ModemEventLog& ModemMonitor::Events() const noexcept {
+    return events_;
+}
+
+} // namespace serial
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "core/Platform.h"
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <thread>
+
+#include "serial/ModemEvents.h"
+
+#ifdef _WIN32
+#include "core/SafeHandle.h"
+#endif
+
+namespace serial {
+
+// Watches CTS/DSR/RI/DCD on an open port and records every transition into a ModemEventLog,
+// blocking in the driver (WaitCommEvent / TIOCMIWAIT) instead of polling GetModemStatus().
+// The monitor does not own the port: Stop() it before the handle is closed.
+class ModemMonitor final {
+public:
+    // Called on the monitor thread after the event is in the log.
+    using EventCallback = std::function<void(const ModemEvent& event)>;
+
+    static constexpr std::size_t kDefaultCapacity = 1024;
+
+    explicit ModemMonitor(std::size_t capacity = kDefaultCapacity);
+    ~ModemMonitor();
+
+    ModemMonitor(const ModemMonitor&) = delete;
+    ModemMonitor& operator=(const ModemMonitor&) = delete;
+
+    // Records the current line state as an event with changed == 0, then starts the thread.
+    // Fails when the device has no modem lines (pseudo-terminals, some USB adapters).
+#ifdef _WIN32
+    bool Start(HANDLE port, EventCallback onEvent = {});
+#else
+    bool Start(int port, EventCallback onEvent = {});
+#endif
+    void Stop();
+    [[nodiscard]] bool IsRunning() const noexcept;
+
+    [[nodiscard]] const ModemEventLog& Events() const noexcept;
+
+private:
+    void Record(std::int64_t timestampNs, DWORD status, DWORD changed);
+
+#ifdef _WIN32
+    static DWORD WINAPI ThreadProc(LPVOID param);
+    void ThreadMain();
+
+    HANDLE port_;
+    core::SafeHandle waitEvent_;
+    core::SafeHandle stopEvent_;
+    core::SafeHandle threadHandle_;
+#else
+    void ThreadMain();
+
+    int port_;
+    std::thread thread_;
+    std::atomic<bool> finished_;
+#endif
+    DWORD status_;
+    std::atomic<bool> running_;
+    EventCallback onEvent_;
+    ModemEventLog events_;
+};
+
+} // namespace serial
@@ -0,0 +1,157 @@
+#include "serial/ModemMonitor.h"
+
+#include <pthread.h>
+#include <signal.h>
+#include <sys/ioctl.h>
+
+#include <linux/serial.h>
+
+#include <cerrno>
+#include <chrono>
+#include <mutex>
+#include <system_error>
+
+#include "core/Clock.h"
+#include "serial/SerialDevice.h"
+
+namespace {
+
+constexpr int kWaitLines = TIOCM_CTS | TIOCM_DSR | TIOCM_RNG | TIOCM_CAR;
+
+// TIOCMIWAIT has no timeout and ignores eventfds: Stop() interrupts it with this signal, whose
+// handler is installed without SA_RESTART so the ioctl returns EINTR.
+int WakeSignal() noexcept {
+    return SIGRTMIN + 2;
+}
+
+void OnWakeSignal(int) {}
+
+void InstallWakeHandler() {
+    static std::once_flag once;
+    std::call_once(once, [] {
+        struct sigaction action{};
+        action.sa_handler = &OnWakeSignal;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = 0;
+        ::sigaction(WakeSignal(), &action, nullptr);
+    });
+}
+
+// Per-line transition counters, so pulses shorter than the wake-up latency are still seen.
+bool ReadCounters(int fd, serial_icounter_struct* counters) {
+    return ::ioctl(fd, TIOCGICOUNT, counters) == 0;
+}
+
+DWORD LinesFromCounters(const serial_icounter_struct& before, const serial_icounter_struct& after) noexcept {
+    DWORD lines = 0;
+    lines |= (after.cts != before.cts) ? MS_CTS_ON : 0U;
+    lines |= (after.dsr != before.dsr) ? MS_DSR_ON : 0U;
+    lines |= (after.rng != before.rng) ? MS_RING_ON : 0U;
+    lines |= (after.dcd != before.dcd) ? MS_RLSD_ON : 0U;
+    return lines;
+}
+
+} // namespace
+
+namespace serial {
+
+ModemMonitor::ModemMonitor(std::size_t capacity)
+    : port_(-1),
+      finished_(true),
+      status_(0),
+      running_(false),
+      events_(capacity) {
+}
+
+ModemMonitor::~ModemMonitor() {
+    Stop();
+}
+
+bool ModemMonitor::Start(int port, EventCallback onEvent) {
+    Stop();
+
+    DWORD status = 0;
+    if (port < 0 || !GetModemLines(port, &status)) {
+        return false;
+    }
+    InstallWakeHandler();
+
+    port_ = port;
+    onEvent_ = std::move(onEvent);
+    events_.Clear();
+    Record(core::MonotonicNanos(), status, 0);
+
+    running_.store(true);
+    finished_.store(false);
+    try {
+        thread_ = std::thread(&ModemMonitor::ThreadMain, this);
+    } catch (const std::system_error&) {
+        running_.store(false);
+        finished_.store(true);
+        port_ = -1;
+        return false;
+    }
+    return true;
+}
+
+void ModemMonitor::Stop() {
+    running_.store(false);
+    if (thread_.joinable()) {
+        // A signal sent just before the thread enters the ioctl is lost, so keep sending until it leaves.
+        while (!finished_.load()) {
+            ::pthread_kill(thread_.native_handle(), WakeSignal());
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        thread_.join();
+    }
+    port_ = -1;
+}
+
+bool ModemMonitor::IsRunning() const noexcept {
+    return running_.load();
+}
+
+void ModemMonitor::ThreadMain() {
+    serial_icounter_struct counters{};
+    const bool haveCounters = ReadCounters(port_, &counters);
+
+    while (running_.load()) {
+        if (::ioctl(port_, TIOCMIWAIT, kWaitLines) != 0 && errno != EINTR) {
+            break;
+        }
+
+        const std::int64_t timestamp = core::MonotonicNanos();
+        DWORD status = 0;
+        if (!GetModemLines(port_, &status)) {
+            break;
+        }
+
+        DWORD changed = status ^ status_;
+        serial_icounter_struct now{};
+        if (haveCounters && ReadCounters(port_, &now)) {
+            changed |= LinesFromCounters(counters, now);
+            counters = now;
+        }
+        changed &= kModemInputLines;
+        if (changed != 0) {
+            Record(timestamp, status, changed);
+        }
+    }
+    running_.store(false);
+    finished_.store(true);
+}
+
+void ModemMonitor::Record(std::int64_t timestampNs, DWORD status, DWORD changed) {
+    status_ = status;
+    const ModemEvent event{timestampNs, status, changed};
+    events_.Push(event);
+    if (onEvent_) {
+        onEvent_(event);
+    }
+}
+
+const ModemEventLog& ModemMonitor::Events() const noexcept {
+    return events_;
+}
+
+} // namespace serial
@@ -0,0 +1,338 @@
+#include "serial/PortBridge.h"
+
+#include <ws2tcpip.h>
+
+#include <memory>
+
+#include "core/Clock.h"
+#include "serial/ReadTiming.h"
+#include "serial/SerialDevice.h"
+
+namespace {
+
+constexpr DWORD kAcceptPollMs = 100;
+
+struct IoSlot {
+    OVERLAPPED overlapped{};
+    core::SafeHandle event{::CreateEventW(nullptr, TRUE, FALSE, nullptr)};
+
+    void Reset() {
+        overlapped = OVERLAPPED{};
+        overlapped.hEvent = event.Get();
+    }
+};
+
+} // namespace
+
+namespace serial {
+
+PortBridge::PortBridge()
+    : taps_{core::SlabRing(kTapSlabCount, kTapSlabSize), core::SlabRing(kTapSlabCount, kTapSlabSize)},
+      running_(false),
+      clientConnected_(false),
+      listeningPort_(0),
+      bytes_{},
+      tapDropped_(0),
+      sessions_(0),
+      copying_{} {}
+
+PortBridge::~PortBridge() {
+    Stop();
+}
+
+bool PortBridge::Start(const BridgeEndpoint& a, const BridgeEndpoint& b, TapCallback onTap) {
+    Stop();
+    if (a.kind == BridgeEndpointKind::TcpListen && b.kind == BridgeEndpointKind::TcpListen) {
+        return false;
+    }
+
+    sides_[0].endpoint = a;
+    sides_[1].endpoint = b;
+    for (Side& side : sides_) {
+        if (side.endpoint.kind == BridgeEndpointKind::Serial) {
+            side.handle = OpenSerialDevice(side.endpoint.portName, side.endpoint.settings, MakeReadGeometry(side.endpoint.settings).timing);
+            if (!side.handle.IsValid()) {
+                Stop();
+                return false;
+            }
+            continue;
+        }
+        WSADATA data{};
+        if (!winsock_ && ::WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+            Stop();
+            return false;
+        }
+        winsock_ = true;
+        if (!OpenListener(side)) {
+            Stop();
+            return false;
+        }
+    }
+
+    stopEvent_.Reset(::CreateEventW(nullptr, TRUE, FALSE, nullptr));
+    sessionEvent_.Reset(::CreateEventW(nullptr, TRUE, FALSE, nullptr));
+    if (!stopEvent_.IsValid() || !sessionEvent_.IsValid()) {
+        Stop();
+        return false;
+    }
+
+    onTap_ = std::move(onTap);
+    for (auto& counter : bytes_) {
+        counter.store(0);
+    }
+    tapDropped_.store(0);
+    sessions_.store(0);
+    running_.store(true);
+    sessionThread_ = std::thread(&PortBridge::SessionMain, this);
+    return true;
+}
+
+void PortBridge::Stop() {
+    if (stopEvent_.IsValid()) {
+        ::SetEvent(stopEvent_.Get());
+    }
+    if (sessionThread_.joinable()) {
+        sessionThread_.join();
+    }
+    running_.store(false);
+    clientConnected_.store(false);
+
+    for (Side& side : sides_) {
+        side.handle.Reset();
+        if (side.client != INVALID_SOCKET) {
+            ::closesocket(side.client);
+            side.client = INVALID_SOCKET;
+        }
+        if (side.listener != INVALID_SOCKET) {
+            ::closesocket(side.listener);
+            side.listener = INVALID_SOCKET;
+        }
+    }
+    if (winsock_) {
+        ::WSACleanup();
+        winsock_ = false;
+    }
+    stopEvent_.Reset();
+    sessionEvent_.Reset();
+    listeningPort_.store(0);
+    onTap_ = {};
+}
+
+bool PortBridge::IsRunning() const noexcept {
+    return running_.load();
+}
+
+std::uint16_t PortBridge::ListeningPort() const noexcept {
+    return listeningPort_.load();
+}
+
+bool PortBridge::ClientConnected() const noexcept {
+    return clientConnected_.load();
+}
+
+BridgeStats PortBridge::Stats() const {
+    BridgeStats stats;
+    stats.bytesAToB = bytes_[0].load(std::memory_order_relaxed);
+    stats.bytesBToA = bytes_[1].load(std::memory_order_relaxed);
+    stats.tapDroppedBytes = tapDropped_.load(std::memory_order_relaxed);
+    stats.sessions = sessions_.load(std::memory_order_relaxed);
+    // Buffers are handed from ReadFile to WriteFile untouched, only the tap copies.
+    stats.zeroCopy = true;
+    return stats;
+}
+
+core::SlabRing& PortBridge::Tap(Direction direction) noexcept {
+    return taps_[static_cast<std::size_t>(direction)];
+}
+
+PortBridge::Side& PortBridge::Source(Direction direction) noexcept {
+    return sides_[direction == Direction::AToB ? 0U : 1U];
+}
+
+PortBridge::Side& PortBridge::Destination(Direction direction) noexcept {
+    return sides_[direction == Direction::AToB ? 1U : 0U];
+}
+
+bool PortBridge::OpenListener(Side& side) {
+    // socket() creates overlapped sockets, so ReadFile/WriteFile with an OVERLAPPED work on them.
+    const SOCKET listener = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (listener == INVALID_SOCKET) {
+        return false;
+    }
+    side.listener = listener;
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = ::htons(side.endpoint.tcpPort);
+    address.sin_addr.s_addr = ::htonl(side.endpoint.loopbackOnly ? INADDR_LOOPBACK : INADDR_ANY);
+    int length = sizeof(address);
+    if (::bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listener, 1) != 0 ||
+        ::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        return false;
+    }
+    listeningPort_.store(::ntohs(address.sin_port));
+    return true;
+}
+
+bool PortBridge::AcceptClient(Side& side) {
+    while (::WaitForSingleObject(stopEvent_.Get(), 0) != WAIT_OBJECT_0) {
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(side.listener, &readable);
+        timeval timeout{0, static_cast<long>(kAcceptPollMs * 1000U)};
+        if (::select(0, &readable, nullptr, nullptr, &timeout) <= 0) {
+            continue;
+        }
+        const SOCKET client = ::accept(side.listener, nullptr, nullptr);
+        if (client == INVALID_SOCKET) {
+            continue;
+        }
+        const BOOL noDelay = TRUE;
+        ::setsockopt(client, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+        side.client = client;
+        clientConnected_.store(true);
+        sessions_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void PortBridge::CloseClient(Side& side) {
+    if (side.client != INVALID_SOCKET) {
+        ::closesocket(side.client);
+        side.client = INVALID_SOCKET;
+    }
+    clientConnected_.store(false);
+}
+
+void PortBridge::SessionMain() {
+    Side* tcp = nullptr;
+    for (Side& side : sides_) {
+        if (side.endpoint.kind == BridgeEndpointKind::TcpListen) {
+            tcp = &side;
+        }
+    }
+
+    // While no client is connected the serial side is not read, its driver buffers the data.
+    for (;;) {
+        if (tcp != nullptr && !AcceptClient(*tcp)) {
+            break;
+        }
+        const bool serialOk = RunSession();
+        if (tcp == nullptr || !serialOk) {
+            break;
+        }
+        CloseClient(*tcp);
+    }
+    running_.store(false);
+}
+
+bool PortBridge::RunSession() {
+    ::ResetEvent(sessionEvent_.Get());
+    bool backOk = true;
+    std::thread back([this, &backOk] { backOk = Pump(Direction::BToA); });
+    const bool forthOk = Pump(Direction::AToB);
+    back.join();
+    return forthOk && backOk;
+}
+
+// Returns false when a serial endpoint failed; a TCP peer going away is not a failure.
+bool PortBridge::Pump(Direction direction) {
+    const std::size_t index = static_cast<std::size_t>(direction);
+    Side& source = Source(direction);
+    Side& destination = Destination(direction);
+    const auto ioHandle = [](const Side& side) {
+        return side.endpoint.kind == BridgeEndpointKind::Serial ? side.handle.Get() : reinterpret_cast<HANDLE>(side.client);
+    };
+    const HANDLE in = ioHandle(source);
+    const HANDLE out = ioHandle(destination);
+    const bool socketSource = source.endpoint.kind != BridgeEndpointKind::Serial;
+
+    // Two buffers: the next read lands in one while the other is still being written.
+    std::unique_ptr<uint8_t[]> buffers[2] = {std::make_unique<uint8_t[]>(kChunkBytes), std::make_unique<uint8_t[]>(kChunkBytes)};
+    IoSlot readSlot;
+    IoSlot writeSlot;
+    bool writePending = false;
+    DWORD writeSize = 0;
+    std::size_t current = 0;
+
+    // Waits for an I/O to finish; on stop or session end cancels it and returns false.
+    const auto finish = [this](HANDLE handle, IoSlot& slot, DWORD* transferred, bool* ok) {
+        const HANDLE waits[3] = {stopEvent_.Get(), sessionEvent_.Get(), slot.event.Get()};
+        const DWORD signaled = ::WaitForMultipleObjects(3, waits, FALSE, INFINITE);
+        if (signaled != WAIT_OBJECT_0 + 2U) {
+            ::CancelIoEx(handle, &slot.overlapped);
+            ::GetOverlappedResult(handle, &slot.overlapped, transferred, TRUE);
+            return false;
+        }
+        *ok = ::GetOverlappedResult(handle, &slot.overlapped, transferred, FALSE) == TRUE;
+        return true;
+    };
+    // The buffers must not go away under a write still in flight.
+    const auto abandon = [&writePending, &writeSlot, out] {
+        if (writePending) {
+            ::CancelIoEx(out, &writeSlot.overlapped);
+            DWORD ignored = 0;
+            ::GetOverlappedResult(out, &writeSlot.overlapped, &ignored, TRUE);
+            writePending = false;
+        }
+        return true;
+    };
+    const auto end = [this, &abandon](const Side& failed) {
+        abandon();
+        ::SetEvent(sessionEvent_.Get());
+        return failed.endpoint.kind != BridgeEndpointKind::Serial;
+    };
+
+    for (;;) {
+        uint8_t* buffer = buffers[current].get();
+        readSlot.Reset();
+        if (!::ReadFile(in, buffer, static_cast<DWORD>(kChunkBytes), nullptr, &readSlot.overlapped) &&
+            ::GetLastError() != ERROR_IO_PENDING) {
+            return end(source);
+        }
+        DWORD size = 0;
+        bool ok = false;
+        if (!finish(in, readSlot, &size, &ok)) {
+            return abandon();
+        }
+        if (!ok || (size == 0 && socketSource)) {
+            return end(source);
+        }
+        if (size == 0) {
+            continue; // Serial read timeout, nothing arrived.
+        }
+
+        if (writePending) {
+            DWORD written = 0;
+            writePending = false;
+            if (!finish(out, writeSlot, &written, &ok)) {
+                return true;
+            }
+            if (!ok || written != writeSize) {
+                return end(destination);
+            }
+            bytes_[index].fetch_add(written, std::memory_order_relaxed);
+        }
+
+        if (onTap_) {
+            core::SlabRing& ring = taps_[index];
+            const std::uint64_t droppedBefore = ring.DroppedBytes();
+            if (!ring.Publish(buffer, size, core::MonotonicNanos())) {
+                tapDropped_.fetch_add(ring.DroppedBytes() - droppedBefore, std::memory_order_relaxed);
+            }
+            onTap_(direction);
+        }
+
+        writeSlot.Reset();
+        writeSize = size;
+        if (!::WriteFile(out, buffer, size, nullptr, &writeSlot.overlapped) && ::GetLastError() != ERROR_IO_PENDING) {
+            return end(destination);
+        }
+        writePending = true;
+        current ^= 1U;
+    }
+}
+
+} // namespace serial
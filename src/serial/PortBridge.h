@@ -0,0 +1,133 @@
+#pragma once
+
+#include "core/Platform.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include "core/SlabRing.h"
+#include "serial/PortSettings.h"
+
+#ifdef _WIN32
+#include "core/SafeHandle.h"
+#else
+#include "core/UniqueFd.h"
+#endif
+
+namespace serial {
+
+enum class BridgeEndpointKind {
+    Serial,   // portName opened with settings.
+    TcpListen // Accepts one client at a time on tcpPort; 0 picks a free port.
+};
+
+struct BridgeEndpoint {
+    BridgeEndpointKind kind = BridgeEndpointKind::Serial;
+    std::wstring portName;
+    PortSettings settings{};
+    std::uint16_t tcpPort = 0;
+    bool loopbackOnly = true;
+};
+
+// Counters since Start(); AToB is endpoint a to endpoint b.
+struct BridgeStats {
+    std::uint64_t bytesAToB = 0;
+    std::uint64_t bytesBToA = 0;
+    // Forwarded bytes the tap could not take because the log side fell behind.
+    std::uint64_t tapDroppedBytes = 0;
+    std::uint64_t sessions = 0; // TCP clients accepted.
+    bool zeroCopy = false;      // Both directions still forward without a user-space copy.
+};
+
+// Forwards bytes between two endpoints (port to port, or port to a local TCP client) without
+// passing them through the log. On Linux data moves with splice() through a pipe and never
+// reaches user space; a tee() into a second pipe feeds the tap. On Windows each read buffer is
+// written out as is. The tap rings get a copy for logging off the forwarding path: when a ring
+// is full the tap drops, forwarding does not slow down.
+class PortBridge final {
+public:
+    enum class Direction { AToB, BToA };
+    // Runs on a bridge thread when the tap ring of direction has new slabs.
+    using TapCallback = std::function<void(Direction direction)>;
+
+    static constexpr std::size_t kTapSlabCount = 256;
+    static constexpr std::size_t kTapSlabSize = 4096;
+    static constexpr std::size_t kChunkBytes = 64U * 1024U;
+
+    PortBridge();
+    ~PortBridge();
+
+    PortBridge(const PortBridge&) = delete;
+    PortBridge& operator=(const PortBridge&) = delete;
+
+    // At most one endpoint may be TcpListen. Serial endpoints are opened here.
+    bool Start(const BridgeEndpoint& a, const BridgeEndpoint& b, TapCallback onTap = {});
+    void Stop();
+    // False once stopped or after a serial endpoint failed; a TCP client leaving only ends its
+    // session.
+    [[nodiscard]] bool IsRunning() const noexcept;
+    [[nodiscard]] std::uint16_t ListeningPort() const noexcept;
+    [[nodiscard]] bool ClientConnected() const noexcept;
+    [[nodiscard]] BridgeStats Stats() const;
+
+    // Consumer side of the tap for direction; one consumer thread per ring.
+    [[nodiscard]] core::SlabRing& Tap(Direction direction) noexcept;
+
+private:
+#ifdef _WIN32
+    using Handle = core::SafeHandle;
+#else
+    using Handle = core::UniqueFd;
+#endif
+
+    struct Side {
+        BridgeEndpoint endpoint;
+        Handle handle; // Serial port; on Linux also the accepted client of a TcpListen endpoint.
+#ifdef _WIN32
+        SOCKET listener = INVALID_SOCKET;
+        SOCKET client = INVALID_SOCKET;
+#else
+        Handle listener;
+#endif
+    };
+
+    void SessionMain();
+    bool RunSession();
+    bool OpenListener(Side& side);
+    bool AcceptClient(Side& side);
+    void CloseClient(Side& side);
+    bool Pump(Direction direction);
+#ifndef _WIN32
+    void TapMain(Direction direction);
+#endif
+    [[nodiscard]] Side& Source(Direction direction) noexcept;
+    [[nodiscard]] Side& Destination(Direction direction) noexcept;
+
+    std::array<Side, 2> sides_;
+    std::array<core::SlabRing, 2> taps_;
+    TapCallback onTap_;
+
+    std::thread sessionThread_;
+    Handle stopEvent_;
+    Handle sessionEvent_; // Set by the pump that ends a session, wakes the other one.
+#ifdef _WIN32
+    bool winsock_ = false;
+#else
+    std::array<std::array<Handle, 2>, 2> tapPipes_; // [direction][read end, write end]
+    std::array<std::thread, 2> tapThreads_;
+#endif
+
+    std::atomic<bool> running_;
+    std::atomic<bool> clientConnected_;
+    std::atomic<std::uint16_t> listeningPort_;
+    std::array<std::atomic<std::uint64_t>, 2> bytes_;
+    std::atomic<std::uint64_t> tapDropped_;
+    std::atomic<std::uint64_t> sessions_;
+    std::array<std::atomic<bool>, 2> copying_; // Direction fell back to read/write.
+};
+
+} // namespace serial
@@ -0,0 +1,444 @@
+#include "serial/PortBridge.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <memory>
+
+#include "core/Clock.h"
+#include "serial/ReadTiming.h"
+#include "serial/SerialDevice.h"
+
+namespace {
+
+// Enough for about a second of 3M baud in each pipe, so a slow writer does not stall the source.
+constexpr int kPipeBytes = 1 << 20;
+
+void Signal(int eventFd) {
+    const std::uint64_t one = 1;
+    [[maybe_unused]] const ssize_t ignored = ::write(eventFd, &one, sizeof(one));
+}
+
+void Clear(int eventFd) {
+    std::uint64_t value = 0;
+    [[maybe_unused]] const ssize_t ignored = ::read(eventFd, &value, sizeof(value));
+}
+
+bool MakePipe(core::UniqueFd* readEnd, core::UniqueFd* writeEnd) {
+    int fds[2] = {-1, -1};
+    if (::pipe2(fds, O_NONBLOCK | O_CLOEXEC) != 0) {
+        return false;
+    }
+    readEnd->Reset(fds[0]);
+    writeEnd->Reset(fds[1]);
+    // Best effort: unprivileged processes may grow a pipe up to /proc/sys/fs/pipe-max-size.
+    ::fcntl(fds[1], F_SETPIPE_SZ, kPipeBytes);
+    return true;
+}
+
+// A peer that closed its socket raises SIGPIPE in the writing thread; the pumps want EPIPE.
+void BlockSigpipe() {
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGPIPE);
+    ::pthread_sigmask(SIG_BLOCK, &set, nullptr);
+}
+
+} // namespace
+
+namespace serial {
+
+PortBridge::PortBridge()
+    : taps_{core::SlabRing(kTapSlabCount, kTapSlabSize), core::SlabRing(kTapSlabCount, kTapSlabSize)},
+      running_(false),
+      clientConnected_(false),
+      listeningPort_(0),
+      bytes_{},
+      tapDropped_(0),
+      sessions_(0),
+      copying_{} {}
+
+PortBridge::~PortBridge() {
+    Stop();
+}
+
+bool PortBridge::Start(const BridgeEndpoint& a, const BridgeEndpoint& b, TapCallback onTap) {
+    Stop();
+    if (a.kind == BridgeEndpointKind::TcpListen && b.kind == BridgeEndpointKind::TcpListen) {
+        return false;
+    }
+
+    sides_[0].endpoint = a;
+    sides_[1].endpoint = b;
+    for (Side& side : sides_) {
+        if (side.endpoint.kind == BridgeEndpointKind::Serial) {
+            side.handle = OpenSerialDevice(side.endpoint.portName, side.endpoint.settings, MakeReadGeometry(side.endpoint.settings).timing);
+            if (!side.handle.IsValid()) {
+                Stop();
+                return false;
+            }
+        } else if (!OpenListener(side)) {
+            Stop();
+            return false;
+        }
+    }
+
+    stopEvent_.Reset(::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK));
+    sessionEvent_.Reset(::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK));
+    if (!stopEvent_.IsValid() || !sessionEvent_.IsValid()) {
+        Stop();
+        return false;
+    }
+
+    onTap_ = std::move(onTap);
+    if (onTap_) {
+        for (auto& pipe : tapPipes_) {
+            if (!MakePipe(&pipe[0], &pipe[1])) {
+                Stop();
+                return false;
+            }
+        }
+    }
+
+    for (auto& counter : bytes_) {
+        counter.store(0);
+    }
+    for (auto& flag : copying_) {
+        flag.store(false);
+    }
+    tapDropped_.store(0);
+    sessions_.store(0);
+    running_.store(true);
+
+    if (onTap_) {
+        tapThreads_[0] = std::thread(&PortBridge::TapMain, this, Direction::AToB);
+        tapThreads_[1] = std::thread(&PortBridge::TapMain, this, Direction::BToA);
+    }
+    sessionThread_ = std::thread(&PortBridge::SessionMain, this);
+    return true;
+}
+
+void PortBridge::Stop() {
+    if (stopEvent_.IsValid()) {
+        Signal(stopEvent_.Get());
+    }
+    if (sessionThread_.joinable()) {
+        sessionThread_.join();
+    }
+    for (std::thread& thread : tapThreads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    running_.store(false);
+    clientConnected_.store(false);
+
+    for (Side& side : sides_) {
+        side.handle.Reset();
+        side.listener.Reset();
+    }
+    for (auto& pipe : tapPipes_) {
+        pipe[0].Reset();
+        pipe[1].Reset();
+    }
+    stopEvent_.Reset();
+    sessionEvent_.Reset();
+    listeningPort_.store(0);
+    onTap_ = {};
+}
+
+bool PortBridge::IsRunning() const noexcept {
+    return running_.load();
+}
+
+std::uint16_t PortBridge::ListeningPort() const noexcept {
+    return listeningPort_.load();
+}
+
+bool PortBridge::ClientConnected() const noexcept {
+    return clientConnected_.load();
+}
+
+BridgeStats PortBridge::Stats() const {
+    BridgeStats stats;
+    stats.bytesAToB = bytes_[0].load(std::memory_order_relaxed);
+    stats.bytesBToA = bytes_[1].load(std::memory_order_relaxed);
+    stats.tapDroppedBytes = tapDropped_.load(std::memory_order_relaxed);
+    stats.sessions = sessions_.load(std::memory_order_relaxed);
+    stats.zeroCopy = !copying_[0].load() && !copying_[1].load();
+    return stats;
+}
+
+core::SlabRing& PortBridge::Tap(Direction direction) noexcept {
+    return taps_[static_cast<std::size_t>(direction)];
+}
+
+PortBridge::Side& PortBridge::Source(Direction direction) noexcept {
+    return sides_[direction == Direction::AToB ? 0U : 1U];
+}
+
+PortBridge::Side& PortBridge::Destination(Direction direction) noexcept {
+    return sides_[direction == Direction::AToB ? 1U : 0U];
+}
+
+bool PortBridge::OpenListener(Side& side) {
+    core::UniqueFd listener(::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0));
+    if (!listener.IsValid()) {
+        return false;
+    }
+    const int reuse = 1;
+    ::setsockopt(listener.Get(), SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(side.endpoint.tcpPort);
+    address.sin_addr.s_addr = htonl(side.endpoint.loopbackOnly ? INADDR_LOOPBACK : INADDR_ANY);
+    socklen_t length = sizeof(address);
+    if (::bind(listener.Get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listener.Get(), 1) != 0 ||
+        ::getsockname(listener.Get(), reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        return false;
+    }
+    listeningPort_.store(ntohs(address.sin_port));
+    side.listener = std::move(listener);
+    return true;
+}
+
+bool PortBridge::AcceptClient(Side& side) {
+    pollfd waits[2] = {{stopEvent_.Get(), POLLIN, 0}, {side.listener.Get(), POLLIN, 0}};
+    for (;;) {
+        if (::poll(waits, 2, -1) < 0 && errno != EINTR) {
+            return false;
+        }
+        if ((waits[0].revents & POLLIN) != 0) {
+            return false;
+        }
+        if ((waits[1].revents & POLLIN) == 0) {
+            continue;
+        }
+        const int client = ::accept4(side.listener.Get(), nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client < 0) {
+            continue;
+        }
+        const int noDelay = 1;
+        ::setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        side.handle.Reset(client);
+        clientConnected_.store(true);
+        sessions_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+}
+
+void PortBridge::CloseClient(Side& side) {
+    side.handle.Reset();
+    clientConnected_.store(false);
+}
+
+void PortBridge::SessionMain() {
+    BlockSigpipe();
+    Side* tcp = nullptr;
+    for (Side& side : sides_) {
+        if (side.endpoint.kind == BridgeEndpointKind::TcpListen) {
+            tcp = &side;
+        }
+    }
+
+    // While no client is connected the serial side is not read, its driver buffers the data.
+    for (;;) {
+        if (tcp != nullptr && !AcceptClient(*tcp)) {
+            break;
+        }
+        const bool serialOk = RunSession();
+        if (tcp == nullptr || !serialOk) {
+            break;
+        }
+        CloseClient(*tcp);
+    }
+    running_.store(false);
+}
+
+bool PortBridge::RunSession() {
+    Clear(sessionEvent_.Get());
+    bool backOk = true;
+    std::thread back([this, &backOk] { backOk = Pump(Direction::BToA); });
+    const bool forthOk = Pump(Direction::AToB);
+    back.join();
+    return forthOk && backOk;
+}
+
+// Returns false when a serial endpoint failed; a TCP peer going away is not a failure.
+bool PortBridge::Pump(Direction direction) {
+    const std::size_t index = static_cast<std::size_t>(direction);
+    Side& source = Source(direction);
+    Side& destination = Destination(direction);
+    const int in = source.handle.Get();
+    const int out = destination.handle.Get();
+    const int tapOut = onTap_ ? tapPipes_[index][1].Get() : -1;
+
+    core::UniqueFd pipeRead;
+    core::UniqueFd pipeWrite;
+    bool zeroCopy = MakePipe(&pipeRead, &pipeWrite);
+    std::unique_ptr<uint8_t[]> buffer;
+
+    // Ends the session for both pumps; the result says whose fault it was.
+    const auto end = [this](const Side& failed) {
+        Signal(sessionEvent_.Get());
+        return failed.endpoint.kind != BridgeEndpointKind::Serial;
+    };
+    const auto fallBack = [&] {
+        zeroCopy = false;
+        copying_[index].store(true);
+        buffer = std::make_unique<uint8_t[]>(kChunkBytes);
+    };
+    // Waits for fd to become ready; false when the bridge or the session is stopping.
+    const auto wait = [this](int fd, short events) {
+        pollfd waits[3] = {{stopEvent_.Get(), POLLIN, 0}, {sessionEvent_.Get(), POLLIN, 0}, {fd, events, 0}};
+        for (;;) {
+            if (::poll(waits, 3, -1) < 0 && errno != EINTR) {
+                return false;
+            }
+            if ((waits[0].revents | waits[1].revents) != 0) {
+                return false;
+            }
+            if (waits[2].revents != 0) {
+                return true;
+            }
+        }
+    };
+    // Copy path: write everything in data to out.
+    const auto writeAll = [&](const uint8_t* data, std::size_t size) {
+        while (size > 0) {
+            const ssize_t written = ::write(out, data, size);
+            if (written < 0 && (errno == EAGAIN || errno == EINTR)) {
+                if (!wait(out, POLLOUT)) {
+                    return false;
+                }
+                continue;
+            }
+            if (written <= 0) {
+                return false;
+            }
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+        return true;
+    };
+
+    if (!zeroCopy) {
+        fallBack();
+    }
+
+    for (;;) {
+        if (!wait(in, POLLIN)) {
+            return true;
+        }
+
+        if (!zeroCopy) {
+            const ssize_t size = ::read(in, buffer.get(), kChunkBytes);
+            if (size < 0 && (errno == EAGAIN || errno == EINTR)) {
+                continue;
+            }
+            if (size <= 0) {
+                return end(source);
+            }
+            if (tapOut >= 0) {
+                const ssize_t tapped = ::write(tapOut, buffer.get(), static_cast<std::size_t>(size));
+                tapDropped_.fetch_add(static_cast<std::uint64_t>(size - std::max<ssize_t>(tapped, 0)), std::memory_order_relaxed);
+            }
+            if (!writeAll(buffer.get(), static_cast<std::size_t>(size))) {
+                return end(destination);
+            }
+            bytes_[index].fetch_add(static_cast<std::uint64_t>(size), std::memory_order_relaxed);
+            continue;
+        }
+
+        const ssize_t size = ::splice(in, nullptr, pipeWrite.Get(), nullptr, kChunkBytes, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (size < 0 && (errno == EAGAIN || errno == EINTR)) {
+            continue;
+        }
+        if (size < 0 && errno == EINVAL) {
+            fallBack(); // The source driver cannot splice; nothing was consumed.
+            continue;
+        }
+        if (size <= 0) {
+            return end(source);
+        }
+
+        // tee() duplicates the pipe pages for the tap without consuming them.
+        if (tapOut >= 0) {
+            const ssize_t tapped = ::tee(pipeRead.Get(), tapOut, static_cast<std::size_t>(size), SPLICE_F_NONBLOCK);
+            tapDropped_.fetch_add(static_cast<std::uint64_t>(size - std::max<ssize_t>(tapped, 0)), std::memory_order_relaxed);
+        }
+
+        std::size_t left = static_cast<std::size_t>(size);
+        while (left > 0) {
+            const ssize_t moved = zeroCopy ? ::splice(pipeRead.Get(), nullptr, out, nullptr, left, SPLICE_F_MOVE | SPLICE_F_NONBLOCK) : -1;
+            if (moved > 0) {
+                left -= static_cast<std::size_t>(moved);
+                continue;
+            }
+            if (zeroCopy && moved < 0 && (errno == EAGAIN || errno == EINTR)) {
+                if (!wait(out, POLLOUT)) {
+                    return true;
+                }
+                continue;
+            }
+            if (zeroCopy && moved < 0 && errno == EINVAL) {
+                fallBack(); // The destination cannot splice: drain the pipe by copying.
+            }
+            if (zeroCopy) {
+                return end(destination);
+            }
+            const ssize_t chunk = ::read(pipeRead.Get(), buffer.get(), std::min(left, kChunkBytes));
+            if (chunk <= 0 || !writeAll(buffer.get(), static_cast<std::size_t>(chunk))) {
+                return end(destination);
+            }
+            left -= static_cast<std::size_t>(chunk);
+        }
+        bytes_[index].fetch_add(static_cast<std::uint64_t>(size), std::memory_order_relaxed);
+    }
+}
+
+void PortBridge::TapMain(Direction direction) {
+    const std::size_t index = static_cast<std::size_t>(direction);
+    core::SlabRing& ring = taps_[index];
+    pollfd waits[2] = {{stopEvent_.Get(), POLLIN, 0}, {tapPipes_[index][0].Get(), POLLIN, 0}};
+
+    for (;;) {
+        if (::poll(waits, 2, -1) < 0 && errno != EINTR) {
+            return;
+        }
+        if ((waits[0].revents & POLLIN) != 0) {
+            return;
+        }
+        if ((waits[1].revents & POLLIN) == 0) {
+            continue;
+        }
+
+        // A full ring leaves the data in the pipe; once that fills up too, tee() drops.
+        const std::span<uint8_t> slab = ring.AcquireWrite();
+        if (slab.empty()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        const ssize_t size = ::read(tapPipes_[index][0].Get(), slab.data(), slab.size());
+        if (size <= 0) {
+            continue;
+        }
+        ring.CommitWrite(static_cast<std::size_t>(size), core::MonotonicNanos());
+        onTap_(direction);
+    }
+}
+
+} // namespace serial
@@ -0,0 +1,401 @@
+#include "serial/PortReactor.h"
+
+#include <array>
+
+#include "core/Clock.h"
+#include "serial/ReadTiming.h"
+#include "serial/SerialDevice.h"
+#include "serial/SerialPort.h"
+
+namespace {
+
+// Completion keys: kWakeKey packets carry commands, kIoKey packets carry a Session::Op.
+constexpr ULONG_PTR kWakeKey = 0;
+constexpr ULONG_PTR kIoKey = 1;
+constexpr ULONG kMaxEntriesPerWait = 64;
+
+} // namespace
+
+namespace serial {
+
+struct PortReactor::Session {
+    // OVERLAPPED comes first, so the pointer IOCP hands back can be cast to its Op.
+    struct Op {
+        OVERLAPPED overlapped;
+        Session* owner;
+        bool write;
+        std::size_t slot;
+    };
+
+    PortId id = kInvalidPort;
+    core::SafeHandle handle;
+    ReadGeometry geometry{};
+
+    std::vector<Op> reads;
+    std::unique_ptr<uint8_t[]> buffers;
+
+    Op writeOp{};
+    TxQueue txQueue{SerialPort::kMaxTxQueuedBytes, SerialPort::kMaxTxBatchBytes};
+    TxBatch batch;
+    bool writePending = false;
+
+    // The session is released only once the kernel has returned every posted Op.
+    std::size_t outstanding = 0;
+    bool closing = false;
+    bool failed = false;
+    std::atomic<bool> writeQueued{false};
+};
+
+PortReactor::PortReactor() : running_(false), nextId_(1) {}
+
+PortReactor::~PortReactor() {
+    Stop();
+}
+
+bool PortReactor::Start(ChunkCallback onChunk, ClosedCallback onClosed) {
+    Stop();
+
+    HANDLE rawPort = ::CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+    if (rawPort == nullptr) {
+        return false;
+    }
+    completionPort_.Reset(rawPort);
+
+    onChunk_ = std::move(onChunk);
+    onClosed_ = std::move(onClosed);
+    running_.store(true);
+    HANDLE rawThread = ::CreateThread(nullptr, 0, &PortReactor::ThreadProc, this, 0, nullptr);
+    if (rawThread == nullptr) {
+        Stop();
+        return false;
+    }
+    threadHandle_.Reset(rawThread);
+    return true;
+}
+
+void PortReactor::Stop() {
+    if (running_.exchange(false)) {
+        Wake();
+    }
+    // No timeout: the thread returns once every OVERLAPPED is back, freeing them earlier would
+    // let the driver write into released memory.
+    if (threadHandle_.IsValid()) {
+        ::WaitForSingleObject(threadHandle_.Get(), INFINITE);
+    }
+    threadHandle_.Reset();
+
+    std::unordered_map<PortId, std::shared_ptr<Session>> sessions;
+    std::vector<std::pair<Command, std::shared_ptr<Session>>> commands;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sessions.swap(sessions_);
+        commands.swap(commands_);
+    }
+    for (auto& [command, session] : commands) {
+        session->txQueue.CloseAndFail();
+    }
+    active_.clear();
+
+    completionPort_.Reset();
+}
+
+bool PortReactor::IsRunning() const noexcept {
+    return running_.load();
+}
+
+PortReactor::PortId PortReactor::AddPort(const std::wstring& portName, const PortSettings& settings) {
+    if (!running_.load()) {
+        return kInvalidPort;
+    }
+
+    auto session = std::make_shared<Session>();
+    session->geometry = MakeReadGeometry(settings);
+    session->handle = OpenSerialDevice(portName, settings, session->geometry.timing);
+    if (!session->handle.IsValid()) {
+        return kInvalidPort;
+    }
+
+    const ReadGeometry& geometry = session->geometry;
+    session->buffers = std::make_unique<uint8_t[]>(static_cast<std::size_t>(geometry.depth) * geometry.bufferSize);
+    session->reads.resize(geometry.depth);
+    for (std::size_t i = 0; i < session->reads.size(); ++i) {
+        session->reads[i] = Session::Op{OVERLAPPED{}, session.get(), false, i};
+    }
+    session->writeOp = Session::Op{OVERLAPPED{}, session.get(), true, 0};
+    session->txQueue.Open();
+
+    PortId id = kInvalidPort;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = nextId_++;
+        if (nextId_ == kInvalidPort) {
+            nextId_ = 1;
+        }
+        session->id = id;
+        sessions_[id] = session;
+        commands_.emplace_back(Command::Add, std::move(session));
+    }
+    Wake();
+    return id;
+}
+
+bool PortReactor::RemovePort(PortId port) {
+    std::shared_ptr<Session> session;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = sessions_.find(port);
+        if (it == sessions_.end()) {
+            return false;
+        }
+        session = std::move(it->second);
+        sessions_.erase(it);
+    }
+    Post(Command::Remove, std::move(session));
+    return true;
+}
+
+bool PortReactor::WriteAsync(PortId port, const uint8_t* data, DWORD size, WriteCallback done) {
+    std::shared_ptr<Session> session;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = sessions_.find(port);
+        if (it == sessions_.end()) {
+            return false;
+        }
+        session = it->second;
+    }
+
+    if (!session->txQueue.Push(data, size, std::move(done))) {
+        return false;
+    }
+    // One pending Write command per port is enough, the reactor drains the whole queue.
+    if (!session->writeQueued.exchange(true)) {
+        Post(Command::Write, std::move(session));
+    }
+    return true;
+}
+
+std::size_t PortReactor::PortCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sessions_.size();
+}
+
+void PortReactor::Post(Command command, std::shared_ptr<Session> session) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        commands_.emplace_back(command, std::move(session));
+    }
+    Wake();
+}
+
+void PortReactor::Wake() {
+    if (completionPort_.IsValid()) {
+        ::PostQueuedCompletionStatus(completionPort_.Get(), 0, kWakeKey, nullptr);
+    }
+}
+
+DWORD WINAPI PortReactor::ThreadProc(LPVOID param) {
+    PortReactor* self = static_cast<PortReactor*>(param);
+    self->ThreadMain();
+    return 0;
+}
+
+void PortReactor::ThreadMain() {
+    std::array<OVERLAPPED_ENTRY, kMaxEntriesPerWait> entries{};
+    const auto reap = [this, &entries] {
+        ULONG count = 0;
+        if (!::GetQueuedCompletionStatusEx(
+                completionPort_.Get(), entries.data(), static_cast<ULONG>(entries.size()), &count, INFINITE, FALSE)) {
+            return false;
+        }
+        for (ULONG i = 0; i < count; ++i) {
+            if (entries[i].lpCompletionKey == kIoKey && entries[i].lpOverlapped != nullptr) {
+                auto* op = reinterpret_cast<Session::Op*>(entries[i].lpOverlapped);
+                Complete(*op->owner, entries[i].lpOverlapped);
+            }
+        }
+        return true;
+    };
+
+    while (running_.load() && reap()) {
+        ProcessCommands();
+    }
+
+    // Cancel everything still posted and wait until the kernel has handed back each OVERLAPPED.
+    std::vector<std::shared_ptr<Session>> remaining;
+    for (const auto& [id, session] : active_) {
+        remaining.push_back(session);
+    }
+    for (const auto& session : remaining) {
+        Detach(*session, false);
+    }
+    while (!active_.empty()) {
+        if (!reap()) {
+            break;
+        }
+    }
+}
+
+void PortReactor::ProcessCommands() {
+    std::vector<std::pair<Command, std::shared_ptr<Session>>> commands;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        commands.swap(commands_);
+    }
+
+    for (auto& [command, session] : commands) {
+        const auto it = active_.find(session->id);
+        const bool attached = (it != active_.end() && it->second == session);
+
+        switch (command) {
+        case Command::Add:
+            Attach(session);
+            break;
+        case Command::Remove:
+            if (attached) {
+                Detach(*session, false);
+            } else {
+                session->txQueue.CloseAndFail();
+            }
+            break;
+        case Command::Write:
+            session->writeQueued.store(false);
+            if (attached) {
+                FlushWrites(*session);
+            }
+            break;
+        }
+    }
+}
+
+void PortReactor::Attach(const std::shared_ptr<Session>& session) {
+    if (::CreateIoCompletionPort(session->handle.Get(), completionPort_.Get(), kIoKey, 0) == nullptr) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sessions_.erase(session->id);
+        }
+        session->txQueue.CloseAndFail();
+        if (onClosed_) {
+            onClosed_(session->id);
+        }
+        return;
+    }
+
+    active_[session->id] = session;
+    for (std::size_t slot = 0; slot < session->reads.size(); ++slot) {
+        if (!PostRead(*session, slot)) {
+            Detach(*session, true);
+            return;
+        }
+    }
+}
+
+void PortReactor::Detach(Session& session, bool failed) {
+    if (session.closing) {
+        return;
+    }
+
+    session.closing = true;
+    session.failed = failed;
+    session.txQueue.CloseAndFail();
+    ::CancelIoEx(session.handle.Get(), nullptr);
+
+    if (session.outstanding == 0) {
+        Release(session);
+    }
+}
+
+void PortReactor::Release(Session& session) {
+    const PortId id = session.id;
+    if (session.failed) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sessions_.erase(id);
+        }
+        if (onClosed_) {
+            onClosed_(id);
+        }
+    }
+    // May release the session, so it goes last.
+    active_.erase(id);
+}
+
+void PortReactor::Complete(Session& session, OVERLAPPED* overlapped) {
+    const auto* op = reinterpret_cast<const Session::Op*>(overlapped);
+    --session.outstanding;
+
+    DWORD transferred = 0;
+    const BOOL ok = ::GetOverlappedResult(session.handle.Get(), overlapped, &transferred, FALSE);
+    const std::int64_t timestamp = core::MonotonicNanos();
+
+    if (op->write) {
+        TxQueue::Complete(session.batch, ok == TRUE, transferred);
+        session.writePending = false;
+        FlushWrites(session);
+    } else if (!session.closing) {
+        if (!ok) {
+            Detach(session, true);
+            return;
+        }
+        if (transferred > 0) {
+            const std::size_t offset = op->slot * session.geometry.bufferSize;
+            Deliver(session, session.buffers.get() + offset, transferred, timestamp);
+        }
+        if (!PostRead(session, op->slot)) {
+            Detach(session, true);
+            return;
+        }
+    }
+
+    if (session.closing && session.outstanding == 0) {
+        Release(session);
+    }
+}
+
+bool PortReactor::PostRead(Session& session, std::size_t slot) {
+    Session::Op& op = session.reads[slot];
+    op.overlapped = OVERLAPPED{};
+
+    const ReadGeometry& geometry = session.geometry;
+    const DWORD size = (geometry.timing.gapMs == 0) ? geometry.bufferSize : geometry.timing.minChunkBytes;
+    uint8_t* buffer = session.buffers.get() + slot * geometry.bufferSize;
+
+    // Synchronous completion still queues a packet, so every read is reaped in Complete().
+    if (!::ReadFile(session.handle.Get(), buffer, size, nullptr, &op.overlapped) &&
+        ::GetLastError() != ERROR_IO_PENDING) {
+        return false;
+    }
+    ++session.outstanding;
+    return true;
+}
+
+void PortReactor::FlushWrites(Session& session) {
+    // One batch per port in flight: the driver transmits a port's writes one after another anyway.
+    while (!session.writePending && !session.closing) {
+        if (!session.txQueue.PopBatch(&session.batch)) {
+            return;
+        }
+
+        session.writeOp.overlapped = OVERLAPPED{};
+        if (!::WriteFile(
+                session.handle.Get(),
+                session.batch.data.data(),
+                static_cast<DWORD>(session.batch.data.size()),
+                nullptr,
+                &session.writeOp.overlapped) &&
+            ::GetLastError() != ERROR_IO_PENDING) {
+            TxQueue::Complete(session.batch, false, 0);
+            continue;
+        }
+        session.writePending = true;
+        ++session.outstanding;
+    }
+}
+
+void PortReactor::Deliver(Session& session, const uint8_t* data, std::size_t size, std::int64_t timestampNs) {
+    if (onChunk_) {
+        onChunk_(session.id, std::span<const uint8_t>(data, size), timestampNs);
+    }
+}
+
+} // namespace serial
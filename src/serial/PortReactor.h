@@ -0,0 +1,110 @@
+#pragma once
+
+#include "core/Platform.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "serial/PortSettings.h"
+#include "serial/TxQueue.h"
+
+#ifdef _WIN32
+#include "core/SafeHandle.h"
+#else
+#include "core/UniqueFd.h"
+#endif
+
+namespace serial {
+
+// Serves many open ports from one I/O thread (IOCP on Windows, epoll elsewhere) instead of the
+// two threads per port that SerialPort uses. Every chunk reaches one shared callback tagged with
+// the id AddPort() returned.
+class PortReactor final {
+public:
+    using PortId = std::uint32_t;
+    // timestampNs is core::MonotonicNanos() taken when the chunk was completed, as in SerialPort.
+    using ChunkCallback = std::function<void(PortId port, std::span<const uint8_t> data, std::int64_t timestampNs)>;
+    // Called on the reactor thread when a port fails (unplugged, pty closed) and is dropped.
+    using ClosedCallback = std::function<void(PortId port)>;
+
+    static constexpr PortId kInvalidPort = 0;
+
+    PortReactor();
+    ~PortReactor();
+
+    PortReactor(const PortReactor&) = delete;
+    PortReactor& operator=(const PortReactor&) = delete;
+
+    bool Start(ChunkCallback onChunk, ClosedCallback onClosed = {});
+    void Stop();
+    [[nodiscard]] bool IsRunning() const noexcept;
+
+    // Opens and configures the port on the calling thread, then hands it to the reactor.
+    // Returns kInvalidPort if the reactor is stopped or the port cannot be opened.
+    PortId AddPort(const std::wstring& portName, const PortSettings& settings);
+    // Pending writes fail; chunks already read may still be delivered before the port is released.
+    bool RemovePort(PortId port);
+    bool WriteAsync(PortId port, const uint8_t* data, DWORD size, WriteCallback done = {});
+
+    [[nodiscard]] std::size_t PortCount() const;
+
+private:
+    struct Session;
+
+    enum class Command {
+        Add,
+        Remove,
+        Write
+    };
+
+    void Post(Command command, std::shared_ptr<Session> session);
+    void Wake();
+    void ThreadMain();
+    void ProcessCommands();
+    void Attach(const std::shared_ptr<Session>& session);
+    void Detach(Session& session, bool failed);
+    void FlushWrites(Session& session);
+    void Deliver(Session& session, const uint8_t* data, std::size_t size, std::int64_t timestampNs);
+
+#ifdef _WIN32
+    static DWORD WINAPI ThreadProc(LPVOID param);
+    void Complete(Session& session, OVERLAPPED* overlapped);
+    bool PostRead(Session& session, std::size_t slot);
+    void Release(Session& session);
+
+    core::SafeHandle completionPort_;
+    core::SafeHandle threadHandle_;
+#else
+    bool ReadReady(Session& session);
+    int NextFlushTimeout() const;
+    void FlushExpired();
+    void WatchOutput(Session& session, bool enabled);
+
+    core::UniqueFd epoll_;
+    core::UniqueFd wakeEvent_;
+    std::thread thread_;
+#endif
+    ChunkCallback onChunk_;
+    ClosedCallback onClosed_;
+    std::atomic<bool> running_;
+
+    // Caller-side view, used by WriteAsync/RemovePort from any thread.
+    mutable std::mutex mutex_;
+    std::unordered_map<PortId, std::shared_ptr<Session>> sessions_;
+    std::vector<std::pair<Command, std::shared_ptr<Session>>> commands_;
+    PortId nextId_;
+
+    // Reactor-side view, touched only by the reactor thread.
+    std::unordered_map<PortId, std::shared_ptr<Session>> active_;
+};
+
+} // namespace serial
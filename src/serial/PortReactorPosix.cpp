@@ -0,0 +1,428 @@
+#include "serial/PortReactor.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <system_error>
+
+#include "core/Clock.h"
+#include "serial/ReadTiming.h"
+#include "serial/SerialDevice.h"
+#include "serial/SerialPort.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kMaxEventsPerWait = 64;
+
+} // namespace
+
+namespace serial {
+
+struct PortReactor::Session {
+    PortId id = kInvalidPort;
+    core::UniqueFd fd;
+    ReadGeometry geometry{};
+
+    // Reads accumulate here until geometry.timing says the chunk is complete.
+    std::unique_ptr<uint8_t[]> buffer;
+    std::size_t capacity = 0;
+    std::size_t filled = 0;
+    Clock::time_point flushAt{};
+
+    TxQueue txQueue{SerialPort::kMaxTxQueuedBytes, SerialPort::kMaxTxBatchBytes};
+    TxBatch batch;
+    std::size_t batchOffset = 0;
+    bool batchPending = false;
+    bool watchingOutput = false;
+    std::atomic<bool> writeQueued{false};
+};
+
+PortReactor::PortReactor() : running_(false), nextId_(1) {}
+
+PortReactor::~PortReactor() {
+    Stop();
+}
+
+bool PortReactor::Start(ChunkCallback onChunk, ClosedCallback onClosed) {
+    Stop();
+
+    epoll_.Reset(::epoll_create1(EPOLL_CLOEXEC));
+    wakeEvent_.Reset(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+    if (!epoll_.IsValid() || !wakeEvent_.IsValid()) {
+        Stop();
+        return false;
+    }
+
+    // The wake event is the only registration without a session pointer.
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
+    if (::epoll_ctl(epoll_.Get(), EPOLL_CTL_ADD, wakeEvent_.Get(), &event) != 0) {
+        Stop();
+        return false;
+    }
+
+    onChunk_ = std::move(onChunk);
+    onClosed_ = std::move(onClosed);
+    running_.store(true);
+    try {
+        thread_ = std::thread(&PortReactor::ThreadMain, this);
+    } catch (const std::system_error&) {
+        Stop();
+        return false;
+    }
+    return true;
+}
+
+void PortReactor::Stop() {
+    if (running_.exchange(false)) {
+        Wake();
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    std::unordered_map<PortId, std::shared_ptr<Session>> sessions;
+    std::vector<std::pair<Command, std::shared_ptr<Session>>> commands;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sessions.swap(sessions_);
+        commands.swap(commands_);
+    }
+
+    for (auto& [id, session] : active_) {
+        if (session->batchPending) {
+            TxQueue::Complete(session->batch, false, session->batchOffset);
+            session->batchPending = false;
+        }
+        session->txQueue.CloseAndFail();
+    }
+    for (auto& [command, session] : commands) {
+        session->txQueue.CloseAndFail();
+    }
+    active_.clear();
+
+    epoll_.Reset();
+    wakeEvent_.Reset();
+}
+
+bool PortReactor::IsRunning() const noexcept {
+    return running_.load();
+}
+
+PortReactor::PortId PortReactor::AddPort(const std::wstring& portName, const PortSettings& settings) {
+    if (!running_.load()) {
+        return kInvalidPort;
+    }
+
+    auto session = std::make_shared<Session>();
+    session->geometry = MakeReadGeometry(settings);
+    session->fd = OpenSerialDevice(portName, settings, session->geometry.timing);
+    if (!session->fd.IsValid()) {
+        return kInvalidPort;
+    }
+    session->capacity = static_cast<std::size_t>(session->geometry.depth) * session->geometry.bufferSize;
+    session->buffer = std::make_unique<uint8_t[]>(session->capacity);
+    session->txQueue.Open();
+
+    PortId id = kInvalidPort;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = nextId_++;
+        if (nextId_ == kInvalidPort) {
+            nextId_ = 1;
+        }
+        session->id = id;
+        sessions_[id] = session;
+        commands_.emplace_back(Command::Add, std::move(session));
+    }
+    Wake();
+    return id;
+}
+
+bool PortReactor::RemovePort(PortId port) {
+    std::shared_ptr<Session> session;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = sessions_.find(port);
+        if (it == sessions_.end()) {
+            return false;
+        }
+        session = std::move(it->second);
+        sessions_.erase(it);
+    }
+    Post(Command::Remove, std::move(session));
+    return true;
+}
+
+bool PortReactor::WriteAsync(PortId port, const uint8_t* data, DWORD size, WriteCallback done) {
+    std::shared_ptr<Session> session;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = sessions_.find(port);
+        if (it == sessions_.end()) {
+            return false;
+        }
+        session = it->second;
+    }
+
+    if (!session->txQueue.Push(data, size, std::move(done))) {
+        return false;
+    }
+    // One pending Write command per port is enough, the reactor drains the whole queue.
+    if (!session->writeQueued.exchange(true)) {
+        Post(Command::Write, std::move(session));
+    }
+    return true;
+}
+
+std::size_t PortReactor::PortCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sessions_.size();
+}
+
+void PortReactor::Post(Command command, std::shared_ptr<Session> session) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        commands_.emplace_back(command, std::move(session));
+    }
+    Wake();
+}
+
+void PortReactor::Wake() {
+    if (wakeEvent_.IsValid()) {
+        const std::uint64_t one = 1;
+        [[maybe_unused]] const ssize_t ignored = ::write(wakeEvent_.Get(), &one, sizeof(one));
+    }
+}
+
+void PortReactor::ThreadMain() {
+    std::array<epoll_event, kMaxEventsPerWait> events{};
+
+    while (running_.load()) {
+        const int ready = ::epoll_wait(epoll_.Get(), events.data(), static_cast<int>(events.size()), NextFlushTimeout());
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        // Level-triggered: each ready port gets one read per pass, so a busy port cannot starve the rest.
+        for (int i = 0; i < ready; ++i) {
+            auto* session = static_cast<Session*>(events[i].data.ptr);
+            if (session == nullptr) {
+                std::uint64_t value = 0;
+                [[maybe_unused]] const ssize_t ignored = ::read(wakeEvent_.Get(), &value, sizeof(value));
+                continue;
+            }
+
+            const std::uint32_t flags = events[i].events;
+            if ((flags & EPOLLIN) != 0) {
+                if (!ReadReady(*session)) {
+                    continue;
+                }
+            } else if ((flags & (EPOLLERR | EPOLLHUP)) != 0) {
+                Detach(*session, true);
+                continue;
+            }
+            if ((flags & EPOLLOUT) != 0) {
+                FlushWrites(*session);
+            }
+        }
+
+        ProcessCommands();
+        FlushExpired();
+    }
+}
+
+void PortReactor::ProcessCommands() {
+    std::vector<std::pair<Command, std::shared_ptr<Session>>> commands;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        commands.swap(commands_);
+    }
+
+    for (auto& [command, session] : commands) {
+        const auto it = active_.find(session->id);
+        const bool attached = (it != active_.end() && it->second == session);
+
+        switch (command) {
+        case Command::Add:
+            Attach(session);
+            break;
+        case Command::Remove:
+            if (attached) {
+                Detach(*session, false);
+            } else {
+                session->txQueue.CloseAndFail();
+            }
+            break;
+        case Command::Write:
+            session->writeQueued.store(false);
+            if (attached) {
+                FlushWrites(*session);
+            }
+            break;
+        }
+    }
+}
+
+void PortReactor::Attach(const std::shared_ptr<Session>& session) {
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = session.get();
+    if (::epoll_ctl(epoll_.Get(), EPOLL_CTL_ADD, session->fd.Get(), &event) != 0) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sessions_.erase(session->id);
+        }
+        session->txQueue.CloseAndFail();
+        if (onClosed_) {
+            onClosed_(session->id);
+        }
+        return;
+    }
+    active_[session->id] = session;
+}
+
+void PortReactor::Detach(Session& session, bool failed) {
+    const PortId id = session.id;
+    ::epoll_ctl(epoll_.Get(), EPOLL_CTL_DEL, session.fd.Get(), nullptr);
+
+    if (session.filled != 0) {
+        Deliver(session, session.buffer.get(), session.filled, core::MonotonicNanos());
+        session.filled = 0;
+    }
+    if (session.batchPending) {
+        TxQueue::Complete(session.batch, false, session.batchOffset);
+        session.batchPending = false;
+    }
+    session.txQueue.CloseAndFail();
+
+    if (failed) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sessions_.erase(id);
+        }
+        if (onClosed_) {
+            onClosed_(id);
+        }
+    }
+    // May release the session, so it goes last.
+    active_.erase(id);
+}
+
+bool PortReactor::ReadReady(Session& session) {
+    const ssize_t readBytes = ::read(
+        session.fd.Get(), session.buffer.get() + session.filled, session.capacity - session.filled);
+    if (readBytes > 0) {
+        session.filled += static_cast<std::size_t>(readBytes);
+        const ReadTiming& timing = session.geometry.timing;
+        if (session.filled >= timing.minChunkBytes || session.filled == session.capacity) {
+            Deliver(session, session.buffer.get(), session.filled, core::MonotonicNanos());
+            session.filled = 0;
+        } else {
+            session.flushAt = Clock::now() + std::chrono::milliseconds(timing.gapMs);
+        }
+        return true;
+    }
+    if (readBytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        return true;
+    }
+
+    Detach(session, true);
+    return false;
+}
+
+void PortReactor::FlushWrites(Session& session) {
+    for (;;) {
+        if (!session.batchPending) {
+            if (!session.txQueue.PopBatch(&session.batch)) {
+                WatchOutput(session, false);
+                return;
+            }
+            session.batchPending = true;
+            session.batchOffset = 0;
+        }
+
+        const std::size_t size = session.batch.data.size();
+        const ssize_t written = ::write(
+            session.fd.Get(), session.batch.data.data() + session.batchOffset, size - session.batchOffset);
+        if (written > 0) {
+            session.batchOffset += static_cast<std::size_t>(written);
+            if (session.batchOffset == size) {
+                TxQueue::Complete(session.batch, true, size);
+                session.batchPending = false;
+            }
+            continue;
+        }
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            WatchOutput(session, true);
+            return;
+        }
+
+        TxQueue::Complete(session.batch, false, session.batchOffset);
+        session.batchPending = false;
+    }
+}
+
+void PortReactor::Deliver(Session& session, const uint8_t* data, std::size_t size, std::int64_t timestampNs) {
+    if (!onChunk_) {
+        return;
+    }
+
+    const std::size_t piece = session.geometry.bufferSize;
+    for (std::size_t offset = 0; offset < size; offset += piece) {
+        onChunk_(session.id, std::span<const uint8_t>(data + offset, std::min(size - offset, piece)), timestampNs);
+    }
+}
+
+int PortReactor::NextFlushTimeout() const {
+    int timeout = -1;
+    const auto now = Clock::now();
+    for (const auto& [id, session] : active_) {
+        if (session->filled == 0) {
+            continue;
+        }
+        const auto left = std::chrono::ceil<std::chrono::milliseconds>(session->flushAt - now).count();
+        const int ms = static_cast<int>(std::max<decltype(left)>(left, 0));
+        timeout = (timeout < 0) ? ms : std::min(timeout, ms);
+    }
+    return timeout;
+}
+
+void PortReactor::FlushExpired() {
+    const auto now = Clock::now();
+    for (const auto& [id, session] : active_) {
+        if (session->filled != 0 && session->flushAt <= now) {
+            Deliver(*session, session->buffer.get(), session->filled, core::MonotonicNanos());
+            session->filled = 0;
+        }
+    }
+}
+
+void PortReactor::WatchOutput(Session& session, bool enabled) {
+    if (session.watchingOutput == enabled) {
+        return;
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN | (enabled ? EPOLLOUT : 0U);
+    event.data.ptr = &session;
+    if (::epoll_ctl(epoll_.Get(), EPOLL_CTL_MOD, session.fd.Get(), &event) == 0) {
+        session.watchingOutput = enabled;
+    }
+}
+
+} // namespace serial
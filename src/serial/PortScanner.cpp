@@ -2,11 +2,12 @@
 
 #include <windows.h>
 #include <setupapi.h>
+#include <cfgmgr32.h>
 #include <devguid.h>
 
-#include <algorithm>
+#include <cwchar>
+#include <cwctype>
 #include <set>
-#include <regex>
 
 namespace {
 
@@ -14,15 +15,37 @@ constexpr GUID kGuidDevinterfaceComport = {
     0x86E0D1E0, 0x8089, 0x11D0, {0x9C, 0xE4, 0x08, 0x00, 0x3E, 0x30, 0x1F, 0x73}
 };
 
-std::wstring ExtractComName(const std::wstring& friendlyName) {
-    const std::wregex pattern(LR"((COM\d+))", std::regex_constants::icase);
-    std::wsmatch match;
-    if (std::regex_search(friendlyName, match, pattern) && match.size() > 1) {
-        return match[1].str();
+// Returns "COM<n>" for the first case-insensitive "COM" followed by digits, or an empty string.
+std::wstring ExtractComName(const std::wstring& text) {
+    for (std::size_t i = 0; i + 3 < text.size(); ++i) {
+        if (std::towupper(text[i]) != L'C' || std::towupper(text[i + 1]) != L'O' ||
+            std::towupper(text[i + 2]) != L'M') {
+            continue;
+        }
+        std::size_t end = i + 3;
+        while (end < text.size() && text[end] >= L'0' && text[end] <= L'9') {
+            ++end;
+        }
+        if (end > i + 3) {
+            return L"COM" + text.substr(i + 3, end - i - 3);
+        }
     }
     return L"";
 }
 
+bool IsComName(const wchar_t* name) {
+    if (std::towupper(name[0]) != L'C' || std::towupper(name[1]) != L'O' || std::towupper(name[2]) != L'M' ||
+        name[3] == L'\0') {
+        return false;
+    }
+    for (const wchar_t* digit = name + 3; *digit != L'\0'; ++digit) {
+        if (*digit < L'0' || *digit > L'9') {
+            return false;
+        }
+    }
+    return true;
+}
+
 std::wstring ReadFriendlyName(HDEVINFO deviceInfoSet, SP_DEVINFO_DATA* deviceData) {
     DWORD dataType = 0;
     DWORD requiredSize = 0;
@@ -59,13 +82,24 @@ std::wstring ReadFriendlyName(HDEVINFO deviceInfoSet, SP_DEVINFO_DATA* deviceDat
     return value;
 }
 
-void EnumerateByPortsClass(std::vector<serial::PortInfo>* ports) {
-    const HDEVINFO infoSet = ::SetupDiGetClassDevsW(
-        &GUID_DEVCLASS_PORTS,
-        nullptr,
-        nullptr,
-        DIGCF_PRESENT);
+std::wstring ReadInstanceId(HDEVINFO deviceInfoSet, SP_DEVINFO_DATA* deviceData) {
+    wchar_t buffer[MAX_DEVICE_ID_LEN] = {};
+    if (!::SetupDiGetDeviceInstanceIdW(deviceInfoSet, deviceData, buffer, _countof(buffer), nullptr)) {
+        return L"";
+    }
+    return buffer;
+}
 
+// Walks one SetupAPI device set. The instance ID is cheap to read; the friendly name is a registry
+// lookup and is only done for instances the cache has not seen yet, or whose cached COM name is no
+// longer a DOS device (the port was renumbered).
+void EnumerateDeviceSet(
+    const GUID& guid,
+    DWORD flags,
+    const std::unordered_map<std::wstring, serial::PortInfo>& known,
+    const std::set<std::wstring>& dosNames,
+    std::vector<serial::PortInfo>* ports) {
+    const HDEVINFO infoSet = ::SetupDiGetClassDevsW(&guid, nullptr, nullptr, flags);
     if (infoSet == INVALID_HANDLE_VALUE) {
         return;
     }
@@ -75,53 +109,44 @@ void EnumerateByPortsClass(std::vector<serial::PortInfo>* ports) {
     deviceData.cbSize = sizeof(deviceData);
 
     while (::SetupDiEnumDeviceInfo(infoSet, index, &deviceData) == TRUE) {
+        ++index;
+        const std::wstring instanceId = ReadInstanceId(infoSet, &deviceData);
+        const auto cached = known.find(instanceId);
+        if (!instanceId.empty() && cached != known.end() && dosNames.count(cached->second.portName) != 0) {
+            ports->push_back(cached->second);
+            continue;
+        }
+
         const std::wstring friendly = ReadFriendlyName(infoSet, &deviceData);
         const std::wstring portName = ExtractComName(friendly);
         if (!portName.empty()) {
-            ports->push_back(serial::PortInfo{portName, friendly});
+            ports->push_back(serial::PortInfo{portName, friendly, instanceId.empty() ? portName : instanceId});
         }
-        ++index;
     }
 
     ::SetupDiDestroyDeviceInfoList(infoSet);
 }
 
-void EnumerateByInterfaceGuid(std::vector<serial::PortInfo>* ports) {
-    const HDEVINFO infoSet = ::SetupDiGetClassDevsW(
-        &kGuidDevinterfaceComport,
-        nullptr,
-        nullptr,
-        DIGCF_PRESENT | DIGCF_DEVICEINTERFACE);
-
-    if (infoSet == INVALID_HANDLE_VALUE) {
-        return;
-    }
-
-    DWORD index = 0;
-    SP_DEVINFO_DATA deviceData{};
-    deviceData.cbSize = sizeof(deviceData);
-
-    while (::SetupDiEnumDeviceInfo(infoSet, index, &deviceData) == TRUE) {
-        const std::wstring friendly = ReadFriendlyName(infoSet, &deviceData);
-        const std::wstring portName = ExtractComName(friendly);
-        if (!portName.empty()) {
-            ports->push_back(serial::PortInfo{portName, friendly});
+// One QueryDosDeviceW call lists every DOS device name instead of probing COM1..COM256 one by one.
+std::set<std::wstring> ListDosComNames() {
+    std::set<std::wstring> result;
+    std::vector<wchar_t> names(64U * 1024U);
+    for (;;) {
+        if (::QueryDosDeviceW(nullptr, names.data(), static_cast<DWORD>(names.size())) != 0) {
+            break;
         }
-        ++index;
+        if (::GetLastError() != ERROR_INSUFFICIENT_BUFFER || names.size() >= 4U * 1024U * 1024U) {
+            return result;
+        }
+        names.resize(names.size() * 2U);
     }
 
-    ::SetupDiDestroyDeviceInfoList(infoSet);
-}
-
-void EnumerateByQueryDosDevice(std::vector<serial::PortInfo>* ports) {
-    wchar_t target[1024] = {};
-    for (int i = 1; i <= 256; ++i) {
-        wchar_t name[16] = {};
-        ::swprintf_s(name, L"COM%d", i);
-        if (::QueryDosDeviceW(name, target, static_cast<DWORD>(_countof(target))) != 0) {
-            ports->push_back(serial::PortInfo{name, name});
+    for (const wchar_t* name = names.data(); *name != L'\0'; name += ::wcslen(name) + 1) {
+        if (IsComName(name)) {
+            result.insert(name);
         }
     }
+    return result;
 }
 
 void RemoveDuplicates(std::vector<serial::PortInfo>* ports) {
@@ -142,17 +167,17 @@ void RemoveDuplicates(std::vector<serial::PortInfo>* ports) {
 
 namespace serial {
 
-std::vector<PortInfo> PortScanner::Scan() {
+std::vector<PortInfo> PortScanner::Enumerate(const Cache& known) {
+    const std::set<std::wstring> dosNames = ListDosComNames();
+
     std::vector<PortInfo> ports;
-    EnumerateByPortsClass(&ports);
-    EnumerateByInterfaceGuid(&ports);
-    EnumerateByQueryDosDevice(&ports);
+    EnumerateDeviceSet(GUID_DEVCLASS_PORTS, DIGCF_PRESENT, known, dosNames, &ports);
+    EnumerateDeviceSet(kGuidDevinterfaceComport, DIGCF_PRESENT | DIGCF_DEVICEINTERFACE, known, dosNames, &ports);
+    // Ports without a PnP node (legacy drivers, some virtual port software) only exist as DOS names.
+    for (const std::wstring& name : dosNames) {
+        ports.push_back(PortInfo{name, name, L"DOS\\" + name});
+    }
     RemoveDuplicates(&ports);
-
-    std::sort(ports.begin(), ports.end(), [](const PortInfo& lhs, const PortInfo& rhs) {
-        return lhs.portName < rhs.portName;
-    });
-
     return ports;
 }
 
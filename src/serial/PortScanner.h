@@ -1,6 +1,12 @@
 #pragma once
 
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace serial {
@@ -8,11 +14,67 @@ namespace serial {
 struct PortInfo {
     std::wstring portName;
     std::wstring friendlyName;
+    // Stable key of the underlying device: PnP instance ID on Windows, sysfs device path or pts
+    // node on Linux. Survives renames of the port, so a renumbered COM port shows up as a change.
+    std::wstring instanceId;
 };
 
+// Result of one incremental scan, both lists sorted by portName.
+struct PortDiff {
+    std::vector<PortInfo> added;
+    std::vector<PortInfo> removed;
+    std::uint64_t generation = 0;
+
+    [[nodiscard]] bool Empty() const noexcept { return added.empty() && removed.empty(); }
+};
+
+// Enumerates serial ports. Scan() is a one-shot full listing; an instance keeps the last result
+// keyed by instanceId, reuses per-device details (friendly names) for devices it has already
+// seen and reports only what changed. Start() moves the scanning onto a background thread.
 class PortScanner final {
 public:
+    using DiffCallback = std::function<void(const PortDiff& diff)>;
+
+    PortScanner();
+    ~PortScanner();
+
+    PortScanner(const PortScanner&) = delete;
+    PortScanner& operator=(const PortScanner&) = delete;
+
     static std::vector<PortInfo> Scan();
+
+    // Enumerates now on the calling thread and returns the changes since the previous scan.
+    // The first scan reports every present port as added.
+    PortDiff Rescan();
+    // Ports known after the last scan, sorted by portName. Does not touch the devices.
+    [[nodiscard]] std::vector<PortInfo> Ports() const;
+    [[nodiscard]] std::uint64_t Generation() const;
+
+    // Starts the scanner thread and queues the first scan. onDiff runs on that thread, only for
+    // scans that found a change.
+    bool Start(DiffCallback onDiff);
+    void Stop();
+    [[nodiscard]] bool IsRunning() const;
+    // Queues a background rescan. Requests arriving while a scan runs fold into one more scan.
+    void Request();
+
+private:
+    using Cache = std::unordered_map<std::wstring, PortInfo>;
+
+    // Platform enumeration; details of instances present in `known` are taken from there.
+    static std::vector<PortInfo> Enumerate(const Cache& known);
+    void ThreadMain();
+
+    std::mutex scanMutex_;       // Serializes Rescan(); held while cache_ is read unlocked.
+    mutable std::mutex mutex_;   // Guards cache_, generation_ and the thread state below.
+    Cache cache_;
+    std::uint64_t generation_;
+
+    std::condition_variable wake_;
+    bool running_;
+    bool requested_;
+    DiffCallback onDiff_;
+    std::thread thread_;
 };
 
-} // namespace serial
\ No newline at end of file
+} // namespace serial
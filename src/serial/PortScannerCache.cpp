@@ -0,0 +1,139 @@
+#include "serial/PortScanner.h"
+
+#include <algorithm>
+#include <system_error>
+#include <utility>
+
+namespace {
+
+bool ByPortName(const serial::PortInfo& lhs, const serial::PortInfo& rhs) {
+    return lhs.portName < rhs.portName;
+}
+
+} // namespace
+
+namespace serial {
+
+PortScanner::PortScanner() : generation_(0), running_(false), requested_(false) {}
+
+PortScanner::~PortScanner() {
+    Stop();
+}
+
+std::vector<PortInfo> PortScanner::Scan() {
+    std::vector<PortInfo> ports = Enumerate(Cache{});
+    std::sort(ports.begin(), ports.end(), &ByPortName);
+    return ports;
+}
+
+PortDiff PortScanner::Rescan() {
+    std::lock_guard<std::mutex> scanLock(scanMutex_);
+
+    // Only Rescan() writes cache_, and it holds scanMutex_, so reading it here needs no copy.
+    std::vector<PortInfo> ports = Enumerate(cache_);
+
+    Cache next;
+    next.reserve(ports.size());
+    PortDiff diff;
+    for (PortInfo& port : ports) {
+        const auto known = cache_.find(port.instanceId);
+        if (known == cache_.end() || known->second.portName != port.portName) {
+            diff.added.push_back(port);
+        }
+        next.emplace(port.instanceId, std::move(port));
+    }
+    for (const auto& [instanceId, port] : cache_) {
+        const auto present = next.find(instanceId);
+        if (present == next.end() || present->second.portName != port.portName) {
+            diff.removed.push_back(port);
+        }
+    }
+    std::sort(diff.added.begin(), diff.added.end(), &ByPortName);
+    std::sort(diff.removed.begin(), diff.removed.end(), &ByPortName);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.swap(next);
+    if (!diff.Empty()) {
+        ++generation_;
+    }
+    diff.generation = generation_;
+    return diff;
+}
+
+std::vector<PortInfo> PortScanner::Ports() const {
+    std::vector<PortInfo> ports;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ports.reserve(cache_.size());
+        for (const auto& [instanceId, port] : cache_) {
+            ports.push_back(port);
+        }
+    }
+    std::sort(ports.begin(), ports.end(), &ByPortName);
+    return ports;
+}
+
+std::uint64_t PortScanner::Generation() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return generation_;
+}
+
+bool PortScanner::Start(DiffCallback onDiff) {
+    Stop();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    onDiff_ = std::move(onDiff);
+    running_ = true;
+    requested_ = true;
+    try {
+        thread_ = std::thread(&PortScanner::ThreadMain, this);
+    } catch (const std::system_error&) {
+        running_ = false;
+        return false;
+    }
+    return true;
+}
+
+void PortScanner::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool PortScanner::IsRunning() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_;
+}
+
+void PortScanner::Request() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        requested_ = true;
+    }
+    wake_.notify_one();
+}
+
+void PortScanner::ThreadMain() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return !running_ || requested_; });
+            if (!running_) {
+                return;
+            }
+            requested_ = false;
+        }
+
+        const PortDiff diff = Rescan();
+        if (!diff.Empty() && onDiff_) {
+            onDiff_(diff);
+        }
+    }
+}
+
+} // namespace serial
@@ -0,0 +1,164 @@
+#include "serial/PortScanner.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <string>
+
+#include "core/UniqueFd.h"
+
+namespace {
+
+constexpr const char* kSysClassTty = "/sys/class/tty";
+constexpr const char* kDevPts = "/dev/pts";
+// How far up from a tty's device node to look for USB descriptor strings.
+constexpr int kMaxAncestorDepth = 4;
+
+std::wstring Widen(const std::string& text) {
+    return std::wstring(text.begin(), text.end());
+}
+
+// Small sysfs attribute, trailing newline stripped; empty when missing.
+std::string ReadAttribute(int dirFd, const std::string& path) {
+    core::UniqueFd fd(::openat(dirFd, path.c_str(), O_RDONLY | O_CLOEXEC));
+    if (!fd.IsValid()) {
+        return {};
+    }
+    char buffer[256];
+    const ssize_t size = ::read(fd.Get(), buffer, sizeof(buffer));
+    if (size <= 0) {
+        return {};
+    }
+    std::string value(buffer, static_cast<std::size_t>(size));
+    while (!value.empty() && (value.back() == '\n' || value.back() == ' ')) {
+        value.pop_back();
+    }
+    return value;
+}
+
+std::string ReadLink(int dirFd, const std::string& path) {
+    char buffer[PATH_MAX];
+    const ssize_t size = ::readlinkat(dirFd, path.c_str(), buffer, sizeof(buffer));
+    if (size <= 0 || static_cast<std::size_t>(size) >= sizeof(buffer)) {
+        return {};
+    }
+    return std::string(buffer, static_cast<std::size_t>(size));
+}
+
+std::string BaseName(const std::string& path) {
+    const std::size_t slash = path.rfind('/');
+    return (slash == std::string::npos) ? path : path.substr(slash + 1);
+}
+
+// Builds the name udev would show: USB manufacturer and product strings from the nearest USB
+// device above the tty, otherwise the driver that owns the port.
+std::wstring ReadFriendlyName(int ttyClassFd, const std::string& name) {
+    std::string prefix = name + "/device";
+    std::string driver;
+    for (int depth = 0; depth < kMaxAncestorDepth; ++depth, prefix += "/..") {
+        const std::string product = ReadAttribute(ttyClassFd, prefix + "/product");
+        if (!product.empty()) {
+            const std::string manufacturer = ReadAttribute(ttyClassFd, prefix + "/manufacturer");
+            return Widen((manufacturer.empty() ? product : manufacturer + " " + product) + " (" + name + ")");
+        }
+        if (driver.empty()) {
+            // Recent kernels put a generic "port" device between the tty and the real driver.
+            const std::string candidate = BaseName(ReadLink(ttyClassFd, prefix + "/driver"));
+            if (candidate != "port") {
+                driver = candidate;
+            }
+        }
+    }
+    return Widen((driver.empty() ? std::string("Serial port") : driver) + " (" + name + ")");
+}
+
+// Entries under /sys/class/tty without a device link are virtual consoles and the like. 8250
+// drivers register placeholders for ports that do not exist; their type reads as 0 (unknown).
+bool IsRealSerialPort(int ttyClassFd, const std::string& name) {
+    struct stat info{};
+    if (::fstatat(ttyClassFd, (name + "/device").c_str(), &info, AT_SYMLINK_NOFOLLOW) != 0) {
+        return false;
+    }
+    return ReadAttribute(ttyClassFd, name + "/type") != "0";
+}
+
+void EnumerateSysfs(const std::unordered_map<std::wstring, serial::PortInfo>& known, std::vector<serial::PortInfo>* ports) {
+    DIR* dir = ::opendir(kSysClassTty);
+    if (dir == nullptr) {
+        return;
+    }
+    const int dirFd = ::dirfd(dir);
+
+    while (const dirent* entry = ::readdir(dir)) {
+        const std::string name = entry->d_name;
+        if (name.empty() || name[0] == '.') {
+            continue;
+        }
+
+        // The class entry links to the device node, e.g. ../../devices/pnp0/00:00/.../tty/ttyS0.
+        std::string target = ReadLink(dirFd, name);
+        while (target.compare(0, 3, "../") == 0) {
+            target.erase(0, 3);
+        }
+        const std::wstring instanceId = Widen("/sys/" + target);
+        const auto cached = known.find(instanceId);
+        if (cached != known.end()) {
+            ports->push_back(cached->second);
+            continue;
+        }
+
+        if (!IsRealSerialPort(dirFd, name)) {
+            continue;
+        }
+        ports->push_back(serial::PortInfo{Widen("/dev/" + name), ReadFriendlyName(dirFd, name), instanceId});
+    }
+
+    ::closedir(dir);
+}
+
+// Pseudo-terminal slaves have no sysfs node. Their numbers are reused, so the key carries the
+// node's change time to tell a new pty from the one that had the number before.
+void EnumeratePts(std::vector<serial::PortInfo>* ports) {
+    DIR* dir = ::opendir(kDevPts);
+    if (dir == nullptr) {
+        return;
+    }
+    const int dirFd = ::dirfd(dir);
+
+    while (const dirent* entry = ::readdir(dir)) {
+        const char* name = entry->d_name;
+        char* end = nullptr;
+        std::strtoul(name, &end, 10);
+        if (end == name || *end != '\0') {
+            continue;
+        }
+
+        struct stat info{};
+        if (::fstatat(dirFd, name, &info, 0) != 0 || !S_ISCHR(info.st_mode)) {
+            continue;
+        }
+        const std::string path = std::string(kDevPts) + "/" + name;
+        const std::string instanceId = path + "@" + std::to_string(info.st_ctim.tv_sec) + "." +
+            std::to_string(info.st_ctim.tv_nsec);
+        ports->push_back(serial::PortInfo{Widen(path), Widen(std::string("Pseudo-terminal (pts/") + name + ")"), Widen(instanceId)});
+    }
+
+    ::closedir(dir);
+}
+
+} // namespace
+
+namespace serial {
+
+std::vector<PortInfo> PortScanner::Enumerate(const Cache& known) {
+    std::vector<PortInfo> ports;
+    EnumerateSysfs(known, &ports);
+    EnumeratePts(&ports);
+    return ports;
+}
+
+} // namespace serial
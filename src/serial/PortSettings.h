@@ -0,0 +1,46 @@
+#pragma once
+
+#include "core/Platform.h"
+
+namespace serial {
+
+enum class ParityMode {
+    None,
+    Odd,
+    Even,
+    Mark,
+    Space
+};
+
+enum class StopBitsMode {
+    One,
+    OnePointFive,
+    Two
+};
+
+enum class FlowControlMode {
+    None,
+    Hardware,
+    Software
+};
+
+enum class ReadProfile {
+    LowLatency, // Deliver whatever has arrived, byte by byte if need be.
+    Balanced,   // Chunks of ~5 ms of line-rate data or a short idle gap.
+    Bulk        // Chunks of ~50 ms of line-rate data or a longer idle gap.
+};
+
+struct PortSettings {
+    DWORD baudRate;
+    BYTE dataBits;
+    ParityMode parity;
+    StopBitsMode stopBits;
+    FlowControlMode flowControl;
+    bool rts;
+    bool dtr;
+    DWORD readDepth = 4;
+    DWORD readBufferSize = 4096;
+    ReadProfile readProfile = ReadProfile::LowLatency;
+};
+
+} // namespace serial
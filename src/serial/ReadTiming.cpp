@@ -0,0 +1,61 @@
+#include "serial/ReadTiming.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "serial/SerialPort.h"
+
+namespace {
+
+constexpr std::uint64_t kBitsPerByte = 10;
+
+struct ProfileShape {
+    DWORD chunkMs;     // Line-rate data per delivered chunk.
+    DWORD gapBytes;    // Idle time, in byte times, that ends a chunk early.
+    DWORD minGapMs;
+    DWORD maxGapMs;
+};
+
+constexpr ProfileShape kBalanced{5, 4, 1, 5};
+constexpr ProfileShape kBulk{50, 16, 2, 20};
+
+serial::ReadTiming Shape(const ProfileShape& shape, DWORD baudRate, DWORD readBufferSize) {
+    const std::uint64_t baud = std::max<DWORD>(baudRate, 1U);
+
+    // Round the gap up, a shorter one than requested would split frames mid-burst.
+    const std::uint64_t gapMs = (shape.gapBytes * kBitsPerByte * 1000U + baud - 1U) / baud;
+    const std::uint64_t chunkBytes = baud * shape.chunkMs / (kBitsPerByte * 1000U);
+
+    serial::ReadTiming timing{};
+    timing.gapMs = static_cast<DWORD>(std::clamp<std::uint64_t>(gapMs, shape.minGapMs, shape.maxGapMs));
+    timing.minChunkBytes = static_cast<DWORD>(
+        std::clamp<std::uint64_t>(chunkBytes, 1U, std::max<DWORD>(readBufferSize, 1U)));
+    return timing;
+}
+
+} // namespace
+
+namespace serial {
+
+ReadTiming MakeReadTiming(ReadProfile profile, DWORD baudRate, DWORD readBufferSize) {
+    switch (profile) {
+    case ReadProfile::LowLatency:
+        break;
+    case ReadProfile::Balanced:
+        return Shape(kBalanced, baudRate, readBufferSize);
+    case ReadProfile::Bulk:
+        return Shape(kBulk, baudRate, readBufferSize);
+    }
+    return ReadTiming{0, 1};
+}
+
+ReadGeometry MakeReadGeometry(const PortSettings& settings) {
+    ReadGeometry geometry{};
+    geometry.depth = std::clamp<DWORD>(settings.readDepth, 1U, SerialPort::kMaxReadDepth);
+    geometry.bufferSize = std::clamp<DWORD>(
+        settings.readBufferSize, SerialPort::kMinReadBufferSize, SerialPort::kMaxReadBufferSize);
+    geometry.timing = MakeReadTiming(settings.readProfile, settings.baudRate, geometry.bufferSize);
+    return geometry;
+}
+
+} // namespace serial
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "serial/PortSettings.h"
+
+namespace serial {
+
+// How the read path batches incoming bytes: a chunk is delivered once minChunkBytes have been
+// collected or the line has been idle for gapMs (gapMs == 0 means "deliver immediately").
+struct ReadTiming {
+    DWORD gapMs;
+    DWORD minChunkBytes;
+};
+
+// Derives the gap and chunk size from the byte time at baudRate (10 bits per byte on the wire).
+// minChunkBytes never exceeds readBufferSize.
+ReadTiming MakeReadTiming(ReadProfile profile, DWORD baudRate, DWORD readBufferSize);
+
+// Read-side layout of an open port: readDepth/readBufferSize clamped to SerialPort's limits,
+// plus the timing derived from them.
+struct ReadGeometry {
+    DWORD depth;
+    DWORD bufferSize;
+    ReadTiming timing;
+};
+
+ReadGeometry MakeReadGeometry(const PortSettings& settings);
+
+} // namespace serial
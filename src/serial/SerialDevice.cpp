@@ -0,0 +1,112 @@
+#include "serial/SerialDevice.h"
+
+namespace {
+
+constexpr DWORD kIdleReadTimeoutMs = 1000;
+
+BYTE ToParity(serial::ParityMode mode) {
+    switch (mode) {
+    case serial::ParityMode::None:
+        return NOPARITY;
+    case serial::ParityMode::Odd:
+        return ODDPARITY;
+    case serial::ParityMode::Even:
+        return EVENPARITY;
+    case serial::ParityMode::Mark:
+        return MARKPARITY;
+    case serial::ParityMode::Space:
+        return SPACEPARITY;
+    }
+    return NOPARITY;
+}
+
+BYTE ToStopBits(serial::StopBitsMode mode) {
+    switch (mode) {
+    case serial::StopBitsMode::One:
+        return ONESTOPBIT;
+    case serial::StopBitsMode::OnePointFive:
+        return ONE5STOPBITS;
+    case serial::StopBitsMode::Two:
+        return TWOSTOPBITS;
+    }
+    return ONESTOPBIT;
+}
+
+bool ConfigurePort(HANDLE port, const serial::PortSettings& settings, const serial::ReadTiming& timing) {
+    DCB dcb{};
+    dcb.DCBlength = sizeof(dcb);
+    if (!::GetCommState(port, &dcb)) {
+        return false;
+    }
+
+    dcb.BaudRate = settings.baudRate;
+    dcb.ByteSize = settings.dataBits;
+    dcb.Parity = ToParity(settings.parity);
+    dcb.StopBits = ToStopBits(settings.stopBits);
+    dcb.fBinary = TRUE;
+    dcb.fParity = (settings.parity != serial::ParityMode::None) ? TRUE : FALSE;
+
+    dcb.fOutxCtsFlow = FALSE;
+    dcb.fRtsControl = settings.rts ? RTS_CONTROL_ENABLE : RTS_CONTROL_DISABLE;
+    dcb.fOutxDsrFlow = FALSE;
+    dcb.fDtrControl = settings.dtr ? DTR_CONTROL_ENABLE : DTR_CONTROL_DISABLE;
+    dcb.fOutX = FALSE;
+    dcb.fInX = FALSE;
+
+    if (settings.flowControl == serial::FlowControlMode::Hardware) {
+        dcb.fOutxCtsFlow = TRUE;
+        dcb.fRtsControl = RTS_CONTROL_HANDSHAKE;
+    } else if (settings.flowControl == serial::FlowControlMode::Software) {
+        dcb.fOutX = TRUE;
+        dcb.fInX = TRUE;
+    }
+
+    if (!::SetCommState(port, &dcb)) {
+        return false;
+    }
+
+    COMMTIMEOUTS timeouts{};
+    if (timing.gapMs == 0) {
+        // Complete a read as soon as any byte arrives, otherwise after kIdleReadTimeoutMs with zero bytes,
+        // so queued reads wait in the driver instead of spinning.
+        timeouts.ReadIntervalTimeout = MAXDWORD;
+        timeouts.ReadTotalTimeoutConstant = kIdleReadTimeoutMs;
+        timeouts.ReadTotalTimeoutMultiplier = MAXDWORD;
+    } else {
+        // No total timeout: a read waits for its first byte, then completes when it holds
+        // minChunkBytes (the size PostRead asks for) or the line stays idle for gapMs.
+        timeouts.ReadIntervalTimeout = timing.gapMs;
+    }
+    if (settings.flowControl == serial::FlowControlMode::None) {
+        timeouts.WriteTotalTimeoutConstant = 200;
+        timeouts.WriteTotalTimeoutMultiplier = 10;
+    }
+    // With flow control the peer may hold the line for as long as it likes; a timed-out write
+    // would complete short while later writes are already queued behind it. Writes are
+    // overlapped, so Close() still cancels them.
+
+    return ::SetCommTimeouts(port, &timeouts) == TRUE;
+}
+
+} // namespace
+
+namespace serial {
+
+core::SafeHandle OpenSerialDevice(const std::wstring& portName, const PortSettings& settings, const ReadTiming& timing) {
+    const std::wstring path = L"\\\\.\\" + portName;
+    core::SafeHandle port(::CreateFileW(
+        path.c_str(),
+        GENERIC_READ | GENERIC_WRITE,
+        0,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED,
+        nullptr));
+
+    if (port.IsValid() && !ConfigurePort(port.Get(), settings, timing)) {
+        port.Reset();
+    }
+    return port;
+}
+
+} // namespace serial
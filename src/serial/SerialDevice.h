@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+#include "serial/PortSettings.h"
+#include "serial/ReadTiming.h"
+
+#ifdef _WIN32
+#include "core/SafeHandle.h"
+#else
+#include "core/UniqueFd.h"
+#endif
+
+namespace serial {
+
+// Opening and line configuration shared by SerialPort and PortReactor. The returned handle is
+// invalid on failure.
+#ifdef _WIN32
+// Opens \\.\<portName> for overlapped I/O and applies the DCB and COMMTIMEOUTS for timing.
+core::SafeHandle OpenSerialDevice(const std::wstring& portName, const PortSettings& settings, const ReadTiming& timing);
+#else
+// Opens the tty nonblocking and exclusive, then applies settings through termios.
+core::UniqueFd OpenSerialDevice(const std::wstring& portName, const PortSettings& settings, const ReadTiming& timing);
+bool SetModemLine(int fd, int line, bool enabled);
+// Reads the input lines as GetModemStatus() masks (MS_CTS_ON...); false when the tty has none.
+bool GetModemLines(int fd, DWORD* status);
+#endif
+
+} // namespace serial
@@ -0,0 +1,241 @@
+#include "serial/SerialDevice.h"
+
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+namespace {
+
+struct BaudMapping {
+    DWORD baudRate;
+    speed_t speed;
+};
+
+constexpr BaudMapping kBaudRates[] = {
+    {50, B50},
+    {75, B75},
+    {110, B110},
+    {134, B134},
+    {150, B150},
+    {200, B200},
+    {300, B300},
+    {600, B600},
+    {1200, B1200},
+    {1800, B1800},
+    {2400, B2400},
+    {4800, B4800},
+    {9600, B9600},
+    {19200, B19200},
+    {38400, B38400},
+    {57600, B57600},
+    {115200, B115200},
+    {230400, B230400},
+#ifdef B460800
+    {460800, B460800},
+#endif
+#ifdef B500000
+    {500000, B500000},
+#endif
+#ifdef B576000
+    {576000, B576000},
+#endif
+#ifdef B921600
+    {921600, B921600},
+#endif
+#ifdef B1000000
+    {1000000, B1000000},
+#endif
+#ifdef B1152000
+    {1152000, B1152000},
+#endif
+#ifdef B1500000
+    {1500000, B1500000},
+#endif
+#ifdef B2000000
+    {2000000, B2000000},
+#endif
+#ifdef B2500000
+    {2500000, B2500000},
+#endif
+#ifdef B3000000
+    {3000000, B3000000},
+#endif
+#ifdef B3500000
+    {3500000, B3500000},
+#endif
+#ifdef B4000000
+    {4000000, B4000000},
+#endif
+};
+
+bool ToSpeed(DWORD baudRate, speed_t* speed) {
+    for (const auto& mapping : kBaudRates) {
+        if (mapping.baudRate == baudRate) {
+            *speed = mapping.speed;
+            return true;
+        }
+    }
+    return false;
+}
+
+tcflag_t ToCharSize(BYTE dataBits) {
+    switch (dataBits) {
+    case 5:
+        return CS5;
+    case 6:
+        return CS6;
+    case 7:
+        return CS7;
+    default:
+        return CS8;
+    }
+}
+
+std::string ToDevicePath(const std::wstring& portName) {
+    std::string utf8;
+    utf8.reserve(portName.size());
+    for (const wchar_t wch : portName) {
+        const auto ch = static_cast<std::uint32_t>(wch);
+        if (ch < 0x80U) {
+            utf8.push_back(static_cast<char>(ch));
+        } else if (ch < 0x800U) {
+            utf8.push_back(static_cast<char>(0xC0U | (ch >> 6U)));
+            utf8.push_back(static_cast<char>(0x80U | (ch & 0x3FU)));
+        } else if (ch < 0x10000U) {
+            utf8.push_back(static_cast<char>(0xE0U | (ch >> 12U)));
+            utf8.push_back(static_cast<char>(0x80U | ((ch >> 6U) & 0x3FU)));
+            utf8.push_back(static_cast<char>(0x80U | (ch & 0x3FU)));
+        } else {
+            utf8.push_back(static_cast<char>(0xF0U | (ch >> 18U)));
+            utf8.push_back(static_cast<char>(0x80U | ((ch >> 12U) & 0x3FU)));
+            utf8.push_back(static_cast<char>(0x80U | ((ch >> 6U) & 0x3FU)));
+            utf8.push_back(static_cast<char>(0x80U | (ch & 0x3FU)));
+        }
+    }
+
+    if (!utf8.empty() && utf8.front() == '/') {
+        return utf8;
+    }
+    return "/dev/" + utf8;
+}
+
+bool ConfigurePort(int fd, const serial::PortSettings& settings, const serial::ReadTiming& timing) {
+    termios tty{};
+    if (::tcgetattr(fd, &tty) != 0) {
+        return false;
+    }
+
+    speed_t speed = B0;
+    if (!ToSpeed(settings.baudRate, &speed)) {
+        return false;
+    }
+
+    ::cfmakeraw(&tty);
+    ::cfsetispeed(&tty, speed);
+    ::cfsetospeed(&tty, speed);
+
+    tty.c_cflag &= ~static_cast<tcflag_t>(CSIZE | PARENB | PARODD | CSTOPB | CRTSCTS);
+    tty.c_cflag |= ToCharSize(settings.dataBits) | CLOCAL | CREAD;
+#ifdef CMSPAR
+    tty.c_cflag &= ~static_cast<tcflag_t>(CMSPAR);
+#endif
+
+    switch (settings.parity) {
+    case serial::ParityMode::None:
+        break;
+    case serial::ParityMode::Odd:
+        tty.c_cflag |= PARENB | PARODD;
+        break;
+    case serial::ParityMode::Even:
+        tty.c_cflag |= PARENB;
+        break;
+    case serial::ParityMode::Mark:
+#ifdef CMSPAR
+        tty.c_cflag |= PARENB | PARODD | CMSPAR;
+        break;
+#else
+        return false;
+#endif
+    case serial::ParityMode::Space:
+#ifdef CMSPAR
+        tty.c_cflag |= PARENB | CMSPAR;
+        break;
+#else
+        return false;
+#endif
+    }
+
+    // 1.5 stop bits is what UARTs emit for CSTOPB with 5 data bits, same as on Windows.
+    if (settings.stopBits != serial::StopBitsMode::One) {
+        tty.c_cflag |= CSTOPB;
+    }
+
+    tty.c_iflag &= ~static_cast<tcflag_t>(IXON | IXOFF | IXANY);
+    if (settings.flowControl == serial::FlowControlMode::Hardware) {
+        tty.c_cflag |= CRTSCTS;
+    } else if (settings.flowControl == serial::FlowControlMode::Software) {
+        tty.c_iflag |= IXON | IXOFF;
+    }
+
+    // VTIME is the termios inter-byte timer (in 100 ms steps) for anyone reading the tty in blocking
+    // mode. VMIN stays 1: larger values make n_tty hold back data and throttle the sender, so the
+    // chunk size and the millisecond-resolution gap are applied by the read thread instead.
+    tty.c_cc[VMIN] = 1;
+    tty.c_cc[VTIME] = (timing.gapMs == 0) ? 0 : static_cast<cc_t>(std::clamp<DWORD>((timing.gapMs + 99U) / 100U, 1U, 255U));
+
+    if (::tcsetattr(fd, TCSANOW, &tty) != 0) {
+        return false;
+    }
+
+    // Pseudo-terminals have no modem lines, so a failure here is not fatal.
+    if (settings.flowControl != serial::FlowControlMode::Hardware) {
+        serial::SetModemLine(fd, TIOCM_RTS, settings.rts);
+    }
+    serial::SetModemLine(fd, TIOCM_DTR, settings.dtr);
+    return true;
+}
+
+} // namespace
+
+namespace serial {
+
+bool SetModemLine(int fd, int line, bool enabled) {
+    return ::ioctl(fd, enabled ? TIOCMBIS : TIOCMBIC, &line) == 0;
+}
+
+bool GetModemLines(int fd, DWORD* status) {
+    int lines = 0;
+    if (status == nullptr || ::ioctl(fd, TIOCMGET, &lines) != 0) {
+        return false;
+    }
+
+    DWORD result = 0;
+    result |= ((lines & TIOCM_CTS) != 0) ? MS_CTS_ON : 0U;
+    result |= ((lines & TIOCM_DSR) != 0) ? MS_DSR_ON : 0U;
+    result |= ((lines & TIOCM_RNG) != 0) ? MS_RING_ON : 0U;
+    result |= ((lines & TIOCM_CAR) != 0) ? MS_RLSD_ON : 0U;
+    *status = result;
+    return true;
+}
+
+core::UniqueFd OpenSerialDevice(const std::wstring& portName, const PortSettings& settings, const ReadTiming& timing) {
+    const std::string path = ToDevicePath(portName);
+    core::UniqueFd port(::open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC));
+    if (!port.IsValid()) {
+        return port;
+    }
+
+    // Mirrors the exclusive share mode used by CreateFileW on Windows.
+    ::ioctl(port.Get(), TIOCEXCL);
+
+    if (!ConfigurePort(port.Get(), settings, timing)) {
+        port.Reset();
+    }
+    return port;
+}
+
+} // namespace serial
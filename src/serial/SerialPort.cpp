@@ -1,87 +1,25 @@
 #include "serial/SerialPort.h"
 
-#include <array>
+#include <algorithm>
 
-namespace {
-
-BYTE ToParity(serial::ParityMode mode) {
-    switch (mode) {
-    case serial::ParityMode::None:
-        return NOPARITY;
-    case serial::ParityMode::Odd:
-        return ODDPARITY;
-    case serial::ParityMode::Even:
-        return EVENPARITY;
-    case serial::ParityMode::Mark:
-        return MARKPARITY;
-    case serial::ParityMode::Space:
-        return SPACEPARITY;
-    }
-    return NOPARITY;
-}
-
-BYTE ToStopBits(serial::StopBitsMode mode) {
-    switch (mode) {
-    case serial::StopBitsMode::One:
-        return ONESTOPBIT;
-    case serial::StopBitsMode::OnePointFive:
-        return ONE5STOPBITS;
-    case serial::StopBitsMode::Two:
-        return TWOSTOPBITS;
-    }
-    return ONESTOPBIT;
-}
+#include "core/Clock.h"
+#include "serial/SerialDevice.h"
 
-bool ConfigurePort(HANDLE port, const serial::PortSettings& settings) {
-    DCB dcb{};
-    dcb.DCBlength = sizeof(dcb);
-    if (!::GetCommState(port, &dcb)) {
-        return false;
-    }
-
-    dcb.BaudRate = settings.baudRate;
-    dcb.ByteSize = settings.dataBits;
-    dcb.Parity = ToParity(settings.parity);
-    dcb.StopBits = ToStopBits(settings.stopBits);
-    dcb.fBinary = TRUE;
-    dcb.fParity = (settings.parity != serial::ParityMode::None) ? TRUE : FALSE;
-
-    dcb.fOutxCtsFlow = FALSE;
-    dcb.fRtsControl = settings.rts ? RTS_CONTROL_ENABLE : RTS_CONTROL_DISABLE;
-    dcb.fOutxDsrFlow = FALSE;
-    dcb.fDtrControl = settings.dtr ? DTR_CONTROL_ENABLE : DTR_CONTROL_DISABLE;
-    dcb.fOutX = FALSE;
-    dcb.fInX = FALSE;
-
-    if (settings.flowControl == serial::FlowControlMode::Hardware) {
-        dcb.fOutxCtsFlow = TRUE;
-        dcb.fRtsControl = RTS_CONTROL_HANDSHAKE;
-    } else if (settings.flowControl == serial::FlowControlMode::Software) {
-        dcb.fOutX = TRUE;
-        dcb.fInX = TRUE;
-    }
-
-    if (!::SetCommState(port, &dcb)) {
-        return false;
-    }
-
-    COMMTIMEOUTS timeouts{};
-    timeouts.ReadIntervalTimeout = MAXDWORD;
-    timeouts.ReadTotalTimeoutConstant = 0;
-    timeouts.ReadTotalTimeoutMultiplier = 0;
-    timeouts.WriteTotalTimeoutConstant = 200;
-    timeouts.WriteTotalTimeoutMultiplier = 10;
+namespace {
 
-    return ::SetCommTimeouts(port, &timeouts) == TRUE;
-}
+constexpr DWORD kWriteTimeoutMs = 3000;
 
 } // namespace
 
 namespace serial {
 
-SerialPort::SerialPort() : readOverlapped_{}, writeOverlapped_{}, running_(false) {
-    readOverlapped_.hEvent = nullptr;
-    writeOverlapped_.hEvent = nullptr;
+SerialPort::SerialPort()
+    : readDepth_(0),
+      readBufferSize_(0),
+      readTiming_{0, 1},
+      running_(false),
+      purgeTx_(false),
+      txQueue_(kMaxTxQueuedBytes, kMaxTxBatchBytes) {
 }
 
 SerialPort::~SerialPort() {
@@ -91,24 +29,19 @@ SerialPort::~SerialPort() {
 bool SerialPort::Open(const std::wstring& portName, const PortSettings& settings) {
     Close();
 
-    std::wstring path = L"\\\\.\\" + portName;
-    HANDLE rawPort = ::CreateFileW(
-        path.c_str(),
-        GENERIC_READ | GENERIC_WRITE,
-        0,
-        nullptr,
-        OPEN_EXISTING,
-        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED,
-        nullptr);
-
-    if (rawPort == INVALID_HANDLE_VALUE) {
-        return false;
+    const ReadGeometry geometry = MakeReadGeometry(settings);
+    if (IsVirtualPortName(portName)) {
+        TrafficSpec spec{};
+        virtualDevice_ = std::make_unique<VirtualDevice>();
+        if (!ParseVirtualPortName(portName, settings.baudRate, &spec) || !virtualDevice_->Start(spec)) {
+            Close();
+            return false;
+        }
+        port_ = virtualDevice_->OpenPortSide(settings, geometry.timing);
+    } else {
+        port_ = OpenSerialDevice(portName, settings, geometry.timing);
     }
-
-    port_.Reset(rawPort);
-
-    HANDLE rawReadEvent = ::CreateEventW(nullptr, TRUE, FALSE, nullptr);
-    if (rawReadEvent == nullptr) {
+    if (!port_.IsValid()) {
         Close();
         return false;
     }
@@ -118,38 +51,70 @@ bool SerialPort::Open(const std::wstring& portName, const PortSettings& settings
         Close();
         return false;
     }
-    HANDLE rawWriteEvent = ::CreateEventW(nullptr, TRUE, FALSE, nullptr);
-    if (rawWriteEvent == nullptr) {
+    shutdownEvent_.Reset(rawShutdownEvent);
+
+    HANDLE rawTxEvent = ::CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    if (rawTxEvent == nullptr) {
         Close();
         return false;
     }
+    txEvent_.Reset(rawTxEvent);
+
+    writeSlots_.clear();
+    writeSlots_.reserve(kMaxOutstandingWrites);
+    for (DWORD i = 0; i < kMaxOutstandingWrites; ++i) {
+        HANDLE rawWriteEvent = ::CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        if (rawWriteEvent == nullptr) {
+            Close();
+            return false;
+        }
 
-    readEvent_.Reset(rawReadEvent);
-    writeEvent_.Reset(rawWriteEvent);
-    shutdownEvent_.Reset(rawShutdownEvent);
-    readOverlapped_ = OVERLAPPED{};
-    writeOverlapped_ = OVERLAPPED{};
-    readOverlapped_.hEvent = readEvent_.Get();
-    writeOverlapped_.hEvent = writeEvent_.Get();
+        WriteSlot slot{};
+        slot.event.Reset(rawWriteEvent);
+        writeSlots_.push_back(std::move(slot));
+    }
 
-    if (!ConfigurePort(port_.Get(), settings)) {
-        Close();
-        return false;
+    readDepth_ = geometry.depth;
+    readBufferSize_ = geometry.bufferSize;
+    readTiming_ = geometry.timing;
+    readSlots_.clear();
+    readSlots_.reserve(readDepth_);
+    for (DWORD i = 0; i < readDepth_; ++i) {
+        HANDLE rawReadEvent = ::CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        if (rawReadEvent == nullptr) {
+            Close();
+            return false;
+        }
+
+        ReadSlot slot{};
+        slot.event.Reset(rawReadEvent);
+        slot.buffer = std::make_unique<uint8_t[]>(readBufferSize_);
+        slot.pending = false;
+        readSlots_.push_back(std::move(slot));
     }
 
     running_.store(true);
+    txQueue_.Open();
     HANDLE rawThread = ::CreateThread(nullptr, 0, &SerialPort::ReadThreadProc, this, 0, nullptr);
     if (rawThread == nullptr) {
         Close();
         return false;
     }
-
     threadHandle_.Reset(rawThread);
+
+    HANDLE rawWriter = ::CreateThread(nullptr, 0, &SerialPort::WriteThreadProc, this, 0, nullptr);
+    if (rawWriter == nullptr) {
+        Close();
+        return false;
+    }
+    writerHandle_.Reset(rawWriter);
     return true;
 }
 
 void SerialPort::Close() {
+    modemMonitor_.Stop();
     const bool wasRunning = running_.exchange(false);
+    txQueue_.CloseAndFail();
 
     if (wasRunning) {
         if (port_.IsValid()) {
@@ -158,18 +123,26 @@ void SerialPort::Close() {
         if (shutdownEvent_.IsValid()) {
             ::SetEvent(shutdownEvent_.Get());
         }
+        // No timeout: the read slots' OVERLAPPEDs and buffers may still be with the driver until
+        // the thread has reaped them, and it uses port_ and shutdownEvent_ until it returns.
         if (threadHandle_.IsValid()) {
-            ::WaitForSingleObject(threadHandle_.Get(), 3000);
+            ::WaitForSingleObject(threadHandle_.Get(), INFINITE);
+        }
+        // Likewise for the writer: its slots hold the batches being written and its final reap
+        // runs the completion callbacks against them.
+        if (writerHandle_.IsValid()) {
+            ::WaitForSingleObject(writerHandle_.Get(), INFINITE);
         }
     }
 
     threadHandle_.Reset();
-    readEvent_.Reset();
-    writeEvent_.Reset();
+    writerHandle_.Reset();
+    readSlots_.clear();
+    writeSlots_.clear();
+    txEvent_.Reset();
     shutdownEvent_.Reset();
     port_.Reset();
-    readOverlapped_ = OVERLAPPED{};
-    writeOverlapped_ = OVERLAPPED{};
+    virtualDevice_.reset();
 }
 
 bool SerialPort::IsOpen() const noexcept {
@@ -182,25 +155,38 @@ bool SerialPort::Write(const uint8_t* data, DWORD size, DWORD* writtenBytes) {
     }
 
     *writtenBytes = 0;
-    ::ResetEvent(writeEvent_.Get());
-
-    const BOOL ok = ::WriteFile(port_.Get(), data, size, writtenBytes, &writeOverlapped_);
-    if (ok == TRUE) {
-        return true;
+    const auto waiter = TxWaiter::Create();
+    if (!WriteAsync(data, size, waiter->Callback())) {
+        return false;
     }
+    return waiter->Wait(std::chrono::milliseconds(kWriteTimeoutMs), writtenBytes);
+}
 
-    const DWORD error = ::GetLastError();
-    if (error != ERROR_IO_PENDING) {
+bool SerialPort::WriteAsync(const uint8_t* data, DWORD size, WriteCallback done) {
+    if (!IsOpen() || data == nullptr || size == 0) {
         return false;
     }
-
-    HANDLE waits[2] = {writeEvent_.Get(), shutdownEvent_.Get()};
-    const DWORD wait = ::WaitForMultipleObjects(2, waits, FALSE, 3000);
-    if (wait != WAIT_OBJECT_0) {
+    if (!txQueue_.Push(data, size, std::move(done))) {
         return false;
     }
+    ::SetEvent(txEvent_.Get());
+    return true;
+}
+
+std::size_t SerialPort::TxQueuedBytes() const {
+    return txQueue_.QueuedBytes();
+}
 
-    return ::GetOverlappedResult(port_.Get(), &writeOverlapped_, writtenBytes, FALSE) == TRUE;
+std::size_t SerialPort::TxQueuedRequests() const {
+    return txQueue_.QueuedRequests();
+}
+
+void SerialPort::PurgeTx() {
+    if (!IsOpen()) {
+        return;
+    }
+    purgeTx_.store(true);
+    ::SetEvent(txEvent_.Get());
 }
 
 bool SerialPort::GetModemStatus(DWORD* modemStatus) {
@@ -224,6 +210,21 @@ bool SerialPort::SetDtr(bool enabled) {
     return ::EscapeCommFunction(port_.Get(), enabled ? SETDTR : CLRDTR) == TRUE;
 }
 
+bool SerialPort::StartModemMonitor(ModemMonitor::EventCallback onEvent) {
+    if (!IsOpen()) {
+        return false;
+    }
+    return modemMonitor_.Start(port_.Get(), std::move(onEvent));
+}
+
+void SerialPort::StopModemMonitor() {
+    modemMonitor_.Stop();
+}
+
+const ModemEventLog& SerialPort::ModemEvents() const noexcept {
+    return modemMonitor_.Events();
+}
+
 void SerialPort::SetDataCallback(DataCallback callback) {
     callback_ = std::move(callback);
 }
@@ -233,44 +234,150 @@ DWORD WINAPI SerialPort::ReadThreadProc(LPVOID param) {
     return self->ReadThreadMain();
 }
 
+DWORD WINAPI SerialPort::WriteThreadProc(LPVOID param) {
+    SerialPort* self = static_cast<SerialPort*>(param);
+    return self->WriteThreadMain();
+}
+
 DWORD SerialPort::ReadThreadMain() {
-    std::array<uint8_t, 1024> readBuffer{};
-    HANDLE waits[2] = {readEvent_.Get(), shutdownEvent_.Get()};
+    // Keep readSlots_.size() reads queued in the driver and complete them strictly in posting order,
+    // so the callback runs while the remaining reads keep receiving.
+    for (auto& slot : readSlots_) {
+        if (!PostRead(slot)) {
+            CancelPendingReads();
+            return 0;
+        }
+    }
 
+    std::size_t next = 0;
     while (running_.load()) {
-        DWORD readBytes = 0;
-        ::ResetEvent(readEvent_.Get());
+        ReadSlot& slot = readSlots_[next];
 
-        const BOOL ok = ::ReadFile(
-            port_.Get(),
-            readBuffer.data(),
-            static_cast<DWORD>(readBuffer.size()),
-            &readBytes,
-            &readOverlapped_);
+        HANDLE waits[2] = {slot.event.Get(), shutdownEvent_.Get()};
+        const DWORD wait = ::WaitForMultipleObjects(2, waits, FALSE, INFINITE);
+        if (wait != WAIT_OBJECT_0) {
+            break;
+        }
 
+        DWORD readBytes = 0;
+        const BOOL ok = ::GetOverlappedResult(port_.Get(), &slot.overlapped, &readBytes, FALSE);
+        const std::int64_t timestamp = core::MonotonicNanos();
+        slot.pending = false;
         if (!ok) {
-            const DWORD error = ::GetLastError();
-            if (error != ERROR_IO_PENDING) {
-                break;
-            }
+            break;
+        }
+
+        if (readBytes > 0 && callback_) {
+            callback_(std::span<const uint8_t>(slot.buffer.get(), readBytes), timestamp);
+        }
+
+        if (!PostRead(slot)) {
+            break;
+        }
+        next = (next + 1U) % readSlots_.size();
+    }
 
-            const DWORD wait = ::WaitForMultipleObjects(2, waits, FALSE, INFINITE);
-            if (wait == WAIT_OBJECT_0 + 1U) {
+    CancelPendingReads();
+    return 0;
+}
+
+bool SerialPort::PostRead(ReadSlot& slot) {
+    slot.overlapped = OVERLAPPED{};
+    slot.overlapped.hEvent = slot.event.Get();
+    ::ResetEvent(slot.event.Get());
+
+    // Synchronous completion also signals the event, so every slot is reaped the same way.
+    const DWORD size = (readTiming_.gapMs == 0) ? readBufferSize_ : readTiming_.minChunkBytes;
+    if (!::ReadFile(port_.Get(), slot.buffer.get(), size, nullptr, &slot.overlapped) &&
+        ::GetLastError() != ERROR_IO_PENDING) {
+        return false;
+    }
+
+    slot.pending = true;
+    return true;
+}
+
+DWORD SerialPort::WriteThreadMain() {
+    // writeSlots_ is used as a ring: [oldest, oldest + outstanding) are posted to the driver,
+    // which completes serial writes in order, so only the oldest one has to be waited on.
+    std::size_t oldest = 0;
+    std::size_t outstanding = 0;
+    const auto cancelOutstanding = [this, &oldest, &outstanding] {
+        for (; outstanding > 0; --outstanding) {
+            WriteSlot& slot = writeSlots_[oldest];
+            ::CancelIoEx(port_.Get(), &slot.overlapped);
+            DWORD written = 0;
+            const BOOL ok = ::GetOverlappedResult(port_.Get(), &slot.overlapped, &written, TRUE);
+            TxQueue::Complete(slot.batch, ok == TRUE, written);
+            oldest = (oldest + 1U) % writeSlots_.size();
+        }
+    };
+
+    while (running_.load()) {
+        if (purgeTx_.exchange(false)) {
+            txQueue_.FailQueued();
+            // Fails on a virtual port's pipe; cancelling the slots is what matters there.
+            ::PurgeComm(port_.Get(), PURGE_TXABORT | PURGE_TXCLEAR);
+            cancelOutstanding();
+        }
+
+        while (outstanding < writeSlots_.size()) {
+            WriteSlot& slot = writeSlots_[(oldest + outstanding) % writeSlots_.size()];
+            if (!txQueue_.PopBatch(&slot.batch)) {
                 break;
             }
 
-            if (!::GetOverlappedResult(port_.Get(), &readOverlapped_, &readBytes, FALSE)) {
-                break;
+            slot.overlapped = OVERLAPPED{};
+            slot.overlapped.hEvent = slot.event.Get();
+            ::ResetEvent(slot.event.Get());
+            if (!::WriteFile(
+                    port_.Get(),
+                    slot.batch.data.data(),
+                    static_cast<DWORD>(slot.batch.data.size()),
+                    nullptr,
+                    &slot.overlapped) &&
+                ::GetLastError() != ERROR_IO_PENDING) {
+                TxQueue::Complete(slot.batch, false, 0);
+                continue;
             }
+            ++outstanding;
         }
 
-        if (readBytes > 0 && callback_) {
-            std::vector<uint8_t> packet(readBuffer.begin(), readBuffer.begin() + readBytes);
-            callback_(packet);
+        HANDLE waits[3] = {shutdownEvent_.Get(), txEvent_.Get(), nullptr};
+        DWORD waitCount = 2;
+        if (outstanding > 0) {
+            waits[waitCount++] = writeSlots_[oldest].event.Get();
+        }
+
+        const DWORD wait = ::WaitForMultipleObjects(waitCount, waits, FALSE, INFINITE);
+        if (wait == WAIT_OBJECT_0 || wait == WAIT_FAILED) {
+            break;
+        }
+        if (wait == WAIT_OBJECT_0 + 2U) {
+            WriteSlot& slot = writeSlots_[oldest];
+            DWORD written = 0;
+            const BOOL ok = ::GetOverlappedResult(port_.Get(), &slot.overlapped, &written, FALSE);
+            TxQueue::Complete(slot.batch, ok == TRUE, written);
+            oldest = (oldest + 1U) % writeSlots_.size();
+            --outstanding;
         }
     }
 
+    cancelOutstanding();
     return 0;
 }
 
+void SerialPort::CancelPendingReads() {
+    for (auto& slot : readSlots_) {
+        if (!slot.pending) {
+            continue;
+        }
+
+        ::CancelIoEx(port_.Get(), &slot.overlapped);
+        DWORD ignored = 0;
+        ::GetOverlappedResult(port_.Get(), &slot.overlapped, &ignored, TRUE);
+        slot.pending = false;
+    }
+}
+
 } // namespace serial
@@ -1,50 +1,41 @@
 #pragma once
 
-#include <windows.h>
+#include "core/Platform.h"
 
 #include <atomic>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <span>
 #include <string>
 #include <thread>
 #include <vector>
 
+#include "serial/ModemMonitor.h"
+#include "serial/PortSettings.h"
+#include "serial/ReadTiming.h"
+#include "serial/TxQueue.h"
+#include "serial/VirtualDevice.h"
+
+#ifdef _WIN32
 #include "core/SafeHandle.h"
+#else
+#include "core/UniqueFd.h"
+#endif
 
 namespace serial {
 
-enum class ParityMode {
-    None,
-    Odd,
-    Even,
-    Mark,
-    Space
-};
-
-enum class StopBitsMode {
-    One,
-    OnePointFive,
-    Two
-};
-
-enum class FlowControlMode {
-    None,
-    Hardware,
-    Software
-};
-
-struct PortSettings {
-    DWORD baudRate;
-    BYTE dataBits;
-    ParityMode parity;
-    StopBitsMode stopBits;
-    FlowControlMode flowControl;
-    bool rts;
-    bool dtr;
-};
-
 class SerialPort final {
 public:
-    using DataCallback = std::function<void(const std::vector<uint8_t>&)>;
+    // timestampNs is core::MonotonicNanos() taken when the read path completed the chunk.
+    using DataCallback = std::function<void(std::span<const uint8_t> data, std::int64_t timestampNs)>;
+
+    static constexpr std::size_t kMaxTxQueuedBytes = 1U << 20U;
+    static constexpr std::size_t kMaxTxBatchBytes = 16U * 1024U;
+    static constexpr DWORD kMaxOutstandingWrites = 4;
+    static constexpr DWORD kMaxReadDepth = 64;
+    static constexpr DWORD kMinReadBufferSize = 64;
+    static constexpr DWORD kMaxReadBufferSize = 1U << 20U;
 
     SerialPort();
     ~SerialPort();
@@ -56,26 +47,76 @@ public:
     void Close();
     bool IsOpen() const noexcept;
     bool Write(const uint8_t* data, DWORD size, DWORD* writtenBytes);
+    bool WriteAsync(const uint8_t* data, DWORD size, WriteCallback done = {});
+    [[nodiscard]] std::size_t TxQueuedBytes() const;
+    [[nodiscard]] std::size_t TxQueuedRequests() const;
+    // Drops everything not yet on the line, from every writer, without waiting: the writer
+    // thread fails the queued requests, aborts the writes it has in the driver and flushes the
+    // driver's output buffer. Unlike Close() this also frees a line the peer holds with flow control.
+    void PurgeTx();
     bool GetModemStatus(DWORD* modemStatus);
     bool SetRts(bool enabled);
     bool SetDtr(bool enabled);
 
+    // Event-driven alternative to polling GetModemStatus(); stopped by Close().
+    bool StartModemMonitor(ModemMonitor::EventCallback onEvent = {});
+    void StopModemMonitor();
+    [[nodiscard]] const ModemEventLog& ModemEvents() const noexcept;
+
     void SetDataCallback(DataCallback callback);
 
 private:
+#ifdef _WIN32
+    struct ReadSlot {
+        OVERLAPPED overlapped;
+        core::SafeHandle event;
+        std::unique_ptr<uint8_t[]> buffer;
+        bool pending;
+    };
+
+    struct WriteSlot {
+        OVERLAPPED overlapped;
+        core::SafeHandle event;
+        TxBatch batch;
+    };
+
     static DWORD WINAPI ReadThreadProc(LPVOID param);
+    static DWORD WINAPI WriteThreadProc(LPVOID param);
     DWORD ReadThreadMain();
+    DWORD WriteThreadMain();
+    bool PostRead(ReadSlot& slot);
+    void CancelPendingReads();
 
     core::SafeHandle port_;
-    core::SafeHandle readEvent_;
-    core::SafeHandle writeEvent_;
+    core::SafeHandle txEvent_;
     core::SafeHandle shutdownEvent_;
     core::SafeHandle threadHandle_;
-
-    OVERLAPPED readOverlapped_;
-    OVERLAPPED writeOverlapped_;
+    core::SafeHandle writerHandle_;
+
+    std::vector<ReadSlot> readSlots_;
+    std::vector<WriteSlot> writeSlots_;
+#else
+    void ReadThreadMain();
+    void WriteThreadMain();
+    void Deliver(const uint8_t* data, std::size_t size, std::int64_t timestampNs);
+
+    core::UniqueFd port_;
+    core::UniqueFd epoll_;
+    core::UniqueFd shutdownEvent_;
+    core::UniqueFd txEvent_;
+    std::thread thread_;
+    std::thread writer_;
+    std::unique_ptr<uint8_t[]> readBuffer_;
+#endif
+    DWORD readDepth_;
+    DWORD readBufferSize_;
+    ReadTiming readTiming_;
     std::atomic<bool> running_;
+    std::atomic<bool> purgeTx_;
     DataCallback callback_;
+    TxQueue txQueue_;
+    ModemMonitor modemMonitor_;
+    std::unique_ptr<VirtualDevice> virtualDevice_; // Set while a "virtual:" port is open.
 };
 
 } // namespace serial
@@ -0,0 +1,364 @@
+#include "serial/SerialPort.h"
+
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <system_error>
+
+#include "core/Clock.h"
+#include "serial/SerialDevice.h"
+
+namespace {
+
+constexpr int kWriteTimeoutMs = 3000;
+
+void SignalEvent(int eventFd) {
+    const std::uint64_t one = 1;
+    [[maybe_unused]] const ssize_t ignored = ::write(eventFd, &one, sizeof(one));
+}
+
+void DrainEvent(int eventFd) {
+    std::uint64_t value = 0;
+    [[maybe_unused]] const ssize_t ignored = ::read(eventFd, &value, sizeof(value));
+}
+
+bool AddToEpoll(int epoll, int fd) {
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    return ::epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+
+} // namespace
+
+namespace serial {
+
+SerialPort::SerialPort()
+    : readDepth_(0),
+      readBufferSize_(0),
+      readTiming_{0, 1},
+      running_(false),
+      purgeTx_(false),
+      txQueue_(kMaxTxQueuedBytes, kMaxTxBatchBytes) {
+}
+
+SerialPort::~SerialPort() {
+    Close();
+}
+
+bool SerialPort::Open(const std::wstring& portName, const PortSettings& settings) {
+    Close();
+
+    const ReadGeometry geometry = MakeReadGeometry(settings);
+    if (IsVirtualPortName(portName)) {
+        TrafficSpec spec{};
+        virtualDevice_ = std::make_unique<VirtualDevice>();
+        if (!ParseVirtualPortName(portName, settings.baudRate, &spec) || !virtualDevice_->Start(spec)) {
+            Close();
+            return false;
+        }
+        port_ = virtualDevice_->OpenPortSide(settings, geometry.timing);
+    } else {
+        port_ = OpenSerialDevice(portName, settings, geometry.timing);
+    }
+    if (!port_.IsValid()) {
+        Close();
+        return false;
+    }
+
+    readDepth_ = geometry.depth;
+    readBufferSize_ = geometry.bufferSize;
+    readTiming_ = geometry.timing;
+    readBuffer_ = std::make_unique<uint8_t[]>(static_cast<std::size_t>(readDepth_) * readBufferSize_);
+
+    shutdownEvent_.Reset(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+    txEvent_.Reset(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+    epoll_.Reset(::epoll_create1(EPOLL_CLOEXEC));
+    if (!shutdownEvent_.IsValid() || !txEvent_.IsValid() || !epoll_.IsValid()) {
+        Close();
+        return false;
+    }
+
+    if (!AddToEpoll(epoll_.Get(), port_.Get()) || !AddToEpoll(epoll_.Get(), shutdownEvent_.Get())) {
+        Close();
+        return false;
+    }
+
+    running_.store(true);
+    txQueue_.Open();
+    try {
+        thread_ = std::thread(&SerialPort::ReadThreadMain, this);
+        writer_ = std::thread(&SerialPort::WriteThreadMain, this);
+    } catch (const std::system_error&) {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void SerialPort::Close() {
+    modemMonitor_.Stop();
+    const bool wasRunning = running_.exchange(false);
+    txQueue_.CloseAndFail();
+
+    if (wasRunning && shutdownEvent_.IsValid()) {
+        SignalEvent(shutdownEvent_.Get());
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+
+    epoll_.Reset();
+    txEvent_.Reset();
+    shutdownEvent_.Reset();
+    port_.Reset();
+    readBuffer_.reset();
+    virtualDevice_.reset();
+}
+
+bool SerialPort::IsOpen() const noexcept {
+    return running_.load() && port_.IsValid();
+}
+
+bool SerialPort::Write(const uint8_t* data, DWORD size, DWORD* writtenBytes) {
+    if (!IsOpen() || data == nullptr || size == 0 || writtenBytes == nullptr) {
+        return false;
+    }
+
+    *writtenBytes = 0;
+    const auto waiter = TxWaiter::Create();
+    if (!WriteAsync(data, size, waiter->Callback())) {
+        return false;
+    }
+    return waiter->Wait(std::chrono::milliseconds(kWriteTimeoutMs), writtenBytes);
+}
+
+bool SerialPort::WriteAsync(const uint8_t* data, DWORD size, WriteCallback done) {
+    if (!IsOpen() || data == nullptr || size == 0) {
+        return false;
+    }
+    if (!txQueue_.Push(data, size, std::move(done))) {
+        return false;
+    }
+    SignalEvent(txEvent_.Get());
+    return true;
+}
+
+std::size_t SerialPort::TxQueuedBytes() const {
+    return txQueue_.QueuedBytes();
+}
+
+std::size_t SerialPort::TxQueuedRequests() const {
+    return txQueue_.QueuedRequests();
+}
+
+void SerialPort::PurgeTx() {
+    if (!IsOpen()) {
+        return;
+    }
+    purgeTx_.store(true);
+    SignalEvent(txEvent_.Get());
+}
+
+bool SerialPort::GetModemStatus(DWORD* modemStatus) {
+    if (!IsOpen()) {
+        return false;
+    }
+    return GetModemLines(port_.Get(), modemStatus);
+}
+
+bool SerialPort::SetRts(bool enabled) {
+    if (!IsOpen()) {
+        return false;
+    }
+    return SetModemLine(port_.Get(), TIOCM_RTS, enabled);
+}
+
+bool SerialPort::SetDtr(bool enabled) {
+    if (!IsOpen()) {
+        return false;
+    }
+    return SetModemLine(port_.Get(), TIOCM_DTR, enabled);
+}
+
+bool SerialPort::StartModemMonitor(ModemMonitor::EventCallback onEvent) {
+    if (!IsOpen()) {
+        return false;
+    }
+    return modemMonitor_.Start(port_.Get(), std::move(onEvent));
+}
+
+void SerialPort::StopModemMonitor() {
+    modemMonitor_.Stop();
+}
+
+const ModemEventLog& SerialPort::ModemEvents() const noexcept {
+    return modemMonitor_.Events();
+}
+
+void SerialPort::SetDataCallback(DataCallback callback) {
+    callback_ = std::move(callback);
+}
+
+void SerialPort::ReadThreadMain() {
+    // Reads accumulate in readBuffer_ (readDepth_ buffers of readBufferSize_ back to back). With a
+    // gap configured the thread sleeps gapMs between reads instead of waking per byte, and delivers
+    // once minChunkBytes are collected or a sleep brings nothing new - VMIN/VTIME at 1 ms resolution.
+    uint8_t* const buffer = readBuffer_.get();
+    const std::size_t capacity = static_cast<std::size_t>(readDepth_) * readBufferSize_;
+    std::size_t filled = 0;
+
+    std::array<epoll_event, 2> events{};
+
+    while (running_.load()) {
+        if (filled == 0) {
+            const int ready = ::epoll_wait(epoll_.Get(), events.data(), static_cast<int>(events.size()), -1);
+            if (ready < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+
+            bool portReadable = false;
+            bool portFailed = false;
+            for (int i = 0; i < ready; ++i) {
+                if (events[i].data.fd == shutdownEvent_.Get()) {
+                    return;
+                }
+                if ((events[i].events & EPOLLIN) != 0) {
+                    portReadable = true;
+                } else if ((events[i].events & (EPOLLERR | EPOLLHUP)) != 0) {
+                    portFailed = true;
+                }
+            }
+
+            if (!portReadable) {
+                if (portFailed) {
+                    break;
+                }
+                continue;
+            }
+        } else {
+            pollfd shutdown{shutdownEvent_.Get(), POLLIN, 0};
+            if (::poll(&shutdown, 1, static_cast<int>(readTiming_.gapMs)) > 0) {
+                return;
+            }
+        }
+
+        const ssize_t readBytes = ::read(port_.Get(), buffer + filled, capacity - filled);
+        bool idle = false;
+        if (readBytes > 0) {
+            filled += static_cast<std::size_t>(readBytes);
+        } else if (readBytes < 0 && errno == EINTR) {
+            continue;
+        } else if (readBytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            idle = true;
+        } else {
+            Deliver(buffer, filled, core::MonotonicNanos());
+            break;
+        }
+
+        if (filled != 0 && (idle || filled >= readTiming_.minChunkBytes || filled == capacity)) {
+            Deliver(buffer, filled, core::MonotonicNanos());
+            filled = 0;
+        }
+    }
+}
+
+void SerialPort::Deliver(const uint8_t* data, std::size_t size, std::int64_t timestampNs) {
+    if (!callback_) {
+        return;
+    }
+
+    // Hand the chunk over in readBufferSize_ pieces, as the Windows read slots do.
+    for (std::size_t offset = 0; offset < size; offset += readBufferSize_) {
+        const std::size_t piece = std::min<std::size_t>(size - offset, readBufferSize_);
+        callback_(std::span<const uint8_t>(data + offset, piece), timestampNs);
+    }
+}
+
+void SerialPort::WriteThreadMain() {
+    // The port is nonblocking, so one batch is kept in flight and the thread sleeps in poll()
+    // until the driver has room for the rest, new requests arrive or the port is closed.
+    TxBatch batch;
+    std::size_t offset = 0;
+    bool pending = false;
+
+    while (running_.load()) {
+        if (purgeTx_.exchange(false)) {
+            txQueue_.FailQueued();
+            ::tcflush(port_.Get(), TCOFLUSH);
+            if (pending) {
+                TxQueue::Complete(batch, false, offset);
+                pending = false;
+            }
+        }
+
+        if (!pending && txQueue_.PopBatch(&batch)) {
+            pending = true;
+            offset = 0;
+        }
+
+        if (pending) {
+            const ssize_t written = ::write(port_.Get(), batch.data.data() + offset, batch.data.size() - offset);
+            if (written > 0) {
+                offset += static_cast<std::size_t>(written);
+                if (offset == batch.data.size()) {
+                    TxQueue::Complete(batch, true, offset);
+                    pending = false;
+                }
+                continue;
+            }
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                TxQueue::Complete(batch, false, offset);
+                pending = false;
+                continue;
+            }
+        }
+
+        pollfd waits[3] = {
+            {shutdownEvent_.Get(), POLLIN, 0},
+            {txEvent_.Get(), POLLIN, 0},
+            {port_.Get(), POLLOUT, 0},
+        };
+        const int ready = ::poll(waits, pending ? 3 : 2, -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if ((waits[0].revents & POLLIN) != 0) {
+            break;
+        }
+        if ((waits[1].revents & POLLIN) != 0) {
+            DrainEvent(txEvent_.Get());
+        }
+        if (pending && (waits[2].revents & (POLLERR | POLLHUP)) != 0) {
+            TxQueue::Complete(batch, false, offset);
+            pending = false;
+        }
+    }
+
+    if (pending) {
+        TxQueue::Complete(batch, false, offset);
+    }
+}
+
+} // namespace serial
@@ -0,0 +1,241 @@
+#include "serial/TrafficGenerator.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cwctype>
+#include <string_view>
+
+namespace {
+
+constexpr std::wstring_view kVirtualPrefix = L"virtual:";
+constexpr std::int64_t kNanosPerSecond = 1000000000;
+constexpr std::int64_t kMaxBacklogNs = kNanosPerSecond / 10;
+constexpr std::uint32_t kBurstyBytes = 4096;
+constexpr std::uint32_t kBurstyGapMs = 20;
+constexpr std::uint32_t kMinLineLength = 12;
+constexpr char kLineFiller[] = "The quick brown fox jumps over the lazy dog. ";
+
+std::wstring Lowercase(std::wstring_view text) {
+    std::wstring result(text);
+    for (wchar_t& ch : result) {
+        ch = static_cast<wchar_t>(std::towlower(ch));
+    }
+    return result;
+}
+
+bool ParseNumber(std::wstring_view text, std::uint64_t* value) {
+    if (text.empty() || text.size() > 19) {
+        return false;
+    }
+    std::uint64_t result = 0;
+    for (const wchar_t ch : text) {
+        if (ch < L'0' || ch > L'9') {
+            return false;
+        }
+        result = result * 10U + static_cast<std::uint64_t>(ch - L'0');
+    }
+    *value = result;
+    return true;
+}
+
+} // namespace
+
+namespace serial {
+
+bool IsVirtualPortName(const std::wstring& portName) {
+    return portName.size() >= kVirtualPrefix.size() &&
+           Lowercase(std::wstring_view(portName).substr(0, kVirtualPrefix.size())) == kVirtualPrefix;
+}
+
+bool ParseVirtualPortName(const std::wstring& portName, DWORD baudRate, TrafficSpec* spec) {
+    if (spec == nullptr || !IsVirtualPortName(portName)) {
+        return false;
+    }
+
+    TrafficSpec result{};
+    result.bytesPerSecond = std::max<std::uint64_t>(baudRate / 10U, 1U);
+
+    const std::wstring options = Lowercase(std::wstring_view(portName).substr(kVirtualPrefix.size()));
+    std::wstring_view rest = options;
+    bool first = true;
+    while (!rest.empty() || first) {
+        const std::size_t comma = rest.find(L',');
+        const std::wstring_view item = rest.substr(0, comma);
+        rest = (comma == std::wstring_view::npos) ? std::wstring_view{} : rest.substr(comma + 1U);
+
+        if (first) {
+            first = false;
+            if (item == L"echo") {
+                result.pattern = TrafficPattern::Echo;
+            } else if (item == L"text" || item.empty()) {
+                result.pattern = TrafficPattern::Text;
+            } else if (item == L"random") {
+                result.pattern = TrafficPattern::Random;
+            } else if (item == L"prbs") {
+                result.pattern = TrafficPattern::Prbs;
+            } else if (item == L"bursty") {
+                result.pattern = TrafficPattern::Random;
+                result.burstBytes = kBurstyBytes;
+                result.gapMs = kBurstyGapMs;
+            } else {
+                return false;
+            }
+            continue;
+        }
+
+        const std::size_t equals = item.find(L'=');
+        std::uint64_t value = 0;
+        if (equals == std::wstring_view::npos || !ParseNumber(item.substr(equals + 1U), &value)) {
+            return false;
+        }
+        const std::wstring_view key = item.substr(0, equals);
+        if (key == L"rate" && value > 0) {
+            result.bytesPerSecond = value;
+        } else if (key == L"burst" && value <= UINT32_MAX) {
+            result.burstBytes = static_cast<std::uint32_t>(value);
+        } else if (key == L"gap" && value <= UINT32_MAX) {
+            result.gapMs = static_cast<std::uint32_t>(value);
+        } else if (key == L"line" && value >= kMinLineLength && value <= UINT32_MAX) {
+            result.lineLength = static_cast<std::uint32_t>(value);
+        } else if (key == L"seed" && value <= UINT32_MAX) {
+            result.seed = static_cast<std::uint32_t>(value);
+        } else {
+            return false;
+        }
+    }
+
+    *spec = result;
+    return true;
+}
+
+TrafficGenerator::TrafficGenerator(const TrafficSpec& spec)
+    : pattern_(spec.pattern),
+      random_(0x9E3779B97F4A7C15ULL ^ spec.seed),
+      prbs_((spec.seed & 0x7FFFFFFFU) != 0 ? (spec.seed & 0x7FFFFFFFU) : 1U),
+      line_(std::max(spec.lineLength, kMinLineLength)),
+      lineOffset_(line_.size()),
+      lineNumber_(0) {
+}
+
+void TrafficGenerator::Fill(std::span<uint8_t> out) {
+    switch (pattern_) {
+    case TrafficPattern::Echo:
+        std::fill(out.begin(), out.end(), uint8_t{0});
+        break;
+
+    case TrafficPattern::Text:
+        for (std::size_t offset = 0; offset < out.size();) {
+            if (lineOffset_ == line_.size()) {
+                NextLine();
+            }
+            const std::size_t chunk = std::min(out.size() - offset, line_.size() - lineOffset_);
+            std::copy_n(line_.begin() + static_cast<std::ptrdiff_t>(lineOffset_), chunk, out.begin() + static_cast<std::ptrdiff_t>(offset));
+            lineOffset_ += chunk;
+            offset += chunk;
+        }
+        break;
+
+    case TrafficPattern::Random:
+        // One xorshift64* step per byte keeps the stream independent of how Fill() is called.
+        for (uint8_t& byte : out) {
+            random_ ^= random_ >> 12U;
+            random_ ^= random_ << 25U;
+            random_ ^= random_ >> 27U;
+            byte = static_cast<uint8_t>((random_ * 0x2545F4914F6CDD1DULL) >> 56U);
+        }
+        break;
+
+    case TrafficPattern::Prbs:
+        for (uint8_t& byte : out) {
+            uint8_t value = 0;
+            for (unsigned bit = 0; bit < 8; ++bit) {
+                const std::uint32_t next = ((prbs_ >> 30U) ^ (prbs_ >> 27U)) & 1U;
+                prbs_ = ((prbs_ << 1U) | next) & 0x7FFFFFFFU;
+                value = static_cast<uint8_t>(value | (next << bit));
+            }
+            byte = value;
+        }
+        break;
+    }
+}
+
+void TrafficGenerator::NextLine() {
+    // "00000042 The quick brown fox...\r\n", padded with the filler to exactly lineLength bytes.
+    char number[16] = {};
+    std::snprintf(number, sizeof(number), "%08llu ", static_cast<unsigned long long>(lineNumber_ % 100000000ULL));
+    ++lineNumber_;
+
+    const std::size_t body = line_.size() - 2U;
+    std::size_t i = 0;
+    for (; i < body && number[i] != '\0'; ++i) {
+        line_[i] = static_cast<uint8_t>(number[i]);
+    }
+    for (std::size_t filler = 0; i < body; ++i, ++filler) {
+        line_[i] = static_cast<uint8_t>(kLineFiller[filler % (sizeof(kLineFiller) - 1U)]);
+    }
+    line_[body] = '\r';
+    line_[body + 1U] = '\n';
+    lineOffset_ = 0;
+}
+
+TrafficPacer::TrafficPacer(const TrafficSpec& spec, std::int64_t nowNs)
+    : bytesPerSecond_(std::max<std::uint64_t>(spec.bytesPerSecond, 1U)),
+      burstBytes_(spec.burstBytes),
+      gapNs_(static_cast<std::int64_t>(spec.gapMs) * 1000000),
+      burstStart_(nowNs),
+      sentInBurst_(0) {
+}
+
+std::size_t TrafficPacer::Budget(std::int64_t nowNs) const noexcept {
+    const std::uint64_t allowed = Allowed(nowNs);
+    return (allowed > sentInBurst_) ? static_cast<std::size_t>(allowed - sentInBurst_) : 0U;
+}
+
+void TrafficPacer::Consume(std::size_t bytes, std::int64_t nowNs) noexcept {
+    sentInBurst_ += bytes;
+    if (burstBytes_ != 0 && sentInBurst_ >= burstBytes_) {
+        burstStart_ = nowNs + gapNs_;
+        sentInBurst_ = 0;
+        return;
+    }
+
+    // A sender more than kMaxBacklogNs behind (receiver not draining) restarts the schedule
+    // instead of flooding the receiver with the whole backlog afterwards.
+    const std::uint64_t maxBacklog = bytesPerSecond_ * kMaxBacklogNs / kNanosPerSecond;
+    if (burstBytes_ == 0 && Allowed(nowNs) > sentInBurst_ + maxBacklog) {
+        burstStart_ = nowNs - kMaxBacklogNs;
+        sentInBurst_ = 0;
+    }
+}
+
+std::int64_t TrafficPacer::WaitNs(std::int64_t nowNs) const noexcept {
+    if (Budget(nowNs) > 0) {
+        return 0;
+    }
+    if (nowNs < burstStart_) {
+        return burstStart_ - nowNs;
+    }
+    // Time at which the next byte becomes due, split like Allowed() so bytes * 1e9 cannot overflow.
+    const std::uint64_t bytes = sentInBurst_ + 1U;
+    const std::uint64_t seconds = bytes / bytesPerSecond_;
+    const std::uint64_t remainder = bytes % bytesPerSecond_;
+    const auto due = static_cast<std::int64_t>(seconds * kNanosPerSecond + remainder * kNanosPerSecond / bytesPerSecond_);
+    return std::max<std::int64_t>(burstStart_ + due - nowNs, 1);
+}
+
+std::uint64_t TrafficPacer::Allowed(std::int64_t nowNs) const noexcept {
+    if (nowNs <= burstStart_) {
+        return 0;
+    }
+    const auto elapsed = static_cast<std::uint64_t>(nowNs - burstStart_);
+    // Split to keep elapsed * rate from overflowing on long runs.
+    const std::uint64_t seconds = elapsed / kNanosPerSecond;
+    const std::uint64_t remainder = elapsed % kNanosPerSecond;
+    std::uint64_t allowed = seconds * bytesPerSecond_ + remainder * bytesPerSecond_ / kNanosPerSecond;
+    if (burstBytes_ != 0) {
+        allowed = std::min(allowed, burstBytes_);
+    }
+    return allowed;
+}
+
+} // namespace serial
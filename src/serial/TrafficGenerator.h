@@ -0,0 +1,75 @@
+#pragma once
+
+#include "core/Platform.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace serial {
+
+enum class TrafficPattern {
+    Echo,   // Nothing generated, the device only loops TX back.
+    Text,   // Numbered ASCII lines ending in CR LF.
+    Random, // xorshift64* bytes.
+    Prbs    // PRBS-31 (x^31 + x^28 + 1) bit stream, LSB first.
+};
+
+struct TrafficSpec {
+    TrafficPattern pattern = TrafficPattern::Text;
+    std::uint64_t bytesPerSecond = 0; // Line rate; also the rate inside a burst.
+    std::uint32_t burstBytes = 0;     // 0: continuous stream.
+    std::uint32_t gapMs = 0;          // Silence after each burst.
+    std::uint32_t lineLength = 64;    // Text lines, including CR LF.
+    std::uint32_t seed = 1;
+};
+
+// Port names of the form "virtual:<pattern>[,rate=N][,burst=N][,gap=MS][,line=N][,seed=N]".
+// Patterns are echo, text, random, prbs and bursty (random in 4 KiB bursts with 20 ms gaps).
+// Without rate= the device runs at the 8N1 rate of baudRate.
+bool IsVirtualPortName(const std::wstring& portName);
+bool ParseVirtualPortName(const std::wstring& portName, DWORD baudRate, TrafficSpec* spec);
+
+// Deterministic byte stream for a spec: two generators built from the same spec produce the same
+// bytes however the output is split into Fill() calls, so a receiver can verify what it got.
+class TrafficGenerator final {
+public:
+    explicit TrafficGenerator(const TrafficSpec& spec);
+
+    void Fill(std::span<uint8_t> out);
+
+private:
+    void NextLine();
+
+    TrafficPattern pattern_;
+    std::uint64_t random_;
+    std::uint32_t prbs_;
+    std::vector<uint8_t> line_;
+    std::size_t lineOffset_;
+    std::uint64_t lineNumber_;
+};
+
+// Spends a byte budget at spec.bytesPerSecond, in bursts when spec.burstBytes is set.
+// Times are core::MonotonicNanos() values.
+class TrafficPacer final {
+public:
+    TrafficPacer(const TrafficSpec& spec, std::int64_t nowNs);
+
+    [[nodiscard]] std::size_t Budget(std::int64_t nowNs) const noexcept;
+    void Consume(std::size_t bytes, std::int64_t nowNs) noexcept;
+    // How long to sleep before Budget() can be non-zero again.
+    [[nodiscard]] std::int64_t WaitNs(std::int64_t nowNs) const noexcept;
+
+private:
+    [[nodiscard]] std::uint64_t Allowed(std::int64_t nowNs) const noexcept;
+
+    std::uint64_t bytesPerSecond_;
+    std::uint64_t burstBytes_;
+    std::int64_t gapNs_;
+    std::int64_t burstStart_;
+    std::uint64_t sentInBurst_;
+};
+
+} // namespace serial
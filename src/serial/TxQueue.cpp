@@ -0,0 +1,134 @@
+#include "serial/TxQueue.h"
+
+#include <algorithm>
+
+namespace serial {
+
+TxQueue::TxQueue(std::size_t maxQueuedBytes, std::size_t maxBatchBytes)
+    : maxQueuedBytes_(maxQueuedBytes),
+      maxBatchBytes_(maxBatchBytes),
+      queuedBytes_(0),
+      open_(false) {
+}
+
+bool TxQueue::Push(const uint8_t* data, std::size_t size, WriteCallback done) {
+    if (data == nullptr || size == 0U) {
+        return false;
+    }
+
+    Request request{std::vector<uint8_t>(data, data + size), std::move(done)};
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!open_) {
+        return false;
+    }
+    // An oversized request is still accepted into an empty queue, otherwise it could never be sent.
+    if (queuedBytes_ != 0U && queuedBytes_ + size > maxQueuedBytes_) {
+        return false;
+    }
+
+    queuedBytes_ += size;
+    requests_.push_back(std::move(request));
+    return true;
+}
+
+bool TxQueue::PopBatch(TxBatch* batch) {
+    batch->data.clear();
+    batch->parts.clear();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (!requests_.empty()) {
+        Request& request = requests_.front();
+        if (!batch->parts.empty() && batch->data.size() + request.data.size() > maxBatchBytes_) {
+            break;
+        }
+
+        batch->data.insert(batch->data.end(), request.data.begin(), request.data.end());
+        batch->parts.push_back(TxBatch::Part{static_cast<DWORD>(request.data.size()), std::move(request.done)});
+        queuedBytes_ -= request.data.size();
+        requests_.pop_front();
+    }
+    return !batch->parts.empty();
+}
+
+void TxQueue::Complete(TxBatch& batch, bool ok, std::size_t writtenBytes) {
+    std::size_t remaining = writtenBytes;
+    for (auto& part : batch.parts) {
+        const auto written = static_cast<DWORD>(std::min<std::size_t>(remaining, part.size));
+        remaining -= written;
+        if (part.done) {
+            part.done(ok && written == part.size, written);
+        }
+    }
+    batch.parts.clear();
+}
+
+void TxQueue::Open() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    open_ = true;
+}
+
+void TxQueue::CloseAndFail() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        open_ = false;
+    }
+    FailQueued();
+}
+
+void TxQueue::FailQueued() {
+    std::deque<Request> dropped;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dropped.swap(requests_);
+        queuedBytes_ = 0;
+    }
+
+    for (auto& request : dropped) {
+        if (request.done) {
+            request.done(false, 0);
+        }
+    }
+}
+
+std::size_t TxQueue::QueuedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queuedBytes_;
+}
+
+std::size_t TxQueue::QueuedRequests() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return requests_.size();
+}
+
+std::size_t TxQueue::MaxQueuedBytes() const noexcept {
+    return maxQueuedBytes_;
+}
+
+std::shared_ptr<TxWaiter> TxWaiter::Create() {
+    return std::make_shared<TxWaiter>();
+}
+
+WriteCallback TxWaiter::Callback() {
+    // The callback keeps the waiter alive in case Wait() already gave up.
+    return [self = shared_from_this()](bool ok, DWORD writtenBytes) {
+        std::lock_guard<std::mutex> lock(self->mutex_);
+        self->finished_ = true;
+        self->ok_ = ok;
+        self->written_ = writtenBytes;
+        self->done_.notify_all();
+    };
+}
+
+bool TxWaiter::Wait(std::chrono::milliseconds timeout, DWORD* writtenBytes) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!done_.wait_for(lock, timeout, [this] { return finished_; })) {
+        return false;
+    }
+    if (writtenBytes != nullptr) {
+        *writtenBytes = written_;
+    }
+    return ok_;
+}
+
+} // namespace serial
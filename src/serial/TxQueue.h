@@ -0,0 +1,84 @@
+#pragma once
+
+#include "core/Platform.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace serial {
+
+using WriteCallback = std::function<void(bool ok, DWORD writtenBytes)>;
+
+// A run of queued writes merged into one contiguous buffer for a single WriteFile/write call.
+struct TxBatch {
+    struct Part {
+        DWORD size;
+        WriteCallback done;
+    };
+
+    std::vector<uint8_t> data;
+    std::vector<Part> parts;
+};
+
+// Bounded, thread-safe transmit queue. Producers enqueue without blocking, the port's writer
+// thread pops merged batches and reports completion back per request.
+class TxQueue final {
+public:
+    TxQueue(std::size_t maxQueuedBytes, std::size_t maxBatchBytes);
+
+    TxQueue(const TxQueue&) = delete;
+    TxQueue& operator=(const TxQueue&) = delete;
+
+    // Returns false when the request does not fit (backpressure) or the queue is closed.
+    bool Push(const uint8_t* data, std::size_t size, WriteCallback done);
+    bool PopBatch(TxBatch* batch);
+    static void Complete(TxBatch& batch, bool ok, std::size_t writtenBytes);
+
+    void Open();
+    void CloseAndFail();
+    // Fails every queued request but stays open.
+    void FailQueued();
+
+    [[nodiscard]] std::size_t QueuedBytes() const;
+    [[nodiscard]] std::size_t QueuedRequests() const;
+    [[nodiscard]] std::size_t MaxQueuedBytes() const noexcept;
+
+private:
+    struct Request {
+        std::vector<uint8_t> data;
+        WriteCallback done;
+    };
+
+    std::size_t maxQueuedBytes_;
+    std::size_t maxBatchBytes_;
+
+    mutable std::mutex mutex_;
+    std::deque<Request> requests_;
+    std::size_t queuedBytes_;
+    bool open_;
+};
+
+// Turns an asynchronous write into a blocking one: pass Callback() to WriteAsync, then Wait().
+class TxWaiter final : public std::enable_shared_from_this<TxWaiter> {
+public:
+    static std::shared_ptr<TxWaiter> Create();
+
+    [[nodiscard]] WriteCallback Callback();
+    bool Wait(std::chrono::milliseconds timeout, DWORD* writtenBytes);
+
+private:
+    std::mutex mutex_;
+    std::condition_variable done_;
+    bool finished_ = false;
+    bool ok_ = false;
+    DWORD written_ = 0;
+};
+
+} // namespace serial
@@ -0,0 +1,242 @@
+#include "serial/TxScheduler.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <system_error>
+
+#include "core/Clock.h"
+
+namespace serial {
+
+TxScheduler::TxScheduler(SerialPort& port, std::int64_t charTimeNs)
+    : port_(port),
+      charTimeNs_(std::max<std::int64_t>(charTimeNs, 0)),
+      running_(false),
+      busy_(false),
+      writeDone_(false),
+      writeOk_(false),
+      writeDoneNs_(0),
+      releases_(0),
+      failedWrites_(0),
+      errorSumNs_(0),
+      maxErrorNs_(0),
+      histogram_{} {}
+
+TxScheduler::~TxScheduler() {
+    Stop();
+}
+
+std::int64_t TxScheduler::CharTimeNs(const PortSettings& settings) {
+    if (settings.baudRate == 0) {
+        return 0;
+    }
+    double bits = 1.0 + settings.dataBits + (settings.parity == ParityMode::None ? 0.0 : 1.0);
+    switch (settings.stopBits) {
+    case StopBitsMode::One:
+        bits += 1.0;
+        break;
+    case StopBitsMode::OnePointFive:
+        bits += 1.5;
+        break;
+    case StopBitsMode::Two:
+        bits += 2.0;
+        break;
+    }
+    return std::llround(bits * 1e9 / settings.baudRate);
+}
+
+bool TxScheduler::Start(ReleaseCallback onRelease) {
+    Stop();
+    if (!timer_.IsValid()) {
+        return false;
+    }
+
+    onRelease_ = std::move(onRelease);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = true;
+    }
+    try {
+        thread_ = std::thread(&TxScheduler::ThreadMain, this);
+    } catch (const std::system_error&) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+        return false;
+    }
+    return true;
+}
+
+void TxScheduler::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+        frames_.clear();
+    }
+    timer_.Interrupt();
+    changed_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    timer_.ClearInterrupt();
+}
+
+bool TxScheduler::Enqueue(PacedFrame frame) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return false;
+        }
+        frames_.push_back(std::move(frame));
+    }
+    changed_.notify_all();
+    return true;
+}
+
+std::size_t TxScheduler::PendingFrames() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return frames_.size() + (busy_ ? 1U : 0U);
+}
+
+bool TxScheduler::WaitIdle(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return changed_.wait_for(lock, timeout, [this] { return !running_ || (frames_.empty() && !busy_); });
+}
+
+PacingStats TxScheduler::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PacingStats stats;
+    stats.releases = releases_;
+    stats.failedWrites = failedWrites_;
+    stats.maxErrorNs = maxErrorNs_;
+    if (releases_ == 0) {
+        return stats;
+    }
+    stats.meanErrorNs = errorSumNs_ / static_cast<std::int64_t>(releases_);
+
+    const auto percentile = [this](std::uint64_t rank) {
+        std::uint64_t seen = 0;
+        for (std::size_t bucket = 0; bucket < histogram_.size(); ++bucket) {
+            seen += histogram_[bucket];
+            if (seen >= rank) {
+                return bucket == 0 ? std::int64_t{0} : std::min((std::int64_t{1} << bucket) - 1, maxErrorNs_);
+            }
+        }
+        return maxErrorNs_;
+    };
+    stats.p50ErrorNs = percentile((releases_ + 1U) / 2U);
+    stats.p99ErrorNs = percentile(releases_ - releases_ / 100U);
+    return stats;
+}
+
+void TxScheduler::ResetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    releases_ = 0;
+    failedWrites_ = 0;
+    errorSumNs_ = 0;
+    maxErrorNs_ = 0;
+    histogram_.fill(0);
+}
+
+void TxScheduler::ThreadMain() {
+    std::uint64_t frameNumber = 0;
+    // When the line is free again: end of the previous write on the wire, or its completion if
+    // the port accepted it later than that (flow control, full driver buffer). Without a char
+    // time the completion is ignored too, delays then count from the previous release.
+    std::int64_t lineFreeNs = 0;
+
+    for (;;) {
+        PacedFrame frame;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            changed_.wait(lock, [this] { return !running_ || !frames_.empty(); });
+            if (!running_) {
+                break;
+            }
+            frame = std::move(frames_.front());
+            frames_.pop_front();
+            busy_ = true;
+        }
+
+        // An idle line has already waited out the delay.
+        std::int64_t dueNs = std::max(lineFreeNs + frame.delayNs, core::MonotonicNanos());
+        bool interrupted = false;
+        if (frame.data.empty()) {
+            interrupted = !timer_.WaitUntil(dueNs);
+            lineFreeNs = dueNs;
+        }
+
+        const std::size_t step = (frame.interByteNs > 0) ? 1U : frame.data.size();
+        for (std::size_t offset = 0; offset < frame.data.size() && !interrupted; offset += step) {
+            if (offset > 0) {
+                dueNs += frame.interByteNs;
+            }
+            const std::size_t size = std::min(step, frame.data.size() - offset);
+            std::int64_t releasedNs = 0;
+            if (!Release(frame.data.data() + offset, size, dueNs, &releasedNs)) {
+                interrupted = true;
+                break;
+            }
+            lineFreeNs = releasedNs + static_cast<std::int64_t>(size) * charTimeNs_;
+            if (charTimeNs_ > 0) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                lineFreeNs = std::max(lineFreeNs, writeDoneNs_);
+            }
+            if (onRelease_) {
+                onRelease_(PacedRelease{frameNumber, offset, size, dueNs, releasedNs});
+            }
+        }
+        ++frameNumber;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            busy_ = false;
+        }
+        changed_.notify_all();
+        if (interrupted) {
+            break;
+        }
+    }
+}
+
+bool TxScheduler::Release(const uint8_t* data, std::size_t size, std::int64_t dueNs, std::int64_t* releasedNs) {
+    if (!timer_.WaitUntil(dueNs)) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        writeDone_ = false;
+    }
+    *releasedNs = core::MonotonicNanos();
+    const bool queued = port_.WriteAsync(data, static_cast<DWORD>(size), [this](bool ok, DWORD) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            writeDone_ = true;
+            writeOk_ = ok;
+            writeDoneNs_ = core::MonotonicNanos();
+        }
+        changed_.notify_all();
+    });
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (queued) {
+        // Even when stopping: the callback still references this object, so it has to come
+        // back first. Closing the port completes it.
+        changed_.wait(lock, [this] { return writeDone_; });
+    } else {
+        writeOk_ = false;
+        writeDoneNs_ = *releasedNs;
+    }
+
+    const std::int64_t errorNs = std::max<std::int64_t>(*releasedNs - dueNs, 0);
+    ++releases_;
+    failedWrites_ += writeOk_ ? 0U : 1U;
+    errorSumNs_ += errorNs;
+    maxErrorNs_ = std::max(maxErrorNs_, errorNs);
+    const auto bucket = static_cast<std::size_t>(std::bit_width(static_cast<std::uint64_t>(errorNs)));
+    ++histogram_[std::min(bucket, kHistogramBuckets - 1U)];
+    return true;
+}
+
+} // namespace serial
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "core/PreciseTimer.h"
+#include "serial/SerialPort.h"
+
+namespace serial {
+
+struct PacedFrame {
+    std::vector<uint8_t> data;
+    // Idle time before this frame, counted from the end of the previous frame on the wire.
+    std::int64_t delayNs = 0;
+    // 0 sends the frame in one write; otherwise each byte is written on its own, this far apart
+    // (start to start).
+    std::int64_t interByteNs = 0;
+};
+
+// One write the scheduler released: when it was due and when it actually went to the port.
+struct PacedRelease {
+    std::uint64_t frame;     // Sequence number of the frame since Start().
+    std::size_t offset;      // First byte of the frame in this write.
+    std::size_t size;
+    std::int64_t dueNs;      // core::MonotonicNanos() timeline.
+    std::int64_t releasedNs;
+};
+
+// Release error (released - due) across all writes since Start() or ResetStats().
+struct PacingStats {
+    std::uint64_t releases = 0;
+    std::uint64_t failedWrites = 0;
+    std::int64_t meanErrorNs = 0;
+    std::int64_t maxErrorNs = 0;
+    // Upper bounds of the power-of-two histogram buckets holding the percentile, capped at the max.
+    std::int64_t p50ErrorNs = 0;
+    std::int64_t p99ErrorNs = 0;
+};
+
+// Transmits queued frames with precise gaps between frames or between bytes. Release times come
+// from core::PreciseTimer rather than Sleep(), and each write waits for the previous one to be
+// accepted by the port, so a gap is never shortened by data still sitting in the TxQueue.
+class TxScheduler final {
+public:
+    using ReleaseCallback = std::function<void(const PacedRelease& release)>;
+
+    // charTimeNs is the wire time of one character (see CharTimeNs()); 0 ignores wire time and
+    // counts delays from the write of the previous frame.
+    TxScheduler(SerialPort& port, std::int64_t charTimeNs);
+    ~TxScheduler();
+
+    TxScheduler(const TxScheduler&) = delete;
+    TxScheduler& operator=(const TxScheduler&) = delete;
+
+    // Wire time of one character for the settings: start, data, parity and stop bits at baudRate.
+    static std::int64_t CharTimeNs(const PortSettings& settings);
+
+    // onRelease runs on the scheduler thread after every write.
+    bool Start(ReleaseCallback onRelease = {});
+    // Drops frames that have not started and waits for the thread.
+    void Stop();
+    bool Enqueue(PacedFrame frame);
+    [[nodiscard]] std::size_t PendingFrames() const;
+    // Waits until every queued frame has been written; false on timeout.
+    bool WaitIdle(std::chrono::milliseconds timeout);
+
+    [[nodiscard]] PacingStats Stats() const;
+    void ResetStats();
+
+private:
+    static constexpr std::size_t kHistogramBuckets = 48;
+
+    void ThreadMain();
+    bool Release(const uint8_t* data, std::size_t size, std::int64_t dueNs, std::int64_t* releasedNs);
+
+    SerialPort& port_;
+    std::int64_t charTimeNs_;
+    core::PreciseTimer timer_;
+    ReleaseCallback onRelease_;
+    std::thread thread_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    std::deque<PacedFrame> frames_;
+    bool running_;
+    bool busy_;               // A frame is being transmitted.
+    bool writeDone_;
+    bool writeOk_;
+    std::int64_t writeDoneNs_;
+
+    std::uint64_t releases_;
+    std::uint64_t failedWrites_;
+    std::int64_t errorSumNs_;
+    std::int64_t maxErrorNs_;
+    std::array<std::uint64_t, kHistogramBuckets> histogram_;
+};
+
+} // namespace serial
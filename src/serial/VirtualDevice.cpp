@@ -0,0 +1,234 @@
+#include "serial/VirtualDevice.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "core/Clock.h"
+
+namespace {
+
+constexpr std::size_t kMaxChunkBytes = 16U * 1024U;
+constexpr std::size_t kMaxEchoBytes = 256U * 1024U;
+constexpr DWORD kPipeBufferBytes = 64U * 1024U;
+
+DWORD ToWaitTimeoutMs(std::int64_t waitNs) {
+    if (waitNs <= 0) {
+        return 0;
+    }
+    return static_cast<DWORD>(std::min<std::int64_t>((waitNs + 999999) / 1000000, 1000));
+}
+
+std::wstring MakePipeName() {
+    static std::atomic<unsigned> counter{0};
+    return L"\\\\.\\pipe\\COMTerminal-virtual-" + std::to_wstring(::GetCurrentProcessId()) + L"-" +
+           std::to_wstring(counter.fetch_add(1U));
+}
+
+} // namespace
+
+namespace serial {
+
+VirtualDevice::VirtualDevice() : running_(false), generated_(0), echoed_(0) {}
+
+VirtualDevice::~VirtualDevice() {
+    Stop();
+}
+
+bool VirtualDevice::Start(const TrafficSpec& spec) {
+    Stop();
+
+    pipeName_ = MakePipeName();
+    HANDLE rawPipe = ::CreateNamedPipeW(
+        pipeName_.c_str(),
+        PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE,
+        PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+        1,
+        kPipeBufferBytes,
+        kPipeBufferBytes,
+        0,
+        nullptr);
+    if (rawPipe == INVALID_HANDLE_VALUE) {
+        Stop();
+        return false;
+    }
+    pipe_.Reset(rawPipe);
+
+    HANDLE rawStopEvent = ::CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (rawStopEvent == nullptr) {
+        Stop();
+        return false;
+    }
+    stopEvent_.Reset(rawStopEvent);
+
+    spec_ = spec;
+    generated_.store(0);
+    echoed_.store(0);
+
+    running_.store(true);
+    HANDLE rawThread = ::CreateThread(nullptr, 0, &VirtualDevice::ThreadProc, this, 0, nullptr);
+    if (rawThread == nullptr) {
+        Stop();
+        return false;
+    }
+    threadHandle_.Reset(rawThread);
+    return true;
+}
+
+void VirtualDevice::Stop() {
+    if (running_.exchange(false) && stopEvent_.IsValid()) {
+        ::SetEvent(stopEvent_.Get());
+    }
+    // No timeout: the thread's OVERLAPPEDs must be back before the pipe goes away.
+    if (threadHandle_.IsValid()) {
+        ::WaitForSingleObject(threadHandle_.Get(), INFINITE);
+    }
+    threadHandle_.Reset();
+    stopEvent_.Reset();
+    pipe_.Reset();
+    pipeName_.clear();
+}
+
+core::SafeHandle VirtualDevice::OpenPortSide(const PortSettings&, const ReadTiming&) const {
+    if (pipeName_.empty()) {
+        return core::SafeHandle();
+    }
+    // A pipe has no DCB or COMMTIMEOUTS; a byte-mode pipe read completes as soon as data arrives.
+    HANDLE handle = ::CreateFileW(
+        pipeName_.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return core::SafeHandle();
+    }
+    return core::SafeHandle(handle);
+}
+
+std::uint64_t VirtualDevice::GeneratedBytes() const noexcept {
+    return generated_.load(std::memory_order_relaxed);
+}
+
+std::uint64_t VirtualDevice::EchoedBytes() const noexcept {
+    return echoed_.load(std::memory_order_relaxed);
+}
+
+DWORD WINAPI VirtualDevice::ThreadProc(LPVOID param) {
+    static_cast<VirtualDevice*>(param)->ThreadMain();
+    return 0;
+}
+
+void VirtualDevice::ThreadMain() {
+    core::SafeHandle readEvent(::CreateEventW(nullptr, TRUE, FALSE, nullptr));
+    core::SafeHandle writeEvent(::CreateEventW(nullptr, TRUE, FALSE, nullptr));
+    if (!readEvent.IsValid() || !writeEvent.IsValid()) {
+        return;
+    }
+
+    const HANDLE pipe = pipe_.Get();
+    OVERLAPPED readOverlapped{};
+    OVERLAPPED writeOverlapped{};
+    bool readPending = false;
+    bool writePending = false;
+
+    // Wait for SerialPort to open the client end.
+    readOverlapped.hEvent = readEvent.Get();
+    if (!::ConnectNamedPipe(pipe, &readOverlapped)) {
+        const DWORD error = ::GetLastError();
+        if (error == ERROR_IO_PENDING) {
+            const HANDLE handles[] = {readEvent.Get(), stopEvent_.Get()};
+            if (::WaitForMultipleObjects(2, handles, FALSE, INFINITE) != WAIT_OBJECT_0) {
+                DWORD ignored = 0;
+                ::CancelIoEx(pipe, &readOverlapped);
+                ::GetOverlappedResult(pipe, &readOverlapped, &ignored, TRUE);
+                return;
+            }
+        } else if (error != ERROR_PIPE_CONNECTED) {
+            return;
+        }
+    }
+
+    TrafficGenerator generator(spec_);
+    TrafficPacer pacer(spec_, core::MonotonicNanos());
+    const bool generating = (spec_.pattern != TrafficPattern::Echo);
+
+    std::vector<uint8_t> out;
+    bool outGenerated = false;
+    std::vector<uint8_t> echo;
+    std::vector<uint8_t> readBuffer(kMaxChunkBytes);
+
+    while (running_.load()) {
+        if (!readPending && echo.size() < kMaxEchoBytes) {
+            readOverlapped = OVERLAPPED{};
+            readOverlapped.hEvent = readEvent.Get();
+            ::ResetEvent(readEvent.Get());
+            if (!::ReadFile(pipe, readBuffer.data(), static_cast<DWORD>(readBuffer.size()), nullptr, &readOverlapped) &&
+                ::GetLastError() != ERROR_IO_PENDING) {
+                break;
+            }
+            readPending = true;
+        }
+
+        const std::int64_t now = core::MonotonicNanos();
+        if (!writePending) {
+            out.clear();
+            outGenerated = echo.empty();
+            if (!echo.empty()) {
+                out.swap(echo);
+            } else if (generating) {
+                const std::size_t size = std::min(pacer.Budget(now), kMaxChunkBytes);
+                if (size > 0) {
+                    out.resize(size);
+                    generator.Fill(out);
+                    pacer.Consume(size, now);
+                }
+            }
+            if (!out.empty()) {
+                writeOverlapped = OVERLAPPED{};
+                writeOverlapped.hEvent = writeEvent.Get();
+                ::ResetEvent(writeEvent.Get());
+                if (!::WriteFile(pipe, out.data(), static_cast<DWORD>(out.size()), nullptr, &writeOverlapped) &&
+                    ::GetLastError() != ERROR_IO_PENDING) {
+                    break;
+                }
+                writePending = true;
+            }
+        }
+
+        const HANDLE handles[] = {stopEvent_.Get(), readEvent.Get(), writeEvent.Get()};
+        const DWORD timeout = (writePending || !generating) ? INFINITE : ToWaitTimeoutMs(pacer.WaitNs(now));
+        // The read event only matters while a read is posted; an unposted one stays unsignalled.
+        const DWORD wait = ::WaitForMultipleObjects(3, handles, FALSE, timeout);
+        if (wait == WAIT_OBJECT_0 || wait == WAIT_FAILED) {
+            break;
+        }
+
+        DWORD transferred = 0;
+        if (readPending && ::WaitForSingleObject(readEvent.Get(), 0) == WAIT_OBJECT_0) {
+            readPending = false;
+            if (!::GetOverlappedResult(pipe, &readOverlapped, &transferred, FALSE)) {
+                break;
+            }
+            echo.insert(echo.end(), readBuffer.begin(), readBuffer.begin() + transferred);
+            echoed_.fetch_add(transferred, std::memory_order_relaxed);
+        }
+        if (writePending && ::WaitForSingleObject(writeEvent.Get(), 0) == WAIT_OBJECT_0) {
+            writePending = false;
+            if (!::GetOverlappedResult(pipe, &writeOverlapped, &transferred, FALSE)) {
+                break;
+            }
+            if (outGenerated) {
+                generated_.fetch_add(transferred, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Reap whatever is still posted before the buffers on this stack go away.
+    ::CancelIoEx(pipe, nullptr);
+    DWORD ignored = 0;
+    if (readPending) {
+        ::GetOverlappedResult(pipe, &readOverlapped, &ignored, TRUE);
+    }
+    if (writePending) {
+        ::GetOverlappedResult(pipe, &writeOverlapped, &ignored, TRUE);
+    }
+    ::DisconnectNamedPipe(pipe);
+}
+
+} // namespace serial
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "core/Platform.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "serial/PortSettings.h"
+#include "serial/ReadTiming.h"
+#include "serial/TrafficGenerator.h"
+
+#ifdef _WIN32
+#include "core/SafeHandle.h"
+#else
+#include "core/UniqueFd.h"
+#endif
+
+namespace serial {
+
+// Device end of a virtual port: generates TrafficSpec traffic at its byte rate and loops
+// everything the port transmits back to it. SerialPort opens the other end through
+// OpenPortSide() and then runs its normal read/write threads on it: a named pipe on Windows,
+// a pseudo-terminal on Linux.
+class VirtualDevice final {
+public:
+    VirtualDevice();
+    ~VirtualDevice();
+
+    VirtualDevice(const VirtualDevice&) = delete;
+    VirtualDevice& operator=(const VirtualDevice&) = delete;
+
+    bool Start(const TrafficSpec& spec);
+    void Stop();
+
+#ifdef _WIN32
+    [[nodiscard]] core::SafeHandle OpenPortSide(const PortSettings& settings, const ReadTiming& timing) const;
+#else
+    [[nodiscard]] core::UniqueFd OpenPortSide(const PortSettings& settings, const ReadTiming& timing) const;
+#endif
+
+    [[nodiscard]] std::uint64_t GeneratedBytes() const noexcept;
+    [[nodiscard]] std::uint64_t EchoedBytes() const noexcept;
+
+private:
+#ifdef _WIN32
+    static DWORD WINAPI ThreadProc(LPVOID param);
+    void ThreadMain();
+
+    std::wstring pipeName_;
+    core::SafeHandle pipe_;
+    core::SafeHandle stopEvent_;
+    core::SafeHandle threadHandle_;
+#else
+    void ThreadMain();
+
+    core::UniqueFd master_;
+    core::UniqueFd slaveHold_;
+    core::UniqueFd stopEvent_;
+    std::wstring slaveName_;
+    std::thread thread_;
+#endif
+    TrafficSpec spec_;
+    std::atomic<bool> running_;
+    std::atomic<std::uint64_t> generated_;
+    std::atomic<std::uint64_t> echoed_;
+};
+
+} // namespace serial
@@ -0,0 +1,185 @@
+#include "serial/VirtualDevice.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <sys/eventfd.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <system_error>
+#include <vector>
+
+#include "core/Clock.h"
+#include "serial/SerialDevice.h"
+
+namespace {
+
+// Largest generated write; at 12 Mbaud the pacer hands out about 1.2 KiB per millisecond.
+constexpr std::size_t kMaxChunkBytes = 16U * 1024U;
+// TX waiting to be looped back; beyond this the device stops reading and the port's writes block.
+constexpr std::size_t kMaxEchoBytes = 256U * 1024U;
+constexpr DWORD kPtyBaudRate = 115200;
+
+int ToPollTimeoutMs(std::int64_t waitNs) {
+    if (waitNs <= 0) {
+        return 0;
+    }
+    return static_cast<int>(std::min<std::int64_t>((waitNs + 999999) / 1000000, 1000));
+}
+
+} // namespace
+
+namespace serial {
+
+VirtualDevice::VirtualDevice() : running_(false), generated_(0), echoed_(0) {}
+
+VirtualDevice::~VirtualDevice() {
+    Stop();
+}
+
+bool VirtualDevice::Start(const TrafficSpec& spec) {
+    Stop();
+
+    master_.Reset(::posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC));
+    char name[128] = {};
+    if (!master_.IsValid() || ::grantpt(master_.Get()) != 0 || ::unlockpt(master_.Get()) != 0 ||
+        ::ptsname_r(master_.Get(), name, sizeof(name)) != 0) {
+        Stop();
+        return false;
+    }
+
+    // Raw master: the device's bytes pass through unchanged.
+    termios tty{};
+    if (::tcgetattr(master_.Get(), &tty) == 0) {
+        ::cfmakeraw(&tty);
+        ::tcsetattr(master_.Get(), TCSANOW, &tty);
+    }
+
+    // Holding a slave open keeps the master from reporting POLLHUP while the port is closed.
+    slaveHold_.Reset(::open(name, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC));
+    stopEvent_.Reset(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+    if (!slaveHold_.IsValid() || !stopEvent_.IsValid()) {
+        Stop();
+        return false;
+    }
+
+    const std::string narrow = name;
+    slaveName_.assign(narrow.begin(), narrow.end());
+    spec_ = spec;
+    generated_.store(0);
+    echoed_.store(0);
+
+    running_.store(true);
+    try {
+        thread_ = std::thread(&VirtualDevice::ThreadMain, this);
+    } catch (const std::system_error&) {
+        Stop();
+        return false;
+    }
+    return true;
+}
+
+void VirtualDevice::Stop() {
+    if (running_.exchange(false) && stopEvent_.IsValid()) {
+        const std::uint64_t one = 1;
+        [[maybe_unused]] const ssize_t ignored = ::write(stopEvent_.Get(), &one, sizeof(one));
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    stopEvent_.Reset();
+    slaveHold_.Reset();
+    master_.Reset();
+    slaveName_.clear();
+}
+
+core::UniqueFd VirtualDevice::OpenPortSide(const PortSettings& settings, const ReadTiming& timing) const {
+    if (slaveName_.empty()) {
+        return core::UniqueFd();
+    }
+    // The generator sets the line rate; termios only has to accept the speed, which a pty ignores.
+    PortSettings ptySettings = settings;
+    ptySettings.baudRate = kPtyBaudRate;
+    return OpenSerialDevice(slaveName_, ptySettings, timing);
+}
+
+std::uint64_t VirtualDevice::GeneratedBytes() const noexcept {
+    return generated_.load(std::memory_order_relaxed);
+}
+
+std::uint64_t VirtualDevice::EchoedBytes() const noexcept {
+    return echoed_.load(std::memory_order_relaxed);
+}
+
+void VirtualDevice::ThreadMain() {
+    TrafficGenerator generator(spec_);
+    TrafficPacer pacer(spec_, core::MonotonicNanos());
+    const bool generating = (spec_.pattern != TrafficPattern::Echo);
+
+    // out is the write in progress; echo collects TX and goes out before the next generated chunk.
+    std::vector<uint8_t> out;
+    std::size_t outOffset = 0;
+    bool outGenerated = false;
+    std::vector<uint8_t> echo;
+    std::vector<uint8_t> readBuffer(kMaxChunkBytes);
+    out.reserve(kMaxChunkBytes);
+
+    while (running_.load()) {
+        const std::int64_t now = core::MonotonicNanos();
+        if (outOffset == out.size()) {
+            out.clear();
+            outOffset = 0;
+            outGenerated = echo.empty();
+            if (!echo.empty()) {
+                out.swap(echo);
+            } else if (generating) {
+                const std::size_t size = std::min(pacer.Budget(now), kMaxChunkBytes);
+                if (size > 0) {
+                    out.resize(size);
+                    generator.Fill(out);
+                    pacer.Consume(size, now);
+                }
+            }
+        }
+
+        const bool writing = (outOffset < out.size());
+        pollfd fds[2] = {
+            {master_.Get(), static_cast<short>((echo.size() < kMaxEchoBytes ? POLLIN : 0) | (writing ? POLLOUT : 0)), 0},
+            {stopEvent_.Get(), POLLIN, 0},
+        };
+        const int timeout = (writing || !generating) ? -1 : ToPollTimeoutMs(pacer.WaitNs(now));
+        if (::poll(fds, 2, timeout) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if ((fds[1].revents & POLLIN) != 0) {
+            break;
+        }
+
+        if ((fds[0].revents & POLLIN) != 0) {
+            const ssize_t size = ::read(master_.Get(), readBuffer.data(), readBuffer.size());
+            if (size > 0) {
+                echo.insert(echo.end(), readBuffer.begin(), readBuffer.begin() + size);
+                echoed_.fetch_add(static_cast<std::uint64_t>(size), std::memory_order_relaxed);
+            }
+        }
+        if ((fds[0].revents & POLLOUT) != 0 && writing) {
+            const ssize_t size = ::write(master_.Get(), out.data() + outOffset, out.size() - outOffset);
+            if (size > 0) {
+                outOffset += static_cast<std::size_t>(size);
+                if (outGenerated) {
+                    generated_.fetch_add(static_cast<std::uint64_t>(size), std::memory_order_relaxed);
+                }
+            } else if (size < 0 && errno != EAGAIN && errno != EINTR) {
+                break;
+            }
+        }
+    }
+}
+
+} // namespace serial
@@ -18,6 +18,21 @@
 namespace {
 
 constexpr UINT WM_APP_SERIAL_DATA = WM_APP + 1;
+constexpr UINT WM_APP_SERIAL_TX_DONE = WM_APP + 2;
+constexpr UINT WM_APP_MODEM_EVENT = WM_APP + 3;
+constexpr UINT WM_APP_PORTS_CHANGED = WM_APP + 4;
+constexpr UINT WM_APP_FILE_PROGRESS = WM_APP + 5;
+constexpr UINT WM_APP_AUTODETECT_DONE = WM_APP + 6;
+constexpr UINT WM_APP_BRIDGE_TAP = WM_APP + 7;
+constexpr UINT WM_APP_REPLAY_DONE = WM_APP + 8;
+
+constexpr UINT_PTR kCrcExpireTimerId = 1;
+
+// About ten seconds of 921600 baud traffic before the read thread overruns the UI. Unlike
+// fixed slabs, small reads only take the bytes they carry plus a 12-byte record header.
+constexpr std::size_t kRxBufferBytes = 1024U * 1024U;
+
+constexpr std::int64_t kUnixEpochFileTimeTicks = 116444736000000000LL;
 
 constexpr GUID kGuidDevinterfaceComport = {
     0x86E0D1E0, 0x8089, 0x11D0, {0x9C, 0xE4, 0x08, 0x00, 0x3E, 0x30, 0x1F, 0x73}
@@ -104,6 +119,31 @@ MainWindow::MainWindow(HINSTANCE instance):
     ledBrushConnected_(::CreateSolidBrush(RGB(50, 160, 70))),
     deviceNotify_(nullptr),
     serialPort_(),
+    portDiffMutex_(),
+    portDiffs_(),
+    portScanner_(),
+    fileSender_(serialPort_),
+    fileProgressPending_(false),
+    fileSendActive_(false),
+    fileTxCounted_(0),
+    autoDetectThread_(),
+    autoDetectCancel_(false),
+    autoDetectMutex_(),
+    autoDetectResult_(),
+    autoDetectPort_(),
+    bridge_(),
+    bridgeTapPending_(false),
+    rxBuffer_(kRxBufferBytes),
+    rxRecord_(),
+    rxNotifyPending_(false),
+    modemNotifyPending_(false),
+    modemCursor_(0),
+    crcFraming_(),
+    crcCursor_(0),
+    crcCommand_(IDM_PORT_CRC_NONE),
+    captureWriter_(),
+    replayer_(),
+    replayCancel_(false),
     logVirtualizer_(2000, 5000, 5U * 1024U * 1024U),
     rebuildingRichEdit_(false),
     txBytes_(0),
@@ -115,7 +155,11 @@ MainWindow::MainWindow(HINSTANCE instance):
 }
 
 MainWindow::~MainWindow() {
+    actions_->StopAutoDetect();
+    bridge_.Stop();
+    actions_->StopReplay();
     actions_->ClosePort();
+    captureWriter_.Close();
     if (deviceNotify_) ::UnregisterDeviceNotification(deviceNotify_);
 }
 
@@ -218,7 +262,7 @@ bool MainWindow::RegisterClass() {
     return ::RegisterClassExW(&wc) != 0;
 }
 
-void MainWindow::AppendLog(LogKind kind, const std::wstring& text) {
+void MainWindow::AppendLog(LogKind kind, const std::wstring& text, std::int64_t monotonicNs) {
     if (richLog_ == nullptr) {
         return;
     }
@@ -226,7 +270,7 @@ void MainWindow::AppendLog(LogKind kind, const std::wstring& text) {
     const COLORREF color = ColorForLogKind(kind);
     
     // Разбиваем текст на строки и добавляем каждую отдельно
-    std::wstring line = L"[" + BuildTimestamp() + L"] " + text;
+    std::wstring line = L"[" + BuildTimestamp(monotonicNs) + L"] " + text;
     
     // Заменяем одиночные \r или \n на \r\n
     size_t pos = 0;
@@ -318,8 +362,29 @@ void MainWindow::RebuildRichEditFromVirtualBuffer() {
 }
 
 void MainWindow::UpdateStatusText() {
-    wchar_t buffer[128] = {};
-    ::StringCchPrintfW(buffer, _countof(buffer), L"TX: %llu  RX: %llu", txBytes_, rxBytes_);
+    wchar_t buffer[224] = {};
+    const core::BufferPoolStats stats = rxBuffer_.Stats();
+    const auto bufferedKiB = static_cast<unsigned long long>(rxBuffer_.Size() / 1024U);
+    const auto peakKiB = static_cast<unsigned long long>(stats.highWaterMark / 1024U);
+    ::StringCchPrintfW(
+        buffer,
+        _countof(buffer),
+        L"TX: %llu  RX: %llu  Buffered: %llu KiB (peak %llu)  Lost: %llu B",
+        txBytes_,
+        rxBytes_,
+        bufferedKiB,
+        peakKiB,
+        static_cast<unsigned long long>(stats.droppedBytes));
+    if (crcFraming_.Enabled()) {
+        const serial::CrcFramingStats crc = crcFraming_.Stats();
+        const std::size_t length = std::wcslen(buffer);
+        ::StringCchPrintfW(
+            buffer + length,
+            _countof(buffer) - length,
+            L"  CRC: %llu ok, %llu bad",
+            static_cast<unsigned long long>(crc.passed),
+            static_cast<unsigned long long>(crc.failed));
+    }
     ::SendMessage(statusBar_, SB_SETTEXTW, 1, reinterpret_cast<LPARAM>(buffer));
 }
 
@@ -421,9 +486,22 @@ void MainWindow::SaveLogToFile() {
     }
 }
 
-std::wstring MainWindow::BuildTimestamp() {
+std::wstring MainWindow::BuildTimestamp(std::int64_t monotonicNs) {
+    if (monotonicNs == 0) {
+        monotonicNs = core::MonotonicNanos();
+    }
+
+    // Unix nanoseconds -> FILETIME ticks (100 ns since 1601-01-01).
+    const std::int64_t ticks = wallClock_.ToWallNanos(monotonicNs) / 100 + kUnixEpochFileTimeTicks;
+    FILETIME utc{};
+    utc.dwLowDateTime = static_cast<DWORD>(ticks & 0xFFFFFFFF);
+    utc.dwHighDateTime = static_cast<DWORD>(ticks >> 32);
+
+    SYSTEMTIME utcTime{};
     SYSTEMTIME st{};
-    ::GetLocalTime(&st);
+    if (!::FileTimeToSystemTime(&utc, &utcTime) || !::SystemTimeToTzSpecificLocalTime(nullptr, &utcTime, &st)) {
+        ::GetLocalTime(&st);
+    }
 
     wchar_t buffer[32] = {};
     ::StringCchPrintfW(
@@ -437,23 +515,6 @@ std::wstring MainWindow::BuildTimestamp() {
     return buffer;
 }
 
-std::wstring MainWindow::BytesToHex(const std::vector<uint8_t>& bytes) {
-    std::wstringstream ss;
-    ss.setf(std::ios::uppercase);
-    ss << std::hex;
-
-    for (std::size_t i = 0; i < bytes.size(); ++i) {
-        if (i > 0) {
-            ss << L' ';
-        }
-        ss.width(2);
-        ss.fill(L'0');
-        ss << static_cast<unsigned int>(bytes[i]);
-    }
-
-    return ss.str();
-}
-
 COLORREF MainWindow::ColorForLogKind(LogKind kind) noexcept {
     switch (kind) {
     case LogKind::Rx:
@@ -505,7 +566,7 @@ LRESULT MainWindow::WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
         layout_->ResizeChildren();
         // Show the appropriate button based on initial connection state
         UpdateConnectionButtons();
-        actions_->RefreshPorts();
+        actions_->StartPortScanner();
         // AppendLog(LogKind::System, L"Application started");
         return 0;
     }
@@ -530,6 +591,19 @@ LRESULT MainWindow::WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
         // case IDM_VIEW_DARK_THEME:
         //     ApplyTheme(true);
         //     return 0;
+        case IDM_FILE_CAPTURE_START:
+            actions_->StartCapture();
+            return 0;
+        case IDM_FILE_CAPTURE_STOP:
+            actions_->StopCapture();
+            return 0;
+        case IDM_FILE_REPLAY:
+        case IDM_FILE_REPLAY_FAST:
+            actions_->StartReplay(LOWORD(wParam) == IDM_FILE_REPLAY_FAST);
+            return 0;
+        case IDM_FILE_REPLAY_STOP:
+            actions_->StopReplay();
+            return 0;
         case IDM_FILE_EXIT:
             ::DestroyWindow(hwnd);
             return 0;
@@ -548,6 +622,28 @@ LRESULT MainWindow::WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
         case IDC_BTN_SEND:
             actions_->SendInputData();
             return 0;
+        case IDM_PORT_SEND_FILE:
+            actions_->SendFile();
+            return 0;
+        case IDM_PORT_CANCEL_FILE:
+            actions_->CancelFileSend();
+            return 0;
+        case IDM_PORT_AUTODETECT:
+            actions_->StartAutoDetect();
+            return 0;
+        case IDM_PORT_BRIDGE_TCP:
+            actions_->StartBridge();
+            return 0;
+        case IDM_PORT_BRIDGE_STOP:
+            actions_->StopBridge();
+            return 0;
+        case IDM_PORT_CRC_NONE:
+        case IDM_PORT_CRC_MODBUS:
+        case IDM_PORT_CRC_CCITT:
+        case IDM_PORT_CRC_XMODEM:
+        case IDM_PORT_CRC_32:
+            actions_->SetCrcFraming(LOWORD(wParam));
+            return 0;
         case IDC_BTN_CLEAR:
             // Call the member function directly; 'owner_' is not a valid identifier here.
             ClearTerminal();
@@ -717,17 +813,52 @@ LRESULT MainWindow::WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
         }
         return 0;
 
-    case WM_APP_SERIAL_DATA: {
-        auto* message = reinterpret_cast<std::vector<uint8_t>*>(lParam);
-        if (message != nullptr) {
-            actions_->HandleSerialData(*message);
-            delete message;
-        }
+    case WM_APP_SERIAL_DATA:
+        actions_->DrainSerialData();
         return 0;
-    }
+
+    case WM_APP_SERIAL_TX_DONE:
+        actions_->HandleWriteDone(wParam != 0, static_cast<DWORD>(lParam));
+        return 0;
+
+    case WM_APP_MODEM_EVENT:
+        actions_->DrainModemEvents();
+        return 0;
+
+    case WM_APP_PORTS_CHANGED:
+        actions_->DrainPortDiffs();
+        return 0;
+
+    case WM_APP_FILE_PROGRESS:
+        actions_->HandleFileProgress();
+        return 0;
+
+    case WM_APP_AUTODETECT_DONE:
+        actions_->HandleAutoDetectDone();
+        return 0;
+
+    case WM_APP_BRIDGE_TAP:
+        actions_->DrainBridgeTap();
+        return 0;
+
+    case WM_APP_REPLAY_DONE:
+        actions_->HandleReplayDone();
+        return 0;
+
+    case WM_TIMER:
+        if (wParam == kCrcExpireTimerId) {
+            actions_->ExpireCrcFrames();
+            return 0;
+        }
+        break;
 
     case WM_DESTROY:
+        portScanner_.Stop();
+        actions_->StopAutoDetect();
+        bridge_.Stop();
+        actions_->StopReplay();
         actions_->ClosePort();
+        captureWriter_.Close();
         if (deviceNotify_ != nullptr) {
             ::UnregisterDeviceNotification(deviceNotify_);
             deviceNotify_ = nullptr;
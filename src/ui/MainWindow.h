@@ -4,12 +4,26 @@
 
 #include <dbt.h>
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
+#include <mutex>
+#include <span>
+#include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "core/Clock.h"
+#include "core/BufferPool.h"
 #include "core/LogVirtualizer.h"
+#include "serial/AutoBaud.h"
+#include "serial/CaptureFile.h"
+#include "serial/CaptureReplayer.h"
+#include "serial/CrcFraming.h"
+#include "serial/FileSender.h"
+#include "serial/PortBridge.h"
+#include "serial/PortScanner.h"
 #include "serial/SerialPort.h"
 
 #include <versionhelpers.h>  // Для IsWindows10OrGreater()
@@ -47,14 +61,14 @@ private:
 
     bool RegisterClass();
 
-    void AppendLog(LogKind kind, const std::wstring& text);
+    // monotonicNs is a core::MonotonicNanos() capture stamp; 0 stamps the line with the current time.
+    void AppendLog(LogKind kind, const std::wstring& text, std::int64_t monotonicNs = 0);
     void AppendLineToRichEdit(const std::wstring& line, COLORREF color, bool scrollToCaret);
     void RebuildRichEditFromVirtualBuffer();
     void UpdateStatusText();
     static COLORREF ColorForLogKind(LogKind kind) noexcept;
 
-    static std::wstring BuildTimestamp();
-    static std::wstring BytesToHex(const std::vector<uint8_t>& bytes);
+    std::wstring BuildTimestamp(std::int64_t monotonicNs);
 
     HINSTANCE instance_;
     HWND window_;
@@ -97,6 +111,41 @@ private:
     HDEVNOTIFY deviceNotify_;
 
     serial::SerialPort serialPort_;
+    // Diffs from the scanner thread wait here for WM_APP_PORTS_CHANGED; declared before the
+    // scanner so they outlive its thread.
+    std::mutex portDiffMutex_;
+    std::vector<serial::PortDiff> portDiffs_;
+    serial::PortScanner portScanner_;
+    serial::FileSender fileSender_;
+    std::atomic<bool> fileProgressPending_;
+    bool fileSendActive_;
+    std::uint64_t fileTxCounted_; // Part of the current file already added to txBytes_.
+    // Auto-detection runs on its own thread and leaves the result here for
+    // WM_APP_AUTODETECT_DONE.
+    std::thread autoDetectThread_;
+    std::atomic<bool> autoDetectCancel_;
+    std::mutex autoDetectMutex_;
+    std::optional<serial::AutoBaudCandidate> autoDetectResult_;
+    std::wstring autoDetectPort_;
+    serial::PortBridge bridge_;
+    std::atomic<bool> bridgeTapPending_;
+    // Read thread to UI thread: one timestamped record per read.
+    core::BufferPool rxBuffer_;
+    std::vector<uint8_t> rxRecord_; // Drain scratch, reused.
+    core::WallClockMapper wallClock_;
+    std::atomic<bool> rxNotifyPending_;
+    std::atomic<bool> modemNotifyPending_;
+    std::uint64_t modemCursor_;
+    // Frame CRC stage, fed next to rxBuffer_ by its producer; the UI reads results from
+    // crcCursor_. crcCommand_ is the checked IDM_PORT_CRC_* item.
+    serial::CrcFraming crcFraming_;
+    std::uint64_t crcCursor_;
+    UINT crcCommand_;
+    // Raw traffic of the open port goes here as well as to the log. A replay feeds rxBuffer_ in
+    // place of the port, so the two never run together.
+    serial::CaptureWriter captureWriter_;
+    serial::CaptureReplayer replayer_;
+    std::atomic<bool> replayCancel_;
     core::LogVirtualizer logVirtualizer_;
     bool rebuildingRichEdit_;
     std::uint64_t txBytes_;
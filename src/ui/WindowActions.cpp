@@ -1,9 +1,61 @@
 #include "ui/WindowActions.h"
 
+#include <algorithm>
+#include <chrono>
+
+#include "core/CrcModel.h"
+#include "core/Hex.h"
+
 namespace ui {
 
 namespace {
 constexpr UINT WM_APP_SERIAL_DATA = WM_APP + 1;
+constexpr UINT WM_APP_SERIAL_TX_DONE = WM_APP + 2;
+constexpr UINT WM_APP_MODEM_EVENT = WM_APP + 3;
+constexpr UINT WM_APP_PORTS_CHANGED = WM_APP + 4;
+constexpr UINT WM_APP_FILE_PROGRESS = WM_APP + 5;
+constexpr UINT WM_APP_AUTODETECT_DONE = WM_APP + 6;
+constexpr UINT WM_APP_BRIDGE_TAP = WM_APP + 7;
+constexpr UINT WM_APP_REPLAY_DONE = WM_APP + 8;
+
+// Local TCP port the selected serial port is exposed on.
+constexpr std::uint16_t kBridgeTcpPort = 7000;
+
+// Upper bound on read records (or bridge tap slabs) formatted per message so input and painting
+// stay responsive.
+constexpr std::size_t kMaxChunksPerDrain = 64;
+// Replayed payloads are cut to read-sized records.
+constexpr std::size_t kReplayChunkBytes = 4096;
+
+// Ends a CRC frame the line went quiet after, when no further read arrives to end it.
+constexpr UINT_PTR kCrcExpireTimerId = 1;
+constexpr UINT kCrcExpireTimerMs = 50;
+// Frames end after 3.5 character times of silence, as in Modbus RTU, but reads are stamped on a
+// thread, so a few milliseconds of scheduling jitter must not split a frame.
+constexpr std::int64_t kMinCrcGapNs = 4000000;
+
+struct CrcPreset {
+    UINT command;
+    core::CrcModel model;
+    bool bigEndian;
+    const wchar_t* name;
+};
+
+constexpr CrcPreset kCrcPresets[] = {
+    {IDM_PORT_CRC_MODBUS, core::kCrc16Modbus, false, L"CRC-16/MODBUS"},
+    {IDM_PORT_CRC_CCITT, core::kCrc16Ibm3740, true, L"CRC-16/CCITT-FALSE"},
+    {IDM_PORT_CRC_XMODEM, core::kCrc16Xmodem, true, L"CRC-16/XMODEM"},
+    {IDM_PORT_CRC_32, core::kCrc32IsoHdlc, false, L"CRC-32"},
+};
+
+const CrcPreset* FindCrcPreset(UINT command) {
+    for (const CrcPreset& preset : kCrcPresets) {
+        if (preset.command == command) {
+            return &preset;
+        }
+    }
+    return nullptr;
+}
 } // namespace
 
 // Helper to load a string resource into std::wstring
@@ -15,11 +67,65 @@ inline std::wstring LoadStringFromRes(HINSTANCE hInst, UINT id) {
 
 WindowActions::WindowActions(MainWindow& owner) : owner_(owner) {}
 
+void WindowActions::StartPortScanner() {
+    // Virtual ports are selectable right away; real ones arrive with the first scan.
+    RebuildPortCombo({});
+
+    HWND window = owner_.window_;
+    MainWindow& owner = owner_;
+    owner_.portScanner_.Start([window, &owner](const serial::PortDiff& diff) {
+        bool notify = false;
+        {
+            std::lock_guard<std::mutex> lock(owner.portDiffMutex_);
+            notify = owner.portDiffs_.empty();
+            owner.portDiffs_.push_back(diff);
+        }
+        if (notify) {
+            ::PostMessageW(window, WM_APP_PORTS_CHANGED, 0, 0);
+        }
+    });
+}
+
 void WindowActions::RefreshPorts() {
+    // The scan runs on the scanner thread; changes come back through WM_APP_PORTS_CHANGED.
+    owner_.portScanner_.Request();
+}
+
+void WindowActions::DrainPortDiffs() {
+    std::vector<serial::PortDiff> diffs;
+    {
+        std::lock_guard<std::mutex> lock(owner_.portDiffMutex_);
+        diffs.swap(owner_.portDiffs_);
+    }
+    if (diffs.empty()) {
+        return;
+    }
+
+    const auto ports = owner_.portScanner_.Ports();
+    RebuildPortCombo(ports);
+
+    for (const serial::PortDiff& diff : diffs) {
+        // The first diff is the initial listing, not news about individual ports.
+        if (diff.generation == 1) {
+            const std::wstring fmt = LoadStringFromRes(owner_.instance_, IDS_PORT_LIST_REFRESHED);
+            wchar_t buffer[256];
+            wsprintfW(buffer, fmt.c_str(), static_cast<int>(diff.added.size()));
+            owner_.AppendLog(LogKind::System, std::wstring(buffer));
+            continue;
+        }
+        for (const serial::PortInfo& port : diff.removed) {
+            LogPortChange(IDS_PORT_REMOVED, port);
+        }
+        for (const serial::PortInfo& port : diff.added) {
+            LogPortChange(IDS_PORT_ADDED, port);
+        }
+    }
+}
+
+void WindowActions::RebuildPortCombo(const std::vector<serial::PortInfo>& ports) {
     const std::wstring previous = ComboText(owner_.comboPort_);
 
     ::SendMessage(owner_.comboPort_, CB_RESETCONTENT, 0, 0);
-    const auto ports = serial::PortScanner::Scan();
 
     int selectedIndex = -1;
     for (std::size_t i = 0; i < ports.size(); ++i) {
@@ -30,38 +136,41 @@ void WindowActions::RefreshPorts() {
         }
     }
 
+    // Synthetic devices for load-testing the RX path without an adapter, see serial/TrafficGenerator.h.
+    for (const wchar_t* name : {L"virtual:text", L"virtual:random", L"virtual:prbs", L"virtual:bursty", L"virtual:echo"}) {
+        const LRESULT idx = ::SendMessage(owner_.comboPort_, CB_ADDSTRING, 0, reinterpret_cast<LPARAM>(name));
+        if (idx >= 0 && previous == name) {
+            selectedIndex = static_cast<int>(idx);
+        }
+    }
+
     if (selectedIndex < 0 && !ports.empty()) {
         selectedIndex = 0;
     }
-
     if (selectedIndex >= 0) {
         ::SendMessage(owner_.comboPort_, CB_SETCURSEL, static_cast<WPARAM>(selectedIndex), 0);
-        const std::wstring fmt = LoadStringFromRes(owner_.instance_, IDS_PORT_LIST_REFRESHED);
-        wchar_t buffer[256];
-        wsprintfW(buffer, fmt.c_str(), static_cast<int>(ports.size()));
-        owner_.AppendLog(LogKind::System, std::wstring(buffer));
-    } else {
-        owner_.AppendLog(LogKind::System, LoadStringFromRes(owner_.instance_, IDS_NO_PORTS_FOUND));
     }
 }
 
+void WindowActions::LogPortChange(UINT formatId, const serial::PortInfo& port) {
+    const std::wstring fmt = LoadStringFromRes(owner_.instance_, formatId);
+    const std::wstring text = port.portName + L" - " + port.friendlyName;
+    wchar_t buffer[512];
+    ::StringCchPrintfW(buffer, _countof(buffer), fmt.c_str(), text.c_str());
+    owner_.AppendLog(LogKind::System, std::wstring(buffer));
+}
+
 bool WindowActions::OpenSelectedPort() {
     if (owner_.serialPort_.IsOpen()) {
         return true;
     }
 
-    const int selected = static_cast<int>(::SendMessage(owner_.comboPort_, CB_GETCURSEL, 0, 0));
-    if (selected < 0) {
+    const std::wstring portName = SelectedPortName();
+    if (portName.empty()) {
         owner_.AppendLog(LogKind::Error, LoadStringFromRes(owner_.instance_, IDS_NO_COM_PORT));
         return false;
     }
 
-    wchar_t portText[256] = {};
-    ::SendMessage(owner_.comboPort_, CB_GETLBTEXT, static_cast<WPARAM>(selected), reinterpret_cast<LPARAM>(portText));
-    std::wstring selection = portText;
-    const std::size_t spacePos = selection.find(L' ');
-    const std::wstring portName = (spacePos == std::wstring::npos) ? selection : selection.substr(0, spacePos);
-
     bool settingsOk = false;
     const serial::PortSettings settings = BuildPortSettingsFromUi(&settingsOk);
     if (!settingsOk) {
@@ -69,11 +178,20 @@ bool WindowActions::OpenSelectedPort() {
         return false;
     }
 
-    owner_.serialPort_.SetDataCallback([this](const std::vector<uint8_t>& packet) {
-        auto* message = new std::vector<uint8_t>(packet);
-        if (!::PostMessageW(owner_.window_, WM_APP_SERIAL_DATA, 0, reinterpret_cast<LPARAM>(message))) {
-            delete message;
-        }
+    // Both feed rxBuffer_, which has a single producer.
+    StopReplay();
+
+    // The frame gap follows the baud rate just read from the UI.
+    owner_.crcFraming_.Reset();
+    owner_.crcCursor_ = owner_.crcFraming_.NextSequence();
+    ApplyCrcFraming();
+
+    // Runs on the read thread: write a timestamped record to rxBuffer_, wake the UI once per batch.
+    owner_.serialPort_.SetDataCallback([this](std::span<const uint8_t> packet, std::int64_t timestampNs) {
+        owner_.captureWriter_.Append(serial::CaptureKind::Rx, timestampNs, packet);
+        owner_.crcFraming_.Feed(packet, timestampNs);
+        owner_.rxBuffer_.WriteRecord(packet, timestampNs);
+        NotifySerialData();
     });
 
     if (!owner_.serialPort_.Open(portName, settings)) {
@@ -95,6 +213,14 @@ bool WindowActions::OpenSelectedPort() {
     wchar_t buffer[256];
     wsprintfW(buffer, fmt.c_str(), portName.c_str(), static_cast<int>(settings.baudRate));
     owner_.AppendLog(LogKind::System, std::wstring(buffer));
+
+    // Adapters without modem lines refuse the monitor; the port works without it.
+    owner_.modemCursor_ = owner_.serialPort_.ModemEvents().NextSequence();
+    owner_.serialPort_.StartModemMonitor([this](const serial::ModemEvent& event) {
+        owner_.captureWriter_.AppendModem(event);
+        NotifyModemEvent();
+    });
+
     // Update button visibility after successful connection
     owner_.UpdateConnectionButtons();
     return true;
@@ -104,6 +230,8 @@ void WindowActions::ClosePort() {
     owner_.serialPort_.SetDataCallback({});
     if (owner_.serialPort_.IsOpen()) {
         owner_.serialPort_.Close();
+        owner_.crcFraming_.Flush();
+        DrainCrcChecks();
         const std::wstring disconnectedStr = LoadStringFromRes(owner_.instance_, IDS_STATUS_DISCONNECTED);
         ::SetWindowText(owner_.ledStatus_, disconnectedStr.c_str());
         ::SendMessage(owner_.statusBar_, SB_SETTEXTW, 0, reinterpret_cast<LPARAM>(disconnectedStr.c_str()));
@@ -111,6 +239,9 @@ void WindowActions::ClosePort() {
         // Update button visibility after closing
         owner_.UpdateConnectionButtons();
     }
+    // The closed port has failed whatever the sender still had queued; its final progress
+    // message ends the transfer in the UI.
+    owner_.fileSender_.Cancel();
 }
 
 void WindowActions::SendInputData() {
@@ -143,89 +274,615 @@ void WindowActions::SendInputData() {
                 CP_UTF8, 0, text.c_str(), -1,
                 reinterpret_cast<LPSTR>(bytes.data()), utf8Len - 1, nullptr, nullptr);
         }
-    } else {        
-        // ============ HEX режим - продвинутый парсинг ============
-        
-        // Разделяем строку по любым не-hex символам
-        std::wstring current;
-        for (wchar_t ch : text) {
-            if (iswxdigit(ch)) {
-                current += ch;
+    } else {
+        bytes = core::ParseHex(text);
+    }
+
+    if (bytes.empty()) {
+        owner_.AppendLog(LogKind::Error, LoadStringFromRes(owner_.instance_, IDS_NO_DATA_TO_SEND));
+        return;
+    }
+    const std::size_t crcBytes = owner_.crcFraming_.Append(&bytes);
+
+    // Completion arrives on the port's writer thread, so it is only forwarded to the UI thread.
+    HWND window = owner_.window_;
+    const bool queued = owner_.serialPort_.WriteAsync(
+        bytes.data(),
+        static_cast<DWORD>(bytes.size()),
+        [window](bool ok, DWORD written) {
+            ::PostMessageW(window, WM_APP_SERIAL_TX_DONE, ok ? 1U : 0U, static_cast<LPARAM>(written));
+        });
+    if (!queued) {
+        owner_.AppendLog(LogKind::Error, LoadStringFromRes(owner_.instance_, IDS_TX_QUEUE_FULL));
+        return;
+    }
+    owner_.captureWriter_.Append(serial::CaptureKind::Tx, core::MonotonicNanos(), bytes);
+
+    if (mode == 0) {
+        std::wstring displayText = text;
+        if (displayText.length() > 100) {
+            displayText = displayText.substr(0, 100) + L"...";
+        }
+        if (crcBytes != 0) {
+            displayText += L" + CRC " + core::BytesToHex(std::span<const uint8_t>(bytes).last(crcBytes));
+        }
+        owner_.AppendLog(LogKind::Tx, L"TX: " + displayText);
+    } else {
+        owner_.AppendLog(LogKind::Tx, L"TX: " + core::BytesToHex(bytes));
+    }
+}
+
+void WindowActions::SendFile() {
+    if (!owner_.serialPort_.IsOpen()) {
+        owner_.AppendLog(LogKind::Error, LoadStringFromRes(owner_.instance_, IDS_PORT_NOT_OPEN));
+        return;
+    }
+
+    wchar_t filename[MAX_PATH] = {};
+    OPENFILENAMEW ofn = {};
+    ofn.lStructSize = sizeof(ofn);
+    ofn.hwndOwner = owner_.window_;
+    ofn.lpstrFilter = L"All Files (*.*)\0*.*\0Binary Files (*.bin;*.hex)\0*.bin;*.hex\0";
+    ofn.lpstrFile = filename;
+    ofn.nMaxFile = MAX_PATH;
+    ofn.Flags = OFN_FILEMUSTEXIST | OFN_PATHMUSTEXIST | OFN_HIDEREADONLY;
+    if (!::GetOpenFileNameW(&ofn)) {
+        return;
+    }
+
+    // Progress arrives on the sender thread; the UI thread reads it back with Progress().
+    HWND window = owner_.window_;
+    MainWindow& owner = owner_;
+    const bool started = owner_.fileSender_.Start(filename, [window, &owner](const serial::FileSendProgress&) {
+        if (!owner.fileProgressPending_.exchange(true) && !::PostMessageW(window, WM_APP_FILE_PROGRESS, 0, 0)) {
+            owner.fileProgressPending_.store(false);
+        }
+    });
+
+    wchar_t buffer[MAX_PATH + 128];
+    if (!started) {
+        ::StringCchPrintfW(buffer, _countof(buffer), LoadStringFromRes(owner_.instance_, IDS_FILE_OPEN_FAILED).c_str(), filename);
+        owner_.AppendLog(LogKind::Error, buffer);
+        return;
+    }
+    owner_.fileSendActive_ = true;
+    owner_.fileTxCounted_ = 0;
+    const auto total = static_cast<unsigned long long>(owner_.fileSender_.Progress().totalBytes);
+    ::StringCchPrintfW(buffer, _countof(buffer), LoadStringFromRes(owner_.instance_, IDS_FILE_SEND_STARTED).c_str(), filename, total);
+    owner_.AppendLog(LogKind::Tx, buffer);
+}
+
+// Returns at once: the port drops the unsent chunks and the sender's final progress message
+// reports the stopped transfer, so a peer holding the line cannot freeze the window.
+void WindowActions::CancelFileSend() {
+    owner_.fileSender_.Cancel();
+}
+
+void WindowActions::HandleFileProgress() {
+    owner_.fileProgressPending_.store(false);
+    if (!owner_.fileSendActive_) {
+        return;
+    }
+
+    const serial::FileSendProgress progress = owner_.fileSender_.Progress();
+    owner_.txBytes_ += progress.sentBytes - owner_.fileTxCounted_;
+    owner_.fileTxCounted_ = progress.sentBytes;
+    owner_.UpdateStatusText();
+
+    wchar_t buffer[256];
+    const auto sent = static_cast<unsigned long long>(progress.sentBytes);
+    if (!progress.finished) {
+        const auto percent = static_cast<unsigned long long>(
+            progress.totalBytes == 0 ? 100U : progress.sentBytes * 100U / progress.totalBytes);
+        if (progress.stalled) {
+            ::StringCchPrintfW(buffer, _countof(buffer), LoadStringFromRes(owner_.instance_, IDS_FILE_PROGRESS_STALLED).c_str(), percent);
+        } else {
+            ::StringCchPrintfW(
+                buffer, _countof(buffer), LoadStringFromRes(owner_.instance_, IDS_FILE_PROGRESS).c_str(), percent, progress.bytesPerSecond / 1024.0);
+        }
+        ::SendMessage(owner_.statusBar_, SB_SETTEXTW, 2, reinterpret_cast<LPARAM>(buffer));
+        return;
+    }
+
+    owner_.fileSendActive_ = false;
+    ::SendMessage(owner_.statusBar_, SB_SETTEXTW, 2, reinterpret_cast<LPARAM>(L""));
+    if (progress.ok) {
+        ::StringCchPrintfW(
+            buffer,
+            _countof(buffer),
+            LoadStringFromRes(owner_.instance_, IDS_FILE_SEND_DONE).c_str(),
+            sent,
+            static_cast<double>(progress.elapsedNs) / 1e9,
+            progress.bytesPerSecond);
+        owner_.AppendLog(LogKind::Tx, buffer);
+    } else {
+        ::StringCchPrintfW(
+            buffer,
+            _countof(buffer),
+            LoadStringFromRes(owner_.instance_, IDS_FILE_SEND_STOPPED).c_str(),
+            sent,
+            static_cast<unsigned long long>(progress.totalBytes));
+        owner_.AppendLog(LogKind::Error, buffer);
+    }
+}
+
+void WindowActions::StartAutoDetect() {
+    if (owner_.serialPort_.IsOpen()) {
+        owner_.AppendLog(LogKind::Error, LoadStringFromRes(owner_.instance_, IDS_AUTODETECT_CLOSE_PORT));
+        return;
+    }
+    if (owner_.autoDetectThread_.joinable()) {
+        return;
+    }
+    const std::wstring portName = SelectedPortName();
+    if (portName.empty()) {
+        owner_.AppendLog(LogKind::Error, LoadStringFromRes(owner_.instance_, IDS_NO_COM_PORT));
+        return;
+    }
+
+    wchar_t buffer[256];
+    ::StringCchPrintfW(buffer, _countof(buffer), LoadStringFromRes(owner_.instance_, IDS_AUTODETECT_STARTED).c_str(), portName.c_str());
+    owner_.AppendLog(LogKind::System, buffer);
+    ::EnableMenuItem(::GetMenu(owner_.window_), IDM_PORT_AUTODETECT, MF_BYCOMMAND | MF_GRAYED);
+
+    // Listening at every rate takes a few seconds, so it runs off the UI thread.
+    owner_.autoDetectPort_ = portName;
+    owner_.autoDetectCancel_.store(false);
+    HWND window = owner_.window_;
+    MainWindow& owner = owner_;
+    owner_.autoDetectThread_ = std::thread([window, &owner, portName] {
+        const std::vector<serial::LineCapture> captures = serial::AutoBaud::Capture(
+            portName, {}, [&owner](DWORD) { return !owner.autoDetectCancel_.load(); });
+        std::optional<serial::AutoBaudCandidate> best = serial::AutoBaud::Detect(captures);
+        {
+            std::lock_guard<std::mutex> lock(owner.autoDetectMutex_);
+            owner.autoDetectResult_ = std::move(best);
+        }
+        ::PostMessageW(window, WM_APP_AUTODETECT_DONE, 0, 0);
+    });
+}
+
+void WindowActions::StopAutoDetect() {
+    owner_.autoDetectCancel_.store(true);
+    if (owner_.autoDetectThread_.joinable()) {
+        owner_.autoDetectThread_.join();
+    }
+}
+
+void WindowActions::HandleAutoDetectDone() {
+    if (!owner_.autoDetectThread_.joinable()) {
+        return;
+    }
+    owner_.autoDetectThread_.join();
+    ::EnableMenuItem(::GetMenu(owner_.window_), IDM_PORT_AUTODETECT, MF_BYCOMMAND | MF_ENABLED);
+
+    std::optional<serial::AutoBaudCandidate> best;
+    {
+        std::lock_guard<std::mutex> lock(owner_.autoDetectMutex_);
+        best.swap(owner_.autoDetectResult_);
+    }
+
+    wchar_t buffer[256];
+    if (!best || owner_.autoDetectCancel_.load()) {
+        ::StringCchPrintfW(
+            buffer, _countof(buffer), LoadStringFromRes(owner_.instance_, IDS_AUTODETECT_FAILED).c_str(), owner_.autoDetectPort_.c_str());
+        owner_.AppendLog(LogKind::Error, buffer);
+        return;
+    }
+
+    const serial::PortSettings& settings = best->settings;
+    ApplyPortSettingsToUi(settings);
+    constexpr wchar_t kParity[] = {L'N', L'O', L'E', L'M', L'S'};
+    constexpr const wchar_t* kStopBits[] = {L"1", L"1.5", L"2"};
+    ::StringCchPrintfW(
+        buffer,
+        _countof(buffer),
+        LoadStringFromRes(owner_.instance_, IDS_AUTODETECT_DONE).c_str(),
+        static_cast<unsigned long>(settings.baudRate),
+        static_cast<unsigned>(settings.dataBits),
+        kParity[static_cast<int>(settings.parity)],
+        kStopBits[static_cast<int>(settings.stopBits)],
+        static_cast<unsigned long long>(best->frames),
+        static_cast<unsigned long long>(best->framingErrors + best->parityErrors));
+    owner_.AppendLog(LogKind::System, buffer);
+}
+
+void WindowActions::StartBridge() {
+    if (owner_.serialPort_.IsOpen()) {
+        owner_.AppendLog(LogKind::Error, LoadStringFromRes(owner_.instance_, IDS_BRIDGE_CLOSE_PORT));
+        return;
+    }
+    if (owner_.bridge_.IsRunning()) {
+        return;
+    }
+    const std::wstring portName = SelectedPortName();
+    bool settingsOk = false;
+    const serial::PortSettings settings = BuildPortSettingsFromUi(&settingsOk);
+    if (portName.empty() || !settingsOk) {
+        owner_.AppendLog(LogKind::Error, LoadStringFromRes(owner_.instance_, IDS_NO_COM_PORT));
+        return;
+    }
+
+    serial::BridgeEndpoint port;
+    port.portName = portName;
+    port.settings = settings;
+    serial::BridgeEndpoint tcp;
+    tcp.kind = serial::BridgeEndpointKind::TcpListen;
+    tcp.tcpPort = kBridgeTcpPort;
+
+    const bool started = owner_.bridge_.Start(port, tcp, [this](serial::PortBridge::Direction) { NotifyBridgeTap(); });
+
+    wchar_t buffer[256];
+    ::StringCchPrintfW(
+        buffer,
+        _countof(buffer),
+        LoadStringFromRes(owner_.instance_, started ? IDS_BRIDGE_STARTED : IDS_BRIDGE_FAILED).c_str(),
+        portName.c_str(),
+        static_cast<unsigned>(started ? owner_.bridge_.ListeningPort() : kBridgeTcpPort));
+    owner_.AppendLog(started ? LogKind::System : LogKind::Error, buffer);
+}
+
+void WindowActions::StopBridge() {
+    if (!owner_.bridge_.IsRunning()) {
+        return;
+    }
+    const serial::BridgeStats stats = owner_.bridge_.Stats();
+    owner_.bridge_.Stop();
+    DrainBridgeTap();
+
+    wchar_t buffer[256];
+    ::StringCchPrintfW(
+        buffer,
+        _countof(buffer),
+        LoadStringFromRes(owner_.instance_, IDS_BRIDGE_STOPPED).c_str(),
+        static_cast<unsigned long long>(stats.bytesAToB),
+        static_cast<unsigned long long>(stats.bytesBToA));
+    owner_.AppendLog(LogKind::System, buffer);
+}
+
+// Port to TCP is logged as RX, TCP to port as TX, as if the terminal itself were talking.
+void WindowActions::DrainBridgeTap() {
+    owner_.bridgeTapPending_.store(false);
+
+    bool more = false;
+    for (const auto direction : {serial::PortBridge::Direction::AToB, serial::PortBridge::Direction::BToA}) {
+        const bool fromPort = direction == serial::PortBridge::Direction::AToB;
+        core::SlabRing& ring = owner_.bridge_.Tap(direction);
+        std::size_t drained = 0;
+        for (auto slab = ring.Front(); !slab.empty(); slab = ring.Front()) {
+            if (drained == kMaxChunksPerDrain) {
+                more = true;
+                break;
+            }
+            if (fromPort) {
+                owner_.rxBytes_ += slab.size();
+                owner_.AppendLog(LogKind::Rx, L"RX: " + FormatIncoming(slab), ring.FrontTimestamp());
             } else {
-                // Если накопили 2 символа - конвертируем
-                if (current.length() >= 2) {
-                    // Берем по 2 символа
-                    for (size_t i = 0; i < current.length() / 2; i++) {
-                        std::wstring byteStr = current.substr(i * 2, 2);
-                        wchar_t* end;
-                        long val = std::wcstol(byteStr.c_str(), &end, 16);
-                        bytes.push_back(static_cast<uint8_t>(val));
-                    }
-                    // Если остался 1 символ - добавим 0 спереди
-                    if (current.length() % 2 == 1) {
-                        std::wstring byteStr = L"0" + current.substr(current.length() - 1);
-                        wchar_t* end;
-                        long val = std::wcstol(byteStr.c_str(), &end, 16);
-                        bytes.push_back(static_cast<uint8_t>(val));
-                    }
-                }
-                current.clear();
+                owner_.txBytes_ += slab.size();
+                owner_.AppendLog(LogKind::Tx, L"TX: " + FormatIncoming(slab), ring.FrontTimestamp());
             }
+            ring.Release();
+            ++drained;
         }
-        
-        // Обрабатываем остаток строки
-        if (!current.empty()) {
-            if (current.length() >= 2) {
-                for (size_t i = 0; i < current.length() / 2; i++) {
-                    std::wstring byteStr = current.substr(i * 2, 2);
-                    wchar_t* end;
-                    long val = std::wcstol(byteStr.c_str(), &end, 16);
-                    bytes.push_back(static_cast<uint8_t>(val));
-                }
-                if (current.length() % 2 == 1) {
-                    std::wstring byteStr = L"0" + current.substr(current.length() - 1);
-                    wchar_t* end;
-                    long val = std::wcstol(byteStr.c_str(), &end, 16);
-                    bytes.push_back(static_cast<uint8_t>(val));
+    }
+    if (more) {
+        NotifyBridgeTap();
+    }
+    owner_.UpdateStatusText();
+}
+
+// Called on bridge threads.
+void WindowActions::NotifyBridgeTap() {
+    if (owner_.bridgeTapPending_.exchange(true)) {
+        return;
+    }
+    if (!::PostMessageW(owner_.window_, WM_APP_BRIDGE_TAP, 0, 0)) {
+        owner_.bridgeTapPending_.store(false);
+    }
+}
+
+void WindowActions::StartCapture() {
+    if (owner_.captureWriter_.IsOpen()) {
+        return;
+    }
+
+    wchar_t filename[MAX_PATH] = L"capture.comcap";
+    OPENFILENAMEW ofn = {};
+    ofn.lStructSize = sizeof(ofn);
+    ofn.hwndOwner = owner_.window_;
+    ofn.lpstrFilter = L"Traffic Captures (*.comcap)\0*.comcap\0All Files (*.*)\0*.*\0";
+    ofn.lpstrFile = filename;
+    ofn.nMaxFile = MAX_PATH;
+    ofn.lpstrDefExt = L"comcap";
+    ofn.Flags = OFN_OVERWRITEPROMPT | OFN_PATHMUSTEXIST | OFN_HIDEREADONLY;
+    if (!::GetSaveFileNameW(&ofn)) {
+        return;
+    }
+
+    const bool opened = owner_.captureWriter_.Open(filename);
+    wchar_t buffer[MAX_PATH + 128];
+    ::StringCchPrintfW(
+        buffer, _countof(buffer), LoadStringFromRes(owner_.instance_, opened ? IDS_CAPTURE_STARTED : IDS_CAPTURE_FAILED).c_str(), filename);
+    owner_.AppendLog(opened ? LogKind::System : LogKind::Error, buffer);
+}
+
+void WindowActions::StopCapture() {
+    if (!owner_.captureWriter_.IsOpen()) {
+        return;
+    }
+    owner_.captureWriter_.Close();
+
+    const serial::CaptureWriterStats stats = owner_.captureWriter_.Stats();
+    wchar_t buffer[256];
+    ::StringCchPrintfW(
+        buffer,
+        _countof(buffer),
+        LoadStringFromRes(owner_.instance_, IDS_CAPTURE_STOPPED).c_str(),
+        static_cast<unsigned long long>(stats.records),
+        static_cast<unsigned long long>(stats.payloadBytes),
+        static_cast<unsigned long long>(stats.droppedBytes));
+    owner_.AppendLog(stats.writeFailed || stats.droppedBytes != 0 ? LogKind::Error : LogKind::System, buffer);
+}
+
+void WindowActions::StartReplay(bool asFastAsPossible) {
+    if (owner_.serialPort_.IsOpen()) {
+        owner_.AppendLog(LogKind::Error, LoadStringFromRes(owner_.instance_, IDS_REPLAY_CLOSE_PORT));
+        return;
+    }
+    StopReplay();
+
+    wchar_t filename[MAX_PATH] = {};
+    OPENFILENAMEW ofn = {};
+    ofn.lStructSize = sizeof(ofn);
+    ofn.hwndOwner = owner_.window_;
+    ofn.lpstrFilter = L"Traffic Captures (*.comcap)\0*.comcap\0All Files (*.*)\0*.*\0";
+    ofn.lpstrFile = filename;
+    ofn.nMaxFile = MAX_PATH;
+    ofn.Flags = OFN_FILEMUSTEXIST | OFN_PATHMUSTEXIST | OFN_HIDEREADONLY;
+    if (!::GetOpenFileNameW(&ofn)) {
+        return;
+    }
+
+    // Only RX re-enters the pipeline. Unlike a live port the replay waits for room in rxBuffer_
+    // instead of overrunning, so a fast replay shows every byte.
+    owner_.replayCancel_.store(false);
+    owner_.crcFraming_.Reset();
+    owner_.crcCursor_ = owner_.crcFraming_.NextSequence();
+    HWND window = owner_.window_;
+    MainWindow& owner = owner_;
+    const bool started = owner_.replayer_.Start(
+        filename,
+        [this, &owner](const serial::CaptureRecord& record, std::int64_t replayNs) {
+            if (record.kind != serial::CaptureKind::Rx) {
+                return;
+            }
+            std::span<const uint8_t> rest = record.payload;
+            while (!rest.empty() && !owner.replayCancel_.load()) {
+                const std::span<const uint8_t> chunk = rest.first(std::min(rest.size(), kReplayChunkBytes));
+                const std::size_t free = owner.rxBuffer_.Capacity() - owner.rxBuffer_.Size();
+                if (free < core::BufferPool::kRecordHeaderBytes + chunk.size()) {
+                    NotifySerialData();
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    continue;
                 }
-            } else {
-                // Один символ в конце
-                std::wstring byteStr = L"0" + current;
-                wchar_t* end;
-                long val = std::wcstol(byteStr.c_str(), &end, 16);
-                bytes.push_back(static_cast<uint8_t>(val));
+                owner.crcFraming_.Feed(chunk, replayNs);
+                owner.rxBuffer_.WriteRecord(chunk, replayNs);
+                rest = rest.subspan(chunk.size());
             }
+            NotifySerialData();
+        },
+        serial::ReplayOptions{asFastAsPossible ? 0.0 : 1.0},
+        [window](const serial::ReplayStats&) { ::PostMessageW(window, WM_APP_REPLAY_DONE, 0, 0); });
+
+    wchar_t buffer[MAX_PATH + 128];
+    ::StringCchPrintfW(
+        buffer, _countof(buffer), LoadStringFromRes(owner_.instance_, started ? IDS_REPLAY_STARTED : IDS_REPLAY_FAILED).c_str(), filename);
+    owner_.AppendLog(started ? LogKind::System : LogKind::Error, buffer);
+}
+
+void WindowActions::StopReplay() {
+    owner_.replayCancel_.store(true);
+    owner_.replayer_.Stop();
+}
+
+void WindowActions::HandleReplayDone() {
+    const serial::ReplayStats stats = owner_.replayer_.Stats();
+    if (!stats.finished) {
+        return;
+    }
+    wchar_t buffer[256];
+    ::StringCchPrintfW(
+        buffer,
+        _countof(buffer),
+        LoadStringFromRes(owner_.instance_, IDS_REPLAY_DONE).c_str(),
+        static_cast<unsigned long long>(stats.records),
+        static_cast<unsigned long long>(stats.bytes));
+    owner_.AppendLog(stats.ok ? LogKind::System : LogKind::Error, buffer);
+}
+
+void WindowActions::HandleWriteDone(bool ok, DWORD written) {
+    owner_.txBytes_ += written;
+    owner_.UpdateStatusText();
+
+    if (!ok) {
+        owner_.AppendLog(LogKind::Error, LoadStringFromRes(owner_.instance_, IDS_WRITE_FAILED));
+    }
+}
+
+void WindowActions::DrainSerialData() {
+    owner_.rxNotifyPending_.store(false);
+
+    std::int64_t timestampNs = 0;
+    for (std::size_t drained = 0; owner_.rxBuffer_.ReadRecord(&owner_.rxRecord_, &timestampNs); ++drained) {
+        HandleSerialData(owner_.rxRecord_, timestampNs);
+        if (drained + 1U == kMaxChunksPerDrain) {
+            NotifySerialData();
+            break;
         }
     }
 
-    if (bytes.empty()) {
-        owner_.AppendLog(LogKind::Error, LoadStringFromRes(owner_.instance_, IDS_NO_DATA_TO_SEND));
+    DrainCrcChecks();
+    owner_.UpdateStatusText();
+}
+
+void WindowActions::NotifySerialData() {
+    if (owner_.rxNotifyPending_.exchange(true)) {
         return;
     }
+    if (!::PostMessageW(owner_.window_, WM_APP_SERIAL_DATA, 0, 0)) {
+        owner_.rxNotifyPending_.store(false);
+    }
+}
 
-    DWORD written = 0;
-    if (owner_.serialPort_.Write(bytes.data(), static_cast<DWORD>(bytes.size()), &written)) {
-        owner_.txBytes_ += written;
-        owner_.UpdateStatusText();
-        
-        if (mode == 0) {
-            std::wstring displayText = text;
-            if (displayText.length() > 100) {
-                displayText = displayText.substr(0, 100) + L"...";
-            }
-            owner_.AppendLog(LogKind::Tx, L"TX: " + displayText);
-        } else {
-            owner_.AppendLog(LogKind::Tx, L"TX: " + MainWindow::BytesToHex(bytes));
+void WindowActions::DrainModemEvents() {
+    owner_.modemNotifyPending_.store(false);
+
+    std::array<serial::ModemEvent, 16> events{};
+    std::uint64_t lost = 0;
+    for (;;) {
+        const std::size_t count = owner_.serialPort_.ModemEvents().Read(&owner_.modemCursor_, events, &lost);
+        for (std::size_t i = 0; i < count; ++i) {
+            owner_.AppendLog(LogKind::System, L"MODEM: " + FormatModemEvent(events[i]), events[i].timestampNs);
         }
+        if (count < events.size()) {
+            break;
+        }
+    }
+    if (lost != 0) {
+        owner_.AppendLog(LogKind::Error, L"MODEM: " + std::to_wstring(lost) + L" events lost");
+    }
+}
+
+void WindowActions::NotifyModemEvent() {
+    if (owner_.modemNotifyPending_.exchange(true)) {
+        return;
+    }
+    if (!::PostMessageW(owner_.window_, WM_APP_MODEM_EVENT, 0, 0)) {
+        owner_.modemNotifyPending_.store(false);
+    }
+}
+
+void WindowActions::SetCrcFraming(UINT command) {
+    owner_.crcCommand_ = command;
+    ::CheckMenuRadioItem(::GetMenu(owner_.window_), IDM_PORT_CRC_NONE, IDM_PORT_CRC_32, command, MF_BYCOMMAND);
+    ApplyCrcFraming();
+
+    const CrcPreset* preset = FindCrcPreset(command);
+    if (preset == nullptr) {
+        owner_.AppendLog(LogKind::System, LoadStringFromRes(owner_.instance_, IDS_CRC_FRAMING_OFF));
     } else {
-        owner_.AppendLog(LogKind::Error, LoadStringFromRes(owner_.instance_, IDS_WRITE_FAILED));
+        wchar_t buffer[256];
+        ::StringCchPrintfW(
+            buffer,
+            _countof(buffer),
+            LoadStringFromRes(owner_.instance_, IDS_CRC_FRAMING_ON).c_str(),
+            preset->name,
+            static_cast<unsigned>(owner_.crcFraming_.Settings().gapNs / 1000000));
+        owner_.AppendLog(LogKind::System, buffer);
     }
+    owner_.UpdateStatusText();
 }
 
-void WindowActions::HandleSerialData(const std::vector<uint8_t>& bytes) {
-    owner_.rxBytes_ += static_cast<std::uint64_t>(bytes.size());
+void WindowActions::ApplyCrcFraming() {
+    serial::CrcFramingSettings settings;
+    if (const CrcPreset* preset = FindCrcPreset(owner_.crcCommand_)) {
+        bool ok = false;
+        const serial::PortSettings port = BuildPortSettingsFromUi(&ok);
+        const std::int64_t baud = ok ? static_cast<std::int64_t>(port.baudRate) : 9600;
+        settings.model = preset->model;
+        settings.bigEndian = preset->bigEndian;
+        settings.gapNs = std::max<std::int64_t>(35LL * 1000000000LL / baud, kMinCrcGapNs);
+    }
+    owner_.crcFraming_.Configure(settings);
+
+    if (settings.model.width != 0U) {
+        ::SetTimer(owner_.window_, kCrcExpireTimerId, kCrcExpireTimerMs, nullptr);
+    } else {
+        ::KillTimer(owner_.window_, kCrcExpireTimerId);
+    }
+}
+
+void WindowActions::ExpireCrcFrames() {
+    owner_.crcFraming_.Expire(core::MonotonicNanos());
+    DrainCrcChecks();
+}
+
+void WindowActions::DrainCrcChecks() {
+    if (owner_.crcFraming_.NextSequence() == owner_.crcCursor_) {
+        return;
+    }
+
+    const int digits = static_cast<int>((owner_.crcFraming_.Settings().model.width + 3U) / 4U);
+    const std::wstring format = LoadStringFromRes(owner_.instance_, IDS_CRC_FRAME_BAD);
+    std::array<serial::CrcFrameCheck, 64> checks{};
+    std::uint64_t lost = 0;
+    for (;;) {
+        const std::size_t count = owner_.crcFraming_.Read(&owner_.crcCursor_, checks, &lost);
+        // Passed frames only move the counters; a log line each would flood it at line rate.
+        for (std::size_t i = 0; i < count; ++i) {
+            const serial::CrcFrameCheck& check = checks[i];
+            if (check.ok) {
+                continue;
+            }
+            wchar_t buffer[256];
+            ::StringCchPrintfW(
+                buffer,
+                _countof(buffer),
+                format.c_str(),
+                static_cast<unsigned>(check.length),
+                static_cast<unsigned long long>(check.offset),
+                digits,
+                static_cast<unsigned>(check.received),
+                digits,
+                static_cast<unsigned>(check.computed));
+            owner_.AppendLog(LogKind::Error, buffer, check.timestampNs);
+        }
+        if (count < checks.size()) {
+            break;
+        }
+    }
+    if (lost != 0) {
+        wchar_t buffer[256];
+        ::StringCchPrintfW(
+            buffer,
+            _countof(buffer),
+            LoadStringFromRes(owner_.instance_, IDS_CRC_CHECKS_LOST).c_str(),
+            static_cast<unsigned long long>(lost));
+        owner_.AppendLog(LogKind::Error, buffer);
+    }
     owner_.UpdateStatusText();
-    owner_.AppendLog(LogKind::Rx, L"RX: " + FormatIncoming(bytes));
+}
+
+std::wstring WindowActions::FormatModemEvent(const serial::ModemEvent& event) {
+    struct Line {
+        DWORD mask;
+        const wchar_t* name;
+    };
+    static constexpr Line kLines[] = {
+        {MS_CTS_ON, L"CTS"}, {MS_DSR_ON, L"DSR"}, {MS_RING_ON, L"RI"}, {MS_RLSD_ON, L"DCD"}};
+
+    // "CTS=1 DSR=0 RI=0 DCD=1 [CTS]": the brackets list the lines that toggled.
+    std::wstring text;
+    std::wstring changed;
+    for (const Line& line : kLines) {
+        text += line.name;
+        text += ((event.status & line.mask) != 0) ? L"=1 " : L"=0 ";
+        if ((event.changed & line.mask) != 0) {
+            changed += changed.empty() ? L"" : L" ";
+            changed += line.name;
+        }
+    }
+    if (!changed.empty()) {
+        text += L"[" + changed + L"]";
+    } else if (!text.empty()) {
+        text.pop_back();
+    }
+    return text;
+}
+
+void WindowActions::HandleSerialData(std::span<const uint8_t> bytes, std::int64_t timestampNs) {
+    owner_.rxBytes_ += static_cast<std::uint64_t>(bytes.size());
+    owner_.AppendLog(LogKind::Rx, L"RX: " + FormatIncoming(bytes), timestampNs);
 }
 
 std::wstring WindowActions::ComboText(HWND combo) {
@@ -240,6 +897,27 @@ std::wstring WindowActions::ComboText(HWND combo) {
     return text;
 }
 
+std::wstring WindowActions::SelectedPortName() const {
+    const int selected = static_cast<int>(::SendMessage(owner_.comboPort_, CB_GETCURSEL, 0, 0));
+    if (selected < 0) {
+        return L"";
+    }
+
+    wchar_t portText[256] = {};
+    ::SendMessage(owner_.comboPort_, CB_GETLBTEXT, static_cast<WPARAM>(selected), reinterpret_cast<LPARAM>(portText));
+    const std::wstring selection = portText;
+    const std::size_t spacePos = selection.find(L' ');
+    return (spacePos == std::wstring::npos) ? selection : selection.substr(0, spacePos);
+}
+
+// Combo indices follow the enum order, see WindowBuilder::FillConnectionDefaults().
+void WindowActions::ApplyPortSettingsToUi(const serial::PortSettings& settings) {
+    ::SetWindowTextW(owner_.comboBaud_, std::to_wstring(settings.baudRate).c_str());
+    ::SendMessage(owner_.comboDataBits_, CB_SETCURSEL, static_cast<WPARAM>(settings.dataBits - 5U), 0);
+    ::SendMessage(owner_.comboParity_, CB_SETCURSEL, static_cast<WPARAM>(settings.parity), 0);
+    ::SendMessage(owner_.comboStopBits_, CB_SETCURSEL, static_cast<WPARAM>(settings.stopBits), 0);
+}
+
 serial::PortSettings WindowActions::BuildPortSettingsFromUi(bool* ok) const {
     serial::PortSettings s{};
     if (ok != nullptr) {
@@ -282,7 +960,7 @@ serial::PortSettings WindowActions::BuildPortSettingsFromUi(bool* ok) const {
     return s;
 }
 
-std::wstring WindowActions::FormatIncoming(const std::vector<uint8_t>& bytes) const {
+std::wstring WindowActions::FormatIncoming(std::span<const uint8_t> bytes) const {
     const int mode = static_cast<int>(::SendMessage(owner_.comboRxMode_, CB_GETCURSEL, 0, 0));
     
     if (mode == 0) {
@@ -368,11 +1046,11 @@ std::wstring WindowActions::FormatIncoming(const std::vector<uint8_t>& bytes) co
         }
         
         // Если ничего не работает - HEX
-        return L"[BIN] " + MainWindow::BytesToHex(bytes);
+        return L"[BIN] " + core::BytesToHex(bytes);
     }
     
     // HEX режим
-    return MainWindow::BytesToHex(bytes);
+    return core::BytesToHex(bytes);
 }
 
 } // namespace ui
@@ -2,8 +2,10 @@
 
 #include <windows.h>
 #include <commctrl.h>
+#include <array>
 #include <cstdlib>
 #include <limits>
+#include <span>
 #include <string>
 #include <vector>
 #include <sstream>      // Для stringstream
@@ -25,15 +27,46 @@ class WindowActions final {
 public:
     explicit WindowActions(MainWindow& owner);
 
+    void StartPortScanner();
     void RefreshPorts();
+    void DrainPortDiffs();
     bool OpenSelectedPort();
     void ClosePort();
     void SendInputData();
-    void HandleSerialData(const std::vector<uint8_t>& bytes);
+    void SendFile();
+    void CancelFileSend();
+    void HandleFileProgress();
+    void StartAutoDetect();
+    void StopAutoDetect();
+    void HandleAutoDetectDone();
+    void StartBridge();
+    void StopBridge();
+    void DrainBridgeTap();
+    void NotifyBridgeTap();
+    void StartCapture();
+    void StopCapture();
+    void StartReplay(bool asFastAsPossible);
+    void StopReplay();
+    void HandleReplayDone();
+    void HandleWriteDone(bool ok, DWORD written);
+    void DrainSerialData();
+    void HandleSerialData(std::span<const uint8_t> bytes, std::int64_t timestampNs);
+    void DrainModemEvents();
+    void SetCrcFraming(UINT command);
+    void ExpireCrcFrames();
 
 private:
     static std::wstring ComboText(HWND combo);
-    std::wstring FormatIncoming(const std::vector<uint8_t>& bytes) const;
+    std::wstring SelectedPortName() const;
+    void ApplyPortSettingsToUi(const serial::PortSettings& settings);
+    void RebuildPortCombo(const std::vector<serial::PortInfo>& ports);
+    void LogPortChange(UINT formatId, const serial::PortInfo& port);
+    void NotifySerialData();
+    void NotifyModemEvent();
+    void ApplyCrcFraming();
+    void DrainCrcChecks();
+    static std::wstring FormatModemEvent(const serial::ModemEvent& event);
+    std::wstring FormatIncoming(std::span<const uint8_t> bytes) const;
     serial::PortSettings BuildPortSettingsFromUi(bool* ok) const;
 
     MainWindow& owner_;